@@ -96,6 +96,9 @@ public:
   /// Checks if any task has thrown an exception and optionally rethrows it
   bool checkForException(bool rethrow=false);
 
+  /// Returns the number of threads of the pool
+  unsigned int threadCount() const;
+
 private:
   
   std::mutex m_queue_mutex {};
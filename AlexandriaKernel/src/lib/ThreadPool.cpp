@@ -122,6 +122,10 @@ bool ThreadPool::checkForException(bool rethrow) {
   return false;
 }
 
+unsigned int ThreadPool::threadCount() const {
+  return m_worker_run_flags.size();
+}
+
 void ThreadPool::block() {
   // Wait for the queue to be empty
   bool queue_is_empty = false;
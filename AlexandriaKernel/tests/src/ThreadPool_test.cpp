@@ -167,6 +167,19 @@ BOOST_AUTO_TEST_CASE( checkForException_test ) {
 }
 
 
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( threadCount_test ) {
+
+  // Given
+  ThreadPool pool {3, 10};
+
+  // Then
+  BOOST_CHECK_EQUAL(pool.threadCount(), 3);
+
+}
+
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END ()
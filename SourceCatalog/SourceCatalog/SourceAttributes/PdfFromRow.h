@@ -43,6 +43,7 @@
 #define SOURCECATALOG_PDFFROMROW_H
 
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 #include "ElementsKernel/Exception.h"
@@ -69,6 +70,18 @@ public:
   std::unique_ptr<Attribute> createAttribute(const Euclid::Table::Row& row) override {
     std::map<std::string, typename Pdf<T>::PdfType> pdf_map {};
     
+    // The columns are resolved once, with the columns of the first row, so the
+    // following rows do not search them by name. The attributes can be created
+    // by many threads, so the handles are set only once.
+    std::call_once(m_column_handles_flag, [this, &row]() {
+      std::vector<Table::ColumnInfo::Handle> handles {};
+      for (auto& pair : m_keys) {
+        handles.push_back(row.getColumnInfo()->getHandle(m_column_names.at(pair.first)));
+      }
+      m_column_handles = std::move(handles);
+    });
+    
+    auto handle = m_column_handles.begin();
     for (auto& pair : m_keys) {
       // Use the key values to create the axis of the PDF
       GridContainer::GridAxis<T> axis {pair.first, pair.second};
@@ -76,8 +89,7 @@ public:
       typename Pdf<T>::PdfType pdf {axis};
       
       // Get the PDF data from the row
-      auto& col_name = m_column_names.at(pair.first);
-      auto data = boost::apply_visitor(Table::CastVisitor<std::vector<double>>{}, row[col_name]);
+      auto data = boost::apply_visitor(Table::CastVisitor<std::vector<double>>{}, row[*(handle++)]);
       if (data.size() != pdf.size()) {
         throw Elements::Exception() << "Incompatible PDF size";
       }
@@ -96,6 +108,8 @@ private:
   
   std::map<std::string, std::vector<T>> m_keys;
   std::map<std::string, std::string> m_column_names;
+  std::vector<Table::ColumnInfo::Handle> m_column_handles {};
+  std::once_flag m_column_handles_flag {};
   
 };
 
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file Table/ArrowReader.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef _TABLE_ARROWREADER_H
+#define _TABLE_ARROWREADER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Table/TableReader.h"
+
+namespace Euclid {
+namespace Table {
+
+struct ArrowSchema;
+struct ArrowBatch;
+
+/**
+ * @class ArrowReader
+ *
+ * @brief TableReader implementation for reading tables from Arrow IPC files
+ *
+ * @details
+ * The file is memory mapped and only its footer and the metadata of its
+ * record batches are parsed when the reader is constructed. The column data
+ * are accessed only when they are read, directly from the mapping.
+ *
+ * The Arrow types are mapped to the column types as following:
+ * - Bool: bool
+ * - Int8, Int16, Int32, UInt8, UInt16: int32_t
+ * - Int64, UInt32: int64_t
+ * - Float32, Float64: float, double
+ * - Utf8, LargeUtf8: std::string
+ * - List, LargeList, FixedSizeList of the above numeric types: std::vector<T>
+ * - FixedSizeList with the "arrow.fixed_shape_tensor" extension type: NdArray<T>
+ *
+ * Files with null values, dictionary encoded or compressed columns, or any
+ * other type, are rejected with an exception. The values of the numeric and
+ * fixed size list columns can be accessed without any copy by using the
+ * mapColumn() method.
+ */
+class ArrowReader : public TableReader {
+
+public:
+
+  /// A contiguous part of a column, pointing directly in the mapped file
+  template <typename T>
+  struct ColumnChunk {
+    const T* data;
+    std::size_t size;
+  };
+
+  /**
+   * @brief Creates an ArrowReader for the given file
+   * @param filename
+   *    The file to read the table from
+   * @throws Elements::Exception
+   *    if the file cannot be mapped, if it is not an Arrow file or if it
+   *    contains unsupported features
+   */
+  ArrowReader(const std::string& filename);
+
+  ArrowReader(ArrowReader&&);
+  ArrowReader& operator=(ArrowReader&&);
+
+  ArrowReader(const ArrowReader&) = delete;
+  ArrowReader& operator=(const ArrowReader&) = delete;
+
+  /// Destructor
+  virtual ~ArrowReader();
+
+  /**
+   * @brief Restricts the reading to the given columns
+   * @details
+   * The returned tables contain only the given columns, in the given order.
+   * The data of the other columns are never accessed.
+   * @param column_names
+   *    The names of the columns to read
+   * @return
+   *    A reference to the ArrowReader instance
+   * @throws Elements::Exception
+   *    if the list is empty or any of the columns does not exist
+   * @throws Elements::Exception
+   *    if the ArrowReader instance has already been used for reading
+   */
+  ArrowReader& selectColumns(const std::vector<std::string>& column_names);
+
+  /**
+   * @brief Returns the values of a column as they are stored in the file
+   * @details
+   * The column must be a scalar or a fixed size list column, with values
+   * stored exactly as T, which can be int32_t, int64_t, float or double. There
+   * is one chunk for each record batch of the file. For fixed size lists the
+   * values of all the rows are contiguous, so the size of the chunks is the
+   * number of rows times the list size. The returned pointers are valid for
+   * the lifetime of the reader. This method does not affect the rows read by
+   * the read() method.
+   * @param column_name
+   *    The name of the column
+   * @return
+   *    The chunks of the column values
+   * @throws Elements::Exception
+   *    if the column does not exist or its values are not stored as T
+   */
+  template <typename T>
+  std::vector<ColumnChunk<T>> mapColumn(const std::string& column_name) const;
+
+  /// Returns the description of the (selected) columns of the table
+  const ColumnInfo& getInfo() override;
+
+  /// Returns the comment of the table
+  std::string getComment() override;
+
+  /// Implements the TableReader::skip() contract
+  void skip(long rows) override;
+
+  /// Implements the TableReader::hasMoreRows() contract
+  bool hasMoreRows() override;
+
+  /// Implements the TableReader::rowsLeft() contract
+  std::size_t rowsLeft() override;
+
+protected:
+
+  /// Implements the TableReader::readImpl() contract
+  Table readImpl(long rows) override;
+
+private:
+
+  std::size_t columnIndex(const std::string& column_name) const;
+
+  std::string m_filename;
+  // The mapped file is kept behind a pointer, so the header does not depend on
+  // the boost iostreams library
+  std::shared_ptr<const void> m_file;
+  std::unique_ptr<ArrowSchema> m_schema;
+  std::vector<ArrowBatch> m_batches;
+  std::vector<std::size_t> m_columns {};
+  std::shared_ptr<ColumnInfo> m_column_info {};
+  std::size_t m_total_rows = 0;
+  std::size_t m_current_row = 0;
+  bool m_reading_started = false;
+
+}; /* End of ArrowReader class */
+
+} /* namespace Table */
+} /* namespace Euclid */
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file Table/ArrowWriter.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef _TABLE_ARROWWRITER_H
+#define _TABLE_ARROWWRITER_H
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Table/TableWriter.h"
+
+namespace Euclid {
+namespace Table {
+
+struct ArrowSchema;
+struct ArrowBlock;
+
+/**
+ * @class ArrowWriter
+ *
+ * @brief TableWriter implementation for writing tables in the Arrow IPC file
+ * format
+ *
+ * @details
+ * The files can be read by any Arrow implementation (for example pyarrow). The
+ * format is implemented by this class itself, so there is no dependency on the
+ * Arrow libraries.
+ *
+ * Each call of addData() appends a record batch to the file, followed by an
+ * updated footer. The file is therefore a valid Arrow file after each call.
+ *
+ * The columns are mapped to the Arrow types as following:
+ * - bool, int32_t, int64_t, float, double: Bool, Int32, Int64, Float32, Float64
+ * - std::string: Utf8
+ * - std::vector<T>: List of T
+ * - NdArray<T>: FixedSizeList of T, with the "arrow.fixed_shape_tensor"
+ *   extension type. All the NdArrays of a column must have the same shape.
+ *
+ * The units and the descriptions of the columns are stored in the "unit" and
+ * "description" field metadata and the comment of the table in the "comment"
+ * schema metadata. None of the columns is nullable.
+ */
+class ArrowWriter : public TableWriter {
+
+public:
+
+  /**
+   * @brief Creates an ArrowWriter that writes to a specific file
+   *
+   * @details
+   * If the override_flag is set to true, any pre-existing file will be
+   * replaced. If this flag is set to false and the file exists, its record
+   * batches are appended, in which case the first table given to addData()
+   * must have the same columns.
+   *
+   * The file is opened during the first call of addData() and it is kept open
+   * until the ArrowWriter is destroyed.
+   *
+   * @param filename
+   *    The path of the file to store the table
+   * @param override_flag
+   *    When true, any existing file will be overridden
+   */
+  ArrowWriter(const std::string& filename, bool override_flag=false);
+
+  ArrowWriter(ArrowWriter&&);
+  ArrowWriter& operator=(ArrowWriter&&);
+
+  ArrowWriter(const ArrowWriter&) = delete;
+  ArrowWriter& operator=(const ArrowWriter&) = delete;
+
+  /// Destructor
+  virtual ~ArrowWriter();
+
+  /**
+   * @brief Adds a comment to the table
+   * @details
+   * The comments are stored in the schema of the footer, so they can be added
+   * at any time. Multiple comments are separated by new line characters.
+   */
+  void addComment(const std::string& comment) override;
+
+protected:
+
+  /// Creates the file or reads the footer of the existing one
+  void init(const Table& table) override;
+
+  /// Writes the table as a new record batch and updates the footer
+  void append(const Table& table) override;
+
+private:
+
+  void writeFooter();
+
+  std::string m_filename;
+  bool m_override_file;
+  std::string m_comment {};
+  std::fstream m_stream {};
+  std::unique_ptr<ArrowSchema> m_schema;
+  std::vector<ArrowBlock> m_blocks;
+  std::uint64_t m_data_end = 0;
+  std::uint64_t m_file_end = 0;
+
+}; /* End of ArrowWriter class */
+
+} /* namespace Table */
+} /* namespace Euclid */
+
+#endif
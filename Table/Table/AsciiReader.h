@@ -26,11 +26,15 @@
 #define _TABLE_ASCIIREADER_H
 
 #include "AlexandriaKernel/InstOrRefHolder.h"
+#include "Table/ColumnReader.h"
+#include "Table/Filter.h"
 #include "Table/TableReader.h"
 
 namespace Euclid {
 namespace Table {
 
+struct AsciiRowIndex;
+
 /**
  * @class AsciiReader
  * 
@@ -72,19 +76,41 @@ namespace Table {
  * If the column names comment is present, the column descriptions can be missing
  * and be given in any order.
  * 
+ * Columns without a description are by default read as strings. If the
+ * inferColumnTypes() method is called, their types are instead inferred from
+ * the values of the first data rows.
+ * 
  * The above automatic detection of the names and types of the columns can be
  * overridden by used defined values, by calling the fixColumnNames() and
  * fixColumnTypes() methods.
  * 
  * Note that the vector entries are values separated by "," (no spaces).
  * 
+ * The cells equal to one of the tokens given with setNullTokens() are read as
+ * missing values and marked in the validity bitmaps of the returned tables
+ * (see Table::getValidity()), as are the NaN values of the floating point
+ * columns. The cells of the missing values contain NaN for floating point
+ * columns, zero for integers, false for booleans and the null token itself
+ * for strings.
+ * 
  * The stream is red line by line and one row is created for each line which,
  * after comments are removed, does not contain only whitespace characters.
  * The columns are separated by one or more whitespace characters and all rows
  * must have the same number of columns.
  * 
+ * By default the rowsLeft(), hasMoreRows() and skip() methods have to parse the
+ * stream from the current position. If they are used repeatedly (or if random
+ * access to the rows is needed), a row offset index can be enabled with the
+ * useRowIndex() method. The index can be stored next to the table with the
+ * saveRowIndex() method and be reused with the loadRowIndex() method, so the
+ * stream does not need to be scanned again.
+ * 
+ * The reader also implements the ColumnReader interface, which converts the
+ * cells of the requested columns directly to typed vectors, without creating
+ * Row objects (see TypedTableReader).
+ * 
  */
-class AsciiReader : public TableReader {
+class AsciiReader : public TableReader, public ColumnReader {
 
 public:
   
@@ -119,7 +145,10 @@ public:
   /// Constructs an AsciiReader which reads from the given stream
   AsciiReader(std::istream& stream);
   
-  /// Constructs an AsciiReader which reads from the given file
+  /// Constructs an AsciiReader which reads from the given file. If the file
+  /// is compressed with gzip, bzip2 or zstd (detected by its magic bytes) it
+  /// is decompressed while it is read. To decompress on a helper thread use
+  /// AsciiReader::create<CompressedIStream>(filename, true) instead.
   AsciiReader(const std::string& filename);
   
   AsciiReader(AsciiReader&&) = default;
@@ -159,6 +188,23 @@ public:
    *    vectors does not match
    */
   AsciiReader& fixColumnNames(std::vector<std::string> column_names);
+
+  /**
+   * @brief Sets the tokens which represent missing values
+   * @details
+   * The tokens are compared with the whole cells of the scalar columns (for
+   * example "null", "NA" or "-99"). The type inference ignores the cells with
+   * null tokens.
+   * @param tokens
+   *    The null tokens
+   * @return 
+   *    A reference to the AsciiReader instance
+   * @throws Elements::Exception
+   *    if reading has already started
+   * @throws Elements::Exception
+   *    if a token is empty or contains whitespace characters
+   */
+  AsciiReader& setNullTokens(std::vector<std::string> tokens);
   
   /**
    * @brief Overrides the automatically detected column types
@@ -172,6 +218,115 @@ public:
    */
   AsciiReader& fixColumnTypes(std::vector<std::type_index> column_types);
 
+  /**
+   * @brief Enables the type inference for the columns without description
+   * @details
+   * The first sample_rows data rows are parsed and each column without a
+   * column description comment gets the narrowest type among bool, int32,
+   * int64, float and double (or vector of those) that can represent all the
+   * sampled values without loss of information. Columns containing other
+   * values are read as strings. Note that if a value after the sampled rows
+   * does not fit the inferred type, reading that row fails. Types fixed with
+   * fixColumnTypes() take precedence over the inferred ones.
+   * @param sample_rows
+   *    The number of data rows to use for the inference
+   * @return
+   *    A reference to the AsciiReader instance
+   * @throws Elements::Exception
+   *    if the sample_rows is zero
+   * @throws Elements::Exception
+   *    if reading has already started
+   */
+  AsciiReader& inferColumnTypes(std::size_t sample_rows=1000);
+
+  /**
+   * @brief Enables the usage of a row offset index
+   * @details
+   * When the index is enabled, the first call of any of the methods rowsLeft(),
+   * hasMoreRows(), skip() or readRows() scans the full stream once and keeps
+   * the position of every sampling-th data row. After that, rowsLeft() and
+   * hasMoreRows() are O(1) and skip() and readRows() need to parse at most
+   * sampling lines. Note that the stream must support seeking.
+   * @param sampling
+   *    Every how many rows a position is kept
+   * @return
+   *    A reference to the AsciiReader instance
+   * @throws Elements::Exception
+   *    if the sampling is zero
+   * @throws Elements::Exception
+   *    if reading has already started
+   */
+  AsciiReader& useRowIndex(std::size_t sampling=1024);
+
+  /**
+   * @brief Sets a filter selecting the rows to read
+   * @details
+   * When a filter is set, read() and readRows() return the next rows which
+   * pass the filter. The lines are split in chunks, the filter columns of the
+   * chunk are converted first and the rest of the cells are converted only
+   * for the selected lines, so the rejected rows never become Row objects.
+   *
+   * With a filter, hasMoreRows() scans ahead for the next row passing the
+   * filter (keeping the rows it finds for the next read()), so read() always
+   * succeeds when it returns true. The skip() method skips rows passing the
+   * filter. The rowsLeft() method returns an upper limit of the rows read()
+   * can still return: the rows already found by hasMoreRows() plus the data
+   * lines of the stream which have not been scanned yet. The readRows()
+   * method still refers to the rows of the stream before filtering.
+   * @param filter
+   *    The filter to apply
+   * @return
+   *    A reference to the AsciiReader instance
+   * @throws Elements::Exception
+   *    if reading has already started
+   */
+  AsciiReader& setFilter(Filter filter);
+
+  /**
+   * @brief Loads a row index previously stored with saveRowIndex()
+   * @details
+   * It enables the usage of the row index (see useRowIndex()) without the need
+   * of scanning the stream.
+   * @param filename
+   *    The file containing the index
+   * @return
+   *    A reference to the AsciiReader instance
+   * @throws Elements::Exception
+   *    if the file does not contain a valid index
+   * @throws Elements::Exception
+   *    if the index was created for a stream with different length or a
+   *    different comment indicator
+   */
+  AsciiReader& loadRowIndex(const std::string& filename);
+
+  /**
+   * @brief Stores the row index of the stream in a file
+   * @details
+   * If the index has not been created yet it is created by this call (scanning
+   * the stream), by using the sampling set by useRowIndex() or the default one.
+   * @param filename
+   *    The file to write the index to
+   */
+  void saveRowIndex(const std::string& filename);
+
+  /**
+   * @brief Reads rows starting from the given row
+   * @details
+   * The reader is positioned at the given row (zero based, counting only the
+   * data rows) and the rows are read like with the read() method. Subsequent
+   * calls of read() continue after the last returned row. If the row index is
+   * not yet enabled, it is enabled with the default sampling.
+   * @param first
+   *    The index of the first row to read
+   * @param rows
+   *    The number of rows to read, or -1 for all the remaining rows
+   * @return
+   *    The table containing the row data
+   * @throws Elements::Exception
+   *    if the first row is not smaller than the number of rows in the stream
+   */
+  Table readRows(std::size_t first, long rows=-1);
+
   /**
    * @brief Returns the column information of the table
    * @details
@@ -200,6 +355,36 @@ public:
   
   /// Implements the TableReader::rowsLeft() contract
   std::size_t rowsLeft() override;
+
+  /**
+   * @brief Implements the ColumnReader::readColumns() contract
+   * @details
+   * The lines are only split in cells, which are converted when the columns
+   * are retrieved with getColumn().
+   * @throws Elements::Exception
+   *    if a line has a wrong number of cells
+   * @throws Elements::Exception
+   *    if a filter is set
+   */
+  std::size_t readColumns(long rows) override;
+
+  /// Implements the ColumnReader::getColumn() contract
+  void getColumn(std::size_t index, std::vector<bool>& values) override;
+
+  /// Implements the ColumnReader::getColumn() contract
+  void getColumn(std::size_t index, std::vector<int32_t>& values) override;
+
+  /// Implements the ColumnReader::getColumn() contract
+  void getColumn(std::size_t index, std::vector<int64_t>& values) override;
+
+  /// Implements the ColumnReader::getColumn() contract
+  void getColumn(std::size_t index, std::vector<float>& values) override;
+
+  /// Implements the ColumnReader::getColumn() contract
+  void getColumn(std::size_t index, std::vector<double>& values) override;
+
+  /// Implements the ColumnReader::getColumn() contract
+  void getColumn(std::size_t index, std::vector<std::string>& values) override;
   
 protected:
 
@@ -227,12 +412,41 @@ private:
   
   void readColumnInfo();
   
+  const AsciiRowIndex& rowIndex();
+  
+  void seekRow(std::size_t row);
+  
+  void skipLines(long rows);
+
+  Table readFiltered(long rows);
+
+  std::unique_ptr<Table> scanFiltered(long rows, bool first_match);
+
+  bool isNullToken(const std::string& token, std::type_index type) const;
+
+  Row::cell_type convertCell(const std::string& token, std::size_t column, bool& is_null) const;
+
+  template <typename T>
+  void convertColumn(std::size_t index, std::vector<T>& values);
+  
   std::unique_ptr<InstOrRefHolder<std::istream>> m_stream_holder;
+  std::streampos m_stream_start;
   bool m_reading_started = false;
   std::string m_comment = "#";
+  std::vector<std::string> m_null_tokens {};
   std::vector<std::type_index> m_column_types {};
   std::vector<std::string> m_column_names {};
+  std::size_t m_inference_rows = 0;
   std::shared_ptr<ColumnInfo> m_column_info;
+  std::size_t m_current_row = 0;
+  std::size_t m_row_index_sampling = 0;
+  std::shared_ptr<AsciiRowIndex> m_row_index;
+  std::unique_ptr<Filter> m_filter {};
+  // The rows passing the filter found by hasMoreRows(), or scanned with more
+  // rows than requested, and not read yet
+  std::unique_ptr<Table> m_filtered_ahead {};
+  // The cells of the rows of the last readColumns() call, one line per row
+  std::vector<std::vector<std::string>> m_column_tokens {};
 
 }; /* End of AsciiReader class */
 
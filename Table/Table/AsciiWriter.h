@@ -76,6 +76,12 @@ namespace Table {
  * would result to longer columns, this is applied from that moment on. All the
  * values are right aligned.
  *
+ * Calculating the column sizes requires formatting all the values twice. When
+ * writing big tables this can be avoided by fixing the sizes of the columns
+ * with the setColumnWidths() method, by declaring the widths of the columns in
+ * their ColumnDescription, or by separating the values with a string instead
+ * of aligning them, by using the setColumnSeparator() method.
+ *
  */
 class AsciiWriter : public TableWriter {
 
@@ -113,7 +119,8 @@ public:
   AsciiWriter(std::ostream& stream);
   
   /// Constructs an AsciiWriter which writes to the given file (overrides if
-  /// it already exists)
+  /// it already exists). If the filename ends with .gz, .bz2 or .zst the
+  /// output is compressed with the corresponding format.
   AsciiWriter(const std::string& filename);
   
   AsciiWriter(AsciiWriter&&) = default;
@@ -153,6 +160,43 @@ public:
    */
   AsciiWriter& showColumnInfo(bool show);
 
+  /**
+   * @brief Fixes the sizes in characters of the columns
+   * @details
+   * The values are right aligned to the given sizes, without calculating the
+   * size of the longest entry of each column. Note that the sizes include the
+   * space separating the columns. Values which do not fit in their column size
+   * are written preceded by a single space, so the columns are always
+   * separated (but not aligned). Calling this method disables the
+   * column separator set by setColumnSeparator().
+   * @param widths
+   *    The sizes of the columns, or empty for the automatic calculation
+   * @return
+   *    A reference to the AsciiWriter instance
+   * @throws Elements::Exception
+   *    if writing of data has already started
+   * @throws Elements::Exception
+   *    if any of the sizes is zero
+   */
+  AsciiWriter& setColumnWidths(std::vector<std::size_t> widths);
+
+  /**
+   * @brief Separates the columns with the given string instead of aligning them
+   * @details
+   * The values (and the column names) are written one after the other,
+   * separated by the given string. Note that the AsciiReader can read the
+   * produced tables only if the separator consists of whitespace characters
+   * (for example a tab). Calling this method disables the column sizes set by
+   * setColumnWidths().
+   * @param separator
+   *    The separator of the columns, or empty to align the columns
+   * @return
+   *    A reference to the AsciiWriter instance
+   * @throws Elements::Exception
+   *    if writing of data has already started
+   */
+  AsciiWriter& setColumnSeparator(const std::string& separator);
+
   /**
    * @brief Adds a comment to the stream
    * @details
@@ -186,6 +230,9 @@ private:
   std::string m_comment = "#";
   bool m_show_column_info = true;
   std::vector<size_t> m_column_lengths;
+  std::vector<size_t> m_column_widths {};
+  std::string m_separator {};
+  std::string m_buffer {};
 
 }; // End of AsciiWriter class
 
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file Table/BinaryColumnarReader.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef _TABLE_BINARYCOLUMNARREADER_H
+#define _TABLE_BINARYCOLUMNARREADER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Table/TableReader.h"
+
+namespace Euclid {
+namespace Table {
+
+struct BinaryColumnarFooter;
+
+/**
+ * @class BinaryColumnarReader
+ *
+ * @brief TableReader implementation for reading tables in the native binary
+ * columnar format
+ *
+ * @details
+ * The file is memory mapped and only its footer is parsed when the reader is
+ * constructed, so opening a file costs the same regardless of its size. The
+ * data of the columns are accessed only when they are read, which means that
+ * reading a few columns of a big file (see selectColumns()) touches only the
+ * pages of these columns.
+ *
+ * The numeric scalar columns can also be accessed without any copy, by using
+ * the mapColumn() method.
+ *
+ * For the description of the format see the BinaryColumnarWriter.
+ */
+class BinaryColumnarReader : public TableReader {
+
+public:
+
+  /// A contiguous part of a column, pointing directly in the mapped file
+  template <typename T>
+  struct ColumnChunk {
+    const T* data;
+    std::size_t size;
+  };
+
+  /**
+   * @brief Creates a BinaryColumnarReader for the given file
+   * @param filename
+   *    The file to read the table from
+   * @throws Elements::Exception
+   *    if the file cannot be mapped or if it is not a binary columnar file
+   */
+  BinaryColumnarReader(const std::string& filename);
+
+  BinaryColumnarReader(BinaryColumnarReader&&) = default;
+  BinaryColumnarReader& operator=(BinaryColumnarReader&&) = default;
+
+  BinaryColumnarReader(const BinaryColumnarReader&) = delete;
+  BinaryColumnarReader& operator=(const BinaryColumnarReader&) = delete;
+
+  /// Destructor
+  virtual ~BinaryColumnarReader();
+
+  /**
+   * @brief Restricts the reading to the given columns
+   * @details
+   * The returned tables contain only the given columns, in the given order.
+   * The data of the other columns are never accessed.
+   * @param column_names
+   *    The names of the columns to read
+   * @return
+   *    A reference to the BinaryColumnarReader instance
+   * @throws Elements::Exception
+   *    if the list is empty or any of the columns does not exist
+   * @throws Elements::Exception
+   *    if the BinaryColumnarReader instance has already been used for reading
+   */
+  BinaryColumnarReader& selectColumns(const std::vector<std::string>& column_names);
+
+  /**
+   * @brief Returns the data of a column as they are stored in the file
+   * @details
+   * The column must have the type T, which can be int32_t, int64_t, float or
+   * double. There is one chunk for each call of BinaryColumnarWriter::addData()
+   * used for writing the file. The returned pointers are valid for the
+   * lifetime of the reader. This method does not affect the rows read by the
+   * read() method.
+   * @param column_name
+   *    The name of the column
+   * @return
+   *    The chunks of the column data
+   * @throws Elements::Exception
+   *    if the column does not exist or has a different type than T
+   */
+  template <typename T>
+  std::vector<ColumnChunk<T>> mapColumn(const std::string& column_name) const;
+
+  /// Returns the description of the (selected) columns of the table
+  const ColumnInfo& getInfo() override;
+
+  /// Returns the comment of the table
+  std::string getComment() override;
+
+  /// Implements the TableReader::skip() contract
+  void skip(long rows) override;
+
+  /// Implements the TableReader::hasMoreRows() contract
+  bool hasMoreRows() override;
+
+  /// Implements the TableReader::rowsLeft() contract
+  std::size_t rowsLeft() override;
+
+protected:
+
+  /// Implements the TableReader::readImpl() contract
+  Table readImpl(long rows) override;
+
+private:
+
+  std::size_t columnIndex(const std::string& column_name) const;
+
+  std::string m_filename;
+  // The mapped file is kept behind a pointer, so the header does not depend on
+  // the boost iostreams library
+  std::shared_ptr<const void> m_file;
+  const char* m_data = nullptr;
+  std::unique_ptr<BinaryColumnarFooter> m_footer;
+  std::vector<std::size_t> m_columns {};
+  std::shared_ptr<ColumnInfo> m_column_info {};
+  std::size_t m_total_rows = 0;
+  std::size_t m_current_row = 0;
+  bool m_reading_started = false;
+
+}; /* End of BinaryColumnarReader class */
+
+} /* namespace Table */
+} /* namespace Euclid */
+
+#endif
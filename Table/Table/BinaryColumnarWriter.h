@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file Table/BinaryColumnarWriter.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef _TABLE_BINARYCOLUMNARWRITER_H
+#define _TABLE_BINARYCOLUMNARWRITER_H
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include "Table/TableWriter.h"
+
+namespace Euclid {
+namespace Table {
+
+struct BinaryColumnarFooter;
+
+/**
+ * @class BinaryColumnarWriter
+ *
+ * @brief TableWriter implementation for writing tables in the native binary
+ * columnar format
+ *
+ * @details
+ * The binary columnar format stores the data of each column in typed arrays,
+ * aligned to 8 bytes, so they can be accessed directly from a memory mapped
+ * file (see BinaryColumnarReader). The description of the columns and the
+ * locations of their data are stored in a footer at the end of the file.
+ *
+ * Each call of addData() appends a row group to the file, containing the data
+ * of the given table. The footer is written once, by the close() method or the
+ * destructor, so a new file is a valid table only after it is closed. The row
+ * groups appended to an existing file, or after close(), are written after its
+ * footer, which is left in place as unused bytes, so the file keeps its
+ * previous valid table until it is closed again. Because every row group adds
+ * to the size of the footer, it is recommended to add the data in big tables.
+ *
+ * All the column types of the Row::cell_type are supported. The data are stored
+ * in the byte order of the machine, so the files cannot be read by machines
+ * with a different byte order.
+ */
+class BinaryColumnarWriter : public TableWriter {
+
+public:
+
+  /**
+   * @brief Creates a BinaryColumnarWriter that writes to a specific file
+   *
+   * @details
+   * If the override_flag is set to true, any pre-existing file will be
+   * replaced. If this flag is set to false and the file exists, its table is
+   * appended, in which case the first table given to addData() must have the
+   * same columns.
+   *
+   * The file is opened during the first call of addData() and it is kept open
+   * until the close() method is called or the BinaryColumnarWriter is
+   * destroyed. If addData() is called after close(), the file is opened again
+   * and the new row groups are appended.
+   *
+   * @param filename
+   *    The path of the file to store the table
+   * @param override_flag
+   *    When true, any existing file will be overridden
+   */
+  BinaryColumnarWriter(const std::string& filename, bool override_flag=false);
+
+  BinaryColumnarWriter(BinaryColumnarWriter&&) = default;
+  BinaryColumnarWriter& operator=(BinaryColumnarWriter&&) = default;
+
+  BinaryColumnarWriter(const BinaryColumnarWriter&) = delete;
+  BinaryColumnarWriter& operator=(const BinaryColumnarWriter&) = delete;
+
+  /**
+   * @brief Destructor
+   * @details
+   * The footer is written if close() was not called. Errors are logged, as
+   * they cannot be thrown from a destructor, so call close() explicitly to
+   * detect them.
+   */
+  virtual ~BinaryColumnarWriter();
+
+  /**
+   * @brief Adds a comment to the table
+   * @details
+   * The comments are stored in the footer, so they can be added at any time
+   * and they are written by the next close().
+   * Multiple comments are separated by new line characters.
+   */
+  void addComment(const std::string& comment) override;
+
+  /**
+   * @brief Writes the footer and closes the file
+   * @throws Elements::Exception
+   *    if writing the footer fails
+   */
+  void close();
+
+protected:
+
+  /// Creates the file or reads the footer of the existing one
+  void init(const Table& table) override;
+
+  /// Writes the table as a new row group and updates the footer
+  void append(const Table& table) override;
+
+private:
+
+  void openStream();
+
+  void writeFooter();
+
+  std::string m_filename;
+  bool m_override_file;
+  std::fstream m_stream {};
+  std::unique_ptr<BinaryColumnarFooter> m_footer;
+  // The end of the file, where the next row group or footer is written
+  std::uint64_t m_data_end = 0;
+  bool m_footer_changed = false;
+
+}; /* End of BinaryColumnarWriter class */
+
+} /* namespace Table */
+} /* namespace Euclid */
+
+#endif
@@ -29,7 +29,10 @@
 #include <typeindex>
 #include <iomanip>
 #include <functional>
+#include <memory>
 #include <ostream>
+#include <vector>
+#include "Table/StringDictionary.h"
 
 namespace Euclid {
 namespace Table {
@@ -45,12 +48,25 @@ namespace Table {
  * - type : The type of its data
  * - unit : The unit in which the data are expressed
  * - description : A string describing the column
+ * - dictionary : For dictionary encoded string columns, the values of the
+ *   int32_t codes stored in the cells (see StringDictionary), or null
+ * - width : The maximum number of characters of the values when they are
+ *   written as text (the maximum length of string values), or 0 if unknown
+ * - shape : The shape of the values of vector and NdArray columns, which must
+ *   be the same for all the rows, or empty if unknown
+ *
+ * The width and the shape form the declared schema of the column. When they
+ * are set the writers use them for the column formats, instead of scanning
+ * the values of the first rows, so all the chunks of a table streamed in
+ * many addData() calls are written with the same, correct formats. They are
+ * not set by the constructor, but by assigning the public members.
  * 
  * The access to the above is done by directly accessing the public members of
  * the ColumnDescription class.
  * 
  * The ColumnDescription implements the comparison operators by checking only 
- * the name, type and unit and by ignoring the description text.
+ * the name, type, unit and dictionary values and by ignoring the description
+ * text and the declared schema.
  */
 class ColumnDescription {
 
@@ -59,8 +75,11 @@ public:
   /// Constructs a new ColumnDescription instance
   /// @throws Elements::Exception
   ///     if the name is the empty string or if it contains whitespaces
+  /// @throws Elements::Exception
+  ///     if a dictionary is given and the type is not int32_t
   ColumnDescription(std::string name, std::type_index type=typeid(std::string),
-                    std::string unit="", std::string description="");
+                    std::string unit="", std::string description="",
+                    std::shared_ptr<const StringDictionary> dictionary=nullptr);
 
   ColumnDescription(const ColumnDescription&) = default;
   ColumnDescription(ColumnDescription&&) = default;
@@ -76,13 +95,18 @@ public:
   /// Returns true if the two ColumnDescriptions describe the same column 
   /// (ignoring the description text)
   bool operator==(const ColumnDescription& other) const {
-    return name == other.name && type == other.type && unit == other.unit;
+    return name == other.name && type == other.type && unit == other.unit
+           && (dictionary == other.dictionary
+               || (dictionary != nullptr && other.dictionary != nullptr && *dictionary == *other.dictionary));
   }
 
   std::string name;
   std::type_index type;
   std::string unit;
   std::string description;
+  std::shared_ptr<const StringDictionary> dictionary;
+  std::size_t width = 0;
+  std::vector<std::size_t> shape {};
 
 }; /* End of ColumnDescription class */
 
@@ -25,11 +25,14 @@
 #ifndef TABLE_COLUMNINFO_H
 #define	TABLE_COLUMNINFO_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
 #include <typeindex>
+#include <unordered_map>
 #include <utility>
+#include <boost/optional.hpp>
 
 #include "ElementsKernel/Export.h"
 
@@ -48,6 +51,11 @@ namespace Table {
  * columns of a Table. This class can be used for retrieving the
  * ColumnDescription of a column using its index (zero based) and for searching
  * a column with a specific name. The names of the columns must by unique.
+ *
+ * The names are indexed in a hash map, so searching a column by name does not
+ * depend on the number of columns. Callers accessing the same column of many
+ * rows can resolve it once to a ColumnInfo::Handle, which gives access to the
+ * cells with the cost of an access by index.
  */
 class ELEMENTS_API ColumnInfo {
 
@@ -55,6 +63,50 @@ public:
 
   using info_type = ColumnDescription;
 
+  /**
+   * @class Handle
+   * @brief A column resolved by its name, which can be used for accessing the
+   * cells of rows without searching the name again
+   * @details
+   * Handles are created with the ColumnInfo::getHandle() method. When used with
+   * rows of the ColumnInfo the handle was created from, or of a copy of it
+   * (which is always the case for rows of the same table), the access costs
+   * the same as an access by index, without comparing any names. Otherwise the
+   * column is searched again by name.
+   */
+  class Handle {
+  public:
+    /// Returns the index of the column in the ColumnInfo it was created from
+    std::size_t index() const {
+      return m_index;
+    }
+    /// Returns the name of the column
+    const std::string& name() const {
+      return m_name;
+    }
+  private:
+    friend class ColumnInfo;
+    Handle(std::uint64_t info_id, std::size_t index, std::string name)
+            : m_info_id(info_id), m_index(index), m_name(std::move(name)) {
+    }
+    std::uint64_t m_info_id;
+    std::size_t m_index;
+    std::string m_name;
+  };
+
+  /**
+   * @brief Describes where the cell of a column is stored in a CompactRow
+   * @details
+   * The cells of the bool, int32_t, int64_t, float and double columns are
+   * stored inline, in the contiguous buffer of the CompactRow, at the given
+   * byte offset. All other cells (strings, vectors and NdArrays) are stored
+   * out of line and the position is their index in the out of line cells.
+   */
+  struct CellLayout {
+    bool is_inline;
+    std::size_t position;
+  };
+
   /**
    * @brief
    * Constructs a ColumnInfo representing the given column names and types
@@ -126,8 +178,79 @@ public:
    */
   std::unique_ptr<std::size_t> find(const std::string& name) const;
 
+  /**
+   * @brief
+   * Returns the index of a column, given the name of it, or an empty optional if
+   * there is no column with this name
+   * @details
+   * In contrary with the find() method, this method does not allocate memory.
+   *
+   * @param name The name to search for
+   * @return The index of the column or an empty optional if there is no such column
+   */
+  boost::optional<std::size_t> findIndex(const std::string& name) const;
+
+  /**
+   * @brief
+   * Returns a Handle of the column with the given name
+   * @param name The name of the column
+   * @return The handle of the column
+   * @throws Elements::Exception
+   *    if there is no column with the given name
+   */
+  Handle getHandle(const std::string& name) const;
+
+  /**
+   * @brief
+   * Returns the index of the column represented by the given handle
+   * @details
+   * If the handle was created from this ColumnInfo or a copy of it, no search
+   * is done. Otherwise the column is at the index stored in the handle only
+   * if it has the name of the handle, or it is searched by name.
+   *
+   * @param handle The handle of the column
+   * @return The index of the column or an empty optional if there is no such column
+   */
+  boost::optional<std::size_t> findIndex(const Handle& handle) const;
+
+  /**
+   * @brief
+   * Returns the layout of the cell of a column in a CompactRow
+   *
+   * @param index The index of the column
+   * @return The layout of the cell
+   */
+  const CellLayout& getCellLayout(std::size_t index) const {
+    return m_cell_layouts[index];
+  }
+
+  /**
+   * @brief
+   * Returns the size in bytes of the inline buffer of a CompactRow
+   */
+  std::size_t getInlineSize() const {
+    return m_inline_size;
+  }
+
+  /**
+   * @brief
+   * Returns the number of cells a CompactRow stores out of line
+   */
+  std::size_t getOutOfLineSize() const {
+    return m_out_of_line_size;
+  }
+
 private:
+  void computeCellLayouts();
+
   std::vector<info_type> m_info_list;
+  std::unordered_map<std::string, std::size_t> m_name_index {};
+  std::vector<CellLayout> m_cell_layouts {};
+  std::size_t m_inline_size = 0;
+  std::size_t m_out_of_line_size = 0;
+  /// Identifies the columns for the handles, it is unique for every
+  /// constructed ColumnInfo and it is shared only by its copies
+  std::uint64_t m_id;
 
 };
 
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file Table/ColumnReader.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef _TABLE_COLUMNREADER_H
+#define _TABLE_COLUMNREADER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Table/ColumnInfo.h"
+
+namespace Euclid {
+namespace Table {
+
+/**
+ * @class ColumnReader
+ *
+ * @brief Interface of the readers which can return the values of the scalar
+ * columns as typed arrays
+ *
+ * @details
+ * The rows are read in chunks with the readColumns() method, and the values of
+ * the columns of the chunk are then retrieved with the getColumn() methods,
+ * converted to the type of the given vector. This way the data are decoded
+ * from the file directly to their final type, without creating Row objects
+ * and without going through the Row::cell_type variant. The readers
+ * implementing it (FitsReader and AsciiReader) share the position of the
+ * stream with their TableReader interface, so the two interfaces can be mixed.
+ *
+ * Numeric columns can be retrieved as any numeric type and string columns
+ * only as strings. Checking that the conversion does not lose information is
+ * left to the caller (see TypedTableReader).
+ */
+class ColumnReader {
+
+public:
+
+  virtual ~ColumnReader() = default;
+
+  /// Returns the column information of the table
+  virtual const ColumnInfo& getInfo() = 0;
+
+  /**
+   * @brief Reads the next rows, for retrieving their values with getColumn()
+   * @param rows
+   *    The maximum number of rows to read, or -1 for all the remaining rows
+   * @return
+   *    The number of rows read, which is zero if no rows were left
+   */
+  virtual std::size_t readColumns(long rows) = 0;
+
+  /// Returns true if there are rows left to read
+  virtual bool hasMoreRows() = 0;
+
+  /**
+   * @brief Returns the values of a column for the rows of the last
+   * readColumns() call
+   * @param index
+   *    The index of the column (zero based)
+   * @param values
+   *    The vector to store the values, which is resized to the number of rows
+   * @throws Elements::Exception
+   *    if the column is not a scalar column, or if it is a string column and
+   *    the values are numeric or vice versa
+   * @throws Elements::Exception
+   *    if the values cannot be converted
+   */
+  virtual void getColumn(std::size_t index, std::vector<bool>& values) = 0;
+
+  /// @copydoc getColumn(std::size_t, std::vector<bool>&)
+  virtual void getColumn(std::size_t index, std::vector<int32_t>& values) = 0;
+
+  /// @copydoc getColumn(std::size_t, std::vector<bool>&)
+  virtual void getColumn(std::size_t index, std::vector<int64_t>& values) = 0;
+
+  /// @copydoc getColumn(std::size_t, std::vector<bool>&)
+  virtual void getColumn(std::size_t index, std::vector<float>& values) = 0;
+
+  /// @copydoc getColumn(std::size_t, std::vector<bool>&)
+  virtual void getColumn(std::size_t index, std::vector<double>& values) = 0;
+
+  /// @copydoc getColumn(std::size_t, std::vector<bool>&)
+  virtual void getColumn(std::size_t index, std::vector<std::string>& values) = 0;
+
+}; /* End of ColumnReader class */
+
+} /* namespace Table */
+} /* namespace Euclid */
+
+#endif
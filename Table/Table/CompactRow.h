@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file Table/CompactRow.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef TABLE_COMPACTROW_H
+#define TABLE_COMPACTROW_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "ElementsKernel/Export.h"
+#include "Table/ColumnInfo.h"
+#include "Table/Row.h"
+
+namespace Euclid {
+namespace Table {
+
+/**
+ * @class CompactRow
+ *
+ * @brief Memory efficient representation of a table row
+ *
+ * @details
+ * The CompactRow stores the bool, int32_t, int64_t, float and double cells in
+ * a single contiguous buffer, at the offsets precomputed by the ColumnInfo
+ * (see ColumnInfo::getCellLayout()). Only the strings, vectors and NdArrays are
+ * stored out of line, as Row::cell_type values.
+ *
+ * In contrary with the Row, the CompactRow does not share the ownership of its
+ * ColumnInfo, so copying it does not modify any reference counter. The caller
+ * must make sure the ColumnInfo outlives the rows using it.
+ *
+ * The cells can be accessed either as Row::cell_type values, for compatibility
+ * with the Row, or with the typed get() method, which returns a reference to
+ * the stored value. A moved from CompactRow can only be assigned, copied or
+ * destroyed.
+ */
+class ELEMENTS_API CompactRow {
+
+public:
+
+  /**
+   * @brief Constructs a CompactRow with the given cell values
+   * @param values The values of the cells
+   * @param column_info The description of the columns, which must outlive the row
+   * @throws Elements::Exception
+   *    if the values have different size or types than the columns
+   */
+  CompactRow(const std::vector<Row::cell_type>& values, const ColumnInfo& column_info);
+
+  /**
+   * @brief Constructs a CompactRow with the values of the given Row
+   * @details
+   * The new row refers to the ColumnInfo of the given row, so the caller must
+   * keep a reference to it for as long as the CompactRow is used.
+   */
+  explicit CompactRow(const Row& row);
+
+  CompactRow(const CompactRow& other);
+  CompactRow& operator=(const CompactRow& other);
+  CompactRow(CompactRow&&) = default;
+  CompactRow& operator=(CompactRow&&) = default;
+
+  /// Destructor
+  ~CompactRow() = default;
+
+  /// Returns the description of the columns of the row
+  const ColumnInfo& getColumnInfo() const {
+    return *m_column_info;
+  }
+
+  /// Returns the number of cells of the row
+  std::size_t size() const {
+    return m_column_info->size();
+  }
+
+  /**
+   * @brief Returns the value of a cell as a Row::cell_type
+   * @param index The index of the column (zero based)
+   * @return A copy of the cell value
+   * @throws Elements::Exception
+   *    if the index is out of range
+   */
+  Row::cell_type operator[](std::size_t index) const;
+
+  /**
+   * @brief Returns a reference to the value of a cell
+   * @details
+   * The template parameter must be the type of the column.
+   * @param index The index of the column (zero based)
+   * @return A reference to the cell value, valid for the lifetime of the row
+   * @throws Elements::Exception
+   *    if the index is out of range or the column has a different type
+   */
+  template <typename T>
+  const T& get(std::size_t index) const;
+
+  /**
+   * @brief Converts the CompactRow to a Row
+   * @param column_info
+   *    The ColumnInfo of the new row, which must describe the same columns
+   *    with the ColumnInfo of the CompactRow
+   * @throws Elements::Exception
+   *    if the column_info describes different columns
+   */
+  Row toRow(std::shared_ptr<ColumnInfo> column_info) const;
+
+private:
+
+  void checkType(std::size_t index, std::type_index type) const;
+
+  template <typename T>
+  void setInline(std::size_t position, const Row::cell_type& value);
+
+  const ColumnInfo* m_column_info;
+  // The inline buffer is allocated in 64 bit words, so all the cells are
+  // correctly aligned
+  std::unique_ptr<std::uint64_t[]> m_inline;
+  std::vector<Row::cell_type> m_out_of_line;
+
+}; /* End of CompactRow class */
+
+} /* namespace Table */
+} /* namespace Euclid */
+
+#include "Table/_impl/CompactRow.icpp"
+
+#endif
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file Table/CompressedStream.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef _TABLE_COMPRESSEDSTREAM_H
+#define _TABLE_COMPRESSEDSTREAM_H
+
+#include <istream>
+#include <ostream>
+#include <memory>
+#include <string>
+
+namespace Euclid {
+namespace Table {
+
+/// The compression formats supported by the CompressedIStream and CompressedOStream
+enum class Compression {
+  /// Not compressed data
+  NONE,
+  /// gzip (RFC 1952) format
+  GZIP,
+  /// bzip2 format
+  BZIP2,
+  /// Zstandard format
+  ZSTD
+};
+
+/**
+ * @brief Detects the compression of a file by its magic bytes
+ * @param filename
+ *    The file to check
+ * @return
+ *    The compression of the file, or Compression::NONE if the file does not
+ *    start with any of the known magic numbers
+ * @throws Elements::Exception
+ *    if the file cannot be opened
+ */
+Compression detectCompression(const std::string& filename);
+
+/**
+ * @brief Returns the compression implied by the extension of a filename
+ * @details
+ * The recognized extensions are .gz, .bz2 and .zst. For any other extension
+ * Compression::NONE is returned.
+ */
+Compression compressionFromExtension(const std::string& filename);
+
+/**
+ * @class CompressedIStream
+ *
+ * @brief Input stream which decompresses a file while it is being read
+ *
+ * @details
+ * The compression format is detected by the magic bytes of the file. The data
+ * are decompressed in chunks, so the full decompressed file is never kept in
+ * memory.
+ *
+ * The stream supports seeking, which is required by the AsciiReader for
+ * detecting the column information. Seeking forward is implemented by
+ * decompressing the data in between, and seeking backwards within the last
+ * decompressed chunk is free. Seeking further back restarts the decompression
+ * from the beginning of the file, so it should be avoided for big files.
+ *
+ * If the decompress_in_thread flag is set, the decompression is performed by a
+ * helper thread, which prepares the next chunks while the previous ones are
+ * being parsed.
+ */
+class CompressedIStream : public std::istream {
+
+public:
+
+  /**
+   * @brief Constructs a stream reading the given (possibly compressed) file
+   * @param filename
+   *    The file to read
+   * @param decompress_in_thread
+   *    If true the decompression is done by a helper thread
+   * @throws Elements::Exception
+   *    if the file cannot be opened
+   */
+  CompressedIStream(const std::string& filename, bool decompress_in_thread=false);
+
+  CompressedIStream(const CompressedIStream&) = delete;
+  CompressedIStream& operator=(const CompressedIStream&) = delete;
+
+  /// Destructor
+  virtual ~CompressedIStream();
+
+private:
+
+  std::unique_ptr<std::streambuf> m_buffer;
+
+}; /* End of CompressedIStream class */
+
+/**
+ * @class CompressedOStream
+ *
+ * @brief Output stream which compresses the data written to a file
+ *
+ * @details
+ * The compression is finalized when the stream is destroyed.
+ */
+class CompressedOStream : public std::ostream {
+
+public:
+
+  /**
+   * @brief Constructs a stream writing to the given file
+   * @param filename
+   *    The file to write (overridden if it already exists)
+   * @param compression
+   *    The compression to apply on the data
+   * @throws Elements::Exception
+   *    if the file cannot be opened
+   */
+  CompressedOStream(const std::string& filename, Compression compression);
+
+  CompressedOStream(const CompressedOStream&) = delete;
+  CompressedOStream& operator=(const CompressedOStream&) = delete;
+
+  /// Flushes and finalizes the compressed data
+  virtual ~CompressedOStream();
+
+private:
+
+  std::unique_ptr<std::streambuf> m_buffer;
+
+}; /* End of CompressedOStream class */
+
+} /* namespace Table */
+} /* namespace Euclid */
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file Table/DictionaryEncoding.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef _TABLE_DICTIONARYENCODING_H
+#define _TABLE_DICTIONARYENCODING_H
+
+#include "ElementsKernel/Export.h"
+#include "Table/Table.h"
+
+namespace Euclid {
+namespace Table {
+
+/**
+ * @brief Dictionary encodes the low cardinality string columns of a table
+ * @details
+ * Each string column with at most max_cardinality distinct values is replaced
+ * by an int32_t column with the codes of the values, which shares a single
+ * StringDictionary via its ColumnDescription. The rest of the columns are
+ * copied unchanged.
+ * @param table
+ *    The table to encode
+ * @param max_cardinality
+ *    The maximum number of distinct values of the encoded columns
+ * @return
+ *    The encoded table
+ */
+ELEMENTS_API Table encodeDictionaryColumns(const Table& table, std::size_t max_cardinality);
+
+/**
+ * @brief Replaces the dictionary encoded columns of a table with string columns
+ * @details
+ * This is the inverse of encodeDictionaryColumns(). It is used by the
+ * TableWriter implementations, so the dictionary encoded columns are always
+ * written as string columns.
+ * @param table
+ *    The table to decode
+ * @return
+ *    The table with the decoded values
+ * @throws Elements::Exception
+ *    if a cell contains a code which is not in the dictionary of its column
+ */
+ELEMENTS_API Table decodeDictionaryColumns(const Table& table);
+
+/// Returns true if any of the columns is dictionary encoded
+ELEMENTS_API bool hasDictionaryColumns(const ColumnInfo& column_info);
+
+} /* namespace Table */
+} /* namespace Euclid */
+
+#endif
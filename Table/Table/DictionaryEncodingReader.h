@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file Table/DictionaryEncodingReader.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef _TABLE_DICTIONARYENCODINGREADER_H
+#define _TABLE_DICTIONARYENCODINGREADER_H
+
+#include <map>
+#include <memory>
+#include "Table/TableReader.h"
+
+namespace Euclid {
+namespace Table {
+
+class DictionaryEncoder;
+
+/**
+ * @class DictionaryEncodingReader
+ *
+ * @brief TableReader decorator dictionary encoding the low cardinality string
+ * columns
+ *
+ * @details
+ * The string columns which have at most a given number of distinct values in
+ * the first rows read are returned as dictionary encoded columns (see
+ * StringDictionary), so their cells are int32_t codes instead of strings.
+ * The same columns are encoded in all the following reads, with codes which
+ * stay the same for the whole table: the values met for the first time are
+ * appended to the dictionary, so the tables of later reads might have a
+ * bigger dictionary (and thus a different ColumnInfo) than the previous ones.
+ * Consecutive tables which do not introduce new values share their
+ * ColumnInfo.
+ *
+ * The getInfo() method returns the column information of the wrapped reader,
+ * which describes the encoded columns as string columns. The rest of the
+ * calls are forwarded to the wrapped reader, which must not be used by anyone
+ * else after it has been given to the DictionaryEncodingReader.
+ */
+class DictionaryEncodingReader : public TableReader {
+
+public:
+
+  /**
+   * @brief Constructs a DictionaryEncodingReader
+   * @param reader
+   *    The reader to read the rows from
+   * @param max_cardinality
+   *    The maximum number of distinct values a string column can have in the
+   *    first rows read, for being encoded
+   * @throws Elements::Exception
+   *    if the reader is null
+   */
+  DictionaryEncodingReader(std::unique_ptr<TableReader> reader, std::size_t max_cardinality);
+
+  DictionaryEncodingReader(DictionaryEncodingReader&&);
+  DictionaryEncodingReader& operator=(DictionaryEncodingReader&&);
+
+  /// Destructor
+  virtual ~DictionaryEncodingReader();
+
+  /// Returns the comment of the wrapped reader
+  std::string getComment() override;
+
+  /// Returns the column information of the wrapped reader
+  const ColumnInfo& getInfo() override;
+
+  /// Implements the TableReader::skip() contract
+  void skip(long rows) override;
+
+  /// Implements the TableReader::hasMoreRows() contract
+  bool hasMoreRows() override;
+
+  /// Implements the TableReader::rowsLeft() contract
+  std::size_t rowsLeft() override;
+
+protected:
+
+  /// Implements the TableReader::readImpl() contract
+  Table readImpl(long rows) override;
+
+private:
+
+  std::unique_ptr<TableReader> m_reader;
+  std::size_t m_max_cardinality;
+  // The encoders of the encoded columns, by column index, selected by the
+  // first read
+  std::unique_ptr<std::map<std::size_t, DictionaryEncoder>> m_encoders {};
+  // The ColumnInfo of the last table read
+  std::shared_ptr<ColumnInfo> m_column_info {};
+
+}; /* End of DictionaryEncodingReader class */
+
+} /* namespace Table */
+} /* namespace Euclid */
+
+#endif
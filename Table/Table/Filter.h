@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file Table/Filter.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef _TABLE_FILTER_H
+#define _TABLE_FILTER_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/variant.hpp>
+#include "ElementsKernel/Export.h"
+#include "Table/StringDictionary.h"
+#include "Table/Table.h"
+#include "Table/ValidityBitmap.h"
+#include "Table/ZoneMap.h"
+
+namespace Euclid {
+namespace Table {
+
+/**
+ * @class Filter
+ *
+ * @brief A predicate selecting the rows of a table based on their values
+ *
+ * @details
+ * Filters are built from column comparisons and ranges, combined with the
+ * &&, || and ! operators. For example:
+ * @code
+ * auto filter = Filter::range("Z", 0.5, 1.) && !(Filter::compare("Flux", Filter::Operator::LESS, 1E-3)
+ *                                               || Filter::compare("Flag", Filter::Operator::EQUAL, 1));
+ * @endcode
+ *
+ * The filters are evaluated column-wise: each comparison is a tight loop over
+ * a typed array of the column values, producing a mask of the selected rows,
+ * which the compiler turns into vector instructions. The readers which
+ * support filtering (FitsReader and AsciiReader) use this to read only the
+ * filter columns of the rejected rows, without ever creating Row objects for
+ * them.
+ *
+ * Numeric comparisons can be applied on the bool, int32_t, int64_t, float and
+ * double columns (bool values are handled as 0 and 1). Integer literals are
+ * compared as int64_t values with the integer columns and floating point
+ * literals as double values. String literals can be compared
+ * (lexicographically) only with string columns. Comparisons involving NaN
+ * values are false, except for NOT_EQUAL. Comparisons involving values marked
+ * as missing by the validity bitmap of their column are always false. Note
+ * that the readers mark the NaN values as missing too, so with the filters
+ * pushed in the readers, or evaluated on the tables they read, the NaN
+ * values do not pass NOT_EQUAL either.
+ *
+ * Dictionary encoded string columns (see StringDictionary) are compared with
+ * string literals without decoding their cells: the equality comparisons
+ * compare the integer codes with the code of the literal, and the rest of the
+ * comparisons are evaluated once per dictionary value and the rows are
+ * selected by their codes.
+ */
+class ELEMENTS_API Filter {
+
+public:
+
+  /// The comparison operators
+  enum class Operator {
+    LESS, LESS_EQUAL, GREATER, GREATER_EQUAL, EQUAL, NOT_EQUAL
+  };
+
+  /// The literal values the columns are compared with
+  typedef boost::variant<int64_t, double, std::string> value_type;
+
+  /// The codes of a dictionary encoded column, together with their dictionary
+  struct DictionaryCodes {
+    std::vector<int32_t> codes;
+    std::shared_ptr<const StringDictionary> dictionary;
+  };
+
+  /// The values of a column, as used for evaluating the filters
+  typedef boost::variant<std::vector<int32_t>, std::vector<int64_t>, std::vector<float>,
+                         std::vector<double>, std::vector<std::string>, DictionaryCodes> column_values;
+
+  /// One element per row, with value 1 for the selected rows and 0 otherwise
+  typedef std::vector<std::uint8_t> mask_type;
+
+  /**
+   * @brief Creates a filter comparing a column with a value
+   * @param column
+   *    The name of the column
+   * @param op
+   *    The comparison operator, applied as "column op value"
+   * @param value
+   *    An integer, floating point or string value
+   */
+  template <typename T>
+  static Filter compare(const std::string& column, Operator op, const T& value);
+
+  /**
+   * @brief Creates a filter selecting the rows where min <= column <= max
+   * @details
+   * This is equivalent with combining two comparisons, but the column values
+   * are accessed only once.
+   */
+  template <typename T>
+  static Filter range(const std::string& column, const T& min, const T& max);
+
+  /// Returns a filter selecting the rows selected by both filters
+  Filter operator&&(const Filter& other) const;
+
+  /// Returns a filter selecting the rows selected by any of the filters
+  Filter operator||(const Filter& other) const;
+
+  /// Returns a filter selecting the rows not selected by this filter
+  Filter operator!() const;
+
+  /// Returns the names of the columns the filter uses, sorted and without duplicates
+  std::vector<std::string> getColumns() const;
+
+  /**
+   * @brief Evaluates the filter
+   * @param columns
+   *    The values of (at least) the columns returned by getColumns()
+   * @param rows
+   *    The number of rows, which must be the size of all the column values
+   * @param validity
+   *    The validity bitmaps of the columns with missing values, by column name
+   * @return
+   *    The mask of the selected rows
+   * @throws Elements::Exception
+   *    if any of the columns or bitmaps is missing or has the wrong size, or if
+   *    a column is compared with a value of incompatible type
+   */
+  mask_type evaluate(const std::map<std::string, column_values>& columns, std::size_t rows,
+                     const std::map<std::string, ValidityBitmap>& validity = {}) const;
+
+  /**
+   * @brief Evaluates the filter on the rows of a table
+   * @details
+   * The values of the filter columns are first copied in typed arrays, so the
+   * filter is evaluated the same way as when it is pushed in the readers. The
+   * validity bitmaps of the table are taken into account.
+   * @throws Elements::Exception
+   *    if the table does not have any of the columns or if its type is not
+   *    supported
+   */
+  mask_type evaluate(const Table& table) const;
+
+  /**
+   * @brief Checks if a block of rows can contain rows passing the filter
+   * @details
+   * The check is conservative: it returns false only when the statistics
+   * prove that none of the rows of the block passes the filter. Comparisons on
+   * columns without statistics, or with string values, are assumed to match.
+   * @param statistics
+   *    The statistics of the block, by column name
+   * @return
+   *    false if the block can be skipped
+   */
+  bool mayMatch(const std::map<std::string, ColumnStatistics>& statistics) const;
+
+  /**
+   * @brief Returns the column values of the given cells
+   * @details
+   * This method is meant to be used by the readers, for converting the values
+   * of the filter columns when they cannot be read directly as typed arrays.
+   * @param type
+   *    The type of the cells
+   * @param cells
+   *    The cells to convert
+   * @throws Elements::Exception
+   *    if the type is not a bool, int32_t, int64_t, float, double or string
+   */
+  static column_values toColumnValues(std::type_index type, const std::vector<Row::cell_type>& cells);
+
+  /// The nodes of the expression tree
+  struct Node;
+
+private:
+
+  explicit Filter(std::shared_ptr<const Node> root);
+
+  static Filter makeCompare(const std::string& column, Operator op, value_type value);
+
+  static Filter makeRange(const std::string& column, value_type min, value_type max);
+
+  std::shared_ptr<const Node> m_root;
+
+}; /* End of Filter class */
+
+} /* namespace Table */
+} /* namespace Euclid */
+
+#include "Table/_impl/Filter.icpp"
+
+#endif
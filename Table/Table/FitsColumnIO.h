@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file Table/FitsColumnIO.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef _TABLE_FITSCOLUMNIO_H
+#define _TABLE_FITSCOLUMNIO_H
+
+#include <string>
+#include <fitsio.h>
+
+namespace CCfits {
+class Column;
+}
+
+namespace Euclid {
+namespace Table {
+
+/**
+ * @brief Reads rows of a FITS table column directly into a contiguous buffer
+ *
+ * @details
+ * The data are read by cfitsio directly into the given buffer, without any of
+ * the intermediate containers CCfits uses. For columns with more than one
+ * element per row (vector columns) the elements of the rows are stored one
+ * after the other, so the buffer must have space for rows * column.repeat()
+ * values. The values are converted by cfitsio to the type T, which can be one
+ * of bool, int32_t, int64_t, float or double.
+ *
+ * @param column
+ *    The column to read from
+ * @param first_row
+ *    The first row to read (starting from 1, as in FITS)
+ * @param rows
+ *    The number of rows to read
+ * @param buffer
+ *    The buffer to store the data
+ * @throws Elements::Exception
+ *    if cfitsio fails to read the data
+ */
+template <typename T>
+void readColumnData(CCfits::Column& column, long first_row, long rows, T* buffer);
+
+/**
+ * @brief Reads rows of a FITS table column using the given cfitsio handle
+ *
+ * @details
+ * This is the same as the readColumnData() function above, but the data are
+ * read with the given handle, which must already be positioned at the HDU of
+ * the column, instead of the handle of the CCfits::FITS object. The column is
+ * used only for its metadata. Note that the handles created by
+ * fits_reopen_file() share the buffers and the current HDU of the file, so
+ * only handles opened separately with fits_open_file() can be used by
+ * different threads concurrently, if cfitsio is built reentrant.
+ * Additionally to the types supported by readColumnData(), T can be
+ * std::string, for reading string columns.
+ *
+ * @param file
+ *    The cfitsio handle to read with
+ * @param column
+ *    The column to read from
+ * @param first_row
+ *    The first row to read (starting from 1, as in FITS)
+ * @param rows
+ *    The number of rows to read
+ * @param buffer
+ *    The buffer to store the data
+ * @throws Elements::Exception
+ *    if cfitsio fails to read the data
+ */
+template <typename T>
+void readColumnData(fitsfile* file, const CCfits::Column& column, long first_row, long rows, T* buffer);
+
+/**
+ * @brief Writes rows of a FITS table column directly from a contiguous buffer
+ *
+ * @details
+ * This is the counterpart of the readColumnData() function. The buffer must
+ * contain rows * column.repeat() values, with the elements of each row stored
+ * one after the other. Rows after the end of the table are appended.
+ *
+ * @param column
+ *    The column to write to
+ * @param first_row
+ *    The first row to write (starting from 1, as in FITS)
+ * @param rows
+ *    The number of rows to write
+ * @param buffer
+ *    The buffer containing the data
+ * @throws Elements::Exception
+ *    if cfitsio fails to write the data
+ */
+template <typename T>
+void writeColumnData(CCfits::Column& column, long first_row, long rows, const T* buffer);
+
+} /* namespace Table */
+} /* namespace Euclid */
+
+#endif
@@ -26,7 +26,13 @@
 #define _TABLE_FITSREADER_H
 
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <CCfits/CCfits>
+#include <boost/optional.hpp>
+#include "AlexandriaKernel/ThreadPool.h"
+#include "Table/ColumnReader.h"
+#include "Table/Filter.h"
 #include "Table/TableReader.h"
 
 namespace Euclid {
@@ -71,8 +77,25 @@ namespace Table {
  * TUNITn keyword. The names of the columns can be overridden by using the
  * method  fixColumnNames().
  *
+ * Tile compressed binary tables (see FitsWriter::Format::COMPRESSED_BINARY)
+ * are read transparently. As cfitsio cannot read rows from a compressed table
+ * directly, the whole table is uncompressed in memory when reading starts,
+ * before the first rows are returned. Only the compressed data are read from
+ * the file, but the reader keeps the full uncompressed table in memory until
+ * it is destroyed, even when the rows are read in small chunks, so the memory
+ * cost grows with the size of the table.
+ *
+ * The values of the integer columns equal to the TNULLn keyword of a binary
+ * table and the NaN values of the floating point columns are marked as
+ * missing in the validity bitmaps of the returned tables (see
+ * Table::getValidity()).
+ *
+ * The reader also implements the ColumnReader interface, which reads the
+ * requested scalar columns directly into typed vectors, without creating Row
+ * objects (see TypedTableReader).
+ *
  */
-class FitsReader : public TableReader {
+class FitsReader : public TableReader, public ColumnReader {
 
 public:
   
@@ -125,6 +148,92 @@ public:
    */
   FitsReader& fixColumnNames(std::vector<std::string> column_names);
 
+  /**
+   * @brief Sets a thread pool for converting the columns data in parallel
+   * @details
+   * The data are always read from the file by the calling thread, but their
+   * conversion to the table cells is done by the tasks of the pool, one per
+   * column. The pool can be shared with other users, as the reader waits only
+   * for its own tasks. Setting a null pointer switches back to serial
+   * conversion.
+   * @param thread_pool
+   *    The pool to use or null
+   * @return
+   *    A reference to the FitsReader instance
+   */
+  FitsReader& setThreadPool(std::shared_ptr<ThreadPool> thread_pool);
+
+  /**
+   * @brief Sets a filter selecting the rows to read
+   * @details
+   * When a filter is set, read() returns the next rows which pass the filter.
+   * The rows are scanned in chunks: only the filter columns are read for the
+   * whole chunk, while the rest of the columns are read and converted to
+   * cells only for the selected rows, so the rejected rows never become Row
+   * objects. If the table has a zone map (see getZoneMap()), the blocks of
+   * rows which cannot contain any row passing the filter are not read at all.
+   *
+   * With a filter, hasMoreRows() scans ahead for the next row passing the
+   * filter (keeping the rows it finds for the next read()), so read() always
+   * succeeds when it returns true. The skip() method skips rows passing the
+   * filter. The rowsLeft() method returns an upper limit of the rows read()
+   * can still return: the rows already found by hasMoreRows() plus the rows
+   * of the HDU which have not been scanned yet.
+   * @param filter
+   *    The filter to apply
+   * @return
+   *    A reference to the FitsReader instance
+   * @throws Elements::Exception
+   *    if the FitsReader instance has already been used for reading
+   */
+  FitsReader& setFilter(Filter filter);
+
+  /**
+   * @brief Returns the zone map of the table
+   * @details
+   * The zone map is read from the HDU named by the ZONEMAP keyword of the
+   * table HDU, as written by the FitsWriter::setZoneMapBlockSize() method.
+   * The statistics use the column names of the reader, so they follow any
+   * names set with fixColumnNames(). For HDUs given to the constructor, the
+   * keyword is found only if the keywords of the HDU have been read.
+   * @return
+   *    The zone map, which is empty if the table does not have one
+   */
+  const ZoneMap& getZoneMap();
+
+  /**
+   * @brief Reads a range of rows of the table
+   * @details
+   * In contrast with read(), this method does not use or modify the current
+   * position of the reader, so the rows can be read in any order. It can be
+   * called concurrently by many threads sharing the same reader (and thus the
+   * already parsed HDU header), for example for reading partitions of the
+   * table in parallel. Each call reads the data with its own cfitsio handle
+   * of the file, opened with fits_open_file(), so it does not share any state
+   * with the other calls or with the handle used by read(). The data written
+   * to the file must therefore be flushed before the reading. Note that if
+   * cfitsio has not been built reentrant, all the reading from the files is
+   * serialized and only the conversion of the data to table cells is done in
+   * parallel. The same applies to tile compressed tables, which are read from
+   * their in-memory uncompressed copy.
+   *
+   * If a filter is set (see setFilter()) it is ignored by this method.
+   * @param first
+   *    The index of the first row to read (starting from 0)
+   * @param count
+   *    The number of rows to read, or -1 for reading all the rows until the
+   *    end of the table. If the range exceeds the end of the table, only the
+   *    remaining rows are read.
+   * @return
+   *    The rows of the range
+   * @throws Elements::Exception
+   *    if first is not the index of a table row or count is not positive
+   *    (or -1)
+   * @throws Elements::Exception
+   *    if cfitsio fails to open the file or to read the data
+   */
+  Table readRange(long first, long count);
+
   /**
    * @brief Returns the column information of the table
    * @details
@@ -152,6 +261,34 @@ public:
   /// Implements the TableReader::rowsLeft() contract
   std::size_t rowsLeft() override;
 
+  /**
+   * @brief Implements the ColumnReader::readColumns() contract
+   * @details
+   * No data are read by this call. The values of the rows are read from the
+   * file when the columns are retrieved with getColumn().
+   * @throws Elements::Exception
+   *    if a filter is set
+   */
+  std::size_t readColumns(long rows) override;
+
+  /// Implements the ColumnReader::getColumn() contract
+  void getColumn(std::size_t index, std::vector<bool>& values) override;
+
+  /// Implements the ColumnReader::getColumn() contract
+  void getColumn(std::size_t index, std::vector<int32_t>& values) override;
+
+  /// Implements the ColumnReader::getColumn() contract
+  void getColumn(std::size_t index, std::vector<int64_t>& values) override;
+
+  /// Implements the ColumnReader::getColumn() contract
+  void getColumn(std::size_t index, std::vector<float>& values) override;
+
+  /// Implements the ColumnReader::getColumn() contract
+  void getColumn(std::size_t index, std::vector<double>& values) override;
+
+  /// Implements the ColumnReader::getColumn() contract
+  void getColumn(std::size_t index, std::vector<std::string>& values) override;
+
 protected:
 
   /// Implements the TableReader::readImpl() contract
@@ -160,14 +297,47 @@ protected:
 private:
   
   void readColumnInfo();
+
+  Table readFiltered(long rows);
+
+  std::unique_ptr<Table> scanFiltered(long rows, bool first_match);
+
+  template <typename T>
+  void readNumericColumn(std::size_t index, std::vector<T>& values);
+
+  // Returns the mutex to hold while reading with the handle of the HDU
+  std::mutex& hduMutex();
   
   std::unique_ptr<CCfits::FITS> m_fits {nullptr};
   std::reference_wrapper<const CCfits::HDU> m_hdu; 
+  // The in-memory copy of a tile compressed table and the file of the
+  // compressed table
+  std::unique_ptr<CCfits::FITS> m_uncompressed_fits {nullptr};
+  CCfits::FITS* m_source_fits = nullptr;
   bool m_reading_started = false;
   long m_total_rows = -1;
   long m_current_row = 1;
   std::vector<std::string> m_column_names {};
   std::shared_ptr<ColumnInfo> m_column_info;
+  // The TNULLn values of the columns
+  std::vector<boost::optional<int64_t>> m_null_values {};
+  std::shared_ptr<ThreadPool> m_thread_pool {};
+  std::unique_ptr<Filter> m_filter {};
+  std::unique_ptr<ZoneMap> m_zone_map {};
+  // The first and last rows of the zone map blocks rejected by the filter,
+  // computed when filtered reading starts
+  std::unique_ptr<std::vector<std::pair<long, long>>> m_skipped_rows {};
+  // The rows passing the filter found by hasMoreRows() and not read yet
+  std::unique_ptr<Table> m_filtered_ahead {};
+  // Guards the lazy initialization of the column info, which might be
+  // triggered by concurrent readRange() calls
+  std::unique_ptr<std::mutex> m_column_info_mutex {new std::mutex};
+  // Guards the reading with the handle of the HDU, which might be used by
+  // concurrent readRange() calls for the in-memory copies of compressed tables
+  std::unique_ptr<std::mutex> m_hdu_mutex {new std::mutex};
+  // The rows of the last readColumns() call
+  long m_columns_first = 1;
+  long m_columns_rows = 0;
 
 }; /* End of FitsReader class */
 
@@ -25,8 +25,13 @@
 #ifndef _TABLE_FITSWRITER_H
 #define _TABLE_FITSWRITER_H
 
+#include <map>
+#include <memory>
+#include <boost/optional.hpp>
 #include <CCfits/FITS.h>
+#include "AlexandriaKernel/ThreadPool.h"
 #include "Table/TableWriter.h"
+#include "Table/ZoneMap.h"
 
 namespace Euclid {
 namespace Table {
@@ -68,10 +73,29 @@ namespace Table {
  * 
  * Note that, at the moment, only fixed length vector columns are supported
  * and that there is no support for vector columns for ASCII FITS tables.
- * 
+ *
+ * The lengths w above are computed from the first Table given to addData(),
+ * so later chunks with longer strings would be truncated. This is avoided
+ * by declaring the width (for strings and ASCII columns) and the shape (for
+ * vector and NdArray columns, also used for TDIMn) in the ColumnDescription.
+ * The declared values are used without scanning the data, and values which
+ * do not fit them are rejected with an exception.
+ *
  * The TUNITn fits keywords are populated using the unit of the of the
  * ColumnDescriptions of the Table. The descriptions of the columns are
  * set as the values of the (non standard) keywords TDESCn.
+ *
+ * The compressed binary format writes tile compressed binary tables (the
+ * ZTABLE convention used by fpack), with the same column formats as the
+ * binary format. The compression algorithm of each column can be selected
+ * with setCompression(), otherwise cfitsio uses Rice for integer columns and
+ * GZIP_2 for the rest. As cfitsio compresses only whole tables, the rows are
+ * kept in an in-memory binary table and the compressed HDU is added to the
+ * file only by the close() method (or the destructor). The memory used by the
+ * writer therefore grows with the table, up to the full size of its
+ * uncompressed data, and the peak during close() includes the compressed
+ * copy as well. Big catalogs should be split in several HDUs or files, or
+ * written with the uncompressed binary format.
  */
 class FitsWriter : public TableWriter {
 
@@ -82,7 +106,20 @@ public:
     /// FITS ASCII table HDU format
     ASCII,
     /// FITS binary table HDU format
-    BINARY
+    BINARY,
+    /// Tile compressed FITS binary table HDU format
+    COMPRESSED_BINARY
+  };
+
+  /// The compression algorithms of the columns of compressed binary tables
+  enum class Compression {
+    /// Rice compression, only for integer columns
+    RICE,
+    /// GZIP compression of the bytes of the column
+    GZIP,
+    /// GZIP compression after shuffling the bytes of the values, which is
+    /// usually more efficient for numeric columns
+    SHUFFLED_GZIP
   };
   
   /**
@@ -94,11 +131,9 @@ public:
    * by the setHduName() method, the table of this HDU will be appended. Otherwise
    * a new table HDU will be added to the file.
    * 
-   * Note that when this constructor is used the FITS file will be re-opened each 
-   * time the addData() method is called. This takes away from the user the
-   * responsibility of managing the lifetime of the CCfits::FITS objects, but it
-   * might cause performance issues (especially with files with hundreds of HDUs).
-   * If this is the case, consider to use the other constructor of this class.
+   * The FITS file is opened during the first call of addData() and it is kept
+   * open until the close() method is called or the FitsWriter is destroyed. If
+   * addData() is called after close(), the file is opened again.
    * 
    * @param filename
    *    The path of the file to store the FITS table
@@ -134,22 +169,46 @@ public:
 
   /**
    * @brief Destructor
+   * @details
+   * Any rows kept in memory (see setChunkSize()) are written to the file
+   * before it is closed. Errors during this last write are logged, as they
+   * cannot be thrown from a destructor, so call close() explicitly to detect
+   * them.
    */
-  virtual ~FitsWriter() = default;
+  virtual ~FitsWriter();
   
   /**
    * @brief Set the FITS table format
    * @details
-   * It can be set either to ASCII or binary (default). It returns a reference to
-   * the FitsWriter so it can be chained with other calls in the same line.
+   * It can be set to ASCII, binary (default) or compressed binary. It returns a
+   * reference to the FitsWriter so it can be chained with other calls in the
+   * same line.
    * @param format
-   *    One of FitsWriter::Format::ASCII, FitsWriter::Format::BINARY
+   *    One of FitsWriter::Format::ASCII, FitsWriter::Format::BINARY,
+   *    FitsWriter::Format::COMPRESSED_BINARY
    * @return 
    *    A reference to the FitsWriter instance
    * @throws Elements::Exception
    *    if writing of data has already started
    */
   FitsWriter& setFormat(Format format);
+
+  /**
+   * @brief Sets the compression algorithm of a column of a compressed table
+   * @details
+   * It is used only with the FitsWriter::Format::COMPRESSED_BINARY format. The
+   * algorithm is stored in the FZALGn keyword of the column, where cfitsio
+   * reads it from when it compresses the table.
+   * @param column
+   *    The name of the column
+   * @param algorithm
+   *    The compression algorithm
+   * @return
+   *    A reference to the FitsWriter instance
+   * @throws Elements::Exception
+   *    if writing of data has already started
+   */
+  FitsWriter& setCompression(const std::string& column, Compression algorithm);
   
   /**
    * @brief Set the HDU name where the table is written
@@ -166,6 +225,85 @@ public:
    */
   FitsWriter& setHduName(const std::string& name);
 
+  /**
+   * @brief Sets the minimum number of rows written to the FITS file at once
+   * @details
+   * Writing a few rows in a FITS table is expensive, because every column is
+   * written separately. When the chunk size is set, the tables given to the
+   * addData() method are kept in memory until at least this number of rows is
+   * collected and they are then written together. The rows kept in memory are
+   * also written by the flush() and close() methods and when the FitsWriter
+   * is destroyed. The default value is zero, meaning that the rows are written
+   * immediately.
+   * @param rows
+   *    The minimum number of rows to write at once
+   * @return
+   *    A reference to the FitsWriter instance
+   */
+  FitsWriter& setChunkSize(std::size_t rows);
+
+  /**
+   * @brief Sets a thread pool for packing the columns data in parallel
+   * @details
+   * Before the data are written to the file, each column is packed in a
+   * contiguous buffer. When a pool is set, this is done by its tasks, one per
+   * column, and the file is then written by the calling thread. The pool can
+   * be shared with other users, as the writer waits only for its own tasks.
+   * Setting a null pointer switches back to serial packing.
+   * @param thread_pool
+   *    The pool to use or null
+   * @return
+   *    A reference to the FitsWriter instance
+   */
+  FitsWriter& setThreadPool(std::shared_ptr<ThreadPool> thread_pool);
+
+  /**
+   * @brief Enables writing a zone map with the table
+   * @details
+   * When the block size is set, the minimum, maximum and number of NaN or
+   * missing values of every bool, integer, float and double column are
+   * computed for each block of this number of rows, while the columns are
+   * packed for writing. The statistics are written in a separate binary table
+   * HDU, named after the table HDU with the suffix _ZONEMAP (or HDUn_ZONEMAP,
+   * with n the HDU index, for tables without a name), and the table HDU gets
+   * the ZONEMAP keyword with the name of this HDU. Tables of the
+   * COMPRESSED_BINARY format must be given a name with setHduName() for having
+   * a zone map. The completed blocks are written by the flush() method and the
+   * last, incomplete, one by the close() method. The FitsReader uses the zone
+   * map for skipping blocks when reading with a filter. The default value is
+   * zero, meaning that no zone map is written.
+   * @param rows
+   *    The number of rows of each block
+   * @return
+   *    A reference to the FitsWriter instance
+   * @throws Elements::Exception
+   *    if writing of data has already started
+   */
+  FitsWriter& setZoneMapBlockSize(std::size_t rows);
+
+  /**
+   * @brief Writes all the rows kept in memory to the FITS file
+   * @details
+   * After the rows are written, the cfitsio buffers of the file are flushed,
+   * so the data are visible to other processes.
+   */
+  void flush();
+
+  /**
+   * @brief Writes all the rows kept in memory and closes the FITS file
+   * @details
+   * The statistics of the last block of the zone map, if enabled, are also
+   * written, even if the block is not complete.
+   * When the FitsWriter was created with a CCfits::FITS object, this object is
+   * only flushed, as its lifetime is managed by the user.
+   *
+   * For the compressed binary format, this is when the table is compressed and
+   * written to the file. The HDU is added with cfitsio, so a CCfits::FITS
+   * object given to the constructor does not list it until it is opened
+   * again. Compressed tables cannot be extended after they are closed.
+   */
+  void close();
+
   /**
    * @brief Adds a comment to the stream
    * @details
@@ -201,6 +339,31 @@ private:
   std::vector<std::string> m_comments {};
   int m_hdu_index = -1;
   long m_current_line = 0;
+  std::size_t m_chunk_size = 0;
+  std::vector<Row> m_chunk_rows {};
+  // The validity bitmaps of the rows kept in memory, for the zone map statistics
+  std::map<std::size_t, ValidityBitmap> m_chunk_validity {};
+  std::shared_ptr<ThreadPool> m_thread_pool {};
+  std::shared_ptr<ColumnInfo> m_column_info {};
+  std::map<std::string, Compression> m_compression {};
+  // The in-memory file of the uncompressed rows of a compressed table
+  std::shared_ptr<CCfits::FITS> m_staging_fits {};
+  std::size_t m_zone_map_block_size = 0;
+  ZoneMap m_zone_map {};
+  ZoneMapBlock m_zone_block {};
+  
+  CCfits::FITS& openFits();
+
+  CCfits::FITS& tableFits();
+
+  void writeCompressed();
+  
+  void writeRows(const Table& table);
+
+  void addStatistics(std::size_t offset, std::size_t rows,
+                     const std::vector<boost::optional<ColumnStatistics>>& statistics);
+
+  void writeZoneMap(bool include_incomplete);
 
 }; /* End of FitsWriter class */
 
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file Table/MultiFileTableReader.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef _TABLE_MULTIFILETABLEREADER_H
+#define _TABLE_MULTIFILETABLEREADER_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "AlexandriaKernel/ThreadPool.h"
+#include "Table/TableReader.h"
+
+namespace Euclid {
+namespace Table {
+
+/**
+ * @class MultiFileTableReader
+ *
+ * @brief TableReader for a catalog split in multiple FITS files (shards)
+ *
+ * @details
+ * The reader behaves as a single table, with the rows of all the shards. All
+ * the shards must have the table in the same HDU, with exactly the same
+ * columns, which is checked by the constructor from the FITS headers only.
+ * The number of rows of each shard is taken from its NAXIS2 keyword, so
+ * rowsLeft() never needs to read any data.
+ *
+ * When a thread pool is set, the shards are read in parallel by its tasks,
+ * each task reading a whole shard. To bound the memory, at most a given
+ * number of shards are being read or kept in memory at any time. The rows
+ * are returned in the order of the files, or, if setCompletionOrder() is
+ * used, in the order the shards finish being read, which avoids waiting for
+ * slow shards. Without a pool, the shards are read one by one in the calling
+ * thread.
+ *
+ * If cfitsio is not built as reentrant, the shards are still read by the pool
+ * tasks, but one at a time.
+ */
+class MultiFileTableReader : public TableReader {
+
+public:
+
+  /**
+   * @brief Creates a MultiFileTableReader for the given files
+   * @param filenames
+   *    The files of the shards, in the order their rows are returned
+   * @param hdu_index
+   *    The index of the table HDU in all the files
+   * @throws Elements::Exception
+   *    if no files are given, if any of them cannot be read or if their
+   *    columns are not the same
+   */
+  MultiFileTableReader(std::vector<std::string> filenames, int hdu_index=1);
+
+  MultiFileTableReader(MultiFileTableReader&&) = delete;
+  MultiFileTableReader& operator=(MultiFileTableReader&&) = delete;
+
+  /// Waits for the shards still being read
+  virtual ~MultiFileTableReader();
+
+  /**
+   * @brief Returns the files matching a shell wildcard pattern, sorted by name
+   * @throws Elements::Exception
+   *    if no file matches the pattern
+   */
+  static std::vector<std::string> findFiles(const std::string& pattern);
+
+  /**
+   * @brief Sets a thread pool for reading the shards in parallel
+   * @details
+   * The pool can be shared with other users. A null pointer switches back to
+   * reading in the calling thread.
+   * @throws Elements::Exception
+   *    if reading has already started
+   */
+  MultiFileTableReader& setThreadPool(std::shared_ptr<ThreadPool> thread_pool);
+
+  /**
+   * @brief Sets the maximum number of shards read or kept in memory at once
+   * @details
+   * The default is 4. It applies only when a thread pool is set.
+   * @throws Elements::Exception
+   *    if the number is zero or if reading has already started
+   */
+  MultiFileTableReader& setMaxShardsInMemory(std::size_t shards);
+
+  /**
+   * @brief Returns the rows of each shard as soon as the shard has been read
+   * @details
+   * The rows of each shard are still returned together and in order, but the
+   * shards can be returned in any order.
+   * @throws Elements::Exception
+   *    if reading has already started
+   */
+  MultiFileTableReader& setCompletionOrder(bool completion_order=true);
+
+  /// Returns the comment of the first shard
+  std::string getComment() override;
+
+  /// Returns the columns of the shards
+  const ColumnInfo& getInfo() override;
+
+  /// Implements the TableReader::skip() contract. Shards whose rows are all
+  /// skipped are not read, unless their reading has already started.
+  void skip(long rows) override;
+
+  /// Implements the TableReader::hasMoreRows() contract
+  bool hasMoreRows() override;
+
+  /// Implements the TableReader::rowsLeft() contract
+  std::size_t rowsLeft() override;
+
+protected:
+
+  /// Implements the TableReader::readImpl() contract
+  Table readImpl(long rows) override;
+
+private:
+
+  struct Shard {
+    std::string filename;
+    std::size_t rows;
+  };
+
+  struct ShardData {
+    std::unique_ptr<Table> table;
+    std::exception_ptr error;
+  };
+
+  void startReads();
+
+  void releaseCurrent();
+
+  bool loadNextShard();
+
+  std::unique_ptr<Table> readShard(std::size_t index) const;
+
+  std::vector<Shard> m_shards {};
+  int m_hdu_index;
+  std::string m_comment {};
+  std::shared_ptr<ColumnInfo> m_column_info {};
+  std::shared_ptr<ThreadPool> m_thread_pool {};
+  std::size_t m_max_shards = 4;
+  bool m_completion_order = false;
+  bool m_reading_started = false;
+
+  // The shards which are not yet returned or skipped
+  std::size_t m_rows_left = 0;
+  // The shard the rows are currently returned from and the next row of it
+  std::unique_ptr<Table> m_current {};
+  std::size_t m_current_row = 0;
+  // If the current shard is included in m_in_memory
+  bool m_current_counted = false;
+  // In file order, the index of the next shard to return. In completion
+  // order, the number of shards returned.
+  std::size_t m_next_shard = 0;
+  // The shards not started yet have indices from this one and on
+  std::size_t m_next_to_start = 0;
+  // The shards which have been started and not consumed yet, including the
+  // current one and the ones whose rows have been skipped
+  std::size_t m_in_memory = 0;
+
+  // Protects the members below, which are accessed by the pool tasks
+  std::mutex m_mutex {};
+  std::condition_variable m_condition {};
+  std::size_t m_running = 0;
+  std::map<std::size_t, ShardData> m_finished {};
+  std::deque<std::size_t> m_finished_order {};
+
+}; /* End of MultiFileTableReader class */
+
+} /* namespace Table */
+} /* namespace Euclid */
+
+#endif
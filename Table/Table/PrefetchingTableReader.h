@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file Table/PrefetchingTableReader.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef _TABLE_PREFETCHINGTABLEREADER_H
+#define _TABLE_PREFETCHINGTABLEREADER_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "Table/TableReader.h"
+
+namespace Euclid {
+namespace Table {
+
+/**
+ * @class PrefetchingTableReader
+ *
+ * @brief TableReader decorator reading the next rows in a background thread
+ *
+ * @details
+ * The wrapped reader is read in chunks of a fixed number of rows by a
+ * background thread, which keeps up to a given number of chunks ready. This
+ * way the reading of the next rows overlaps with the processing of the
+ * current ones by the caller. The read() calls are served from the ready
+ * chunks, so they return the same rows as the wrapped reader would, no matter
+ * how many rows they request. A read() requesting exactly the chunk size
+ * returns the chunk without copying its rows.
+ *
+ * The getComment(), getInfo(), skip(), hasMoreRows() and rowsLeft() calls
+ * are forwarded to the wrapped reader, taking into account the rows already
+ * prefetched. They wait for any read in progress to finish. An exception
+ * thrown by the wrapped reader in the background thread is thrown by the
+ * read() call which would have returned the rows of the failed chunk.
+ *
+ * The wrapped reader must not be used by anyone else after it has been given
+ * to the PrefetchingTableReader.
+ */
+class PrefetchingTableReader : public TableReader {
+
+public:
+
+  /**
+   * @brief Constructs a PrefetchingTableReader and starts prefetching
+   * @param reader
+   *    The reader to read the rows from
+   * @param chunk_rows
+   *    The number of rows of each chunk read by the background thread
+   * @param chunks
+   *    The maximum number of chunks kept ready, with 2 meaning double
+   *    buffering
+   * @throws Elements::Exception
+   *    if the reader is null or if the chunk_rows or chunks are zero
+   */
+  PrefetchingTableReader(std::unique_ptr<TableReader> reader, std::size_t chunk_rows, std::size_t chunks=2);
+
+  PrefetchingTableReader(PrefetchingTableReader&&) = delete;
+  PrefetchingTableReader& operator=(PrefetchingTableReader&&) = delete;
+
+  /// Stops the background thread, after waiting for any read in progress
+  virtual ~PrefetchingTableReader();
+
+  /// Returns the comment of the wrapped reader
+  std::string getComment() override;
+
+  /// Returns the column information of the wrapped reader
+  const ColumnInfo& getInfo() override;
+
+  /// Implements the TableReader::skip() contract, dropping the prefetched
+  /// rows first
+  void skip(long rows) override;
+
+  /// Implements the TableReader::hasMoreRows() contract
+  bool hasMoreRows() override;
+
+  /// Implements the TableReader::rowsLeft() contract, including the
+  /// prefetched rows
+  std::size_t rowsLeft() override;
+
+protected:
+
+  /// Implements the TableReader::readImpl() contract
+  Table readImpl(long rows) override;
+
+private:
+
+  void prefetch();
+
+  std::unique_ptr<TableReader> m_reader;
+  std::size_t m_chunk_rows;
+  std::size_t m_max_chunks;
+
+  // Locked while the wrapped reader is used. The background thread adds a
+  // chunk to the queue before releasing it, so while a caller holds it the
+  // queue and the position of the wrapped reader agree. When both mutexes
+  // are needed, m_reader_mutex is locked first.
+  std::mutex m_reader_mutex {};
+
+  // Protects the members below
+  std::mutex m_queue_mutex {};
+  std::condition_variable m_queue_condition {};
+  std::deque<Table> m_chunks {};
+  bool m_finished = false;
+  bool m_stop = false;
+  std::exception_ptr m_error {};
+
+  std::thread m_thread {};
+
+}; /* End of PrefetchingTableReader class */
+
+} /* namespace Table */
+} /* namespace Euclid */
+
+#endif
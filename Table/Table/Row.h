@@ -150,6 +150,21 @@ public:
    */
   const cell_type& operator[](const std::string& column) const;
 
+  /**
+   * @brief
+   * Returns the value of the row for the column represented by the given handle
+   * @details
+   * If the handle was created from the ColumnInfo of the row, the cell is
+   * accessed by index without comparing any names. Otherwise the column is
+   * searched as described by ColumnInfo::findIndex(const Handle&).
+   *
+   * @param column The handle of the column
+   * @return The value of the row for the column
+   * @throws Elements::Exception
+   *    if there is no column with the name of the handle
+   */
+  const cell_type& operator[](const ColumnInfo::Handle& column) const;
+
   /**
    * @brief
    * Returns a const iterator to the first cell of the row
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file Table/StringDictionary.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef _TABLE_STRINGDICTIONARY_H
+#define _TABLE_STRINGDICTIONARY_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <boost/optional.hpp>
+#include "ElementsKernel/Export.h"
+
+namespace Euclid {
+namespace Table {
+
+/**
+ * @class StringDictionary
+ *
+ * @brief The distinct values of a dictionary encoded string column
+ *
+ * @details
+ * A dictionary encoded column stores in its cells int32_t codes instead of
+ * strings, so the cells do not allocate any memory. The code of a value is
+ * its index in the dictionary, which is shared by all the rows via the
+ * ColumnDescription of the column (see ColumnDescription::dictionary). Columns
+ * with few distinct values, like filter names or flags, are encoded by the
+ * encodeDictionaryColumns() function and by the DictionaryEncodingReader, and
+ * they are decoded by the TableWriter implementations before writing.
+ *
+ * The dictionary is immutable, so it can be shared between threads.
+ */
+class ELEMENTS_API StringDictionary {
+
+public:
+
+  /**
+   * @brief Constructs a StringDictionary with the given values
+   * @param values
+   *    The distinct values, in the order of their codes
+   * @throws Elements::Exception
+   *    if the values contain duplicates
+   */
+  explicit StringDictionary(std::vector<std::string> values);
+
+  /// Returns the number of values of the dictionary
+  std::size_t size() const {
+    return m_values.size();
+  }
+
+  /// Returns the values of the dictionary, in the order of their codes
+  const std::vector<std::string>& getValues() const {
+    return m_values;
+  }
+
+  /**
+   * @brief Returns the value with the given code
+   * @throws Elements::Exception
+   *    if the code is not in the range [0, size())
+   */
+  const std::string& decode(int32_t code) const;
+
+  /// Returns the code of the given value, if it is in the dictionary
+  boost::optional<int32_t> find(const std::string& value) const;
+
+  /// Returns true if the two dictionaries have the same values with the same codes
+  bool operator==(const StringDictionary& other) const {
+    return m_values == other.m_values;
+  }
+
+  /// Returns true if the two dictionaries differ
+  bool operator!=(const StringDictionary& other) const {
+    return !(*this == other);
+  }
+
+private:
+
+  std::vector<std::string> m_values;
+  std::unordered_map<std::string, int32_t> m_codes;
+
+}; /* End of StringDictionary class */
+
+} /* namespace Table */
+} /* namespace Euclid */
+
+#endif
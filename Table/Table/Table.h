@@ -25,13 +25,18 @@
 #ifndef TABLE_TABLE_H
 #define	TABLE_TABLE_H
 
+#include <cstddef>
+#include <iterator>
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "ElementsKernel/Export.h"
 
 #include "Table/ColumnInfo.h"
 #include "Table/Row.h"
+#include "Table/ValidityBitmap.h"
 
 namespace Euclid {
 namespace Table {
@@ -45,12 +50,24 @@ namespace Table {
  * The Table is an immutable class which represents a table. It contains
  * a list of Rows, which all have the same columns. Note that because the Table
  * is immutable instances without rows are not allowed.
+ *
+ * The columns can have a ValidityBitmap marking their missing values (for
+ * example FITS TNULLn values, NaN or ASCII null tokens). The cells of the
+ * missing values still contain a value of the column type, which should be
+ * ignored.
+ *
+ * The rows are kept in blocks shared between the tables, so copying a Table,
+ * concatenating tables and slicing a table do not copy any rows. The
+ * resulting tables refer to the rows of the original ones, which are kept in
+ * memory for as long as any table uses them (even if it uses only a small
+ * slice of them). Only the validity bitmaps are copied, which need a single
+ * bit per row.
  */
 class ELEMENTS_API Table {
 
 public:
 
-  typedef std::vector<Row>::const_iterator const_iterator;
+  class const_iterator;
 
   /**
    * @brief
@@ -67,6 +84,48 @@ public:
    */
   Table(std::vector<Row> row_list);
 
+  /**
+   * @brief
+   * Constructs a Table with the given rows and validity bitmaps
+   * @details
+   * The columns without a bitmap have all their values valid.
+   *
+   * @param row_list The rows of the table
+   * @param validity The bitmaps of the columns with missing values, with the
+   *    column indices as keys
+   * @throws Elements::Exception
+   *    if the given list is empty
+   * @throws Elements::Exception
+   *    if not all the rows have the same columns
+   * @throws Elements::Exception
+   *    if a bitmap refers to a column which does not exist or its size is not
+   *    the number of rows
+   */
+  Table(std::vector<Row> row_list, std::map<std::size_t, ValidityBitmap> validity);
+
+  /**
+   * @brief
+   * Constructs a Table with the rows of the given tables, one after the other
+   * @details
+   * The rows are not copied, the new table refers to the rows of the given
+   * tables. The validity bitmaps are concatenated, so the columns which have
+   * missing values in any of the tables get a bitmap.
+   *
+   * @param tables The tables to concatenate
+   * @throws Elements::Exception
+   *    if the given list is empty
+   * @throws Elements::Exception
+   *    if not all the tables have the same columns
+   */
+  Table(const std::vector<Table>& tables);
+
+  Table(const Table&) = default;
+  Table& operator=(const Table&) = default;
+
+  /// The rows are moved, so tables can be returned and queued without copies
+  Table(Table&&) = default;
+  Table& operator=(Table&&) = default;
+
   /// Default destructor
   virtual ~Table() = default;
 
@@ -112,13 +171,246 @@ public:
    */
   const_iterator end() const;
 
+  /**
+   * @brief
+   * Returns a Table with the rows in the range [begin, end) of this table
+   * @details
+   * The rows are not copied, the new table refers to the rows of this table.
+   *
+   * @param begin The index of the first row of the slice (zero based)
+   * @param end The index after the last row of the slice
+   * @return The slice of the table
+   * @throws Elements::Exception
+   *    if the range is empty or if it exceeds the rows of the table
+   */
+  Table slice(std::size_t begin, std::size_t end) const;
+
+  /**
+   * @brief
+   * Returns all the values of a column in a vector
+   * @details
+   * The type of the column is checked once, so the values are copied in a
+   * single loop without visiting the variant of each cell. The Table stores
+   * its data in rows, so the values are always copied in a new vector. The
+   * dictionary encoded columns (see StringDictionary) can be retrieved both
+   * as their int32_t codes and as the decoded std::string values.
+   *
+   * @tparam T The type of the column, which must match exactly
+   * @param name The name of the column
+   * @return The values of the column, one for each row
+   * @throws Elements::Exception
+   *    if there is no column with the given name
+   * @throws Elements::Exception
+   *    if the column is not of type T
+   */
+  template <typename T>
+  std::vector<T> column(const std::string& name) const;
+
+  /**
+   * @brief
+   * Returns all the values of a numeric column converted to the type T
+   * @details
+   * The column can be of type bool, int32_t, int64_t, float or double. The
+   * type of the column is resolved once and the values are converted with a
+   * static_cast in a single loop.
+   *
+   * @tparam T An arithmetic type
+   * @param name The name of the column
+   * @return The converted values of the column, one for each row
+   * @throws Elements::Exception
+   *    if there is no column with the given name
+   * @throws Elements::Exception
+   *    if the column is not numeric
+   */
+  template <typename T>
+  std::vector<T> columnCast(const std::string& name) const;
+
+  /**
+   * @brief
+   * Returns the bitmap marking the valid values of a column
+   * @details
+   * For the columns without missing values all the rows are marked as valid.
+   *
+   * @param name The name of the column
+   * @return The validity bitmap of the column
+   * @throws Elements::Exception
+   *    if there is no column with the given name
+   */
+  ValidityBitmap getValidity(const std::string& name) const;
+
+  /// Returns the bitmaps of the columns with missing values, with the column indices as keys
+  const std::map<std::size_t, ValidityBitmap>& getValidityBitmaps() const;
+
 private:
-  std::vector<Row> m_row_list;
-  std::shared_ptr<ColumnInfo> m_column_info;
+
+  /// A range of rows in a vector, which is shared between all the tables
+  /// referring to any of its rows
+  struct RowBlock {
+    std::shared_ptr<const std::vector<Row>> owner;
+    const Row* begin;
+    const Row* end;
+  };
+
+  /// The blocks of rows of a table, which are not modified after the table
+  /// is constructed, so they are shared by its copies and its iterators
+  struct BlockList {
+    std::vector<RowBlock> blocks {};
+    /// The index of the first row of each block
+    std::vector<std::size_t> offsets {};
+    std::size_t size = 0;
+
+    const_iterator iteratorAt(std::size_t index) const;
+  };
+
+  Table() = default;
+
+  const_iterator iteratorAt(std::size_t index) const;
+
+  std::size_t columnIndex(const std::string& name) const;
+
+  template <typename T>
+  std::vector<T> copyColumn(std::size_t index) const;
+
+  template <typename From, typename To>
+  std::vector<To> castColumn(std::size_t index) const;
+
+  std::shared_ptr<BlockList> m_blocks {std::make_shared<BlockList>()};
+  std::shared_ptr<ColumnInfo> m_column_info {};
+  std::map<std::size_t, ValidityBitmap> m_validity {};
 };
 
+/**
+ * @class Table::const_iterator
+ *
+ * @brief Random access iterator over the rows of a Table
+ *
+ * @details
+ * Moving to the next row is a pointer increment inside the blocks of rows, so
+ * iterating over a concatenated table is as fast as over a contiguous one.
+ * The iterator refers to the blocks of rows of the Table it was created from
+ * and not to the Table object, so it stays valid if the Table is moved. The
+ * Table, or a copy of it or the Table it was moved to, must outlive it.
+ */
+class Table::const_iterator {
+
+public:
+
+  typedef std::random_access_iterator_tag iterator_category;
+  typedef Row value_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef const Row* pointer;
+  typedef const Row& reference;
+
+  const_iterator() = default;
+
+  reference operator*() const {
+    return *m_row;
+  }
+
+  pointer operator->() const {
+    return m_row;
+  }
+
+  reference operator[](difference_type n) const {
+    return *(*this + n);
+  }
+
+  const_iterator& operator++() {
+    ++m_index;
+    if (++m_row == m_block_end) {
+      *this = m_blocks->iteratorAt(m_index);
+    }
+    return *this;
+  }
+
+  const_iterator operator++(int) {
+    const_iterator result {*this};
+    ++(*this);
+    return result;
+  }
+
+  const_iterator& operator--() {
+    return *this -= 1;
+  }
+
+  const_iterator operator--(int) {
+    const_iterator result {*this};
+    --(*this);
+    return result;
+  }
+
+  const_iterator& operator+=(difference_type n);
+
+  const_iterator& operator-=(difference_type n) {
+    return *this += -n;
+  }
+
+  const_iterator operator+(difference_type n) const {
+    const_iterator result {*this};
+    return result += n;
+  }
+
+  const_iterator operator-(difference_type n) const {
+    const_iterator result {*this};
+    return result -= n;
+  }
+
+  difference_type operator-(const const_iterator& other) const {
+    return static_cast<difference_type>(m_index) - static_cast<difference_type>(other.m_index);
+  }
+
+  bool operator==(const const_iterator& other) const {
+    return m_index == other.m_index;
+  }
+
+  bool operator!=(const const_iterator& other) const {
+    return m_index != other.m_index;
+  }
+
+  bool operator<(const const_iterator& other) const {
+    return m_index < other.m_index;
+  }
+
+  bool operator>(const const_iterator& other) const {
+    return m_index > other.m_index;
+  }
+
+  bool operator<=(const const_iterator& other) const {
+    return m_index <= other.m_index;
+  }
+
+  bool operator>=(const const_iterator& other) const {
+    return m_index >= other.m_index;
+  }
+
+private:
+
+  friend class Table;
+
+  const_iterator(const BlockList* blocks, std::size_t index, const Row* row,
+                 const Row* block_begin, const Row* block_end)
+          : m_blocks{blocks}, m_index{index}, m_row{row}, m_block_begin{block_begin}, m_block_end{block_end} {
+  }
+
+  const BlockList* m_blocks = nullptr;
+  std::size_t m_index = 0;
+  const Row* m_row = nullptr;
+  const Row* m_block_begin = nullptr;
+  const Row* m_block_end = nullptr;
+};
+
+inline Table::const_iterator operator+(Table::const_iterator::difference_type n, const Table::const_iterator& iter) {
+  return iter + n;
+}
+
+/// Returns the decoded values of the dictionary encoded columns
+template <>
+std::vector<std::string> Table::column<std::string>(const std::string& name) const;
+
 }
 } // end of namespace Euclid
 
+#include "Table/_impl/Table.icpp"
+
 #endif	/* TABLE_TABLE_H */
 
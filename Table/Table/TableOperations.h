@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file Table/TableOperations.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef _TABLE_TABLEOPERATIONS_H
+#define _TABLE_TABLEOPERATIONS_H
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ElementsKernel/Export.h"
+#include "AlexandriaKernel/ThreadPool.h"
+#include "Table/Table.h"
+
+namespace Euclid {
+namespace Table {
+
+/*
+ * The operations of this file work on the key columns copied in typed arrays
+ * (bool and integer keys as int64_t, float and double keys as double, and
+ * strings), so the comparisons and the hashing never go through the
+ * Row::cell_type variant. The key columns can be of type bool, int32_t,
+ * int64_t, float, double or std::string. Dictionary encoded string columns
+ * (see StringDictionary) are keys with string values, but their rows are
+ * compared and hashed by integers derived from their codes, without decoding
+ * them. If a thread pool is given, the work is split in tasks executed by
+ * the pool, otherwise everything runs in the calling thread. The pool can be
+ * shared with other users.
+ */
+
+/// A column used for sorting a table and its sort direction
+struct SortKey {
+  SortKey(std::string column_name, bool descending_order=false)
+          : column(std::move(column_name)), descending(descending_order) {
+  }
+  std::string column;
+  bool descending;
+};
+
+/**
+ * @brief Returns the indices of the rows of the table in sorted order
+ * @details
+ * The rows are compared by the first key, then by the second for the rows
+ * with equal first key, etc. The sorting is stable. NaN values are placed
+ * after all the other values, in both sort directions. The rows themselves are
+ * never moved; the sorting permutes only the indices.
+ * @param table
+ *    The table to sort
+ * @param keys
+ *    The columns to sort by
+ * @param thread_pool
+ *    The pool for sorting parts of the table in parallel, or null
+ * @throws Elements::Exception
+ *    if no key is given or if any of the key columns does not exist or has an
+ *    unsupported type
+ */
+ELEMENTS_API std::vector<std::size_t> sortIndices(const Table& table, const std::vector<SortKey>& keys,
+                                                  std::shared_ptr<ThreadPool> thread_pool=nullptr);
+
+/// Returns a table with the rows of the given table in the order of sortIndices()
+ELEMENTS_API Table sort(const Table& table, const std::vector<SortKey>& keys,
+                        std::shared_ptr<ThreadPool> thread_pool=nullptr);
+
+/// An aggregation computed for each group by the groupBy() function
+struct Aggregation {
+
+  /**
+   * @brief The available aggregation functions
+   * @details
+   * COUNT does not use any column and it returns int64_t values. SUM, MIN and
+   * MAX return int64_t values for bool and integer columns and double values
+   * for float and double columns. MEAN always returns double values.
+   */
+  enum class Function {
+    COUNT, SUM, MIN, MAX, MEAN
+  };
+
+  Aggregation(Function aggregation_function, std::string column_name, std::string result_column_name)
+          : function(aggregation_function), column(std::move(column_name)),
+            result_column(std::move(result_column_name)) {
+  }
+
+  Function function;
+  /// The column to aggregate (ignored for COUNT)
+  std::string column;
+  /// The name of the column of the result
+  std::string result_column;
+};
+
+/**
+ * @brief Groups the rows with the same key values and computes aggregations
+ * @details
+ * The result contains one row per group, in the order the groups first
+ * appear in the table. Its columns are the key columns, followed by one
+ * column per aggregation. The rows are grouped by using a hash table. Float
+ * keys are equal if they compare equal, or if they are both NaN.
+ * @param table
+ *    The table to group
+ * @param keys
+ *    The names of the columns to group by
+ * @param aggregations
+ *    The aggregations to compute for each group
+ * @param thread_pool
+ *    The pool for hashing the keys and computing the aggregations in
+ *    parallel, or null
+ * @throws Elements::Exception
+ *    if no key is given, if any of the columns does not exist or has an
+ *    unsupported type, or if the result column names are not unique
+ */
+ELEMENTS_API Table groupBy(const Table& table, const std::vector<std::string>& keys,
+                           const std::vector<Aggregation>& aggregations,
+                           std::shared_ptr<ThreadPool> thread_pool=nullptr);
+
+/**
+ * @brief Returns the pairs of the indices of the matching rows of two tables
+ * @details
+ * This performs an inner hash join: a hash table is built for the keys of the
+ * right table and it is probed with the keys of the left table. The pairs are
+ * ordered by the left row and, for the same left row, by the right row. The
+ * key columns of the two tables must have the same names and the same kind of
+ * type (bool or integer, float or double, or string).
+ * @param left
+ *    The left table of the join
+ * @param right
+ *    The right table of the join
+ * @param keys
+ *    The names of the key columns, which both tables must have
+ * @param thread_pool
+ *    The pool for probing parts of the left table in parallel, or null
+ * @throws Elements::Exception
+ *    if no key is given, or if any of the key columns does not exist or has an
+ *    unsupported or incompatible type
+ */
+ELEMENTS_API std::vector<std::pair<std::size_t, std::size_t>> joinIndices(
+        const Table& left, const Table& right, const std::vector<std::string>& keys,
+        std::shared_ptr<ThreadPool> thread_pool=nullptr);
+
+/**
+ * @brief Returns the inner hash join of two tables
+ * @details
+ * The rows are the ones of joinIndices(). The columns are all the columns of
+ * the left table, followed by the columns of the right table except the keys.
+ * @throws Elements::Exception
+ *    for any of the reasons of joinIndices()
+ * @throws Elements::Exception
+ *    if the tables have columns with the same name, other than the keys
+ * @throws Elements::Exception
+ *    if there are no matching rows, as a Table cannot be empty
+ */
+ELEMENTS_API Table join(const Table& left, const Table& right, const std::vector<std::string>& keys,
+                        std::shared_ptr<ThreadPool> thread_pool=nullptr);
+
+} /* namespace Table */
+} /* namespace Euclid */
+
+#endif
@@ -83,7 +83,9 @@ public:
    * The first time this method is called defines the columns of the output. Any
    * subsequent calls must be done with tables which match exactly these column
    * names and types. When the call ends, the given data should be already written
-   * to the underlying stream or file.
+   * to the underlying stream or file. Dictionary encoded columns (see
+   * StringDictionary) are decoded before they are given to the implementation,
+   * so they are written and compared as string columns.
    * @param table
    *    The table containing the rows to write
    * @throws Elements::Exception
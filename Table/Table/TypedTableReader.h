@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file Table/TypedTableReader.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef _TABLE_TYPEDTABLEREADER_H
+#define _TABLE_TYPEDTABLEREADER_H
+
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <typeindex>
+#include <vector>
+#include "ElementsKernel/Export.h"
+#include "Table/ColumnReader.h"
+
+namespace Euclid {
+namespace Table {
+
+/**
+ * @struct TypedField
+ * @brief Binds a table column to a member of type T of a Record
+ * @details
+ * The member can be of type bool, int32_t, int64_t, float, double or
+ * std::string. Use the field() function for creating instances without
+ * giving the template parameters.
+ */
+template <typename Record, typename T>
+struct TypedField {
+
+  static_assert(std::is_same<T, bool>::value || std::is_same<T, int32_t>::value
+                || std::is_same<T, int64_t>::value || std::is_same<T, float>::value
+                || std::is_same<T, double>::value || std::is_same<T, std::string>::value,
+                "TypedField members must be bool, int32_t, int64_t, float, double or std::string");
+
+  typedef Record record_type;
+  typedef T value_type;
+
+  TypedField(std::string column_name, T Record::* record_member)
+          : column(std::move(column_name)), member(record_member) {
+  }
+
+  std::string column;
+  T Record::* member;
+
+};
+
+/// Returns a TypedField binding the given column to the given member
+template <typename Record, typename T>
+TypedField<Record, T> field(std::string column, T Record::* member) {
+  return TypedField<Record, T>{std::move(column), member};
+}
+
+/**
+ * @brief Checks if the values of a column of type from can be stored in a
+ * member of type to without losing information
+ * @details
+ * This is the case if the types are the same, for bool columns read as any
+ * numeric type, for int32_t columns read as int64_t or double and for float
+ * columns read as double.
+ */
+ELEMENTS_API bool isLosslessConversion(std::type_index from, std::type_index to);
+
+/**
+ * @class TypedTableReader
+ *
+ * @brief Reads the rows of a table directly into user defined structures
+ *
+ * @details
+ * Each of the Fields is a TypedField, binding a column of the table to a
+ * member of the Record. The types of the members are known at compile time,
+ * so the column values are decoded by the ColumnReader (a FitsReader or an
+ * AsciiReader) directly into typed arrays and they are then assigned to the
+ * members, without creating any Row objects. The columns are looked up and
+ * their types are checked once, when the TypedTableReader is constructed. For
+ * example:
+ * @code
+ * struct Source {
+ *   int64_t id;
+ *   double z;
+ * };
+ * auto reader = makeTypedTableReader<Source>(make_unique<FitsReader>(filename),
+ *                                            field("ID", &Source::id), field("Z", &Source::z));
+ * std::vector<Source> sources = reader.read();
+ * @endcode
+ *
+ * The Record must be default constructible. The columns of the table which
+ * are not bound to any member are not decoded at all.
+ */
+template <typename Record, typename... Fields>
+class TypedTableReader {
+
+public:
+
+  /**
+   * @brief Constructs a TypedTableReader reading from the given reader
+   * @param reader
+   *    The reader to read the column values from
+   * @param fields
+   *    The bindings of the columns to the members of the Record
+   * @throws Elements::Exception
+   *    if the reader is null
+   * @throws Elements::Exception
+   *    if a column does not exist, or if its values cannot be stored in the
+   *    member without losing information (see isLosslessConversion())
+   */
+  TypedTableReader(std::unique_ptr<ColumnReader> reader, Fields... fields);
+
+  TypedTableReader(TypedTableReader&&) = default;
+  TypedTableReader& operator=(TypedTableReader&&) = default;
+
+  /**
+   * @brief Reads the next rows
+   * @param rows
+   *    The maximum number of rows to read, or -1 for all the remaining rows
+   * @return
+   *    A Record for each row read
+   * @throws Elements::Exception
+   *    if all the rows have already been read
+   */
+  std::vector<Record> read(long rows=-1);
+
+  /// Returns true if there are rows left to read
+  bool hasMoreRows() {
+    return m_reader->hasMoreRows();
+  }
+
+private:
+
+  template <std::size_t I>
+  typename std::enable_if<I < sizeof...(Fields)>::type bindFields(const ColumnInfo& info);
+
+  template <std::size_t I>
+  typename std::enable_if<I == sizeof...(Fields)>::type bindFields(const ColumnInfo&) {
+  }
+
+  template <std::size_t I>
+  typename std::enable_if<I < sizeof...(Fields)>::type setMembers(std::vector<Record>& records);
+
+  template <std::size_t I>
+  typename std::enable_if<I == sizeof...(Fields)>::type setMembers(std::vector<Record>&) {
+  }
+
+  std::unique_ptr<ColumnReader> m_reader;
+  std::tuple<Fields...> m_fields;
+  // The column indices of the fields
+  std::vector<std::size_t> m_indices {};
+
+}; /* End of TypedTableReader class */
+
+/// Creates a TypedTableReader, deducing the types of the fields
+template <typename Record, typename... Fields>
+TypedTableReader<Record, Fields...> makeTypedTableReader(std::unique_ptr<ColumnReader> reader, Fields... fields) {
+  return TypedTableReader<Record, Fields...>{std::move(reader), std::move(fields)...};
+}
+
+} /* namespace Table */
+} /* namespace Euclid */
+
+#include "Table/_impl/TypedTableReader.icpp"
+
+#endif
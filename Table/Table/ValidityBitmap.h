@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file Table/ValidityBitmap.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef _TABLE_VALIDITYBITMAP_H
+#define _TABLE_VALIDITYBITMAP_H
+
+#include <cstdint>
+#include <vector>
+#include "ElementsKernel/Export.h"
+
+namespace Euclid {
+namespace Table {
+
+/**
+ * @class ValidityBitmap
+ *
+ * @brief Marks which values of a column are valid and which are missing
+ *
+ * @details
+ * The bitmap stores one bit per row, packed in 64 bit words, where a set bit
+ * means that the value of the row is valid. The unused bits of the last word
+ * are always zero, so the words can be combined directly with bitwise
+ * operations. Consumers can skip the missing values by iterating over the
+ * valid rows with forEachValid(), which handles whole words at once, or by
+ * combining the bitmaps of several columns with the & operator, instead of
+ * checking each value for a sentinel.
+ */
+class ELEMENTS_API ValidityBitmap {
+
+public:
+
+  typedef std::uint64_t word_type;
+
+  /// The number of rows stored in each word
+  static const std::size_t word_bits = 64;
+
+  /// Creates a bitmap of the given size, with all the values valid
+  explicit ValidityBitmap(std::size_t size = 0);
+
+  /// Returns the number of rows of the bitmap
+  std::size_t size() const;
+
+  /// Returns true if the value of the given row is valid. The index is not checked.
+  bool isValid(std::size_t index) const {
+    return (m_words[index / word_bits] >> (index % word_bits)) & 1;
+  }
+
+  /**
+   * @brief Marks the value of the given row as valid or missing
+   * @throws Elements::Exception
+   *    if the index is out of range
+   */
+  void setValid(std::size_t index, bool valid);
+
+  /// Returns the number of valid values
+  std::size_t countValid() const;
+
+  /// Returns true if there are no missing values
+  bool allValid() const;
+
+  /// Returns the words of the bitmap, where bit i of word w is the row w * 64 + i
+  const std::vector<word_type>& getWords() const;
+
+  /**
+   * @brief Returns the bitmap of count rows, starting from the row first
+   * @throws Elements::Exception
+   *    if the rows are out of range
+   */
+  ValidityBitmap slice(std::size_t first, std::size_t count) const;
+
+  /// Appends the rows of the other bitmap after the rows of this one
+  void append(const ValidityBitmap& other);
+
+  /**
+   * @brief Keeps valid only the rows which are valid in both bitmaps
+   * @throws Elements::Exception
+   *    if the bitmaps have different sizes
+   */
+  ValidityBitmap& operator&=(const ValidityBitmap& other);
+
+  bool operator==(const ValidityBitmap& other) const;
+
+  bool operator!=(const ValidityBitmap& other) const;
+
+  /// Calls the given function with the index of each valid row, in increasing order
+  template <typename F>
+  void forEachValid(F function) const;
+
+private:
+
+  std::size_t m_size;
+  std::vector<word_type> m_words;
+
+}; /* End of ValidityBitmap class */
+
+/// Returns a bitmap with the rows valid in both bitmaps
+ELEMENTS_API ValidityBitmap operator&(ValidityBitmap left, const ValidityBitmap& right);
+
+} /* namespace Table */
+} /* namespace Euclid */
+
+#include "Table/_impl/ValidityBitmap.icpp"
+
+#endif
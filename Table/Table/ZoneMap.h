@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file Table/ZoneMap.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef _TABLE_ZONEMAP_H
+#define _TABLE_ZONEMAP_H
+
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/variant.hpp>
+
+namespace Euclid {
+namespace Table {
+
+/**
+ * @struct ColumnStatistics
+ * @brief The statistics of the values of a numeric column in a block of rows
+ * @details
+ * The minimum and maximum are int64_t values for bool and integer columns and
+ * double values for float and double columns. They ignore the NaN values and
+ * the values marked as missing by the validity bitmaps, which are counted as
+ * nulls. If all the values of the block are nulls, the minimum and maximum
+ * are NaN for float and double columns, and the minimum is greater than the
+ * maximum for bool and integer columns.
+ */
+struct ColumnStatistics {
+
+  typedef boost::variant<int64_t, double> value_type;
+
+  value_type min {};
+  value_type max {};
+  std::size_t null_count = 0;
+
+  /// Returns false if all the values of the block are nulls
+  bool hasValues() const {
+    if (min.which() == 0) {
+      return boost::get<int64_t>(min) <= boost::get<int64_t>(max);
+    }
+    return !std::isnan(boost::get<double>(min));
+  }
+
+};
+
+/**
+ * @struct ZoneMapBlock
+ * @brief The statistics of the numeric columns of a block of table rows
+ */
+struct ZoneMapBlock {
+
+  /// The number of table rows before the block
+  std::size_t offset = 0;
+
+  /// The number of rows of the block
+  std::size_t rows = 0;
+
+  /// The statistics of each numeric column, by column name
+  std::map<std::string, ColumnStatistics> columns {};
+
+};
+
+/**
+ * @brief The statistics of a table, per block of rows
+ * @details
+ * Readers can use a zone map for skipping the blocks which cannot contain any
+ * row passing a filter, without reading them. The blocks are ordered by their
+ * offset and they do not overlap, but they do not have to cover all the rows.
+ */
+typedef std::vector<ZoneMapBlock> ZoneMap;
+
+} /* namespace Table */
+} /* namespace Euclid */
+
+#endif
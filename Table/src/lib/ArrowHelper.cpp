@@ -0,0 +1,847 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/ArrowHelper.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include "ElementsKernel/Exception.h"
+#include "ArrowHelper.h"
+
+namespace Euclid {
+namespace Table {
+
+using NdArray::NdArray;
+
+namespace {
+
+// The ids of the Arrow types, as defined by the Type union of Schema.fbs
+const std::uint8_t type_int = 2;
+const std::uint8_t type_floating_point = 3;
+const std::uint8_t type_utf8 = 5;
+const std::uint8_t type_bool = 6;
+const std::uint8_t type_list = 12;
+const std::uint8_t type_fixed_size_list = 16;
+const std::uint8_t type_large_utf8 = 20;
+const std::uint8_t type_large_list = 21;
+
+// The metadata version V5
+const std::int16_t metadata_version = 4;
+
+// The ids of the message headers
+const std::uint8_t header_schema = 1;
+const std::uint8_t header_record_batch = 3;
+
+const std::string extension_name_key {"ARROW:extension:name"};
+const std::string extension_metadata_key {"ARROW:extension:metadata"};
+const std::string tensor_extension {"arrow.fixed_shape_tensor"};
+
+template <typename T>
+void put(std::string& buffer, T value) {
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void pad(std::string& buffer) {
+  buffer.append((8 - buffer.size() % 8) % 8, '\0');
+}
+
+template <typename T>
+T get(const char* data) {
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+bool isLittleEndian() {
+  std::uint16_t value = 1;
+  return *reinterpret_cast<const char*>(&value) == 1;
+}
+
+//-----------------------------------------------------------------------------
+// Schema encoding
+//-----------------------------------------------------------------------------
+
+template <typename T>
+ArrowValueType valueTypeOf();
+template <>
+ArrowValueType valueTypeOf<bool>() { return ArrowValueType::BOOL; }
+template <>
+ArrowValueType valueTypeOf<int32_t>() { return ArrowValueType::INT32; }
+template <>
+ArrowValueType valueTypeOf<int64_t>() { return ArrowValueType::INT64; }
+template <>
+ArrowValueType valueTypeOf<float>() { return ArrowValueType::FLOAT; }
+template <>
+ArrowValueType valueTypeOf<double>() { return ArrowValueType::DOUBLE; }
+
+template <typename T>
+bool setColumnFor(ArrowColumn& column, const Row::cell_type& first_value) {
+  auto type = column.description.type;
+  column.value_type = valueTypeOf<T>();
+  if (type == typeid(T)) {
+    column.layout = ArrowLayout::SCALAR;
+  } else if (type == typeid(std::vector<T>)) {
+    column.layout = ArrowLayout::LIST;
+  } else if (type == typeid(NdArray<T>)) {
+    column.layout = ArrowLayout::FIXED_SIZE_LIST;
+    column.shape = boost::get<NdArray<T>>(first_value).shape();
+    column.list_size = boost::get<NdArray<T>>(first_value).size();
+  } else {
+    return false;
+  }
+  return true;
+}
+
+std::shared_ptr<FlatBufferTable> keyValue(const std::string& key, const std::string& value) {
+  auto table = std::make_shared<FlatBufferTable>();
+  table->addObject(0, std::make_shared<FlatBufferString>(key));
+  table->addObject(1, std::make_shared<FlatBufferString>(value));
+  return table;
+}
+
+std::shared_ptr<FlatBufferTable> valueTypeTable(ArrowValueType value_type, std::uint8_t& type_id) {
+  auto table = std::make_shared<FlatBufferTable>();
+  switch (value_type) {
+    case ArrowValueType::BOOL:
+      type_id = type_bool;
+      break;
+    case ArrowValueType::INT32:
+      type_id = type_int;
+      table->addScalar<std::int32_t>(0, 32).addScalar<std::uint8_t>(1, 1);
+      break;
+    case ArrowValueType::INT64:
+      type_id = type_int;
+      table->addScalar<std::int32_t>(0, 64).addScalar<std::uint8_t>(1, 1);
+      break;
+    case ArrowValueType::FLOAT:
+      type_id = type_floating_point;
+      table->addScalar<std::int16_t>(0, 1);
+      break;
+    case ArrowValueType::DOUBLE:
+      type_id = type_floating_point;
+      table->addScalar<std::int16_t>(0, 2);
+      break;
+    case ArrowValueType::UTF8:
+      type_id = type_utf8;
+      break;
+    default:
+      throw Elements::Exception() << "Writing this Arrow value type is not supported";
+  }
+  return table;
+}
+
+std::shared_ptr<FlatBufferTable> fieldTable(const std::string& name, std::uint8_t type_id,
+                                            std::shared_ptr<FlatBufferTable> type_table,
+                                            std::vector<std::shared_ptr<const FlatBufferObject>> children,
+                                            std::vector<std::shared_ptr<const FlatBufferObject>> metadata) {
+  auto table = std::make_shared<FlatBufferTable>();
+  table->addObject(0, std::make_shared<FlatBufferString>(name));
+  table->addScalar<std::uint8_t>(1, 0);
+  table->addScalar<std::uint8_t>(2, type_id);
+  table->addObject(3, std::move(type_table));
+  table->addObject(5, std::make_shared<FlatBufferObjectVector>(std::move(children)));
+  if (!metadata.empty()) {
+    table->addObject(6, std::make_shared<FlatBufferObjectVector>(std::move(metadata)));
+  }
+  return table;
+}
+
+std::shared_ptr<FlatBufferTable> columnField(const ArrowColumn& column) {
+  std::vector<std::shared_ptr<const FlatBufferObject>> metadata {};
+  if (!column.description.unit.empty()) {
+    metadata.push_back(keyValue("unit", column.description.unit));
+  }
+  if (!column.description.description.empty()) {
+    metadata.push_back(keyValue("description", column.description.description));
+  }
+  std::uint8_t value_type_id;
+  auto value_type = valueTypeTable(column.value_type, value_type_id);
+  if (column.layout == ArrowLayout::SCALAR) {
+    return fieldTable(column.description.name, value_type_id, value_type, {}, std::move(metadata));
+  }
+  auto item = fieldTable("item", value_type_id, value_type, {}, {});
+  auto type_table = std::make_shared<FlatBufferTable>();
+  std::uint8_t type_id = type_list;
+  if (column.layout == ArrowLayout::FIXED_SIZE_LIST) {
+    type_id = type_fixed_size_list;
+    type_table->addScalar<std::int32_t>(0, column.list_size);
+    std::string shape = "{\"shape\":[";
+    for (std::size_t i = 0; i < column.shape.size(); ++i) {
+      shape += (i > 0 ? "," : "") + std::to_string(column.shape[i]);
+    }
+    shape += "]}";
+    metadata.push_back(keyValue(extension_name_key, tensor_extension));
+    metadata.push_back(keyValue(extension_metadata_key, shape));
+  }
+  return fieldTable(column.description.name, type_id, type_table, {item}, std::move(metadata));
+}
+
+std::shared_ptr<FlatBufferTable> schemaTable(const ArrowSchema& schema) {
+  std::vector<std::shared_ptr<const FlatBufferObject>> fields {};
+  for (auto& column : schema.columns) {
+    fields.push_back(columnField(column));
+  }
+  auto table = std::make_shared<FlatBufferTable>();
+  table->addScalar<std::int16_t>(0, 0);
+  table->addObject(1, std::make_shared<FlatBufferObjectVector>(std::move(fields)));
+  if (!schema.comment.empty()) {
+    std::vector<std::shared_ptr<const FlatBufferObject>> metadata {keyValue("comment", schema.comment)};
+    table->addObject(2, std::make_shared<FlatBufferObjectVector>(std::move(metadata)));
+  }
+  return table;
+}
+
+std::string encapsulate(const FlatBufferTable& message) {
+  auto metadata = finishFlatBuffer(message);
+  std::string result {};
+  put<std::uint32_t>(result, 0xFFFFFFFF);
+  put<std::int32_t>(result, metadata.size());
+  result += metadata;
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+// Record batch encoding
+//-----------------------------------------------------------------------------
+
+class BodyBuilder {
+public:
+  BodyBuilder(std::string& body) : m_body(body) {
+  }
+  void node(std::int64_t length) {
+    put<std::int64_t>(m_nodes, length);
+    put<std::int64_t>(m_nodes, 0);
+    ++m_node_count;
+  }
+  void buffer(const std::string& data) {
+    put<std::int64_t>(m_buffers, m_body.size());
+    put<std::int64_t>(m_buffers, data.size());
+    ++m_buffer_count;
+    m_body += data;
+    pad(m_body);
+  }
+  std::shared_ptr<FlatBufferTable> recordBatch(std::int64_t rows) const {
+    auto table = std::make_shared<FlatBufferTable>();
+    table->addScalar<std::int64_t>(0, rows);
+    table->addObject(1, std::make_shared<FlatBufferStructVector>(m_nodes, m_node_count, 8));
+    table->addObject(2, std::make_shared<FlatBufferStructVector>(m_buffers, m_buffer_count, 8));
+    return table;
+  }
+private:
+  std::string& m_body;
+  std::string m_nodes {};
+  std::string m_buffers {};
+  std::size_t m_node_count = 0;
+  std::size_t m_buffer_count = 0;
+};
+
+template <typename T>
+std::string packValues(const std::vector<T>& values) {
+  return std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+template <>
+std::string packValues<bool>(const std::vector<bool>& values) {
+  std::string bits ((values.size() + 7) / 8, '\0');
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    if (values[i]) {
+      bits[i / 8] |= static_cast<char>(1 << (i % 8));
+    }
+  }
+  return bits;
+}
+
+std::string offsetsBuffer(const std::vector<std::size_t>& sizes) {
+  std::string offsets {};
+  std::int64_t offset = 0;
+  put<std::int32_t>(offsets, 0);
+  for (auto size : sizes) {
+    offset += size;
+    if (offset > std::numeric_limits<std::int32_t>::max()) {
+      throw Elements::Exception() << "Arrow column data exceed the 32 bit offsets limit";
+    }
+    put<std::int32_t>(offsets, offset);
+  }
+  return offsets;
+}
+
+template <typename T>
+void encodeColumn(BodyBuilder& builder, const Table& table, std::size_t index, const ArrowColumn& column) {
+  std::vector<T> values {};
+  std::vector<std::size_t> sizes {};
+  for (const auto& row : table) {
+    if (column.layout == ArrowLayout::SCALAR) {
+      values.push_back(boost::get<T>(row[index]));
+    } else if (column.layout == ArrowLayout::LIST) {
+      auto& vector = boost::get<std::vector<T>>(row[index]);
+      values.insert(values.end(), vector.begin(), vector.end());
+      sizes.push_back(vector.size());
+    } else {
+      auto& ndarray = boost::get<NdArray<T>>(row[index]);
+      if (ndarray.shape() != column.shape) {
+        throw Elements::Exception() << "All the NdArrays of column " << column.description.name
+                                    << " must have the same shape";
+      }
+      values.insert(values.end(), ndarray.begin(), ndarray.end());
+    }
+  }
+  builder.node(table.size());
+  builder.buffer("");
+  if (column.layout == ArrowLayout::LIST) {
+    builder.buffer(offsetsBuffer(sizes));
+  }
+  if (column.layout != ArrowLayout::SCALAR) {
+    builder.node(values.size());
+    builder.buffer("");
+  }
+  builder.buffer(packValues(values));
+}
+
+void encodeStringColumn(BodyBuilder& builder, const Table& table, std::size_t index) {
+  std::string data {};
+  std::vector<std::size_t> sizes {};
+  for (const auto& row : table) {
+    auto& value = boost::get<std::string>(row[index]);
+    data += value;
+    sizes.push_back(value.size());
+  }
+  builder.node(table.size());
+  builder.buffer("");
+  builder.buffer(offsetsBuffer(sizes));
+  builder.buffer(data);
+}
+
+//-----------------------------------------------------------------------------
+// Schema decoding
+//-----------------------------------------------------------------------------
+
+ArrowValueType decodeValueType(std::uint8_t type_id, const FlatBufferTableView& type) {
+  switch (type_id) {
+    case type_bool:
+      return ArrowValueType::BOOL;
+    case type_utf8:
+      return ArrowValueType::UTF8;
+    case type_large_utf8:
+      return ArrowValueType::LARGE_UTF8;
+    case type_floating_point:
+      switch (type.scalar<std::int16_t>(0, 0)) {
+        case 1:
+          return ArrowValueType::FLOAT;
+        case 2:
+          return ArrowValueType::DOUBLE;
+        default:
+          throw Elements::Exception() << "Half precision Arrow columns are not supported";
+      }
+    case type_int: {
+      auto bits = type.scalar<std::int32_t>(0, 0);
+      bool is_signed = type.scalar<std::uint8_t>(1, 0) != 0;
+      if (is_signed) {
+        switch (bits) {
+          case 8: return ArrowValueType::INT8;
+          case 16: return ArrowValueType::INT16;
+          case 32: return ArrowValueType::INT32;
+          case 64: return ArrowValueType::INT64;
+        }
+      } else {
+        switch (bits) {
+          case 8: return ArrowValueType::UINT8;
+          case 16: return ArrowValueType::UINT16;
+          case 32: return ArrowValueType::UINT32;
+        }
+      }
+      throw Elements::Exception() << "Arrow integer columns of " << bits << " bits "
+                                  << (is_signed ? "" : "(unsigned) ") << "are not supported";
+    }
+  }
+  throw Elements::Exception() << "Arrow columns of type " << static_cast<int>(type_id) << " are not supported";
+}
+
+template <typename T>
+std::type_index cellType(ArrowLayout layout, bool is_tensor) {
+  if (layout == ArrowLayout::SCALAR) {
+    return typeid(T);
+  }
+  if (is_tensor) {
+    return typeid(NdArray<T>);
+  }
+  return typeid(std::vector<T>);
+}
+
+std::type_index cellType(ArrowValueType value_type, ArrowLayout layout, bool is_tensor) {
+  switch (value_type) {
+    case ArrowValueType::BOOL:
+      return cellType<bool>(layout, is_tensor);
+    case ArrowValueType::INT8:
+    case ArrowValueType::INT16:
+    case ArrowValueType::INT32:
+    case ArrowValueType::UINT8:
+    case ArrowValueType::UINT16:
+      return cellType<int32_t>(layout, is_tensor);
+    case ArrowValueType::INT64:
+    case ArrowValueType::UINT32:
+      return cellType<int64_t>(layout, is_tensor);
+    case ArrowValueType::FLOAT:
+      return cellType<float>(layout, is_tensor);
+    case ArrowValueType::DOUBLE:
+      return cellType<double>(layout, is_tensor);
+    default:
+      if (layout != ArrowLayout::SCALAR) {
+        throw Elements::Exception() << "Arrow lists of strings are not supported";
+      }
+      return typeid(std::string);
+  }
+}
+
+std::vector<std::size_t> parseTensorShape(const std::string& metadata) {
+  auto key = metadata.find("\"shape\"");
+  auto begin = metadata.find('[', key);
+  auto end = metadata.find(']', begin);
+  if (key == std::string::npos || begin == std::string::npos || end == std::string::npos) {
+    throw Elements::Exception() << "Invalid fixed shape tensor metadata " << metadata;
+  }
+  std::vector<std::string> tokens {};
+  auto dimensions = metadata.substr(begin + 1, end - begin - 1);
+  boost::split(tokens, dimensions, boost::is_any_of(","));
+  std::vector<std::size_t> shape {};
+  for (auto& token : tokens) {
+    boost::trim(token);
+    if (!token.empty()) {
+      shape.push_back(boost::lexical_cast<std::size_t>(token));
+    }
+  }
+  return shape;
+}
+
+ArrowColumn decodeField(const FlatBufferTableView& field) {
+  auto name = field.string(0);
+  if (field.has(4)) {
+    throw Elements::Exception() << "Dictionary encoded Arrow column " << name << " is not supported";
+  }
+  std::string unit {}, description {}, extension {}, extension_metadata {};
+  for (std::size_t i = 0; i < field.vectorSize(6); ++i) {
+    auto key_value = field.vectorTable(6, i);
+    auto key = key_value.string(0);
+    if (key == "unit") {
+      unit = key_value.string(1);
+    } else if (key == "description") {
+      description = key_value.string(1);
+    } else if (key == extension_name_key) {
+      extension = key_value.string(1);
+    } else if (key == extension_metadata_key) {
+      extension_metadata = key_value.string(1);
+    }
+  }
+
+  ArrowColumn column {ColumnDescription{name}, ArrowLayout::SCALAR, ArrowValueType::BOOL, 0, {}};
+  auto type_id = field.scalar<std::uint8_t>(2, 0);
+  if (type_id == type_list || type_id == type_large_list || type_id == type_fixed_size_list) {
+    if (field.vectorSize(5) != 1) {
+      throw Elements::Exception() << "Invalid Arrow list column " << name;
+    }
+    auto child = field.vectorTable(5, 0);
+    auto child_type_id = child.scalar<std::uint8_t>(2, 0);
+    if (child_type_id == type_list || child_type_id == type_large_list || child_type_id == type_fixed_size_list) {
+      throw Elements::Exception() << "Nested Arrow list column " << name << " is not supported";
+    }
+    if (child.has(4)) {
+      throw Elements::Exception() << "Dictionary encoded Arrow column " << name << " is not supported";
+    }
+    column.value_type = decodeValueType(child_type_id, child.table(3));
+    if (type_id == type_list) {
+      column.layout = ArrowLayout::LIST;
+    } else if (type_id == type_large_list) {
+      column.layout = ArrowLayout::LARGE_LIST;
+    } else {
+      column.layout = ArrowLayout::FIXED_SIZE_LIST;
+      auto list_size = field.table(3).scalar<std::int32_t>(0, 0);
+      if (list_size < 0) {
+        throw Elements::Exception() << "Invalid Arrow list column " << name;
+      }
+      column.list_size = list_size;
+    }
+  } else {
+    column.value_type = decodeValueType(type_id, field.table(3));
+  }
+
+  bool is_tensor = column.layout == ArrowLayout::FIXED_SIZE_LIST && extension == tensor_extension;
+  if (is_tensor) {
+    column.shape = parseTensorShape(extension_metadata);
+    std::size_t size = std::accumulate(column.shape.begin(), column.shape.end(),
+                                       std::size_t{1}, std::multiplies<std::size_t>());
+    if (column.shape.empty() || size != column.list_size) {
+      throw Elements::Exception() << "Tensor shape of column " << name << " does not match its size";
+    }
+  }
+  column.description = ColumnDescription {name, cellType(column.value_type, column.layout, is_tensor),
+                                          unit, description};
+  return column;
+}
+
+ArrowSchema decodeSchema(const FlatBufferTableView& schema) {
+  if (schema.scalar<std::int16_t>(0, 0) != 0 || !isLittleEndian()) {
+    throw Elements::Exception() << "Only little endian Arrow files are supported";
+  }
+  ArrowSchema result {};
+  for (std::size_t i = 0; i < schema.vectorSize(1); ++i) {
+    result.columns.push_back(decodeField(schema.vectorTable(1, i)));
+  }
+  for (std::size_t i = 0; i < schema.vectorSize(2); ++i) {
+    auto key_value = schema.vectorTable(2, i);
+    if (key_value.string(0) == "comment") {
+      result.comment = key_value.string(1);
+    }
+  }
+  if (result.columns.empty()) {
+    throw Elements::Exception() << "Arrow file without columns";
+  }
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+// Record batch decoding
+//-----------------------------------------------------------------------------
+
+typedef std::pair<const char*, std::size_t> Buffer;
+
+void checkBufferSize(const Buffer& buffer, std::size_t size) {
+  if (buffer.second < size) {
+    throw Elements::Exception() << "Arrow buffer too small for the column data";
+  }
+}
+
+std::size_t offsetAt(const Buffer& offsets, bool large, std::size_t index) {
+  if (large) {
+    checkBufferSize(offsets, (index + 1) * 8);
+    auto value = get<std::int64_t>(offsets.first + index * 8);
+    if (value < 0) {
+      throw Elements::Exception() << "Invalid Arrow offset";
+    }
+    return value;
+  }
+  checkBufferSize(offsets, (index + 1) * 4);
+  auto value = get<std::int32_t>(offsets.first + index * 4);
+  if (value < 0) {
+    throw Elements::Exception() << "Invalid Arrow offset";
+  }
+  return value;
+}
+
+template <typename S, typename T>
+void appendConverted(const Buffer& buffer, std::size_t begin, std::size_t end, std::vector<T>& values) {
+  checkBufferSize(buffer, end * sizeof(S));
+  auto data = reinterpret_cast<const S*>(buffer.first);
+  for (std::size_t i = begin; i < end; ++i) {
+    values.push_back(static_cast<T>(data[i]));
+  }
+}
+
+template <typename T>
+void appendValues(ArrowValueType value_type, const Buffer& buffer, std::size_t begin, std::size_t end,
+                  std::vector<T>& values) {
+  if (begin > end) {
+    throw Elements::Exception() << "Invalid Arrow offsets";
+  }
+  switch (value_type) {
+    case ArrowValueType::BOOL:
+      checkBufferSize(buffer, (end + 7) / 8);
+      for (std::size_t i = begin; i < end; ++i) {
+        values.push_back(static_cast<T>((buffer.first[i / 8] >> (i % 8)) & 1));
+      }
+      break;
+    case ArrowValueType::INT8:
+      appendConverted<std::int8_t>(buffer, begin, end, values);
+      break;
+    case ArrowValueType::INT16:
+      appendConverted<std::int16_t>(buffer, begin, end, values);
+      break;
+    case ArrowValueType::INT32:
+      appendConverted<std::int32_t>(buffer, begin, end, values);
+      break;
+    case ArrowValueType::INT64:
+      appendConverted<std::int64_t>(buffer, begin, end, values);
+      break;
+    case ArrowValueType::UINT8:
+      appendConverted<std::uint8_t>(buffer, begin, end, values);
+      break;
+    case ArrowValueType::UINT16:
+      appendConverted<std::uint16_t>(buffer, begin, end, values);
+      break;
+    case ArrowValueType::UINT32:
+      appendConverted<std::uint32_t>(buffer, begin, end, values);
+      break;
+    case ArrowValueType::FLOAT:
+      appendConverted<float>(buffer, begin, end, values);
+      break;
+    case ArrowValueType::DOUBLE:
+      appendConverted<double>(buffer, begin, end, values);
+      break;
+    default:
+      throw Elements::Exception() << "Unexpected Arrow value type";
+  }
+}
+
+template <typename T>
+void decodeTyped(const ArrowColumn& column, const ArrowColumnData& data, std::size_t first, std::size_t count,
+                 std::vector<Row::cell_type>& cells) {
+  if (column.layout == ArrowLayout::SCALAR) {
+    std::vector<T> values {};
+    values.reserve(count);
+    appendValues(column.value_type, data.buffers[1], first, first + count, values);
+    for (std::size_t i = 0; i < count; ++i) {
+      cells.emplace_back(static_cast<T>(values[i]));
+    }
+    return;
+  }
+  for (std::size_t i = first; i < first + count; ++i) {
+    std::vector<T> values {};
+    if (column.layout == ArrowLayout::FIXED_SIZE_LIST) {
+      appendValues(column.value_type, data.buffers[2], i * column.list_size, (i + 1) * column.list_size, values);
+    } else {
+      bool large = column.layout == ArrowLayout::LARGE_LIST;
+      appendValues(column.value_type, data.buffers[3], offsetAt(data.buffers[1], large, i),
+                   offsetAt(data.buffers[1], large, i + 1), values);
+    }
+    if (column.shape.empty()) {
+      cells.emplace_back(std::move(values));
+    } else {
+      cells.emplace_back(NdArray<T>(column.shape, std::move(values)));
+    }
+  }
+}
+
+void decodeStrings(const ArrowColumn& column, const ArrowColumnData& data, std::size_t first, std::size_t count,
+                   std::vector<Row::cell_type>& cells) {
+  bool large = column.value_type == ArrowValueType::LARGE_UTF8;
+  for (std::size_t i = first; i < first + count; ++i) {
+    auto begin = offsetAt(data.buffers[1], large, i);
+    auto end = offsetAt(data.buffers[1], large, i + 1);
+    if (begin > end) {
+      throw Elements::Exception() << "Invalid Arrow offsets";
+    }
+    checkBufferSize(data.buffers[2], end);
+    cells.emplace_back(std::string(data.buffers[2].first + begin, end - begin));
+  }
+}
+
+} // end of anonymous namespace
+
+ArrowSchema arrowSchemaFor(const Table& table) {
+  ArrowSchema schema {};
+  auto& info = *table.getColumnInfo();
+  for (std::size_t i = 0; i < info.size(); ++i) {
+    ArrowColumn column {info.getDescription(i), ArrowLayout::SCALAR, ArrowValueType::UTF8, 0, {}};
+    if (column.description.type != typeid(std::string)
+        && !setColumnFor<bool>(column, table[0][i]) && !setColumnFor<int32_t>(column, table[0][i])
+        && !setColumnFor<int64_t>(column, table[0][i]) && !setColumnFor<float>(column, table[0][i])
+        && !setColumnFor<double>(column, table[0][i])) {
+      throw Elements::Exception() << "Arrow format does not support columns of type "
+                                  << column.description.type.name();
+    }
+    schema.columns.push_back(std::move(column));
+  }
+  return schema;
+}
+
+std::string encodeSchemaMessage(const ArrowSchema& schema) {
+  FlatBufferTable message {};
+  message.addScalar<std::int16_t>(0, metadata_version);
+  message.addScalar<std::uint8_t>(1, header_schema);
+  message.addObject(2, schemaTable(schema));
+  message.addScalar<std::int64_t>(3, 0);
+  return encapsulate(message);
+}
+
+std::string encodeRecordBatch(const Table& table, const ArrowSchema& schema, std::string& body) {
+  BodyBuilder builder {body};
+  for (std::size_t i = 0; i < schema.columns.size(); ++i) {
+    auto& column = schema.columns[i];
+    switch (column.value_type) {
+      case ArrowValueType::BOOL:
+        encodeColumn<bool>(builder, table, i, column);
+        break;
+      case ArrowValueType::INT32:
+        encodeColumn<int32_t>(builder, table, i, column);
+        break;
+      case ArrowValueType::INT64:
+        encodeColumn<int64_t>(builder, table, i, column);
+        break;
+      case ArrowValueType::FLOAT:
+        encodeColumn<float>(builder, table, i, column);
+        break;
+      case ArrowValueType::DOUBLE:
+        encodeColumn<double>(builder, table, i, column);
+        break;
+      default:
+        encodeStringColumn(builder, table, i);
+    }
+  }
+  FlatBufferTable message {};
+  message.addScalar<std::int16_t>(0, metadata_version);
+  message.addScalar<std::uint8_t>(1, header_record_batch);
+  message.addObject(2, builder.recordBatch(table.size()));
+  message.addScalar<std::int64_t>(3, body.size());
+  return encapsulate(message);
+}
+
+std::string encodeFooter(const ArrowSchema& schema, const std::vector<ArrowBlock>& blocks) {
+  std::string block_bytes {};
+  for (auto& block : blocks) {
+    put<std::int64_t>(block_bytes, block.offset);
+    put<std::int32_t>(block_bytes, block.metadata_length);
+    put<std::int32_t>(block_bytes, 0);
+    put<std::int64_t>(block_bytes, block.body_length);
+  }
+  FlatBufferTable footer {};
+  footer.addScalar<std::int16_t>(0, metadata_version);
+  footer.addObject(1, schemaTable(schema));
+  footer.addObject(3, std::make_shared<FlatBufferStructVector>(block_bytes, blocks.size(), 8));
+  return finishFlatBuffer(footer);
+}
+
+std::pair<ArrowSchema, std::vector<ArrowBlock>> decodeFooter(const char* file_data, std::size_t file_size) {
+  // The file starts with the magic padded to 8 bytes and ends with the footer
+  // size and the magic
+  std::size_t trailer_size = 4 + arrow_magic_size;
+  if (file_size < 8 + trailer_size
+      || std::memcmp(file_data, arrow_magic, arrow_magic_size) != 0
+      || std::memcmp(file_data + file_size - arrow_magic_size, arrow_magic, arrow_magic_size) != 0) {
+    throw Elements::Exception() << "Not an Arrow IPC file";
+  }
+  auto footer_size = get<std::int32_t>(file_data + file_size - trailer_size);
+  if (footer_size <= 0 || static_cast<std::size_t>(footer_size) > file_size - 8 - trailer_size) {
+    throw Elements::Exception() << "Corrupted Arrow file footer";
+  }
+  auto footer = FlatBufferTableView::root(file_data + file_size - trailer_size - footer_size, footer_size);
+  auto schema = decodeSchema(footer.table(1));
+  if (footer.vectorSize(2) != 0) {
+    throw Elements::Exception() << "Arrow files with dictionaries are not supported";
+  }
+  std::vector<ArrowBlock> blocks {};
+  for (std::size_t i = 0; i < footer.vectorSize(3); ++i) {
+    auto block = footer.vectorStruct(3, i, 24);
+    blocks.push_back(ArrowBlock {get<std::int64_t>(block), get<std::int32_t>(block + 8), get<std::int64_t>(block + 16)});
+  }
+  return std::make_pair(std::move(schema), std::move(blocks));
+}
+
+ArrowBatch decodeRecordBatch(const char* file_data, std::size_t file_size,
+                             const ArrowBlock& block, const ArrowSchema& schema) {
+  if (block.offset < 0 || block.metadata_length < 8 || block.body_length < 0
+      || static_cast<std::uint64_t>(block.offset) + block.metadata_length + block.body_length > file_size) {
+    throw Elements::Exception() << "Invalid Arrow record batch location";
+  }
+  auto message_start = file_data + block.offset;
+  // Old files do not have the continuation marker before the metadata size
+  std::size_t prefix = get<std::uint32_t>(message_start) == 0xFFFFFFFF ? 8 : 4;
+  auto metadata_size = get<std::int32_t>(message_start + prefix - 4);
+  if (metadata_size < 0 || prefix + metadata_size > static_cast<std::size_t>(block.metadata_length)) {
+    throw Elements::Exception() << "Invalid Arrow record batch metadata";
+  }
+  auto message = FlatBufferTableView::root(message_start + prefix, metadata_size);
+  if (message.scalar<std::uint8_t>(1, 0) != header_record_batch) {
+    throw Elements::Exception() << "Expected Arrow record batch message";
+  }
+  auto batch = message.table(2);
+  if (batch.has(3)) {
+    throw Elements::Exception() << "Compressed Arrow record batches are not supported";
+  }
+  auto rows = batch.scalar<std::int64_t>(0, 0);
+  if (rows < 0) {
+    throw Elements::Exception() << "Invalid Arrow record batch length";
+  }
+  auto body = message_start + block.metadata_length;
+
+  ArrowBatch result {static_cast<std::size_t>(rows), {}};
+  std::size_t node = 0;
+  std::size_t buffer = 0;
+  for (auto& column : schema.columns) {
+    ArrowColumnData data {};
+    bool is_list = column.layout != ArrowLayout::SCALAR;
+    std::size_t nodes = is_list ? 2 : 1;
+    std::size_t buffers = 2;
+    if (column.layout == ArrowLayout::LIST || column.layout == ArrowLayout::LARGE_LIST) {
+      buffers = 4;
+    } else if (column.layout == ArrowLayout::FIXED_SIZE_LIST) {
+      buffers = 3;
+    } else if (column.value_type == ArrowValueType::UTF8 || column.value_type == ArrowValueType::LARGE_UTF8) {
+      buffers = 3;
+    }
+    for (std::size_t i = 0; i < nodes; ++i, ++node) {
+      auto field_node = batch.vectorStruct(1, node, 16);
+      if (get<std::int64_t>(field_node + 8) != 0) {
+        throw Elements::Exception() << "Arrow column " << column.description.name
+                                    << " contains null values, which are not supported";
+      }
+      data.lengths.push_back(get<std::int64_t>(field_node));
+    }
+    if (data.lengths[0] != rows) {
+      throw Elements::Exception() << "Invalid length of Arrow column " << column.description.name;
+    }
+    for (std::size_t i = 0; i < buffers; ++i, ++buffer) {
+      auto location = batch.vectorStruct(2, buffer, 16);
+      auto offset = get<std::int64_t>(location);
+      auto length = get<std::int64_t>(location + 8);
+      if (offset < 0 || length < 0 || offset + length > block.body_length) {
+        throw Elements::Exception() << "Invalid Arrow buffer location";
+      }
+      data.buffers.emplace_back(body + offset, length);
+    }
+    result.columns.push_back(std::move(data));
+  }
+  return result;
+}
+
+void decodeArrowCells(const ArrowColumn& column, const ArrowColumnData& data,
+                      std::size_t first, std::size_t count, std::vector<Row::cell_type>& cells) {
+  switch (column.value_type) {
+    case ArrowValueType::BOOL:
+      decodeTyped<bool>(column, data, first, count, cells);
+      break;
+    case ArrowValueType::INT8:
+    case ArrowValueType::INT16:
+    case ArrowValueType::INT32:
+    case ArrowValueType::UINT8:
+    case ArrowValueType::UINT16:
+      decodeTyped<int32_t>(column, data, first, count, cells);
+      break;
+    case ArrowValueType::INT64:
+    case ArrowValueType::UINT32:
+      decodeTyped<int64_t>(column, data, first, count, cells);
+      break;
+    case ArrowValueType::FLOAT:
+      decodeTyped<float>(column, data, first, count, cells);
+      break;
+    case ArrowValueType::DOUBLE:
+      decodeTyped<double>(column, data, first, count, cells);
+      break;
+    default:
+      decodeStrings(column, data, first, count, cells);
+  }
+}
+
+}
+} // end of namespace Euclid
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/ArrowHelper.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef TABLE_ARROWHELPER_H
+#define TABLE_ARROWHELPER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ElementsKernel/Export.h"
+#include "Table/Table.h"
+#include "FlatBuffersHelper.h"
+
+namespace Euclid {
+namespace Table {
+
+/// The magic string at the beginning and the end of the Arrow IPC files
+constexpr char arrow_magic[] = "ARROW1";
+
+/// The size of the magic string, without the terminating null character
+constexpr std::size_t arrow_magic_size = sizeof(arrow_magic) - 1;
+
+/// The types of the Arrow values supported
+enum class ArrowValueType {
+  BOOL, INT8, INT16, INT32, INT64, UINT8, UINT16, UINT32, FLOAT, DOUBLE, UTF8, LARGE_UTF8
+};
+
+/// The supported layouts of the Arrow columns
+enum class ArrowLayout {
+  /// One value per row
+  SCALAR,
+  /// A variable length list per row, with 32 bit offsets
+  LIST,
+  /// A variable length list per row, with 64 bit offsets
+  LARGE_LIST,
+  /// A list with the same length for all the rows
+  FIXED_SIZE_LIST
+};
+
+/// The description of a column of an Arrow file
+struct ArrowColumn {
+  /// The name, cell type, unit and description of the column
+  ColumnDescription description;
+  ArrowLayout layout;
+  /// The type of the values (or of the list elements)
+  ArrowValueType value_type;
+  /// The size of the lists, for the FIXED_SIZE_LIST layout
+  std::size_t list_size;
+  /// The shape of the NdArray cells
+  std::vector<std::size_t> shape;
+};
+
+/// The description of the columns of an Arrow file
+struct ArrowSchema {
+  std::vector<ArrowColumn> columns {};
+  std::string comment {};
+};
+
+/// The location of a record batch in an Arrow file
+struct ArrowBlock {
+  std::int64_t offset;
+  std::int32_t metadata_length;
+  std::int64_t body_length;
+};
+
+/// The parts of the body of a record batch belonging to a column
+struct ArrowColumnData {
+  /// The lengths of the column node and of its child node (for lists)
+  std::vector<std::int64_t> lengths {};
+  /// The buffers of the column, in the order they appear in the batch
+  std::vector<std::pair<const char*, std::size_t>> buffers {};
+};
+
+/// A record batch read from an Arrow file
+struct ArrowBatch {
+  std::size_t rows;
+  std::vector<ArrowColumnData> columns;
+};
+
+/**
+ * @brief Returns the Arrow description of the columns of the given table
+ * @details
+ * Vectors are stored as variable length lists and NdArrays as fixed size lists
+ * with the "arrow.fixed_shape_tensor" extension type. The shape of the NdArrays
+ * is taken from the first row.
+ * @throws Elements::Exception
+ *    if the table contains columns of not supported types
+ */
+ELEMENTS_API ArrowSchema arrowSchemaFor(const Table& table);
+
+/// Returns the encapsulated schema message
+ELEMENTS_API std::string encodeSchemaMessage(const ArrowSchema& schema);
+
+/**
+ * @brief Returns the encapsulated record batch message with the table data
+ * @param table The data to encode
+ * @param schema The schema of the file
+ * @param body The string to write the body of the message to
+ * @throws Elements::Exception
+ *    if the data do not fit the schema (for example NdArrays of different shape)
+ */
+ELEMENTS_API std::string encodeRecordBatch(const Table& table, const ArrowSchema& schema, std::string& body);
+
+/// Returns the footer flatbuffer of the file
+ELEMENTS_API std::string encodeFooter(const ArrowSchema& schema, const std::vector<ArrowBlock>& blocks);
+
+/**
+ * @brief Reads the footer of a memory mapped Arrow file
+ * @throws Elements::Exception
+ *    if the file is not a valid Arrow file or contains unsupported features
+ */
+ELEMENTS_API std::pair<ArrowSchema, std::vector<ArrowBlock>> decodeFooter(const char* file_data,
+                                                                         std::size_t file_size);
+
+/**
+ * @brief Reads the location of the column buffers of a record batch
+ * @throws Elements::Exception
+ *    if the record batch is not valid, is compressed or contains null values
+ */
+ELEMENTS_API ArrowBatch decodeRecordBatch(const char* file_data, std::size_t file_size,
+                                          const ArrowBlock& block, const ArrowSchema& schema);
+
+/**
+ * @brief Decodes the cells of a column of a record batch
+ * @param column The description of the column
+ * @param data The buffers of the column
+ * @param first The first row to decode
+ * @param count The number of rows to decode
+ * @param cells The vector to append the cells to
+ */
+ELEMENTS_API void decodeArrowCells(const ArrowColumn& column, const ArrowColumnData& data,
+                                   std::size_t first, std::size_t count, std::vector<Row::cell_type>& cells);
+
+}
+} // end of namespace Euclid
+
+#endif /* TABLE_ARROWHELPER_H */
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/ArrowReader.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <algorithm>
+#include <ios>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include "ElementsKernel/Exception.h"
+#include "AlexandriaKernel/memory_tools.h"
+#include "Table/ArrowReader.h"
+#include "ArrowHelper.h"
+
+namespace Euclid {
+namespace Table {
+
+ArrowReader::ArrowReader(const std::string& filename) : m_filename(filename) {
+  std::shared_ptr<boost::iostreams::mapped_file_source> file;
+  try {
+    file = std::make_shared<boost::iostreams::mapped_file_source>(filename);
+  } catch (const std::ios_base::failure& e) {
+    throw Elements::Exception() << "Failed to map file " << filename << ": " << e.what();
+  }
+  m_file = file;
+  const char* data = file->data();
+  std::size_t size = file->size();
+
+  auto footer = decodeFooter(data, size);
+  m_schema = make_unique<ArrowSchema>(std::move(footer.first));
+  for (auto& block : footer.second) {
+    m_batches.push_back(decodeRecordBatch(data, size, block, *m_schema));
+    m_total_rows += m_batches.back().rows;
+  }
+  std::vector<ColumnDescription> descriptions {};
+  for (std::size_t i = 0; i < m_schema->columns.size(); ++i) {
+    m_columns.push_back(i);
+    descriptions.push_back(m_schema->columns[i].description);
+  }
+  m_column_info = std::make_shared<ColumnInfo>(std::move(descriptions));
+}
+
+ArrowReader::ArrowReader(ArrowReader&&) = default;
+
+ArrowReader& ArrowReader::operator=(ArrowReader&&) = default;
+
+ArrowReader::~ArrowReader() = default;
+
+std::size_t ArrowReader::columnIndex(const std::string& column_name) const {
+  for (std::size_t i = 0; i < m_schema->columns.size(); ++i) {
+    if (m_schema->columns[i].description.name == column_name) {
+      return i;
+    }
+  }
+  throw Elements::Exception() << "File " << m_filename << " does not contain column " << column_name;
+}
+
+ArrowReader& ArrowReader::selectColumns(const std::vector<std::string>& column_names) {
+  if (m_reading_started) {
+    throw Elements::Exception() << "Selecting the columns after reading has started is not allowed";
+  }
+  if (column_names.empty()) {
+    throw Elements::Exception() << "Empty list of selected columns";
+  }
+  std::vector<std::size_t> columns {};
+  std::vector<ColumnDescription> descriptions {};
+  for (auto& name : column_names) {
+    columns.push_back(columnIndex(name));
+    descriptions.push_back(m_schema->columns[columns.back()].description);
+  }
+  m_column_info = std::make_shared<ColumnInfo>(std::move(descriptions));
+  m_columns = std::move(columns);
+  return *this;
+}
+
+namespace {
+
+template <typename T>
+ArrowValueType storedAs();
+template <>
+ArrowValueType storedAs<int32_t>() { return ArrowValueType::INT32; }
+template <>
+ArrowValueType storedAs<int64_t>() { return ArrowValueType::INT64; }
+template <>
+ArrowValueType storedAs<float>() { return ArrowValueType::FLOAT; }
+template <>
+ArrowValueType storedAs<double>() { return ArrowValueType::DOUBLE; }
+
+}
+
+template <typename T>
+std::vector<ArrowReader::ColumnChunk<T>> ArrowReader::mapColumn(const std::string& column_name) const {
+  auto index = columnIndex(column_name);
+  auto& column = m_schema->columns[index];
+  if (column.value_type != storedAs<T>()
+      || (column.layout != ArrowLayout::SCALAR && column.layout != ArrowLayout::FIXED_SIZE_LIST)) {
+    throw Elements::Exception() << "Column " << column_name << " is not stored as the requested type";
+  }
+  // The values are the second buffer of the scalars and the third (the values
+  // buffer of the child) of the fixed size lists
+  std::size_t buffer = column.layout == ArrowLayout::SCALAR ? 1 : 2;
+  std::size_t list_size = column.layout == ArrowLayout::SCALAR ? 1 : column.list_size;
+  std::vector<ColumnChunk<T>> chunks {};
+  for (auto& batch : m_batches) {
+    auto& values = batch.columns[index].buffers[buffer];
+    std::size_t size = batch.rows * list_size;
+    if (values.second < size * sizeof(T)) {
+      throw Elements::Exception() << "Arrow buffer too small for the column data";
+    }
+    chunks.push_back(ColumnChunk<T> {reinterpret_cast<const T*>(values.first), size});
+  }
+  return chunks;
+}
+
+#define TABLE_ARROW_MAP_INSTANTIATION(type) \
+  template std::vector<ArrowReader::ColumnChunk<type>> \
+  ArrowReader::mapColumn<type>(const std::string&) const;
+
+TABLE_ARROW_MAP_INSTANTIATION(int32_t)
+TABLE_ARROW_MAP_INSTANTIATION(int64_t)
+TABLE_ARROW_MAP_INSTANTIATION(float)
+TABLE_ARROW_MAP_INSTANTIATION(double)
+
+const ColumnInfo& ArrowReader::getInfo() {
+  return *m_column_info;
+}
+
+std::string ArrowReader::getComment() {
+  return m_schema->comment;
+}
+
+Table ArrowReader::readImpl(long rows) {
+  m_reading_started = true;
+  if (m_current_row >= m_total_rows) {
+    throw Elements::Exception() << "No more table rows left";
+  }
+  std::size_t count = m_total_rows - m_current_row;
+  if (rows >= 0) {
+    count = std::min(count, static_cast<std::size_t>(rows));
+  }
+
+  // Decode the requested rows of each column from all the record batches they
+  // are stored in
+  std::vector<std::vector<Row::cell_type>> data (m_columns.size());
+  for (auto& column_data : data) {
+    column_data.reserve(count);
+  }
+  std::size_t batch_first = 0;
+  for (auto& batch : m_batches) {
+    std::size_t batch_end = batch_first + batch.rows;
+    std::size_t first = std::max(batch_first, m_current_row);
+    std::size_t end = std::min(batch_end, m_current_row + count);
+    if (first < end) {
+      for (std::size_t i = 0; i < m_columns.size(); ++i) {
+        decodeArrowCells(m_schema->columns[m_columns[i]], batch.columns[m_columns[i]],
+                         first - batch_first, end - first, data[i]);
+      }
+    }
+    batch_first = batch_end;
+  }
+  m_current_row += count;
+
+  std::vector<Row> row_list;
+  row_list.reserve(count);
+  for (std::size_t r = 0; r < count; ++r) {
+    std::vector<Row::cell_type> cells {};
+    cells.reserve(data.size());
+    for (auto& column_data : data) {
+      cells.push_back(std::move(column_data[r]));
+    }
+    row_list.emplace_back(std::move(cells), m_column_info);
+  }
+  return Table{std::move(row_list)};
+}
+
+void ArrowReader::skip(long rows) {
+  m_reading_started = true;
+  m_current_row = std::min(m_total_rows, m_current_row + static_cast<std::size_t>(rows));
+}
+
+bool ArrowReader::hasMoreRows() {
+  return m_current_row < m_total_rows;
+}
+
+std::size_t ArrowReader::rowsLeft() {
+  return m_total_rows - m_current_row;
+}
+
+} // Table namespace
+} // Euclid namespace
@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/ArrowWriter.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "ElementsKernel/Exception.h"
+#include "AlexandriaKernel/memory_tools.h"
+#include "Table/ArrowWriter.h"
+#include "ArrowHelper.h"
+
+namespace Euclid {
+namespace Table {
+
+namespace {
+
+// The size of the footer length and the magic at the end of the file
+const std::size_t trailer_size = 4 + arrow_magic_size;
+
+// The marker at the end of the record batches
+const char end_of_stream[8] = {'\xFF', '\xFF', '\xFF', '\xFF', 0, 0, 0, 0};
+
+bool sameColumns(const std::vector<ArrowColumn>& first, const std::vector<ArrowColumn>& second) {
+  if (first.size() != second.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < first.size(); ++i) {
+    if (first[i].description != second[i].description || first[i].layout != second[i].layout
+        || first[i].value_type != second[i].value_type || first[i].shape != second[i].shape) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Reads the footer of an existing file, without reading its data. The end of
+// the data is returned via the data_end parameter.
+std::pair<ArrowSchema, std::vector<ArrowBlock>> readExistingFooter(std::fstream& stream,
+                                                                   const std::string& filename,
+                                                                   std::uint64_t& file_size,
+                                                                   std::uint64_t& data_end) {
+  stream.seekg(0, std::ios::end);
+  file_size = stream.tellg();
+  if (file_size < 8 + trailer_size) {
+    throw Elements::Exception() << "File " << filename << " is not an Arrow file";
+  }
+  std::vector<char> trailer (trailer_size);
+  stream.seekg(file_size - trailer_size);
+  stream.read(trailer.data(), trailer.size());
+  std::int32_t footer_size;
+  std::memcpy(&footer_size, trailer.data(), sizeof(footer_size));
+  if (!stream || footer_size <= 0 || static_cast<std::uint64_t>(footer_size) > file_size - 8 - trailer_size) {
+    throw Elements::Exception() << "File " << filename << " is not an Arrow file";
+  }
+
+  // The footer is decoded from a buffer with the same layout as a file
+  // without any messages
+  std::vector<char> buffer (8 + footer_size + trailer_size);
+  std::memcpy(buffer.data(), arrow_magic, arrow_magic_size);
+  stream.seekg(file_size - trailer_size - footer_size);
+  stream.read(buffer.data() + 8, footer_size);
+  std::memcpy(buffer.data() + 8 + footer_size, trailer.data(), trailer.size());
+  if (!stream) {
+    throw Elements::Exception() << "Failed to read the footer of file " << filename;
+  }
+  auto footer = decodeFooter(buffer.data(), buffer.size());
+
+  // The data end after the last record batch, or after the schema message if
+  // there are no record batches
+  data_end = 0;
+  for (auto& block : footer.second) {
+    data_end = std::max<std::uint64_t>(data_end, block.offset + block.metadata_length + block.body_length);
+  }
+  if (footer.second.empty()) {
+    char prefix[8];
+    stream.seekg(8);
+    stream.read(prefix, sizeof(prefix));
+    std::uint32_t continuation;
+    std::int32_t metadata_size;
+    std::memcpy(&continuation, prefix, sizeof(continuation));
+    std::memcpy(&metadata_size, prefix + (continuation == 0xFFFFFFFF ? 4 : 0), sizeof(metadata_size));
+    data_end = 8 + (continuation == 0xFFFFFFFF ? 8 : 4) + metadata_size;
+  }
+  if (!stream || data_end > file_size - trailer_size - footer_size) {
+    throw Elements::Exception() << "File " << filename << " is not a valid Arrow file";
+  }
+  return footer;
+}
+
+}
+
+ArrowWriter::ArrowWriter(const std::string& filename, bool override_flag)
+        : m_filename(filename), m_override_file(override_flag) {
+}
+
+ArrowWriter::ArrowWriter(ArrowWriter&&) = default;
+
+ArrowWriter& ArrowWriter::operator=(ArrowWriter&&) = default;
+
+ArrowWriter::~ArrowWriter() = default;
+
+void ArrowWriter::addComment(const std::string& comment) {
+  if (!m_comment.empty()) {
+    m_comment += '\n';
+  }
+  m_comment += comment;
+  if (m_stream.is_open()) {
+    writeFooter();
+  }
+}
+
+void ArrowWriter::init(const Table& table) {
+  auto schema = arrowSchemaFor(table);
+
+  if (!m_override_file && std::ifstream{m_filename}.good()) {
+    m_stream.open(m_filename, std::ios::in | std::ios::out | std::ios::binary);
+    if (!m_stream) {
+      throw Elements::Exception() << "Failed to open file " << m_filename;
+    }
+    auto existing = readExistingFooter(m_stream, m_filename, m_file_end, m_data_end);
+    if (!sameColumns(existing.first.columns, schema.columns)) {
+      throw Elements::Exception() << "File " << m_filename << " contains a table with different columns";
+    }
+    if (!m_comment.empty() && !existing.first.comment.empty()) {
+      m_comment = existing.first.comment + '\n' + m_comment;
+    } else if (m_comment.empty()) {
+      m_comment = existing.first.comment;
+    }
+    m_schema = make_unique<ArrowSchema>(std::move(existing.first));
+    m_blocks = std::move(existing.second);
+    return;
+  }
+
+  m_stream.open(m_filename, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_stream) {
+    throw Elements::Exception() << "Failed to open file " << m_filename << " for writing";
+  }
+  schema.comment = m_comment;
+  m_schema = make_unique<ArrowSchema>(std::move(schema));
+  auto schema_message = encodeSchemaMessage(*m_schema);
+  const char header[8] = {'A', 'R', 'R', 'O', 'W', '1', 0, 0};
+  m_stream.write(header, sizeof(header));
+  m_stream.write(schema_message.data(), schema_message.size());
+  m_data_end = sizeof(header) + schema_message.size();
+  writeFooter();
+}
+
+void ArrowWriter::append(const Table& table) {
+  std::string body {};
+  auto metadata = encodeRecordBatch(table, *m_schema, body);
+  m_stream.seekp(m_data_end);
+  m_stream.write(metadata.data(), metadata.size());
+  m_stream.write(body.data(), body.size());
+  m_blocks.push_back(ArrowBlock {static_cast<std::int64_t>(m_data_end),
+                                 static_cast<std::int32_t>(metadata.size()),
+                                 static_cast<std::int64_t>(body.size())});
+  m_data_end += metadata.size() + body.size();
+  writeFooter();
+}
+
+void ArrowWriter::writeFooter() {
+  m_schema->comment = m_comment;
+  auto footer = encodeFooter(*m_schema, m_blocks);
+  // The file cannot be truncated, so if the new footer is smaller than what
+  // was already there, it is preceded by padding which readers ignore
+  std::uint64_t end = m_data_end + sizeof(end_of_stream) + footer.size() + trailer_size;
+  std::string padding (end < m_file_end ? (m_file_end - end + 7) / 8 * 8 : 0, '\0');
+  std::int32_t footer_size = footer.size();
+  m_stream.seekp(m_data_end);
+  m_stream.write(end_of_stream, sizeof(end_of_stream));
+  m_stream.write(padding.data(), padding.size());
+  m_stream.write(footer.data(), footer.size());
+  m_stream.write(reinterpret_cast<const char*>(&footer_size), sizeof(footer_size));
+  m_stream.write(arrow_magic, arrow_magic_size);
+  m_stream.flush();
+  if (!m_stream) {
+    throw Elements::Exception() << "Failed to write to file " << m_filename;
+  }
+  m_file_end = std::max(m_file_end, end + padding.size());
+}
+
+} // Table namespace
+} // Euclid namespace
@@ -22,7 +22,11 @@
  * @author nikoapos
  */
 
+#include <algorithm>
+#include <cctype>
 #include <fstream>
+#include <limits>
+#include <map>
 #include <set>
 // The std regex library is not fully implemented in GCC 4.8. The following lines
 // make use of the BOOST library and can be modified if GCC 4.9 will be used in
@@ -34,7 +38,9 @@ using boost::regex_match;
 #include <boost/algorithm/string.hpp>
 
 #include "ElementsKernel/Exception.h"
+#include "AlexandriaKernel/memory_tools.h"
 #include "Table/AsciiReader.h"
+#include "Table/CompressedStream.h"
 
 #include "ReaderHelper.h"
 #include "AsciiReaderHelper.h"
@@ -45,11 +51,20 @@ namespace Table {
 AsciiReader::AsciiReader(std::istream& stream) : AsciiReader(InstOrRefHolder<std::istream>::create(stream)) {
 }
 
-AsciiReader::AsciiReader(const std::string& filename) : AsciiReader(create<std::ifstream>(filename)) {
+static std::unique_ptr<InstOrRefHolder<std::istream>> openFile(const std::string& filename) {
+  // Files which cannot be opened are handled by the std::ifstream, so the
+  // errors are reported when reading starts
+  if (std::ifstream{filename} && detectCompression(filename) != Compression::NONE) {
+    return InstOrRefHolder<std::istream>::create<CompressedIStream>(filename);
+  }
+  return InstOrRefHolder<std::istream>::create<std::ifstream>(filename);
+}
+
+AsciiReader::AsciiReader(const std::string& filename) : AsciiReader(openFile(filename)) {
 }
 
 AsciiReader::AsciiReader(std::unique_ptr<InstOrRefHolder<std::istream>> stream_holder)
-        : m_stream_holder(std::move(stream_holder)) {
+        : m_stream_holder(std::move(stream_holder)), m_stream_start(m_stream_holder->ref().tellg()) {
 }
 
 AsciiReader& AsciiReader::setCommentIndicator(const std::string& indicator) {
@@ -64,6 +79,21 @@ AsciiReader& AsciiReader::setCommentIndicator(const std::string& indicator) {
   return *this;
 }
 
+AsciiReader& AsciiReader::setNullTokens(std::vector<std::string> tokens) {
+  if (m_reading_started) {
+    throw Elements::Exception() << "Setting the null tokens after reading "
+            << "has started is not allowed";
+  }
+  for (auto& token : tokens) {
+    if (token.empty() || std::any_of(token.begin(), token.end(),
+                                     [](char c) { return std::isspace(static_cast<unsigned char>(c)); })) {
+      throw Elements::Exception() << "Null token '" << token << "' is empty or contains whitespaces";
+    }
+  }
+  m_null_tokens = std::move(tokens);
+  return *this;
+}
+
 AsciiReader& AsciiReader::fixColumnNames(std::vector<std::string> column_names) {
   if (m_reading_started) {
     throw Elements::Exception() << "Fixing the column names after reading "
@@ -110,6 +140,115 @@ AsciiReader& AsciiReader::fixColumnTypes(std::vector<std::type_index> column_typ
   return *this;
 }
 
+AsciiReader& AsciiReader::inferColumnTypes(std::size_t sample_rows) {
+  if (m_reading_started) {
+    throw Elements::Exception() << "Enabling the type inference after reading "
+            << "has started is not allowed";
+  }
+  if (sample_rows == 0) {
+    throw Elements::Exception() << "Type inference needs at least one sample row";
+  }
+  m_inference_rows = sample_rows;
+  return *this;
+}
+
+AsciiReader& AsciiReader::useRowIndex(std::size_t sampling) {
+  if (m_reading_started) {
+    throw Elements::Exception() << "Enabling the row index after reading "
+            << "has started is not allowed";
+  }
+  if (sampling == 0) {
+    throw Elements::Exception() << "Row index sampling must be a positive number";
+  }
+  m_row_index_sampling = sampling;
+  return *this;
+}
+
+AsciiReader& AsciiReader::setFilter(Filter filter) {
+  if (m_reading_started) {
+    throw Elements::Exception() << "Setting the filter after reading "
+            << "has started is not allowed";
+  }
+  m_filter = make_unique<Filter>(std::move(filter));
+  return *this;
+}
+
+AsciiReader& AsciiReader::loadRowIndex(const std::string& filename) {
+  std::ifstream file {filename};
+  if (!file) {
+    throw Elements::Exception() << "Failed to open row index file " << filename;
+  }
+  auto index = std::make_shared<AsciiRowIndex>(readRowIndex(file));
+  
+  // We use the length of the stream to detect indices which do not belong to it
+  auto& in = m_stream_holder->ref();
+  in.clear();
+  std::streamoff end;
+  {
+    StreamRewinder rewinder {in};
+    in.seekg(0, std::ios::end);
+    end = in.tellg();
+  }
+  if (index->end != end) {
+    throw Elements::Exception() << "Row index " << filename << " was created for "
+            << "a stream of " << index->end << " characters but the stream has "
+            << end;
+  }
+  
+  m_row_index_sampling = index->sampling;
+  m_row_index = std::move(index);
+  return *this;
+}
+
+void AsciiReader::saveRowIndex(const std::string& filename) {
+  const auto& index = rowIndex();
+  std::ofstream file {filename};
+  writeRowIndex(file, index);
+  if (!file) {
+    throw Elements::Exception() << "Failed to write row index file " << filename;
+  }
+}
+
+const AsciiRowIndex& AsciiReader::rowIndex() {
+  m_reading_started = true;
+  if (m_row_index == nullptr) {
+    if (m_row_index_sampling == 0) {
+      m_row_index_sampling = 1024;
+    }
+    // The rows are counted from the beginning of the stream, so we index it
+    // from there and we return back to the current position
+    auto& in = m_stream_holder->ref();
+    in.clear();
+    StreamRewinder rewinder {in};
+    in.seekg(m_stream_start);
+    m_row_index = std::make_shared<AsciiRowIndex>(buildRowIndex(in, m_comment, m_row_index_sampling));
+  } else if (m_row_index->comment != m_comment) {
+    throw Elements::Exception() << "Row index was created with comment indicator '"
+            << m_row_index->comment << "' instead of '" << m_comment << "'";
+  }
+  return *m_row_index;
+}
+
+void AsciiReader::seekRow(std::size_t row) {
+  m_filtered_ahead.reset();
+  const auto& index = rowIndex();
+  auto& in = m_stream_holder->ref();
+  if (row >= index.rows) {
+    in.clear();
+    in.seekg(index.end);
+    m_current_row = index.rows;
+    return;
+  }
+  // We jump only if the closest indexed row is not behind the current position
+  std::size_t indexed_row = row - row % index.sampling;
+  if (row < m_current_row || indexed_row > m_current_row) {
+    in.clear();
+    in.seekg(index.offsets[row / index.sampling]);
+    m_current_row = indexed_row;
+  }
+  skipLines(row - m_current_row);
+}
+
 void AsciiReader::readColumnInfo() {
   if (m_column_info != nullptr) {
     return;
@@ -132,6 +271,10 @@ void AsciiReader::readColumnInfo() {
   
   auto auto_names = autoDetectColumnNames(in, m_comment, columns_number);
   auto auto_desc = autoDetectColumnDescriptions(in, m_comment);
+  std::vector<std::type_index> inferred_types {};
+  if (m_inference_rows != 0 && m_column_types.empty()) {
+    inferred_types = autoDetectColumnTypes(in, m_comment, columns_number, m_inference_rows, m_null_tokens);
+  }
   
   std::vector<std::string> names {};
   std::vector<std::type_index> types {};
@@ -153,7 +296,9 @@ void AsciiReader::readColumnInfo() {
       units.emplace_back(info->second.unit);
       descriptions.emplace_back(info->second.description);
     } else {
-      if (m_column_types.empty()) {
+      if (!inferred_types.empty()) {
+        types.emplace_back(inferred_types[i]);
+      } else if (m_column_types.empty()) {
         types.emplace_back(typeid(std::string));
       } else {
         types.emplace_back(m_column_types[i]);
@@ -200,9 +345,13 @@ std::string AsciiReader::getComment() {
 
 Table AsciiReader::readImpl(long rows) {
   readColumnInfo();
+  if (m_filter != nullptr) {
+    return readFiltered(rows);
+  }
   auto& in = m_stream_holder->ref();
   
   std::vector<Row> row_list;
+  std::vector<std::vector<std::size_t>> null_rows (m_column_info->size());
   regex column_separator {"\\s+"};
   while(in && rows != 0) {
     std::string line;
@@ -214,6 +363,7 @@ Table AsciiReader::readImpl(long rows) {
     boost::trim(line);
     if (!line.empty()) {
       --rows;
+      ++m_current_row;
       boost::sregex_token_iterator i (line.begin(), line.end(), column_separator, -1);
       boost::sregex_token_iterator j;
       size_t count {0};
@@ -222,7 +372,11 @@ Table AsciiReader::readImpl(long rows) {
         if (count >= m_column_info->size()) {
           throw Elements::Exception() << "Line with wrong number of cells: " << line;
         }
-        values.push_back(convertToCellType(*i, m_column_info->getDescription(count).type));
+        bool is_null = false;
+        values.push_back(convertCell(*i, count, is_null));
+        if (is_null) {
+          null_rows[count].push_back(row_list.size());
+        }
         ++count;
         ++i;
       }
@@ -233,33 +387,330 @@ Table AsciiReader::readImpl(long rows) {
   if (row_list.empty()) {
     throw Elements::Exception() << "No more table rows left";
   }
-  return Table{std::move(row_list)};
+  auto validity = createValidityBitmaps(null_rows, row_list.size());
+  return Table{std::move(row_list), std::move(validity)};
 }
 
-void AsciiReader::skip(long rows) {
-  readColumnInfo();
-  auto& in = m_stream_holder->ref();
-  
-  while(in && rows != 0) {
-    std::string line;
+// The values stored in the cells of the missing values. The strings keep the
+// token, because empty string cells are not allowed.
+static Row::cell_type _nullCell(std::type_index type, const std::string& token) {
+  if (type == typeid(bool)) {
+    return Row::cell_type {false};
+  } else if (type == typeid(int32_t)) {
+    return Row::cell_type {int32_t{0}};
+  } else if (type == typeid(int64_t)) {
+    return Row::cell_type {int64_t{0}};
+  } else if (type == typeid(float)) {
+    return Row::cell_type {std::numeric_limits<float>::quiet_NaN()};
+  } else if (type == typeid(double)) {
+    return Row::cell_type {std::numeric_limits<double>::quiet_NaN()};
+  }
+  return Row::cell_type {token};
+}
+
+bool AsciiReader::isNullToken(const std::string& token, std::type_index type) const {
+  return (isNullableType(type) || type == typeid(bool) || type == typeid(std::string))
+         && std::find(m_null_tokens.begin(), m_null_tokens.end(), token) != m_null_tokens.end();
+}
+
+Row::cell_type AsciiReader::convertCell(const std::string& token, std::size_t column, bool& is_null) const {
+  auto& type = m_column_info->getDescription(column).type;
+  if (isNullToken(token, type)) {
+    is_null = true;
+    return _nullCell(type, token);
+  }
+  auto cell = convertToCellType(token, type);
+  is_null = isNullableType(type) && isNullCell(cell, boost::none);
+  return cell;
+}
+
+// Reads the next line containing data, without its comment and the leading and
+// trailing whitespaces. Returns false if the stream ends before such a line.
+static bool _nextDataLine(std::istream& in, const std::string& comment, std::string& line) {
+  while (in) {
     getline(in, line);
-    size_t comment_pos = line.find(m_comment);
+    size_t comment_pos = line.find(comment);
     if (comment_pos != std::string::npos) {
       line = line.substr(0, comment_pos);
     }
     boost::trim(line);
     if (!line.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// The number of lines scanned at once when reading all the rows passing a filter
+static const std::size_t filter_chunk_rows = 4096;
+
+Table AsciiReader::readFiltered(long rows) {
+  std::vector<Table> parts {};
+  long read_rows = 0;
+  if (m_filtered_ahead != nullptr) {
+    if (rows >= 0 && static_cast<long>(m_filtered_ahead->size()) > rows) {
+      auto result = m_filtered_ahead->slice(0, rows);
+      *m_filtered_ahead = m_filtered_ahead->slice(rows, m_filtered_ahead->size());
+      return result;
+    }
+    read_rows = m_filtered_ahead->size();
+    parts.push_back(std::move(*m_filtered_ahead));
+    m_filtered_ahead.reset();
+  }
+  if (rows < 0 || read_rows < rows) {
+    auto rest = scanFiltered(rows < 0 ? -1 : rows - read_rows, false);
+    if (rest != nullptr) {
+      parts.push_back(std::move(*rest));
+    }
+  }
+  if (parts.empty()) {
+    throw Elements::Exception() << "No more table rows left";
+  }
+  if (parts.size() == 1) {
+    return std::move(parts.front());
+  }
+  return Table{parts};
+}
+
+std::unique_ptr<Table> AsciiReader::scanFiltered(long rows, bool first_match) {
+  auto& in = m_stream_holder->ref();
+
+  std::vector<std::size_t> filter_columns {};
+  for (auto& name : m_filter->getColumns()) {
+    auto index = m_column_info->findIndex(name);
+    if (!index) {
+      throw Elements::Exception() << "Filter column " << name << " does not exist";
+    }
+    filter_columns.push_back(*index);
+  }
+
+  std::vector<Row> row_list;
+  std::vector<std::vector<std::size_t>> null_rows (m_column_info->size());
+  regex column_separator {"\\s+"};
+  std::string line;
+  bool is_null = false;
+  while ((rows < 0 || row_list.size() < static_cast<std::size_t>(rows)) && in
+         && !(first_match && !row_list.empty())) {
+    // The lines are always scanned in chunks of the same size. The selected
+    // rows of the last chunk which are not requested are kept for the next
+    // read, because their lines are already consumed.
+    std::vector<std::vector<std::string>> chunk {};
+    while (chunk.size() < filter_chunk_rows && _nextDataLine(in, m_comment, line)) {
+      ++m_current_row;
+      std::vector<std::string> tokens {
+        boost::sregex_token_iterator(line.begin(), line.end(), column_separator, -1),
+        boost::sregex_token_iterator()
+      };
+      if (tokens.size() != m_column_info->size()) {
+        throw Elements::Exception() << "Line with wrong number of cells: " << line;
+      }
+      chunk.push_back(std::move(tokens));
+    }
+
+    // Only the cells of the filter columns are converted for all the lines.
+    // The missing values are marked, so they do not pass the filter.
+    std::map<std::string, Filter::column_values> values {};
+    std::map<std::string, ValidityBitmap> validity {};
+    for (auto index : filter_columns) {
+      auto& description = m_column_info->getDescription(index);
+      std::vector<Row::cell_type> cells {};
+      std::vector<std::size_t> null_cells {};
+      cells.reserve(chunk.size());
+      for (auto& tokens : chunk) {
+        cells.push_back(convertCell(tokens[index], index, is_null));
+        if (is_null) {
+          null_cells.push_back(cells.size() - 1);
+        }
+      }
+      values.emplace(description.name, Filter::toColumnValues(description.type, cells));
+      if (!null_cells.empty()) {
+        auto bitmap = validity.emplace(description.name, ValidityBitmap{chunk.size()}).first;
+        for (auto i : null_cells) {
+          bitmap->second.setValid(i, false);
+        }
+      }
+    }
+    auto mask = m_filter->evaluate(values, chunk.size(), validity);
+
+    for (std::size_t i = 0; i < chunk.size(); ++i) {
+      if (!mask[i]) {
+        continue;
+      }
+      std::vector<Row::cell_type> cells {};
+      cells.reserve(chunk[i].size());
+      for (std::size_t column = 0; column < chunk[i].size(); ++column) {
+        cells.push_back(convertCell(chunk[i][column], column, is_null));
+        if (is_null) {
+          null_rows[column].push_back(row_list.size());
+        }
+      }
+      row_list.emplace_back(std::move(cells), m_column_info);
+    }
+  }
+
+  if (row_list.empty()) {
+    return nullptr;
+  }
+  auto validity = createValidityBitmaps(null_rows, row_list.size());
+  auto table = make_unique<Table>(std::move(row_list), std::move(validity));
+  if (rows >= 0 && table->size() > static_cast<std::size_t>(rows)) {
+    m_filtered_ahead = make_unique<Table>(table->slice(rows, table->size()));
+    *table = table->slice(0, rows);
+  }
+  return table;
+}
+
+Table AsciiReader::readRows(std::size_t first, long rows) {
+  readColumnInfo();
+  if (first >= rowIndex().rows) {
+    throw Elements::Exception() << "Row " << first << " is out of range ("
+            << rowIndex().rows << " rows)";
+  }
+  seekRow(first);
+  return readImpl(rows);
+}
+
+void AsciiReader::skipLines(long rows) {
+  auto& in = m_stream_holder->ref();
+  std::string line;
+  while(in && rows != 0) {
+    getline(in, line);
+    if (isDataLine(line, m_comment)) {
       --rows;
+      ++m_current_row;
+    }
+  }
+}
+
+void AsciiReader::skip(long rows) {
+  readColumnInfo();
+  if (m_filter != nullptr && rows >= 0) {
+    while (rows > 0 && hasMoreRows()) {
+      rows -= readFiltered(rows).size();
     }
+    return;
+  }
+  m_filtered_ahead.reset();
+  if (m_row_index_sampling != 0) {
+    seekRow(rows < 0 ? rowIndex().rows : m_current_row + rows);
+  } else {
+    skipLines(rows);
   }
 }
 
 bool AsciiReader::hasMoreRows() {
+  if (m_filter != nullptr) {
+    readColumnInfo();
+    if (m_filtered_ahead == nullptr) {
+      m_filtered_ahead = scanFiltered(-1, true);
+    }
+    return m_filtered_ahead != nullptr;
+  }
+  if (m_row_index_sampling != 0) {
+    return m_current_row < rowIndex().rows;
+  }
   return hasNextRow(m_stream_holder->ref(), m_comment);
 }
 
 std::size_t AsciiReader::rowsLeft() {
-  return countRemainingRows(m_stream_holder->ref(), m_comment);
+  std::size_t ahead = (m_filtered_ahead != nullptr) ? m_filtered_ahead->size() : 0;
+  if (m_row_index_sampling != 0) {
+    return ahead + rowIndex().rows - m_current_row;
+  }
+  return ahead + countRemainingRows(m_stream_holder->ref(), m_comment);
+}
+
+std::size_t AsciiReader::readColumns(long rows) {
+  readColumnInfo();
+  if (m_filter != nullptr) {
+    throw Elements::Exception() << "Reading columns is not supported when a filter is set";
+  }
+  auto& in = m_stream_holder->ref();
+
+  m_column_tokens.clear();
+  regex column_separator {"\\s+"};
+  std::string line;
+  while (rows != 0 && _nextDataLine(in, m_comment, line)) {
+    --rows;
+    ++m_current_row;
+    std::vector<std::string> tokens {
+      boost::sregex_token_iterator(line.begin(), line.end(), column_separator, -1),
+      boost::sregex_token_iterator()
+    };
+    if (tokens.size() != m_column_info->size()) {
+      throw Elements::Exception() << "Line with wrong number of cells: " << line;
+    }
+    m_column_tokens.push_back(std::move(tokens));
+  }
+  return m_column_tokens.size();
+}
+
+template <typename T, typename C>
+static void _convertTokens(const std::vector<std::vector<std::string>>& rows, std::size_t index,
+                           std::vector<T>& values, const std::vector<std::string>& null_tokens) {
+  values.resize(rows.size());
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    auto& token = rows[i][index];
+    if (std::find(null_tokens.begin(), null_tokens.end(), token) != null_tokens.end()) {
+      values[i] = static_cast<T>(boost::get<C>(_nullCell(typeid(C), token)));
+    } else {
+      values[i] = static_cast<T>(convertToValue<C>(token));
+    }
+  }
+}
+
+template <typename T>
+void AsciiReader::convertColumn(std::size_t index, std::vector<T>& values) {
+  readColumnInfo();
+  auto& description = m_column_info->getDescription(index);
+  if (description.type == typeid(bool)) {
+    _convertTokens<T, bool>(m_column_tokens, index, values, m_null_tokens);
+  } else if (description.type == typeid(int32_t)) {
+    _convertTokens<T, int32_t>(m_column_tokens, index, values, m_null_tokens);
+  } else if (description.type == typeid(int64_t)) {
+    _convertTokens<T, int64_t>(m_column_tokens, index, values, m_null_tokens);
+  } else if (description.type == typeid(float)) {
+    _convertTokens<T, float>(m_column_tokens, index, values, m_null_tokens);
+  } else if (description.type == typeid(double)) {
+    _convertTokens<T, double>(m_column_tokens, index, values, m_null_tokens);
+  } else {
+    throw Elements::Exception() << "Column " << description.name << " of type "
+                                << description.type.name() << " cannot be read as "
+                                << typeid(T).name();
+  }
+}
+
+void AsciiReader::getColumn(std::size_t index, std::vector<bool>& values) {
+  convertColumn(index, values);
+}
+
+void AsciiReader::getColumn(std::size_t index, std::vector<int32_t>& values) {
+  convertColumn(index, values);
+}
+
+void AsciiReader::getColumn(std::size_t index, std::vector<int64_t>& values) {
+  convertColumn(index, values);
+}
+
+void AsciiReader::getColumn(std::size_t index, std::vector<float>& values) {
+  convertColumn(index, values);
+}
+
+void AsciiReader::getColumn(std::size_t index, std::vector<double>& values) {
+  convertColumn(index, values);
+}
+
+void AsciiReader::getColumn(std::size_t index, std::vector<std::string>& values) {
+  readColumnInfo();
+  auto& description = m_column_info->getDescription(index);
+  if (description.type != typeid(std::string)) {
+    throw Elements::Exception() << "Column " << description.name << " of type "
+                                << description.type.name() << " cannot be read as string";
+  }
+  values.resize(m_column_tokens.size());
+  for (std::size_t i = 0; i < m_column_tokens.size(); ++i) {
+    values[i] = m_column_tokens[i][index];
+  }
 }
 
 } // Table namespace
@@ -22,6 +22,10 @@
  * @author Nikolaos Apostolakos
  */
 
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
 #include <set>
 #include <sstream>
 #include <boost/regex.hpp>
@@ -254,6 +258,137 @@ std::vector<std::string> autoDetectColumnNames(std::istream& in,
 
 namespace {
 
+// Flags of the types a value can be converted to without loss of information
+enum : unsigned {
+  BOOL_FLAG = 1, INT32_FLAG = 2, INT64_FLAG = 4, FLOAT_FLAG = 8, DOUBLE_FLAG = 16
+};
+
+// Returns the number of significant digits of a number in decimal notation
+std::size_t significantDigits(const std::string& value) {
+  std::string digits {};
+  for (auto c : value) {
+    if (c == 'e' || c == 'E') {
+      break;
+    }
+    if (std::isdigit(static_cast<unsigned char>(c))) {
+      digits.push_back(c);
+    }
+  }
+  auto first = digits.find_first_not_of('0');
+  if (first == std::string::npos) {
+    return 0;
+  }
+  return digits.find_last_not_of('0') - first + 1;
+}
+
+unsigned compatibleTypes(const std::string& value) {
+  if (value == "true" || value == "t" || value == "yes" || value == "y" ||
+      value == "false" || value == "f" || value == "no" || value == "n") {
+    return BOOL_FLAG;
+  }
+  int64_t int_value;
+  if (boost::conversion::try_lexical_convert(value, int_value)) {
+    unsigned flags = INT64_FLAG | DOUBLE_FLAG;
+    if (int_value >= std::numeric_limits<int32_t>::min() &&
+        int_value <= std::numeric_limits<int32_t>::max()) {
+      flags |= INT32_FLAG;
+    }
+    // Integers up to 2^24 are exactly representable as float
+    if (int_value >= -(1 << 24) && int_value <= (1 << 24)) {
+      flags |= FLOAT_FLAG;
+    }
+    return flags;
+  }
+  double double_value;
+  if (!boost::conversion::try_lexical_convert(value, double_value)) {
+    return 0;
+  }
+  unsigned flags = DOUBLE_FLAG;
+  float float_value;
+  if (boost::conversion::try_lexical_convert(value, float_value) &&
+      std::isfinite(float_value) == std::isfinite(double_value) &&
+      significantDigits(value) <= std::numeric_limits<float>::digits10) {
+    flags |= FLOAT_FLAG;
+  }
+  return flags;
+}
+
+std::type_index narrowestType(unsigned flags, bool vector) {
+  if (flags & BOOL_FLAG) {
+    return vector ? typeid(std::vector<bool>) : typeid(bool);
+  }
+  if (flags & INT32_FLAG) {
+    return vector ? typeid(std::vector<int32_t>) : typeid(int32_t);
+  }
+  if (flags & INT64_FLAG) {
+    return vector ? typeid(std::vector<int64_t>) : typeid(int64_t);
+  }
+  if (flags & FLOAT_FLAG) {
+    return vector ? typeid(std::vector<float>) : typeid(float);
+  }
+  if (flags & DOUBLE_FLAG) {
+    return vector ? typeid(std::vector<double>) : typeid(double);
+  }
+  return typeid(std::string);
+}
+
+} // end of anonymous namespace
+
+std::vector<std::type_index> autoDetectColumnTypes(std::istream& in,
+                                                   const std::string& comment,
+                                                   size_t columns_number,
+                                                   std::size_t sample_rows,
+                                                   const std::vector<std::string>& null_tokens) {
+  StreamRewinder rewinder {in};
+  // Columns without any sampled value are kept as strings
+  std::vector<unsigned> flags (columns_number, 0);
+  std::vector<bool> sampled (columns_number, false);
+  std::vector<bool> vectors (columns_number, false);
+  regex column_separator {"\\s+"};
+  std::size_t rows = 0;
+  while (in && rows < sample_rows) {
+    std::string line;
+    getline(in, line);
+    size_t comment_pos = line.find(comment);
+    if (comment_pos != std::string::npos) {
+      line = line.substr(0, comment_pos);
+    }
+    boost::trim(line);
+    if (line.empty()) {
+      continue;
+    }
+    ++rows;
+    boost::sregex_token_iterator i (line.begin(), line.end(), column_separator, -1);
+    boost::sregex_token_iterator j;
+    for (size_t column = 0; i != j && column < columns_number; ++i, ++column) {
+      std::string cell = *i;
+      if (std::find(null_tokens.begin(), null_tokens.end(), cell) != null_tokens.end()) {
+        continue;
+      }
+      unsigned cell_flags = BOOL_FLAG | INT32_FLAG | INT64_FLAG | FLOAT_FLAG | DOUBLE_FLAG;
+      if (cell.find(',') != std::string::npos) {
+        vectors[column] = true;
+        boost::char_separator<char> sep {","};
+        boost::tokenizer< boost::char_separator<char> > tok {cell, sep};
+        for (auto& element : tok) {
+          cell_flags &= compatibleTypes(element);
+        }
+      } else {
+        cell_flags = compatibleTypes(cell);
+      }
+      flags[column] = sampled[column] ? flags[column] & cell_flags : cell_flags;
+      sampled[column] = true;
+    }
+  }
+  std::vector<std::type_index> types {};
+  for (size_t column = 0; column < columns_number; ++column) {
+    types.push_back(narrowestType(flags[column], vectors[column]));
+  }
+  return types;
+}
+
+namespace {
+
 template <typename T>
 std::vector<T> convertStringToVector(const std::string& str) {
   std::vector<T> result {};
@@ -289,23 +424,43 @@ NdArray<T> convertStringToNdArray(const std::string& str) {
 
 }
 
+template <typename T>
+T convertToValue(const std::string& value) {
+  try {
+    return boost::lexical_cast<T>(value);
+  } catch( boost::bad_lexical_cast const& ) {
+    throw Elements::Exception() << "Cannot convert " << value << " to " << typeid(T).name();
+  }
+}
+
+template <>
+bool convertToValue<bool>(const std::string& value) {
+  if (value == "true" || value == "t" || value == "yes" || value == "y" || value == "1") {
+    return true;
+  }
+  if (value == "false" || value == "f" || value == "no" || value == "n" || value == "0") {
+    return false;
+  }
+  throw Elements::Exception() << "Cannot convert " << value << " to " << typeid(bool).name();
+}
+
+template int32_t convertToValue<int32_t>(const std::string&);
+template int64_t convertToValue<int64_t>(const std::string&);
+template float convertToValue<float>(const std::string&);
+template double convertToValue<double>(const std::string&);
+
 Row::cell_type convertToCellType(const std::string& value, std::type_index type) {
   try {
     if (type == typeid(bool)) {
-      if (value == "true" || value == "t" || value == "yes" || value == "y" || value == "1") {
-        return Row::cell_type {true};
-      }
-      if (value == "false" || value == "f" || value == "no" || value == "n" || value == "0") {
-        return Row::cell_type {false};
-      }
+      return Row::cell_type {convertToValue<bool>(value)};
     } else if (type == typeid(int32_t)) {
-      return Row::cell_type {boost::lexical_cast<int32_t>(value)};
+      return Row::cell_type {convertToValue<int32_t>(value)};
     } else if (type == typeid(int64_t)) {
-      return Row::cell_type {boost::lexical_cast<int64_t>(value)};
+      return Row::cell_type {convertToValue<int64_t>(value)};
     } else if (type == typeid(float)) {
-      return Row::cell_type {boost::lexical_cast<float>(value)};
+      return Row::cell_type {convertToValue<float>(value)};
     } else if (type == typeid(double)) {
-      return Row::cell_type {boost::lexical_cast<double>(value)};
+      return Row::cell_type {convertToValue<double>(value)};
     } else if (type == typeid(std::string)) {
       return Row::cell_type {boost::lexical_cast<std::string>(value)};
     } else if (type == typeid(std::vector<bool>)) {
@@ -335,17 +490,22 @@ Row::cell_type convertToCellType(const std::string& value, std::type_index type)
   throw Elements::Exception() << "Unknown type name " << type.name();
 }
 
+bool isDataLine(const std::string& line, const std::string& comment) {
+  auto data_end = std::min(line.find(comment), line.size());
+  for (std::size_t i = 0; i < data_end; ++i) {
+    if (!std::isspace(static_cast<unsigned char>(line[i]))) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool hasNextRow(std::istream& in, const std::string& comment) {
   StreamRewinder rewinder {in};
+  std::string line;
   while(in) {
-    std::string line;
     getline(in, line);
-    size_t comment_pos = line.find(comment);
-    if (comment_pos != std::string::npos) {
-      line = line.substr(0, comment_pos);
-    }
-    boost::trim(line);
-    if (!line.empty()) {
+    if (isDataLine(line, comment)) {
       return true;
     }
   }
@@ -355,20 +515,72 @@ bool hasNextRow(std::istream& in, const std::string& comment) {
 std::size_t countRemainingRows(std::istream& in, const std::string& comment) {
   StreamRewinder rewinder {in};
   std::size_t count = 0;
+  std::string line;
   while(in) {
-    std::string line;
     getline(in, line);
-    size_t comment_pos = line.find(comment);
-    if (comment_pos != std::string::npos) {
-      line = line.substr(0, comment_pos);
-    }
-    boost::trim(line);
-    if (!line.empty()) {
+    if (isDataLine(line, comment)) {
       ++count;
     }
   }
   return count;
 }
 
+AsciiRowIndex buildRowIndex(std::istream& in, const std::string& comment,
+                            std::size_t sampling) {
+  if (sampling == 0) {
+    throw Elements::Exception() << "Row index sampling must be a positive number";
+  }
+  StreamRewinder rewinder {in};
+  AsciiRowIndex index {comment, sampling, 0, 0, {}};
+  // We keep track of the offsets ourselves, as calling tellg() for every line
+  // is much slower than just counting the characters
+  std::streamoff offset = in.tellg();
+  std::string line;
+  while (getline(in, line)) {
+    if (isDataLine(line, comment)) {
+      if (index.rows % sampling == 0) {
+        index.offsets.push_back(offset);
+      }
+      ++index.rows;
+    }
+    offset += line.size() + 1;
+  }
+  in.clear();
+  in.seekg(0, std::ios::end);
+  index.end = in.tellg();
+  return index;
+}
+
+void writeRowIndex(std::ostream& out, const AsciiRowIndex& index) {
+  out << "AsciiRowIndex 1\n" << index.comment << '\n'
+      << index.sampling << ' ' << index.rows << ' ' << index.end << '\n';
+  for (auto offset : index.offsets) {
+    out << offset << '\n';
+  }
+}
+
+AsciiRowIndex readRowIndex(std::istream& in) {
+  std::string header;
+  getline(in, header);
+  if (header != "AsciiRowIndex 1") {
+    throw Elements::Exception() << "Stream does not contain an ASCII row index";
+  }
+  AsciiRowIndex index {};
+  getline(in, index.comment);
+  in >> index.sampling >> index.rows >> index.end;
+  if (!in || index.sampling == 0) {
+    throw Elements::Exception() << "Malformed ASCII row index header";
+  }
+  std::size_t offsets_no = (index.rows + index.sampling - 1) / index.sampling;
+  index.offsets.resize(offsets_no);
+  for (auto& offset : index.offsets) {
+    in >> offset;
+  }
+  if (!in) {
+    throw Elements::Exception() << "ASCII row index contains less offsets than expected";
+  }
+  return index;
+}
+
 }
 } // end of namespace Euclid
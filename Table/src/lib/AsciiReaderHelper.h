@@ -26,9 +26,11 @@
 #define TABLE_ASCIIREADERHELPER_H
 
 #include <istream>
+#include <ostream>
 #include <string>
 #include <typeindex>
 #include <map>
+#include <vector>
 
 
 #include "ElementsKernel/Export.h"
@@ -56,7 +58,7 @@ public:
 private:
   std::istream& m_stream;
   std::ios::iostate m_state;
-  int m_position;
+  std::streampos m_position;
 };
 
 /**
@@ -113,6 +115,36 @@ ELEMENTS_API std::vector<std::string> autoDetectColumnNames(std::istream& in,
                                                const std::string& comment,
                                                size_t columns_number);
 
+/**
+ * @brief
+ * Infers the types of the columns by sampling the first data rows
+ * @details
+ * For each column the narrowest type which can represent all the sampled
+ * values is selected, in the order bool, int32, int64, float, double. Only the
+ * words true, t, yes, y, false, f, no and n are considered booleans, so
+ * columns of 0 and 1 are detected as int32. Floating point values are detected
+ * as float only if they have at most 6 significant digits (so they are not
+ * altered by the single precision) and they are in the float range. If any of
+ * the sampled cells of a column contains commas the column is detected as a
+ * vector of the narrowest element type. Columns with values that are not
+ * numbers or booleans (or without any sampled value) are detected as strings.
+ * The cells equal to one of the null tokens are ignored. When the method
+ * returns, the given stream is positioned at the same position like before the
+ * method was called.
+ *
+ * @param in The stream to read the data rows from
+ * @param comment The comment pattern
+ * @param columns_number The number of columns
+ * @param sample_rows The maximum number of data rows to use
+ * @param null_tokens The tokens representing missing values
+ * @return The inferred types of the columns
+ */
+ELEMENTS_API std::vector<std::type_index> autoDetectColumnTypes(std::istream& in,
+                                               const std::string& comment,
+                                               size_t columns_number,
+                                               std::size_t sample_rows,
+                                               const std::vector<std::string>& null_tokens = {});
+
 /**
  * @brief
  * Converts the given value to a Row::cell_type of the given type
@@ -128,10 +160,82 @@ ELEMENTS_API std::vector<std::string> autoDetectColumnNames(std::istream& in,
  */
 ELEMENTS_API Row::cell_type convertToCellType(const std::string& value, std::type_index type);
 
+/**
+ * @brief
+ * Converts the given value to a scalar of type T
+ * @details
+ * It accepts the same representations as convertToCellType(). It is
+ * instantiated for bool, int32_t, int64_t, float and double.
+ *
+ * @param value The value to convert
+ * @return The converted value
+ * @throws Elements::Exception
+ *    if the conversion fails
+ */
+template <typename T>
+ELEMENTS_API T convertToValue(const std::string& value);
+
 ELEMENTS_API bool hasNextRow(std::istream& in, const std::string& comment);
 
 ELEMENTS_API std::size_t countRemainingRows(std::istream& in, const std::string& comment);
 
+/**
+ * @brief
+ * Returns true if the given line contains data after the comments are removed
+ *
+ * @param line The line to check
+ * @param comment The comment pattern
+ * @return true if the line is a data row, false otherwise
+ */
+ELEMENTS_API bool isDataLine(const std::string& line, const std::string& comment);
+
+/**
+ * @struct AsciiRowIndex
+ *
+ * @brief
+ * Sampled index of the positions of the data rows of an ASCII table stream
+ * @details
+ * The offsets vector contains the stream position of the data rows 0, sampling,
+ * 2*sampling, etc. The rows member is the total number of data rows and the end
+ * member the length of the indexed stream, used for detecting stale indices.
+ */
+struct AsciiRowIndex {
+  std::string comment;
+  std::size_t sampling;
+  std::size_t rows;
+  std::streamoff end;
+  std::vector<std::streamoff> offsets;
+};
+
+/**
+ * @brief
+ * Scans the given stream and creates the index of its data rows
+ * @details
+ * The scan starts from the current position of the stream. When the method
+ * returns the given stream is positioned at the same position like before the
+ * method was called.
+ *
+ * @param in The stream to index
+ * @param comment The comment pattern
+ * @param sampling Every how many data rows an offset is kept
+ * @return The row index
+ * @throws Elements::Exception
+ *    if the sampling is zero
+ */
+ELEMENTS_API AsciiRowIndex buildRowIndex(std::istream& in, const std::string& comment,
+                                         std::size_t sampling);
+
+/// Writes the given row index in the given stream
+ELEMENTS_API void writeRowIndex(std::ostream& out, const AsciiRowIndex& index);
+
+/**
+ * @brief
+ * Reads a row index previously written with writeRowIndex()
+ * @throws Elements::Exception
+ *    if the stream does not contain a valid row index
+ */
+ELEMENTS_API AsciiRowIndex readRowIndex(std::istream& in);
+
 }
 } // end of namespace Euclid
 
@@ -24,9 +24,9 @@
 
 #include <fstream>
 #include <sstream>
-#include <boost/lexical_cast.hpp>
 #include "ElementsKernel/Exception.h"
 #include "Table/AsciiWriter.h"
+#include "Table/CompressedStream.h"
 #include "AsciiWriterHelper.h"
 
 namespace Euclid {
@@ -35,7 +35,15 @@ namespace Table {
 AsciiWriter::AsciiWriter(std::ostream& stream) : AsciiWriter(InstOrRefHolder<std::ostream>::create(stream)) {
 }
 
-AsciiWriter::AsciiWriter(const std::string& filename) : AsciiWriter(create<std::ofstream>(filename)) {
+static std::unique_ptr<InstOrRefHolder<std::ostream>> openFile(const std::string& filename) {
+  auto compression = compressionFromExtension(filename);
+  if (compression != Compression::NONE) {
+    return InstOrRefHolder<std::ostream>::create<CompressedOStream>(filename, compression);
+  }
+  return InstOrRefHolder<std::ostream>::create<std::ofstream>(filename);
+}
+
+AsciiWriter::AsciiWriter(const std::string& filename) : AsciiWriter(openFile(filename)) {
 }
 
 AsciiWriter::AsciiWriter(std::unique_ptr<InstOrRefHolder<std::ostream>> stream_holder)
@@ -63,6 +71,31 @@ AsciiWriter& AsciiWriter::showColumnInfo(bool show) {
   return *this;
 }
 
+AsciiWriter& AsciiWriter::setColumnWidths(std::vector<std::size_t> widths) {
+  if (m_writing_started) {
+    throw Elements::Exception() << "Changing the column widths after writing "
+            << "has started is not allowed";
+  }
+  for (auto width : widths) {
+    if (width == 0) {
+      throw Elements::Exception() << "Column widths must be positive numbers";
+    }
+  }
+  m_column_widths = std::move(widths);
+  m_separator.clear();
+  return *this;
+}
+
+AsciiWriter& AsciiWriter::setColumnSeparator(const std::string& separator) {
+  if (m_writing_started) {
+    throw Elements::Exception() << "Changing the column separator after writing "
+            << "has started is not allowed";
+  }
+  m_separator = separator;
+  m_column_widths.clear();
+  return *this;
+}
+
 void AsciiWriter::addComment(const std::string& message) {
   if (m_initialized) {
     throw Elements::Exception() << "Adding comments after writing data in ASCII "
@@ -78,6 +111,21 @@ void AsciiWriter::addComment(const std::string& message) {
   }
 }
 
+namespace {
+
+// The size of the formatted data which is written to the stream at once
+const std::size_t write_block_size = 1 << 20;
+
+// Right aligns the text of the buffer after the start position, by inserting
+// spaces in front of it. At least one space is always added, so the columns
+// are separated even if the text does not fit in the width.
+void alignRight(std::string& buffer, std::size_t start, std::size_t width) {
+  auto size = buffer.size() - start;
+  buffer.insert(start, size < width ? width - size : 1, ' ');
+}
+
+} // end of anonymous namespace
+
 void AsciiWriter::init(const Table& table) {
   m_initialized = true;
   // If we have already written anything we leave an empty line
@@ -105,27 +153,64 @@ void AsciiWriter::init(const Table& table) {
     out << '\n';
   }
   
+  if (!m_column_widths.empty() && m_column_widths.size() != info.size()) {
+    throw Elements::Exception() << "Table has " << info.size() << " columns but "
+            << m_column_widths.size() << " column widths were given";
+  }
+  
   // Write the column names
-  auto column_lengths = calculateColumnLengths(table);
   out << m_comment.c_str();
-  for (size_t i=0; i<info.size(); ++i) {
-    out << std::setw(column_lengths[i]) << info.getDescription(i).name;
+  if (!m_separator.empty()) {
+    for (size_t i=0; i<info.size(); ++i) {
+      out << (i == 0 ? " " : m_separator) << info.getDescription(i).name;
+    }
+  } else {
+    auto column_lengths = m_column_widths.empty() ? calculateColumnLengths(table) : m_column_widths;
+    std::string names {};
+    for (size_t i=0; i<info.size(); ++i) {
+      auto name_start = names.size();
+      names.append(info.getDescription(i).name);
+      alignRight(names, name_start, column_lengths[i]);
+    }
+    out << names;
   }
   out << "\n\n";
 }
 
 void AsciiWriter::append(const Table& table) {
   auto& out = m_stream_holder->ref();
-  auto column_lengths = calculateColumnLengths(table);
-  // The data lines are not prefixed with the comment string, so we need to fix
-  // the length of the first column to get the alignment correctly
-  column_lengths[0] = column_lengths[0] + m_comment.size();
-  for (auto row : table) {
+  std::vector<size_t> column_lengths {};
+  if (m_separator.empty()) {
+    column_lengths = m_column_widths.empty() ? calculateColumnLengths(table) : m_column_widths;
+    // The data lines are not prefixed with the comment string, so we need to fix
+    // the length of the first column to get the alignment correctly
+    column_lengths[0] = column_lengths[0] + m_comment.size();
+  }
+  
+  // The rows are formatted in a buffer which is reused between the calls and
+  // is written to the stream in big blocks
+  m_buffer.clear();
+  m_buffer.reserve(write_block_size + 1024);
+  for (const auto& row : table) {
     for (size_t i=0; i<row.size(); ++i) {
-      out << std::setw(column_lengths[i]) << boost::lexical_cast<std::string>(row[i]);
+      auto cell_start = m_buffer.size();
+      if (!m_separator.empty() && i != 0) {
+        m_buffer.append(m_separator);
+        cell_start = m_buffer.size();
+      }
+      formatCell(row[i], m_buffer);
+      if (m_separator.empty()) {
+        alignRight(m_buffer, cell_start, column_lengths[i]);
+      }
+    }
+    m_buffer.push_back('\n');
+    if (m_buffer.size() >= write_block_size) {
+      out.write(m_buffer.data(), m_buffer.size());
+      m_buffer.clear();
     }
-    out << "\n";
   }
+  out.write(m_buffer.data(), m_buffer.size());
+  m_buffer.clear();
 }
 
 
@@ -23,6 +23,7 @@
  */
 
 #include <algorithm>
+#include <cstdio>
 #include <boost/lexical_cast.hpp>
 #include "ElementsKernel/Exception.h"
 #include "AsciiWriterHelper.h"
@@ -70,16 +71,112 @@ std::string typeToKeyword(std::type_index type) {
                             << " is not supported";
 }
 
+namespace {
+
+void formatInteger(int64_t value, std::string& buffer) {
+  char digits[20];
+  int size = 0;
+  // We work with the unsigned value, so the minimum int64_t is handled correctly
+  uint64_t abs_value = value < 0 ? 0 - static_cast<uint64_t>(value) : value;
+  do {
+    digits[size++] = static_cast<char>('0' + abs_value % 10);
+    abs_value /= 10;
+  } while (abs_value != 0);
+  if (value < 0) {
+    buffer.push_back('-');
+  }
+  while (size > 0) {
+    buffer.push_back(digits[--size]);
+  }
+}
+
+void formatFloating(double value, std::string& buffer) {
+  // The %g format is what the streams use with their default precision
+  char chars[32];
+  int size = std::snprintf(chars, sizeof(chars), "%g", value);
+  buffer.append(chars, size);
+}
+
+class FormatVisitor : public boost::static_visitor<void> {
+
+public:
+
+  explicit FormatVisitor(std::string& buffer) : m_buffer(buffer) {
+  }
+
+  void operator()(bool value) const {
+    m_buffer.push_back(value ? '1' : '0');
+  }
+
+  void operator()(int32_t value) const {
+    formatInteger(value, m_buffer);
+  }
+
+  void operator()(int64_t value) const {
+    formatInteger(value, m_buffer);
+  }
+
+  void operator()(float value) const {
+    formatFloating(value, m_buffer);
+  }
+
+  void operator()(double value) const {
+    formatFloating(value, m_buffer);
+  }
+
+  void operator()(const std::string& value) const {
+    m_buffer.append(value);
+  }
+
+  template <typename T>
+  void operator()(const std::vector<T>& value) const {
+    for (auto it = value.begin(); it != value.end(); ++it) {
+      if (it != value.begin()) {
+        m_buffer.push_back(',');
+      }
+      (*this)(static_cast<T>(*it));
+    }
+  }
+
+  template <typename T>
+  void operator()(const NdArray<T>& value) const {
+    // NdArrays are rare in ASCII tables, so we do not optimize them
+    m_buffer.append(boost::lexical_cast<std::string>(value));
+  }
+
+private:
+
+  std::string& m_buffer;
+
+};
+
+} // end of anonymous namespace
+
+void formatCell(const Row::cell_type& cell, std::string& buffer) {
+  boost::apply_visitor(FormatVisitor{buffer}, cell);
+}
+
 std::vector<size_t> calculateColumnLengths(const Table& table) {
   std::vector<size_t> sizes {};
-  // We initialize the values to the required size for the column name
+  // We initialize the values to the required size for the column name, or to
+  // the declared width, and we scan the values only of the rest columns
   auto column_info = table.getColumnInfo();
+  std::vector<size_t> scanned_columns {};
   for (size_t i=0; i<column_info->size(); ++i) {
-    sizes.push_back(column_info->getDescription(i).name.size());
+    auto& description = column_info->getDescription(i);
+    sizes.push_back(std::max(description.name.size(), description.width));
+    if (description.width == 0) {
+      scanned_columns.push_back(i);
+    }
   }
-  for (auto row : table) {
-    for (size_t i=0; i<sizes.size(); ++i) {
-      sizes[i] = std::max(sizes[i], boost::lexical_cast<std::string>(row[i]).size());
+  std::string buffer {};
+  if (!scanned_columns.empty()) {
+    for (const auto& row : table) {
+      for (auto i : scanned_columns) {
+        buffer.clear();
+        formatCell(row[i], buffer);
+        sizes[i] = std::max(sizes[i], buffer.size());
+      }
     }
   }
   for (auto& s : sizes) {
@@ -25,6 +25,7 @@
 #ifndef TABLE_ASCIIWRITERHELPER_H
 #define TABLE_ASCIIWRITERHELPER_H
 
+#include <string>
 #include <vector>
 #include <typeindex>
 
@@ -47,12 +48,28 @@ namespace Table {
  */
 ELEMENTS_API std::string typeToKeyword(std::type_index type);
 
+/**
+ * @brief
+ * Appends the string representation of a cell to the given buffer
+ * @details
+ * The representation is the same with the one of boost::lexical_cast, but it
+ * is produced without any stream or temporary string, so the buffer can be
+ * reused for many cells.
+ *
+ * @param cell The cell to format
+ * @param buffer The buffer to append the characters to
+ */
+ELEMENTS_API void formatCell(const Row::cell_type& cell, std::string& buffer);
+
 /**
  * @brief
  * Calculates the sizes in characters each column of the table needs
  * @details
  * The size is calculated as the size of the longest column entry (including type
  * and name) plus one to ensure separation of the values.
+ * For the columns with a declared width (see ColumnDescription) the
+ * declared width is used instead of the longest entry, without formatting the
+ * values.
  *
  * @param table The table
  * @return  the sizes of the columns
@@ -0,0 +1,465 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/BinaryColumnarHelper.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <cstring>
+#include "ElementsKernel/Exception.h"
+#include "BinaryColumnarHelper.h"
+
+namespace Euclid {
+namespace Table {
+
+using NdArray::NdArray;
+
+const char binary_columnar_magic[8] = {'A', 'L', 'X', 'C', 'O', 'L', 'S', '\0'};
+
+namespace {
+
+// The types of the columns, in the order of their codes in the footer
+const std::vector<std::type_index>& supportedTypes() {
+  static const std::vector<std::type_index> types {
+    typeid(bool), typeid(int32_t), typeid(int64_t), typeid(float), typeid(double),
+    typeid(std::string),
+    typeid(std::vector<bool>), typeid(std::vector<int32_t>), typeid(std::vector<int64_t>),
+    typeid(std::vector<float>), typeid(std::vector<double>),
+    typeid(NdArray<bool>), typeid(NdArray<int32_t>), typeid(NdArray<int64_t>),
+    typeid(NdArray<float>), typeid(NdArray<double>)
+  };
+  return types;
+}
+
+std::uint64_t typeCode(std::type_index type) {
+  auto& types = supportedTypes();
+  for (std::size_t i = 0; i < types.size(); ++i) {
+    if (types[i] == type) {
+      return i;
+    }
+  }
+  throw Elements::Exception() << "Binary columnar format does not support columns of type " << type.name();
+}
+
+// Returns the number of buffers a column of the given type code is stored in
+std::size_t buffersNumber(std::uint64_t type_code) {
+  if (type_code < 5) {
+    return 1;
+  }
+  if (type_code < 11) {
+    return 2;
+  }
+  return 4;
+}
+
+// The booleans are stored as bytes, all the other types as they are
+template <typename T>
+struct Storage {
+  typedef T type;
+};
+
+template <>
+struct Storage<bool> {
+  typedef std::uint8_t type;
+};
+
+template <typename T>
+void put(std::vector<char>& buffer, const T& value) {
+  auto bytes = reinterpret_cast<const char*>(&value);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+void put(std::string& buffer, const T& value) {
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void putString(std::string& buffer, const std::string& value) {
+  put<std::uint64_t>(buffer, value.size());
+  buffer.append(value);
+}
+
+template <typename Iter>
+void putElements(std::vector<char>& buffer, Iter begin, Iter end) {
+  typedef typename Storage<typename std::iterator_traits<Iter>::value_type>::type S;
+  for (auto iter = begin; iter != end; ++iter) {
+    put<S>(buffer, *iter);
+  }
+}
+
+template <typename T>
+std::vector<std::vector<char>> encodeScalar(const Table& table, std::size_t column_index) {
+  std::vector<std::vector<char>> buffers (1);
+  buffers[0].reserve(table.size() * sizeof(typename Storage<T>::type));
+  for (const auto& row : table) {
+    put<typename Storage<T>::type>(buffers[0], boost::get<T>(row[column_index]));
+  }
+  return buffers;
+}
+
+template <>
+std::vector<std::vector<char>> encodeScalar<std::string>(const Table& table, std::size_t column_index) {
+  std::vector<std::vector<char>> buffers (2);
+  std::uint64_t offset = 0;
+  put(buffers[0], offset);
+  for (const auto& row : table) {
+    auto& value = boost::get<std::string>(row[column_index]);
+    buffers[1].insert(buffers[1].end(), value.begin(), value.end());
+    offset += value.size();
+    put(buffers[0], offset);
+  }
+  return buffers;
+}
+
+template <typename T>
+std::vector<std::vector<char>> encodeVector(const Table& table, std::size_t column_index) {
+  std::vector<std::vector<char>> buffers (2);
+  std::uint64_t offset = 0;
+  put(buffers[0], offset);
+  for (const auto& row : table) {
+    auto& value = boost::get<std::vector<T>>(row[column_index]);
+    putElements(buffers[1], value.begin(), value.end());
+    offset += value.size();
+    put(buffers[0], offset);
+  }
+  return buffers;
+}
+
+template <typename T>
+std::vector<std::vector<char>> encodeNdArray(const Table& table, std::size_t column_index) {
+  std::vector<std::vector<char>> buffers (4);
+  std::uint64_t shape_offset = 0;
+  std::uint64_t offset = 0;
+  put(buffers[0], shape_offset);
+  put(buffers[2], offset);
+  for (const auto& row : table) {
+    auto& value = boost::get<NdArray<T>>(row[column_index]);
+    auto shape = value.shape();
+    for (auto dim : shape) {
+      put<std::uint64_t>(buffers[1], dim);
+    }
+    shape_offset += shape.size();
+    put(buffers[0], shape_offset);
+    putElements(buffers[3], value.begin(), value.end());
+    offset += value.size();
+    put(buffers[2], offset);
+  }
+  return buffers;
+}
+
+// The buffers are aligned, so they can be accessed directly
+template <typename T>
+const T* bufferData(const char* file_data, const BufferLocation& location) {
+  return reinterpret_cast<const T*>(file_data + location.offset);
+}
+
+// Checks that the offsets of the given rows are within the data buffer
+void checkOffsets(const std::uint64_t* offsets, std::size_t first, std::size_t count,
+                  const BufferLocation& data, std::size_t element_size) {
+  if (offsets[first] > offsets[first + count] || offsets[first + count] * element_size > data.size) {
+    throw Elements::Exception() << "Corrupted binary columnar data";
+  }
+}
+
+template <typename T>
+void decodeScalar(const char* file_data, const std::vector<BufferLocation>& buffers,
+                  std::size_t first, std::size_t count, std::vector<Row::cell_type>& cells) {
+  auto values = bufferData<typename Storage<T>::type>(file_data, buffers[0]);
+  for (std::size_t i = first; i < first + count; ++i) {
+    cells.emplace_back(static_cast<T>(values[i]));
+  }
+}
+
+template <>
+void decodeScalar<std::string>(const char* file_data, const std::vector<BufferLocation>& buffers,
+                               std::size_t first, std::size_t count, std::vector<Row::cell_type>& cells) {
+  auto offsets = bufferData<std::uint64_t>(file_data, buffers[0]);
+  checkOffsets(offsets, first, count, buffers[1], 1);
+  auto chars = bufferData<char>(file_data, buffers[1]);
+  for (std::size_t i = first; i < first + count; ++i) {
+    cells.emplace_back(std::string(chars + offsets[i], chars + offsets[i + 1]));
+  }
+}
+
+template <typename T>
+void decodeVector(const char* file_data, const std::vector<BufferLocation>& buffers,
+                  std::size_t first, std::size_t count, std::vector<Row::cell_type>& cells) {
+  typedef typename Storage<T>::type S;
+  auto offsets = bufferData<std::uint64_t>(file_data, buffers[0]);
+  checkOffsets(offsets, first, count, buffers[1], sizeof(S));
+  auto values = bufferData<S>(file_data, buffers[1]);
+  for (std::size_t i = first; i < first + count; ++i) {
+    cells.emplace_back(std::vector<T>(values + offsets[i], values + offsets[i + 1]));
+  }
+}
+
+template <typename T>
+void decodeNdArray(const char* file_data, const std::vector<BufferLocation>& buffers,
+                   std::size_t first, std::size_t count, std::vector<Row::cell_type>& cells) {
+  typedef typename Storage<T>::type S;
+  auto shape_offsets = bufferData<std::uint64_t>(file_data, buffers[0]);
+  checkOffsets(shape_offsets, first, count, buffers[1], sizeof(std::uint64_t));
+  auto shapes = bufferData<std::uint64_t>(file_data, buffers[1]);
+  auto offsets = bufferData<std::uint64_t>(file_data, buffers[2]);
+  checkOffsets(offsets, first, count, buffers[3], sizeof(S));
+  auto values = bufferData<S>(file_data, buffers[3]);
+  for (std::size_t i = first; i < first + count; ++i) {
+    std::vector<size_t> shape (shapes + shape_offsets[i], shapes + shape_offsets[i + 1]);
+    std::vector<T> data (values + offsets[i], values + offsets[i + 1]);
+    cells.emplace_back(NdArray<T>(shape, std::move(data)));
+  }
+}
+
+// Reads the footer fields, checking that they are within its size
+class FooterReader {
+public:
+  FooterReader(const char* data, std::size_t size) : m_data(data), m_size(size) {
+  }
+  template <typename T>
+  T get() {
+    T value;
+    std::memcpy(&value, consume(sizeof(T)), sizeof(T));
+    return value;
+  }
+  std::string getString() {
+    auto size = get<std::uint64_t>();
+    if (size > m_size) {
+      throw Elements::Exception() << "Corrupted binary columnar footer";
+    }
+    return std::string(consume(size), size);
+  }
+private:
+  const char* consume(std::size_t size) {
+    if (size > m_size) {
+      throw Elements::Exception() << "Corrupted binary columnar footer";
+    }
+    auto result = m_data;
+    m_data += size;
+    m_size -= size;
+    return result;
+  }
+  const char* m_data;
+  std::size_t m_size;
+};
+
+// Checks that the sizes of the buffers of a column are consistent with the
+// number of rows
+void checkBuffers(std::uint64_t type_code, std::uint64_t rows, const std::vector<BufferLocation>& buffers) {
+  static const std::vector<std::uint64_t> element_sizes {1, 4, 8, 4, 8};
+  bool valid;
+  if (type_code < 5) {
+    valid = buffers[0].size == rows * element_sizes[type_code];
+  } else if (type_code < 11) {
+    valid = buffers[0].size == (rows + 1) * sizeof(std::uint64_t);
+  } else {
+    valid = buffers[0].size == (rows + 1) * sizeof(std::uint64_t)
+            && buffers[2].size == (rows + 1) * sizeof(std::uint64_t);
+  }
+  if (!valid) {
+    throw Elements::Exception() << "Corrupted binary columnar footer";
+  }
+}
+
+} // end of anonymous namespace
+
+std::string binaryColumnarHeader() {
+  std::string header {binary_columnar_magic, sizeof(binary_columnar_magic)};
+  put(header, binary_columnar_byte_order);
+  put(header, binary_columnar_version);
+  return header;
+}
+
+void checkBinaryColumnarHeader(const char* data, std::size_t size) {
+  if (size < binary_columnar_header_size + binary_columnar_trailer_size
+      || std::memcmp(data, binary_columnar_magic, sizeof(binary_columnar_magic)) != 0) {
+    throw Elements::Exception() << "Not a binary columnar file";
+  }
+  FooterReader reader {data + sizeof(binary_columnar_magic), binary_columnar_header_size - sizeof(binary_columnar_magic)};
+  if (reader.get<std::uint32_t>() != binary_columnar_byte_order) {
+    throw Elements::Exception() << "Binary columnar file has different byte order than the machine";
+  }
+  auto version = reader.get<std::uint32_t>();
+  if (version != binary_columnar_version) {
+    throw Elements::Exception() << "Unsupported binary columnar format version " << version;
+  }
+}
+
+std::vector<std::vector<char>> encodeColumn(const Table& table, std::size_t column_index) {
+  auto type = table.getColumnInfo()->getDescription(column_index).type;
+  if (type == typeid(bool)) {
+    return encodeScalar<bool>(table, column_index);
+  } else if (type == typeid(int32_t)) {
+    return encodeScalar<int32_t>(table, column_index);
+  } else if (type == typeid(int64_t)) {
+    return encodeScalar<int64_t>(table, column_index);
+  } else if (type == typeid(float)) {
+    return encodeScalar<float>(table, column_index);
+  } else if (type == typeid(double)) {
+    return encodeScalar<double>(table, column_index);
+  } else if (type == typeid(std::string)) {
+    return encodeScalar<std::string>(table, column_index);
+  } else if (type == typeid(std::vector<bool>)) {
+    return encodeVector<bool>(table, column_index);
+  } else if (type == typeid(std::vector<int32_t>)) {
+    return encodeVector<int32_t>(table, column_index);
+  } else if (type == typeid(std::vector<int64_t>)) {
+    return encodeVector<int64_t>(table, column_index);
+  } else if (type == typeid(std::vector<float>)) {
+    return encodeVector<float>(table, column_index);
+  } else if (type == typeid(std::vector<double>)) {
+    return encodeVector<double>(table, column_index);
+  } else if (type == typeid(NdArray<bool>)) {
+    return encodeNdArray<bool>(table, column_index);
+  } else if (type == typeid(NdArray<int32_t>)) {
+    return encodeNdArray<int32_t>(table, column_index);
+  } else if (type == typeid(NdArray<int64_t>)) {
+    return encodeNdArray<int64_t>(table, column_index);
+  } else if (type == typeid(NdArray<float>)) {
+    return encodeNdArray<float>(table, column_index);
+  } else if (type == typeid(NdArray<double>)) {
+    return encodeNdArray<double>(table, column_index);
+  }
+  throw Elements::Exception() << "Binary columnar format does not support columns of type " << type.name();
+}
+
+void decodeColumn(const char* file_data, const std::vector<BufferLocation>& buffers,
+                  std::type_index type, std::size_t first, std::size_t count,
+                  std::vector<Row::cell_type>& cells) {
+  if (type == typeid(bool)) {
+    decodeScalar<bool>(file_data, buffers, first, count, cells);
+  } else if (type == typeid(int32_t)) {
+    decodeScalar<int32_t>(file_data, buffers, first, count, cells);
+  } else if (type == typeid(int64_t)) {
+    decodeScalar<int64_t>(file_data, buffers, first, count, cells);
+  } else if (type == typeid(float)) {
+    decodeScalar<float>(file_data, buffers, first, count, cells);
+  } else if (type == typeid(double)) {
+    decodeScalar<double>(file_data, buffers, first, count, cells);
+  } else if (type == typeid(std::string)) {
+    decodeScalar<std::string>(file_data, buffers, first, count, cells);
+  } else if (type == typeid(std::vector<bool>)) {
+    decodeVector<bool>(file_data, buffers, first, count, cells);
+  } else if (type == typeid(std::vector<int32_t>)) {
+    decodeVector<int32_t>(file_data, buffers, first, count, cells);
+  } else if (type == typeid(std::vector<int64_t>)) {
+    decodeVector<int64_t>(file_data, buffers, first, count, cells);
+  } else if (type == typeid(std::vector<float>)) {
+    decodeVector<float>(file_data, buffers, first, count, cells);
+  } else if (type == typeid(std::vector<double>)) {
+    decodeVector<double>(file_data, buffers, first, count, cells);
+  } else if (type == typeid(NdArray<bool>)) {
+    decodeNdArray<bool>(file_data, buffers, first, count, cells);
+  } else if (type == typeid(NdArray<int32_t>)) {
+    decodeNdArray<int32_t>(file_data, buffers, first, count, cells);
+  } else if (type == typeid(NdArray<int64_t>)) {
+    decodeNdArray<int64_t>(file_data, buffers, first, count, cells);
+  } else if (type == typeid(NdArray<float>)) {
+    decodeNdArray<float>(file_data, buffers, first, count, cells);
+  } else if (type == typeid(NdArray<double>)) {
+    decodeNdArray<double>(file_data, buffers, first, count, cells);
+  } else {
+    throw Elements::Exception() << "Binary columnar format does not support columns of type " << type.name();
+  }
+}
+
+std::string serializeFooter(const BinaryColumnarFooter& footer, std::uint64_t footer_offset) {
+  std::string result {};
+  putString(result, footer.comment);
+  put<std::uint64_t>(result, footer.columns.size());
+  for (auto& column : footer.columns) {
+    putString(result, column.name);
+    putString(result, column.unit);
+    putString(result, column.description);
+    put<std::uint64_t>(result, typeCode(column.type));
+  }
+  put<std::uint64_t>(result, footer.row_groups.size());
+  for (auto& group : footer.row_groups) {
+    put<std::uint64_t>(result, group.rows);
+    for (auto& buffers : group.columns) {
+      for (auto& buffer : buffers) {
+        put(result, buffer.offset);
+        put(result, buffer.size);
+      }
+    }
+  }
+  put(result, footer_offset);
+  result.append(binary_columnar_magic, sizeof(binary_columnar_magic));
+  return result;
+}
+
+std::uint64_t readFooterOffset(const char* trailer, std::uint64_t file_size) {
+  if (std::memcmp(trailer + sizeof(std::uint64_t), binary_columnar_magic, sizeof(binary_columnar_magic)) != 0) {
+    throw Elements::Exception() << "Binary columnar file is truncated or corrupted";
+  }
+  std::uint64_t offset;
+  std::memcpy(&offset, trailer, sizeof(offset));
+  if (offset < binary_columnar_header_size || offset > file_size - binary_columnar_trailer_size) {
+    throw Elements::Exception() << "Corrupted binary columnar footer";
+  }
+  return offset;
+}
+
+BinaryColumnarFooter deserializeFooter(const char* data, std::size_t size, std::uint64_t footer_offset) {
+  FooterReader reader {data, size};
+  BinaryColumnarFooter footer {};
+  footer.comment = reader.getString();
+  auto columns = reader.get<std::uint64_t>();
+  if (columns == 0 || columns > size) {
+    throw Elements::Exception() << "Corrupted binary columnar footer";
+  }
+  std::vector<std::uint64_t> type_codes {};
+  for (std::uint64_t i = 0; i < columns; ++i) {
+    auto name = reader.getString();
+    auto unit = reader.getString();
+    auto description = reader.getString();
+    auto type_code = reader.get<std::uint64_t>();
+    if (type_code >= supportedTypes().size()) {
+      throw Elements::Exception() << "Unknown binary columnar column type " << type_code;
+    }
+    type_codes.push_back(type_code);
+    footer.columns.emplace_back(name, supportedTypes()[type_code], unit, description);
+  }
+  auto groups = reader.get<std::uint64_t>();
+  if (groups > size) {
+    throw Elements::Exception() << "Corrupted binary columnar footer";
+  }
+  for (std::uint64_t g = 0; g < groups; ++g) {
+    RowGroup group {reader.get<std::uint64_t>(), {}};
+    for (auto type_code : type_codes) {
+      std::vector<BufferLocation> buffers {};
+      for (std::size_t b = 0; b < buffersNumber(type_code); ++b) {
+        BufferLocation buffer {reader.get<std::uint64_t>(), reader.get<std::uint64_t>()};
+        if (buffer.offset < binary_columnar_header_size || buffer.offset % binary_columnar_alignment != 0
+            || buffer.offset > footer_offset || buffer.size > footer_offset - buffer.offset) {
+          throw Elements::Exception() << "Corrupted binary columnar footer";
+        }
+        buffers.push_back(buffer);
+      }
+      checkBuffers(type_code, group.rows, buffers);
+      group.columns.push_back(std::move(buffers));
+    }
+    footer.row_groups.push_back(std::move(group));
+  }
+  return footer;
+}
+
+}
+} // end of namespace Euclid
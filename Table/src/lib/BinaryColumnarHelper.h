@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/BinaryColumnarHelper.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef TABLE_BINARYCOLUMNARHELPER_H
+#define TABLE_BINARYCOLUMNARHELPER_H
+
+#include <cstdint>
+#include <string>
+#include <typeindex>
+#include <vector>
+#include "ElementsKernel/Export.h"
+#include "Table/Table.h"
+
+namespace Euclid {
+namespace Table {
+
+/*
+ * The binary columnar files have the following layout:
+ * - A header with the magic string, the byte order mark and the version
+ * - The column buffers of all the row groups, each one aligned to 8 bytes
+ * - The footer, describing the columns and the locations of the buffers
+ * - A trailer with the offset of the footer and the magic string
+ * Each call of the BinaryColumnarWriter::addData() adds a row group.
+ */
+
+/// The magic string at the beginning and the end of the files
+ELEMENTS_API extern const char binary_columnar_magic[8];
+
+/// The value stored in the header for detecting the byte order
+const std::uint32_t binary_columnar_byte_order = 0x01020304;
+
+/// The version of the format
+const std::uint32_t binary_columnar_version = 1;
+
+/// The size of the header at the beginning of the files
+const std::size_t binary_columnar_header_size = 16;
+
+/// The size of the trailer at the end of the files
+const std::size_t binary_columnar_trailer_size = 16;
+
+/// The alignment of the column buffers in the file
+const std::size_t binary_columnar_alignment = 8;
+
+/// The location of a buffer in the file
+struct BufferLocation {
+  std::uint64_t offset;
+  std::uint64_t size;
+};
+
+/// The rows stored together by a single addData() call
+struct RowGroup {
+  std::uint64_t rows;
+  /// The buffers of each column
+  std::vector<std::vector<BufferLocation>> columns;
+};
+
+/// The contents of the footer of a binary columnar file
+struct BinaryColumnarFooter {
+  std::string comment {};
+  std::vector<ColumnDescription> columns {};
+  std::vector<RowGroup> row_groups {};
+};
+
+/**
+ * @brief Returns the header of the binary columnar files
+ */
+ELEMENTS_API std::string binaryColumnarHeader();
+
+/**
+ * @brief Checks that the given data are a valid binary columnar file header
+ * @throws Elements::Exception
+ *    if the header is not valid
+ */
+ELEMENTS_API void checkBinaryColumnarHeader(const char* data, std::size_t size);
+
+/**
+ * @brief Encodes the data of a column of the table in the buffers stored in
+ * the file
+ * @details
+ * The scalar types are stored as arrays (the booleans as one byte each), the
+ * strings and vectors as an array of offsets followed by their data and the
+ * NdArrays as two such pairs, one for the shapes and one for the data.
+ * @throws Elements::Exception
+ *    if the type of the column is not supported
+ */
+ELEMENTS_API std::vector<std::vector<char>> encodeColumn(const Table& table, std::size_t column_index);
+
+/**
+ * @brief Decodes cells of a column from its buffers in the file
+ * @param file_data The start of the file data
+ * @param buffers The buffers of the column in the row group
+ * @param type The type of the column
+ * @param first The first row to decode, relative to the row group
+ * @param count The number of rows to decode
+ * @param cells The vector to append the cells to
+ */
+ELEMENTS_API void decodeColumn(const char* file_data, const std::vector<BufferLocation>& buffers,
+                               std::type_index type, std::size_t first, std::size_t count,
+                               std::vector<Row::cell_type>& cells);
+
+/**
+ * @brief Serializes the footer, followed by the trailer
+ * @param footer The footer to serialize
+ * @param footer_offset The position of the footer in the file
+ */
+ELEMENTS_API std::string serializeFooter(const BinaryColumnarFooter& footer, std::uint64_t footer_offset);
+
+/**
+ * @brief Returns the offset of the footer stored in the trailer
+ * @param trailer The last binary_columnar_trailer_size bytes of the file
+ * @param file_size The size of the file
+ * @throws Elements::Exception
+ *    if the trailer is not valid
+ */
+ELEMENTS_API std::uint64_t readFooterOffset(const char* trailer, std::uint64_t file_size);
+
+/**
+ * @brief Reads the footer of a binary columnar file
+ * @details
+ * The footer is expected to be located right after the data, so the locations
+ * of all the buffers must be before its offset.
+ * @param data The serialized footer, without the trailer
+ * @param size The size of the serialized footer
+ * @param footer_offset The position of the footer in the file
+ * @throws Elements::Exception
+ *    if the footer is not valid
+ */
+ELEMENTS_API BinaryColumnarFooter deserializeFooter(const char* data, std::size_t size,
+                                                   std::uint64_t footer_offset);
+
+}
+} // end of namespace Euclid
+
+#endif /* TABLE_BINARYCOLUMNARHELPER_H */
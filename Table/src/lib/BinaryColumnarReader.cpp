@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/BinaryColumnarReader.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <algorithm>
+#include <ios>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include "ElementsKernel/Exception.h"
+#include "AlexandriaKernel/memory_tools.h"
+#include "Table/BinaryColumnarReader.h"
+#include "BinaryColumnarHelper.h"
+
+namespace Euclid {
+namespace Table {
+
+BinaryColumnarReader::BinaryColumnarReader(const std::string& filename) : m_filename(filename) {
+  std::shared_ptr<boost::iostreams::mapped_file_source> file;
+  try {
+    file = std::make_shared<boost::iostreams::mapped_file_source>(filename);
+  } catch (const std::ios_base::failure& e) {
+    throw Elements::Exception() << "Failed to map file " << filename << ": " << e.what();
+  }
+  m_file = file;
+  m_data = file->data();
+  std::size_t size = file->size();
+
+  checkBinaryColumnarHeader(m_data, size);
+  auto footer_offset = readFooterOffset(m_data + size - binary_columnar_trailer_size, size);
+  m_footer = make_unique<BinaryColumnarFooter>(deserializeFooter(m_data + footer_offset,
+          size - binary_columnar_trailer_size - footer_offset, footer_offset));
+
+  for (auto& group : m_footer->row_groups) {
+    m_total_rows += group.rows;
+  }
+  for (std::size_t i = 0; i < m_footer->columns.size(); ++i) {
+    m_columns.push_back(i);
+  }
+  m_column_info = std::make_shared<ColumnInfo>(m_footer->columns);
+}
+
+BinaryColumnarReader::~BinaryColumnarReader() = default;
+
+std::size_t BinaryColumnarReader::columnIndex(const std::string& column_name) const {
+  for (std::size_t i = 0; i < m_footer->columns.size(); ++i) {
+    if (m_footer->columns[i].name == column_name) {
+      return i;
+    }
+  }
+  throw Elements::Exception() << "File " << m_filename << " does not contain column " << column_name;
+}
+
+BinaryColumnarReader& BinaryColumnarReader::selectColumns(const std::vector<std::string>& column_names) {
+  if (m_reading_started) {
+    throw Elements::Exception() << "Selecting the columns after reading has started is not allowed";
+  }
+  if (column_names.empty()) {
+    throw Elements::Exception() << "Empty list of selected columns";
+  }
+  std::vector<std::size_t> columns {};
+  std::vector<ColumnDescription> descriptions {};
+  for (auto& name : column_names) {
+    columns.push_back(columnIndex(name));
+    descriptions.push_back(m_footer->columns[columns.back()]);
+  }
+  m_column_info = std::make_shared<ColumnInfo>(std::move(descriptions));
+  m_columns = std::move(columns);
+  return *this;
+}
+
+template <typename T>
+std::vector<BinaryColumnarReader::ColumnChunk<T>> BinaryColumnarReader::mapColumn(const std::string& column_name) const {
+  auto index = columnIndex(column_name);
+  if (m_footer->columns[index].type != typeid(T)) {
+    throw Elements::Exception() << "Column " << column_name << " has different type than the requested";
+  }
+  std::vector<ColumnChunk<T>> chunks {};
+  for (auto& group : m_footer->row_groups) {
+    chunks.push_back(ColumnChunk<T> {reinterpret_cast<const T*>(m_data + group.columns[index][0].offset), group.rows});
+  }
+  return chunks;
+}
+
+#define TABLE_BINARY_COLUMNAR_MAP_INSTANTIATION(type) \
+  template std::vector<BinaryColumnarReader::ColumnChunk<type>> \
+  BinaryColumnarReader::mapColumn<type>(const std::string&) const;
+
+TABLE_BINARY_COLUMNAR_MAP_INSTANTIATION(int32_t)
+TABLE_BINARY_COLUMNAR_MAP_INSTANTIATION(int64_t)
+TABLE_BINARY_COLUMNAR_MAP_INSTANTIATION(float)
+TABLE_BINARY_COLUMNAR_MAP_INSTANTIATION(double)
+
+const ColumnInfo& BinaryColumnarReader::getInfo() {
+  return *m_column_info;
+}
+
+std::string BinaryColumnarReader::getComment() {
+  return m_footer->comment;
+}
+
+Table BinaryColumnarReader::readImpl(long rows) {
+  m_reading_started = true;
+  if (m_current_row >= m_total_rows) {
+    throw Elements::Exception() << "No more table rows left";
+  }
+  std::size_t count = m_total_rows - m_current_row;
+  if (rows >= 0) {
+    count = std::min(count, static_cast<std::size_t>(rows));
+  }
+
+  // Decode the requested rows of each column from all the row groups they
+  // are stored in
+  std::vector<std::vector<Row::cell_type>> data (m_columns.size());
+  for (auto& column_data : data) {
+    column_data.reserve(count);
+  }
+  std::size_t group_first = 0;
+  for (auto& group : m_footer->row_groups) {
+    std::size_t group_end = group_first + group.rows;
+    std::size_t first = std::max(group_first, m_current_row);
+    std::size_t end = std::min(group_end, m_current_row + count);
+    if (first < end) {
+      for (std::size_t i = 0; i < m_columns.size(); ++i) {
+        decodeColumn(m_data, group.columns[m_columns[i]], m_footer->columns[m_columns[i]].type,
+                     first - group_first, end - first, data[i]);
+      }
+    }
+    group_first = group_end;
+  }
+  m_current_row += count;
+
+  std::vector<Row> row_list;
+  row_list.reserve(count);
+  for (std::size_t r = 0; r < count; ++r) {
+    std::vector<Row::cell_type> cells {};
+    cells.reserve(data.size());
+    for (auto& column_data : data) {
+      cells.push_back(std::move(column_data[r]));
+    }
+    row_list.emplace_back(std::move(cells), m_column_info);
+  }
+  return Table{std::move(row_list)};
+}
+
+void BinaryColumnarReader::skip(long rows) {
+  m_reading_started = true;
+  m_current_row = std::min(m_total_rows, m_current_row + static_cast<std::size_t>(rows));
+}
+
+bool BinaryColumnarReader::hasMoreRows() {
+  return m_current_row < m_total_rows;
+}
+
+std::size_t BinaryColumnarReader::rowsLeft() {
+  return m_total_rows - m_current_row;
+}
+
+} // Table namespace
+} // Euclid namespace
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/BinaryColumnarWriter.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include "ElementsKernel/Exception.h"
+#include "ElementsKernel/Logging.h"
+#include "AlexandriaKernel/memory_tools.h"
+#include "Table/BinaryColumnarWriter.h"
+#include "BinaryColumnarHelper.h"
+
+namespace Euclid {
+namespace Table {
+
+static Elements::Logging logger = Elements::Logging::getLogger("BinaryColumnarWriter");
+
+BinaryColumnarWriter::BinaryColumnarWriter(const std::string& filename, bool override_flag)
+        : m_filename(filename), m_override_file(override_flag),
+          m_footer(make_unique<BinaryColumnarFooter>()) {
+}
+
+BinaryColumnarWriter::~BinaryColumnarWriter() {
+  try {
+    close();
+  } catch (const std::exception& e) {
+    logger.error() << "Failed to write the footer of " << m_filename << ": " << e.what();
+  }
+}
+
+void BinaryColumnarWriter::addComment(const std::string& comment) {
+  if (!m_footer->comment.empty()) {
+    m_footer->comment += '\n';
+  }
+  m_footer->comment += comment;
+  // Before the first addData() the comment is written with the first footer
+  m_footer_changed = m_data_end > 0;
+}
+
+void BinaryColumnarWriter::close() {
+  // A moved from writer has no footer and nothing to write
+  if (m_footer_changed && m_footer != nullptr) {
+    writeFooter();
+    m_footer_changed = false;
+  }
+  if (m_stream.is_open()) {
+    m_stream.close();
+  }
+}
+
+void BinaryColumnarWriter::openStream() {
+  if (!m_stream.is_open()) {
+    m_stream.open(m_filename, std::ios::in | std::ios::out | std::ios::binary);
+    if (!m_stream) {
+      throw Elements::Exception() << "Failed to open file " << m_filename;
+    }
+  }
+}
+
+namespace {
+
+// Reads the footer of an existing file, without reading its data
+BinaryColumnarFooter readExistingFooter(std::fstream& stream, const std::string& filename,
+                                        std::uint64_t& footer_offset) {
+  stream.seekg(0, std::ios::end);
+  std::uint64_t file_size = stream.tellg();
+  std::vector<char> header (binary_columnar_header_size);
+  std::vector<char> trailer (binary_columnar_trailer_size);
+  stream.seekg(0);
+  stream.read(header.data(), header.size());
+  if (file_size < binary_columnar_header_size + binary_columnar_trailer_size || !stream) {
+    throw Elements::Exception() << "File " << filename << " is not a binary columnar file";
+  }
+  checkBinaryColumnarHeader(header.data(), file_size);
+  stream.seekg(file_size - binary_columnar_trailer_size);
+  stream.read(trailer.data(), trailer.size());
+  footer_offset = readFooterOffset(trailer.data(), file_size);
+  std::vector<char> footer (file_size - binary_columnar_trailer_size - footer_offset);
+  stream.seekg(footer_offset);
+  stream.read(footer.data(), footer.size());
+  if (!stream) {
+    throw Elements::Exception() << "Failed to read the footer of file " << filename;
+  }
+  return deserializeFooter(footer.data(), footer.size(), footer_offset);
+}
+
+}
+
+void BinaryColumnarWriter::init(const Table& table) {
+  std::vector<ColumnDescription> columns {};
+  auto& info = *table.getColumnInfo();
+  for (std::size_t i = 0; i < info.size(); ++i) {
+    columns.push_back(info.getDescription(i));
+  }
+
+  if (!m_override_file && std::ifstream{m_filename}.good()) {
+    m_stream.open(m_filename, std::ios::in | std::ios::out | std::ios::binary);
+    if (!m_stream) {
+      throw Elements::Exception() << "Failed to open file " << m_filename;
+    }
+    // The new row groups are written after the existing footer, so the file
+    // keeps its table until the new footer is written
+    std::uint64_t footer_offset = 0;
+    auto existing = readExistingFooter(m_stream, m_filename, footer_offset);
+    m_stream.seekg(0, std::ios::end);
+    m_data_end = m_stream.tellg();
+    if (existing.columns != columns) {
+      throw Elements::Exception() << "File " << m_filename << " contains a table with different columns";
+    }
+    if (!m_footer->comment.empty()) {
+      existing.comment += (existing.comment.empty() ? "" : "\n") + m_footer->comment;
+    }
+    m_footer_changed = !m_footer->comment.empty();
+    *m_footer = std::move(existing);
+    return;
+  }
+
+  m_stream.open(m_filename, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_stream) {
+    throw Elements::Exception() << "Failed to open file " << m_filename << " for writing";
+  }
+  m_footer->columns = std::move(columns);
+  auto header = binaryColumnarHeader();
+  m_stream.write(header.data(), header.size());
+  m_data_end = header.size();
+  m_footer_changed = true;
+}
+
+void BinaryColumnarWriter::append(const Table& table) {
+  RowGroup group {table.size(), {}};
+  openStream();
+  m_stream.seekp(m_data_end);
+  const char padding[binary_columnar_alignment] = {};
+  auto write_padding = [this, &padding]() {
+    auto padding_size = (binary_columnar_alignment - m_data_end % binary_columnar_alignment) % binary_columnar_alignment;
+    m_stream.write(padding, padding_size);
+    m_data_end += padding_size;
+  };
+  // The data after a previous footer might not be aligned
+  write_padding();
+  for (std::size_t i = 0; i < table.getColumnInfo()->size(); ++i) {
+    std::vector<BufferLocation> locations {};
+    for (auto& buffer : encodeColumn(table, i)) {
+      locations.push_back(BufferLocation {m_data_end, buffer.size()});
+      m_stream.write(buffer.data(), buffer.size());
+      m_data_end += buffer.size();
+      write_padding();
+    }
+    group.columns.push_back(std::move(locations));
+  }
+  m_footer->row_groups.push_back(std::move(group));
+  m_footer_changed = true;
+  if (!m_stream) {
+    throw Elements::Exception() << "Failed to write to file " << m_filename;
+  }
+}
+
+void BinaryColumnarWriter::writeFooter() {
+  // The footer is written after the data, and any data added later are
+  // written after it, so a valid footer is always at the end of the file
+  auto footer = serializeFooter(*m_footer, m_data_end);
+  openStream();
+  m_stream.seekp(m_data_end);
+  m_stream.write(footer.data(), footer.size());
+  m_stream.flush();
+  if (!m_stream) {
+    throw Elements::Exception() << "Failed to write to file " << m_filename;
+  }
+  m_data_end += footer.size();
+}
+
+} // Table namespace
+} // Euclid namespace
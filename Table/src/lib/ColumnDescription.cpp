@@ -37,8 +37,9 @@ namespace Euclid {
 namespace Table {
 
 ColumnDescription::ColumnDescription(std::string name, std::type_index type,
-                                     std::string unit, std::string description)
-        : name(name), type(type), unit(unit), description(description) {
+                                     std::string unit, std::string description,
+                                     std::shared_ptr<const StringDictionary> dictionary)
+        : name(name), type(type), unit(unit), description(description), dictionary(std::move(dictionary)) {
     if (name.empty()) {
       throw Elements::Exception() << "Empty string name is not allowed";
     }
@@ -46,6 +47,10 @@ ColumnDescription::ColumnDescription(std::string name, std::type_index type,
       throw Elements::Exception() << "Column name '" << name << "' contains "
                                 << "whitespace characters";
     }
+    if (this->dictionary != nullptr && type != typeid(int32_t)) {
+      throw Elements::Exception() << "Dictionary encoded column " << name
+                                << " must have int32_t codes";
+    }
 }
 
 } // Table namespace
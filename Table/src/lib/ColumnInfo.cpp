@@ -23,25 +23,78 @@
  */
 
 #include <algorithm>
-#include <set>
+#include <atomic>
+#include <cstdint>
 #include "ElementsKernel/Exception.h"
 #include "Table/ColumnInfo.h"
 
 namespace Euclid {
 namespace Table {
 
+namespace {
+
+std::atomic<std::uint64_t> next_column_info_id {0};
+
+}
+
 ColumnInfo::ColumnInfo(std::vector<info_type> info_list)
-        : m_info_list{std::move(info_list)} {
+        : m_info_list{std::move(info_list)}, m_id{next_column_info_id++} {
   if (m_info_list.empty()) {
     throw Elements::Exception() << "Empty info_list is not allowed";
   }
-  std::set<std::string> set {};
-  for (const auto& info : m_info_list) {
-    const auto& name = info.name;
-    if (!set.insert(name).second) {  // Check for duplicate names
+  m_name_index.reserve(m_info_list.size());
+  for (std::size_t i = 0; i < m_info_list.size(); ++i) {
+    const auto& name = m_info_list[i].name;
+    if (!m_name_index.emplace(name, i).second) {  // Check for duplicate names
       throw Elements::Exception() << "Duplicate column name " << name;
     }
   }
+  computeCellLayouts();
+}
+
+namespace {
+
+// Returns the size of the inline cells of the given type, or zero if the cells
+// are stored out of line
+std::size_t inlineCellSize(std::type_index type) {
+  if (type == typeid(bool)) {
+    return sizeof(bool);
+  }
+  if (type == typeid(int32_t)) {
+    return sizeof(int32_t);
+  }
+  if (type == typeid(int64_t)) {
+    return sizeof(int64_t);
+  }
+  if (type == typeid(float)) {
+    return sizeof(float);
+  }
+  if (type == typeid(double)) {
+    return sizeof(double);
+  }
+  return 0;
+}
+
+}
+
+void ColumnInfo::computeCellLayouts() {
+  m_cell_layouts.resize(m_info_list.size());
+  // The cells are placed from the biggest to the smallest, so every cell is
+  // aligned to its size without any padding
+  for (std::size_t cell_size : {8, 4, 1}) {
+    for (std::size_t i = 0; i < m_info_list.size(); ++i) {
+      if (inlineCellSize(m_info_list[i].type) == cell_size) {
+        m_cell_layouts[i] = CellLayout {true, m_inline_size};
+        m_inline_size += cell_size;
+      }
+    }
+  }
+  for (std::size_t i = 0; i < m_info_list.size(); ++i) {
+    if (inlineCellSize(m_info_list[i].type) == 0) {
+      m_cell_layouts[i] = CellLayout {false, m_out_of_line_size};
+      ++m_out_of_line_size;
+    }
+  }
 }
 
 bool ColumnInfo::operator==(const ColumnInfo& other) const {
@@ -68,15 +121,38 @@ const ColumnDescription& ColumnInfo::getDescription(std::size_t index) const {
 
 
 std::unique_ptr<size_t> ColumnInfo::find(const std::string& name) const {
-  auto begin = m_info_list.begin();
-  auto end = m_info_list.end();
-  auto iter = std::find_if(begin, end, [&name](const info_type& info){return info.name == name;});
-  if (iter != end) {
-    size_t index {static_cast<size_t>(std::distance(begin, iter))};
-    return std::unique_ptr<size_t> {new size_t {index}}; 
+  auto index = findIndex(name);
+  if (index) {
+    return std::unique_ptr<size_t> {new size_t {*index}};
   }
   return std::unique_ptr<size_t> {};
 }
 
+boost::optional<std::size_t> ColumnInfo::findIndex(const std::string& name) const {
+  auto iter = m_name_index.find(name);
+  if (iter != m_name_index.end()) {
+    return iter->second;
+  }
+  return boost::none;
+}
+
+ColumnInfo::Handle ColumnInfo::getHandle(const std::string& name) const {
+  auto index = findIndex(name);
+  if (!index) {
+    throw Elements::Exception() << "ColumnInfo does not contain column with name " << name;
+  }
+  return Handle {m_id, *index, name};
+}
+
+boost::optional<std::size_t> ColumnInfo::findIndex(const Handle& handle) const {
+  if (handle.m_info_id == m_id) {
+    return handle.m_index;
+  }
+  if (handle.m_index < m_info_list.size() && m_info_list[handle.m_index].name == handle.m_name) {
+    return handle.m_index;
+  }
+  return findIndex(handle.m_name);
+}
+
 }
 } // end of namespace Euclid
\ No newline at end of file
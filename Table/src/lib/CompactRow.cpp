@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/CompactRow.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <cstring>
+#include <new>
+#include "ElementsKernel/Exception.h"
+#include "Table/CompactRow.h"
+
+namespace Euclid {
+namespace Table {
+
+namespace {
+
+std::unique_ptr<std::uint64_t[]> allocateInline(const ColumnInfo& column_info) {
+  std::size_t words = (column_info.getInlineSize() + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+  return std::unique_ptr<std::uint64_t[]> {new std::uint64_t[words]};
+}
+
+}
+
+template <typename T>
+void CompactRow::setInline(std::size_t position, const Row::cell_type& value) {
+  new (reinterpret_cast<char*>(m_inline.get()) + position) T(boost::get<T>(value));
+}
+
+CompactRow::CompactRow(const std::vector<Row::cell_type>& values, const ColumnInfo& column_info)
+        : m_column_info(&column_info), m_inline(allocateInline(column_info)) {
+  if (values.size() != column_info.size()) {
+    throw Elements::Exception() << "Wrong number of row values (" << values.size()
+                              << " instead of " << column_info.size() << ")";
+  }
+  m_out_of_line.reserve(column_info.getOutOfLineSize());
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    auto type = column_info.getDescription(i).type;
+    if (std::type_index{values[i].type()} != type) {
+      throw Elements::Exception() << "Incompatible cell type";
+    }
+    auto& layout = column_info.getCellLayout(i);
+    if (!layout.is_inline) {
+      m_out_of_line.push_back(values[i]);
+    } else if (type == typeid(bool)) {
+      setInline<bool>(layout.position, values[i]);
+    } else if (type == typeid(int32_t)) {
+      setInline<int32_t>(layout.position, values[i]);
+    } else if (type == typeid(int64_t)) {
+      setInline<int64_t>(layout.position, values[i]);
+    } else if (type == typeid(float)) {
+      setInline<float>(layout.position, values[i]);
+    } else {
+      setInline<double>(layout.position, values[i]);
+    }
+  }
+}
+
+CompactRow::CompactRow(const Row& row)
+        : CompactRow(std::vector<Row::cell_type>(row.begin(), row.end()), *row.getColumnInfo()) {
+}
+
+CompactRow::CompactRow(const CompactRow& other)
+        : m_column_info(other.m_column_info), m_inline(nullptr), m_out_of_line(other.m_out_of_line) {
+  // A moved from row has no inline buffer, so its copies do not have one either
+  if (other.m_inline != nullptr) {
+    m_inline = allocateInline(*m_column_info);
+    // The inline cells are trivially copyable
+    std::memcpy(m_inline.get(), other.m_inline.get(), m_column_info->getInlineSize());
+  }
+}
+
+CompactRow& CompactRow::operator=(const CompactRow& other) {
+  if (this != &other) {
+    CompactRow copy {other};
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+void CompactRow::checkType(std::size_t index, std::type_index type) const {
+  if (index >= m_column_info->size()) {
+    throw Elements::Exception("Index out of bounds");
+  }
+  if (m_column_info->getDescription(index).type != type) {
+    throw Elements::Exception() << "Column " << m_column_info->getDescription(index).name
+                                << " has different type than the requested";
+  }
+}
+
+Row::cell_type CompactRow::operator[](std::size_t index) const {
+  if (index >= m_column_info->size()) {
+    throw Elements::Exception("Index out of bounds");
+  }
+  auto& layout = m_column_info->getCellLayout(index);
+  if (!layout.is_inline) {
+    return m_out_of_line[layout.position];
+  }
+  auto type = m_column_info->getDescription(index).type;
+  if (type == typeid(bool)) {
+    return get<bool>(index);
+  } else if (type == typeid(int32_t)) {
+    return get<int32_t>(index);
+  } else if (type == typeid(int64_t)) {
+    return get<int64_t>(index);
+  } else if (type == typeid(float)) {
+    return get<float>(index);
+  }
+  return get<double>(index);
+}
+
+Row CompactRow::toRow(std::shared_ptr<ColumnInfo> column_info) const {
+  if (column_info.get() != m_column_info && *column_info != *m_column_info) {
+    throw Elements::Exception() << "Cannot convert CompactRow to Row with different columns";
+  }
+  std::vector<Row::cell_type> values {};
+  values.reserve(size());
+  for (std::size_t i = 0; i < size(); ++i) {
+    values.push_back((*this)[i]);
+  }
+  return Row {std::move(values), std::move(column_info)};
+}
+
+} // Table namespace
+} // Euclid namespace
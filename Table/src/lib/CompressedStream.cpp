@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file src/lib/CompressedStream.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/zstd.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filtering_streambuf.hpp>
+#include "ElementsKernel/Exception.h"
+#include "AlexandriaKernel/memory_tools.h"
+#include "Table/CompressedStream.h"
+
+namespace Euclid {
+namespace Table {
+
+Compression detectCompression(const std::string& filename) {
+  std::ifstream in {filename, std::ios::binary};
+  if (!in) {
+    throw Elements::Exception() << "Failed to open file " << filename;
+  }
+  unsigned char magic[4] = {0, 0, 0, 0};
+  in.read(reinterpret_cast<char*>(magic), 4);
+  if (magic[0] == 0x1f && magic[1] == 0x8b) {
+    return Compression::GZIP;
+  }
+  if (magic[0] == 'B' && magic[1] == 'Z' && magic[2] == 'h' && magic[3] >= '1' && magic[3] <= '9') {
+    return Compression::BZIP2;
+  }
+  if (magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) {
+    return Compression::ZSTD;
+  }
+  return Compression::NONE;
+}
+
+Compression compressionFromExtension(const std::string& filename) {
+  if (boost::iends_with(filename, ".gz")) {
+    return Compression::GZIP;
+  }
+  if (boost::iends_with(filename, ".bz2")) {
+    return Compression::BZIP2;
+  }
+  if (boost::iends_with(filename, ".zst")) {
+    return Compression::ZSTD;
+  }
+  return Compression::NONE;
+}
+
+namespace {
+
+// The size of the chunks the data are decompressed in
+const std::size_t chunk_size = 1 << 20;
+
+// The number of already consumed characters kept when a new chunk is fetched,
+// so short backward seeks (like the ones of the StreamRewinder) are cheap
+const std::size_t kept_size = 1 << 16;
+
+// The maximum number of chunks the helper thread prepares in advance
+const std::size_t max_queued_chunks = 4;
+
+class ChunkSource {
+public:
+  virtual ~ChunkSource() = default;
+  /// Returns the next decompressed chunk or an empty vector at the end of data
+  virtual std::vector<char> next() = 0;
+};
+
+class DirectSource : public ChunkSource {
+
+public:
+
+  DirectSource(const std::string& filename, Compression compression) : m_filename(filename) {
+    switch (compression) {
+      case Compression::GZIP:
+        m_in.push(boost::iostreams::gzip_decompressor());
+        break;
+      case Compression::BZIP2:
+        m_in.push(boost::iostreams::bzip2_decompressor());
+        break;
+      case Compression::ZSTD:
+        m_in.push(boost::iostreams::zstd_decompressor());
+        break;
+      case Compression::NONE:
+        break;
+    }
+    m_in.push(boost::iostreams::file_source(filename, std::ios::in | std::ios::binary));
+  }
+
+  std::vector<char> next() override {
+    std::vector<char> chunk(chunk_size);
+    m_in.read(chunk.data(), chunk.size());
+    if (m_in.bad()) {
+      throw Elements::Exception() << "Failed to decompress file " << m_filename;
+    }
+    chunk.resize(m_in.gcount());
+    return chunk;
+  }
+
+private:
+
+  std::string m_filename;
+  boost::iostreams::filtering_istream m_in;
+
+};
+
+class ThreadedSource : public ChunkSource {
+
+public:
+
+  ThreadedSource(const std::string& filename, Compression compression)
+          : m_source(filename, compression), m_thread(&ThreadedSource::produce, this) {
+  }
+
+  ~ThreadedSource() {
+    {
+      std::lock_guard<std::mutex> lock {m_mutex};
+      m_stop = true;
+    }
+    m_condition.notify_all();
+    m_thread.join();
+  }
+
+  std::vector<char> next() override {
+    std::unique_lock<std::mutex> lock {m_mutex};
+    m_condition.wait(lock, [this]() { return !m_queue.empty() || m_done; });
+    if (!m_queue.empty()) {
+      auto chunk = std::move(m_queue.front());
+      m_queue.pop_front();
+      m_condition.notify_all();
+      return chunk;
+    }
+    if (m_exception) {
+      std::rethrow_exception(m_exception);
+    }
+    return {};
+  }
+
+private:
+
+  void produce() {
+    try {
+      while (true) {
+        auto chunk = m_source.next();
+        std::unique_lock<std::mutex> lock {m_mutex};
+        m_condition.wait(lock, [this]() { return m_queue.size() < max_queued_chunks || m_stop; });
+        if (m_stop || chunk.empty()) {
+          break;
+        }
+        m_queue.push_back(std::move(chunk));
+        m_condition.notify_all();
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock {m_mutex};
+      m_exception = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock {m_mutex};
+    m_done = true;
+    m_condition.notify_all();
+  }
+
+  DirectSource m_source;
+  std::mutex m_mutex {};
+  std::condition_variable m_condition {};
+  std::deque<std::vector<char>> m_queue {};
+  bool m_stop = false;
+  bool m_done = false;
+  std::exception_ptr m_exception {};
+  // The thread must be the last member, so it starts after everything else is
+  // initialized
+  std::thread m_thread;
+
+};
+
+class DecompressingBuffer : public std::streambuf {
+
+public:
+
+  DecompressingBuffer(const std::string& filename, bool threaded)
+          : m_filename(filename), m_compression(detectCompression(filename)), m_threaded(threaded) {
+    restart();
+  }
+
+protected:
+
+  int_type underflow() override {
+    if (gptr() == egptr() && !fetch()) {
+      return traits_type::eof();
+    }
+    return traits_type::to_int_type(*gptr());
+  }
+
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+    if (!(which & std::ios_base::in)) {
+      return pos_type(off_type(-1));
+    }
+    if (dir == std::ios_base::cur) {
+      return seekTo(m_buffer_start + (gptr() - eback()) + off);
+    }
+    if (dir == std::ios_base::end) {
+      // The length of the decompressed data is not known, so we have to
+      // decompress everything
+      setg(eback(), egptr(), egptr());
+      while (fetch()) {
+        setg(eback(), egptr(), egptr());
+      }
+      return seekTo(m_buffer_start + (egptr() - eback()) + off);
+    }
+    return seekTo(off);
+  }
+
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+    if (!(which & std::ios_base::in)) {
+      return pos_type(off_type(-1));
+    }
+    return seekTo(off_type(pos));
+  }
+
+private:
+
+  void restart() {
+    // The old source must be destroyed first, to stop any running thread
+    m_source.reset();
+    if (m_threaded) {
+      m_source = make_unique<ThreadedSource>(m_filename, m_compression);
+    } else {
+      m_source = make_unique<DirectSource>(m_filename, m_compression);
+    }
+    m_data.clear();
+    m_buffer_start = 0;
+    setg(nullptr, nullptr, nullptr);
+  }
+
+  // Replaces the consumed data with the next chunk, keeping the last kept_size
+  // characters. Returns false if there are no more data.
+  bool fetch() {
+    auto chunk = m_source->next();
+    if (chunk.empty()) {
+      return false;
+    }
+    std::size_t used = gptr() - eback();
+    std::size_t keep = std::min(used, kept_size);
+    m_data.erase(m_data.begin(), m_data.begin() + (used - keep));
+    m_data.resize(keep);
+    m_data.insert(m_data.end(), chunk.begin(), chunk.end());
+    m_buffer_start += used - keep;
+    setg(m_data.data(), m_data.data() + keep, m_data.data() + m_data.size());
+    return true;
+  }
+
+  pos_type seekTo(off_type target) {
+    if (target < 0) {
+      return pos_type(off_type(-1));
+    }
+    if (target < m_buffer_start) {
+      restart();
+    }
+    while (target > m_buffer_start + (egptr() - eback())) {
+      setg(eback(), egptr(), egptr());
+      if (!fetch()) {
+        return pos_type(off_type(-1));
+      }
+    }
+    setg(eback(), eback() + (target - m_buffer_start), egptr());
+    return pos_type(target);
+  }
+
+  std::string m_filename;
+  Compression m_compression;
+  bool m_threaded;
+  std::unique_ptr<ChunkSource> m_source {};
+  std::vector<char> m_data {};
+  off_type m_buffer_start = 0;
+
+};
+
+} // end of anonymous namespace
+
+CompressedIStream::CompressedIStream(const std::string& filename, bool decompress_in_thread)
+        : std::istream(nullptr), m_buffer(make_unique<DecompressingBuffer>(filename, decompress_in_thread)) {
+  rdbuf(m_buffer.get());
+}
+
+CompressedIStream::~CompressedIStream() = default;
+
+CompressedOStream::CompressedOStream(const std::string& filename, Compression compression)
+        : std::ostream(nullptr) {
+  auto buffer = make_unique<boost::iostreams::filtering_ostreambuf>();
+  switch (compression) {
+    case Compression::GZIP:
+      buffer->push(boost::iostreams::gzip_compressor());
+      break;
+    case Compression::BZIP2:
+      buffer->push(boost::iostreams::bzip2_compressor());
+      break;
+    case Compression::ZSTD:
+      buffer->push(boost::iostreams::zstd_compressor());
+      break;
+    case Compression::NONE:
+      break;
+  }
+  boost::iostreams::file_sink sink {filename, std::ios::out | std::ios::binary | std::ios::trunc};
+  if (!sink.is_open()) {
+    throw Elements::Exception() << "Failed to open file " << filename << " for writing";
+  }
+  buffer->push(sink);
+  m_buffer = std::move(buffer);
+  rdbuf(m_buffer.get());
+}
+
+CompressedOStream::~CompressedOStream() {
+  flush();
+  // Destroying the filtering buffer closes the chain, which writes the trailer
+  // of the compressed data
+  m_buffer.reset();
+}
+
+} // Table namespace
+} // Euclid namespace
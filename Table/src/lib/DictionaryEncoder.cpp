@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file src/lib/DictionaryEncoder.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <limits>
+#include "ElementsKernel/Exception.h"
+#include "DictionaryEncoder.h"
+
+namespace Euclid {
+namespace Table {
+
+int32_t DictionaryEncoder::encode(const std::string& value) {
+  auto found = m_codes.find(value);
+  if (found != m_codes.end()) {
+    return found->second;
+  }
+  if (m_values.size() > static_cast<std::size_t>(std::numeric_limits<int32_t>::max())) {
+    throw Elements::Exception() << "Too many distinct values for a dictionary encoded column";
+  }
+  int32_t code = static_cast<int32_t>(m_values.size());
+  m_values.push_back(value);
+  m_codes.emplace(value, code);
+  m_dictionary.reset();
+  return code;
+}
+
+std::shared_ptr<const StringDictionary> DictionaryEncoder::getDictionary() {
+  if (m_dictionary == nullptr) {
+    m_dictionary = std::make_shared<StringDictionary>(m_values);
+  }
+  return m_dictionary;
+}
+
+std::map<std::size_t, DictionaryEncoder> selectDictionaryColumns(const Table& table,
+                                                                 std::size_t max_cardinality) {
+  std::map<std::size_t, DictionaryEncoder> result {};
+  auto& info = *table.getColumnInfo();
+  for (std::size_t i = 0; i < info.size(); ++i) {
+    if (info.getDescription(i).type != typeid(std::string)) {
+      continue;
+    }
+    DictionaryEncoder encoder {};
+    bool low_cardinality = true;
+    for (auto& row : table) {
+      encoder.encode(boost::get<std::string>(row[i]));
+      if (encoder.size() > max_cardinality) {
+        low_cardinality = false;
+        break;
+      }
+    }
+    if (low_cardinality) {
+      result.emplace(i, std::move(encoder));
+    }
+  }
+  return result;
+}
+
+Table encodeTable(const Table& table, std::map<std::size_t, DictionaryEncoder>& encoders,
+                  std::shared_ptr<ColumnInfo>& column_info) {
+  auto& info = *table.getColumnInfo();
+
+  // All the values are encoded before the dictionaries are retrieved, so
+  // there is a single dictionary per column
+  std::map<std::size_t, std::vector<int32_t>> codes {};
+  for (auto& encoder : encoders) {
+    auto& column_codes = codes[encoder.first];
+    column_codes.reserve(table.size());
+    for (auto& row : table) {
+      column_codes.push_back(encoder.second.encode(boost::get<std::string>(row[encoder.first])));
+    }
+  }
+
+  std::vector<ColumnDescription> descriptions {};
+  for (std::size_t i = 0; i < info.size(); ++i) {
+    auto& description = info.getDescription(i);
+    auto encoder = encoders.find(i);
+    if (encoder == encoders.end()) {
+      descriptions.push_back(description);
+    } else {
+      descriptions.emplace_back(description.name, typeid(int32_t), description.unit, description.description,
+                                encoder->second.getDictionary());
+    }
+  }
+  auto new_info = std::make_shared<ColumnInfo>(std::move(descriptions));
+  if (column_info == nullptr || *column_info != *new_info) {
+    column_info = new_info;
+  }
+
+  std::vector<const std::vector<int32_t>*> column_codes (info.size(), nullptr);
+  for (auto& column : codes) {
+    column_codes[column.first] = &column.second;
+  }
+  std::vector<Row> rows {};
+  rows.reserve(table.size());
+  for (std::size_t row = 0; row < table.size(); ++row) {
+    std::vector<Row::cell_type> cells {};
+    cells.reserve(info.size());
+    for (std::size_t i = 0; i < info.size(); ++i) {
+      if (column_codes[i] == nullptr) {
+        cells.push_back(table[row][i]);
+      } else {
+        cells.push_back((*column_codes[i])[row]);
+      }
+    }
+    rows.emplace_back(std::move(cells), column_info);
+  }
+  return Table{std::move(rows), table.getValidityBitmaps()};
+}
+
+} // Table namespace
+} // Euclid namespace
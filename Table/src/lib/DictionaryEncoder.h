@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file src/lib/DictionaryEncoder.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef TABLE_DICTIONARYENCODER_H
+#define TABLE_DICTIONARYENCODER_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ElementsKernel/Export.h"
+#include "Table/StringDictionary.h"
+#include "Table/Table.h"
+
+namespace Euclid {
+namespace Table {
+
+/**
+ * @class DictionaryEncoder
+ * @brief Assigns codes to the values of a string column, growing its dictionary
+ * @details
+ * The codes are assigned in the order the values are first met, so the codes
+ * of the values already encoded never change, and the rows of consecutive
+ * chunks of a table can be encoded with the same encoder.
+ */
+class ELEMENTS_API DictionaryEncoder {
+
+public:
+
+  /// Returns the code of the value, adding the value in the dictionary if needed
+  int32_t encode(const std::string& value);
+
+  /// Returns the number of distinct values encoded so far
+  std::size_t size() const {
+    return m_values.size();
+  }
+
+  /// Returns the dictionary of all the values encoded so far. The same
+  /// instance is returned for as long as no new values are encoded.
+  std::shared_ptr<const StringDictionary> getDictionary();
+
+private:
+
+  std::vector<std::string> m_values {};
+  std::unordered_map<std::string, int32_t> m_codes {};
+  std::shared_ptr<const StringDictionary> m_dictionary {};
+
+};
+
+/**
+ * @brief
+ * Returns encoders for the string columns of the table which have at most
+ * max_cardinality distinct values, by column index
+ * @details
+ * The returned encoders have already encoded the values of the table. The
+ * columns which are already dictionary encoded are not selected.
+ */
+ELEMENTS_API std::map<std::size_t, DictionaryEncoder> selectDictionaryColumns(const Table& table,
+                                                                              std::size_t max_cardinality);
+
+/**
+ * @brief
+ * Replaces the columns of the table which have an encoder with their
+ * dictionary encoded version
+ * @param table
+ *    The table to encode
+ * @param encoders
+ *    The encoders of the columns to encode, by column index
+ * @param column_info
+ *    The ColumnInfo of the previous encoded table, or null. If the result
+ *    has the same columns, it shares it, so the consecutive chunks of a
+ *    table share their ColumnInfo while their dictionaries do not change.
+ *    It is updated with the ColumnInfo of the result.
+ * @return
+ *    The encoded table
+ */
+ELEMENTS_API Table encodeTable(const Table& table, std::map<std::size_t, DictionaryEncoder>& encoders,
+                               std::shared_ptr<ColumnInfo>& column_info);
+
+}
+} // end of namespace Euclid
+
+#endif /* TABLE_DICTIONARYENCODER_H */
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file src/lib/DictionaryEncoding.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include "Table/DictionaryEncoding.h"
+#include "DictionaryEncoder.h"
+
+namespace Euclid {
+namespace Table {
+
+Table encodeDictionaryColumns(const Table& table, std::size_t max_cardinality) {
+  auto encoders = selectDictionaryColumns(table, max_cardinality);
+  std::shared_ptr<ColumnInfo> column_info {};
+  return encodeTable(table, encoders, column_info);
+}
+
+Table decodeDictionaryColumns(const Table& table) {
+  auto& info = *table.getColumnInfo();
+  std::vector<ColumnDescription> descriptions {};
+  for (std::size_t i = 0; i < info.size(); ++i) {
+    auto& description = info.getDescription(i);
+    if (description.dictionary == nullptr) {
+      descriptions.push_back(description);
+    } else {
+      descriptions.emplace_back(description.name, typeid(std::string), description.unit, description.description);
+    }
+  }
+  auto column_info = std::make_shared<ColumnInfo>(std::move(descriptions));
+
+  std::vector<Row> rows {};
+  rows.reserve(table.size());
+  for (auto& row : table) {
+    std::vector<Row::cell_type> cells {};
+    cells.reserve(info.size());
+    for (std::size_t i = 0; i < info.size(); ++i) {
+      auto& dictionary = info.getDescription(i).dictionary;
+      if (dictionary == nullptr) {
+        cells.push_back(row[i]);
+      } else {
+        cells.push_back(dictionary->decode(boost::get<int32_t>(row[i])));
+      }
+    }
+    rows.emplace_back(std::move(cells), column_info);
+  }
+  return Table{std::move(rows), table.getValidityBitmaps()};
+}
+
+bool hasDictionaryColumns(const ColumnInfo& column_info) {
+  for (std::size_t i = 0; i < column_info.size(); ++i) {
+    if (column_info.getDescription(i).dictionary != nullptr) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // Table namespace
+} // Euclid namespace
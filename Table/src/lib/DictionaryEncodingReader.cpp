@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file src/lib/DictionaryEncodingReader.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include "ElementsKernel/Exception.h"
+#include "AlexandriaKernel/memory_tools.h"
+#include "Table/DictionaryEncodingReader.h"
+#include "DictionaryEncoder.h"
+
+namespace Euclid {
+namespace Table {
+
+DictionaryEncodingReader::DictionaryEncodingReader(std::unique_ptr<TableReader> reader,
+                                                   std::size_t max_cardinality)
+        : m_reader(std::move(reader)), m_max_cardinality(max_cardinality) {
+  if (m_reader == nullptr) {
+    throw Elements::Exception() << "DictionaryEncodingReader needs a reader to wrap";
+  }
+}
+
+// Defined here, where the DictionaryEncoder is a complete type
+DictionaryEncodingReader::DictionaryEncodingReader(DictionaryEncodingReader&&) = default;
+DictionaryEncodingReader& DictionaryEncodingReader::operator=(DictionaryEncodingReader&&) = default;
+DictionaryEncodingReader::~DictionaryEncodingReader() = default;
+
+std::string DictionaryEncodingReader::getComment() {
+  return m_reader->getComment();
+}
+
+const ColumnInfo& DictionaryEncodingReader::getInfo() {
+  return m_reader->getInfo();
+}
+
+Table DictionaryEncodingReader::readImpl(long rows) {
+  auto table = m_reader->read(rows);
+  if (m_encoders == nullptr) {
+    m_encoders = make_unique<std::map<std::size_t, DictionaryEncoder>>(
+            selectDictionaryColumns(table, m_max_cardinality));
+  }
+  if (m_encoders->empty()) {
+    return table;
+  }
+  return encodeTable(table, *m_encoders, m_column_info);
+}
+
+void DictionaryEncodingReader::skip(long rows) {
+  m_reader->skip(rows);
+}
+
+bool DictionaryEncodingReader::hasMoreRows() {
+  return m_reader->hasMoreRows();
+}
+
+std::size_t DictionaryEncodingReader::rowsLeft() {
+  return m_reader->rowsLeft();
+}
+
+} // Table namespace
+} // Euclid namespace
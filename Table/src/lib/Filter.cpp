@@ -0,0 +1,518 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/Filter.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <set>
+#include <type_traits>
+#include "ElementsKernel/Exception.h"
+#include "Table/Filter.h"
+
+namespace Euclid {
+namespace Table {
+
+struct Filter::Node {
+  virtual ~Node() = default;
+  virtual void evaluate(const std::map<std::string, column_values>& columns,
+                        const std::map<std::string, ValidityBitmap>& validity, std::size_t rows,
+                        mask_type& mask) const = 0;
+  virtual void addColumns(std::set<std::string>& columns) const = 0;
+  virtual bool mayMatch(const std::map<std::string, ColumnStatistics>& statistics) const = 0;
+};
+
+namespace {
+
+typedef Filter::Operator Operator;
+
+class SizeVisitor : public boost::static_visitor<std::size_t> {
+public:
+  template <typename T>
+  std::size_t operator()(const std::vector<T>& values) const {
+    return values.size();
+  }
+  std::size_t operator()(const Filter::DictionaryCodes& values) const {
+    return values.codes.size();
+  }
+};
+
+const Filter::column_values& getColumn(const std::map<std::string, Filter::column_values>& columns,
+                                       const std::string& name, std::size_t rows) {
+  auto column = columns.find(name);
+  if (column == columns.end()) {
+    throw Elements::Exception() << "Missing values of filter column " << name;
+  }
+  if (boost::apply_visitor(SizeVisitor{}, column->second) != rows) {
+    throw Elements::Exception() << "Wrong number of values for filter column " << name;
+  }
+  return column->second;
+}
+
+// The rows with missing values do not pass any comparison
+void applyValidity(const std::map<std::string, ValidityBitmap>& validity, const std::string& name,
+                   Filter::mask_type& mask) {
+  auto bitmap = validity.find(name);
+  if (bitmap == validity.end()) {
+    return;
+  }
+  if (bitmap->second.size() != mask.size()) {
+    throw Elements::Exception() << "Wrong size of the validity bitmap of filter column " << name;
+  }
+  for (std::size_t i = 0; i < mask.size(); ++i) {
+    mask[i] &= bitmap->second.isValid(i);
+  }
+}
+
+// The loops below do not have any branches, so they are vectorized by the
+// compiler. The values are converted to the type of the literal V before
+// they are compared.
+template <typename V, typename T>
+void compareValues(const std::vector<T>& values, Operator op, const V& literal, std::uint8_t* mask) {
+  const T* data = values.data();
+  std::size_t size = values.size();
+  switch (op) {
+    case Operator::LESS:
+      for (std::size_t i = 0; i < size; ++i) {
+        mask[i] = static_cast<const V&>(data[i]) < literal;
+      }
+      break;
+    case Operator::LESS_EQUAL:
+      for (std::size_t i = 0; i < size; ++i) {
+        mask[i] = static_cast<const V&>(data[i]) <= literal;
+      }
+      break;
+    case Operator::GREATER:
+      for (std::size_t i = 0; i < size; ++i) {
+        mask[i] = static_cast<const V&>(data[i]) > literal;
+      }
+      break;
+    case Operator::GREATER_EQUAL:
+      for (std::size_t i = 0; i < size; ++i) {
+        mask[i] = static_cast<const V&>(data[i]) >= literal;
+      }
+      break;
+    case Operator::EQUAL:
+      for (std::size_t i = 0; i < size; ++i) {
+        mask[i] = static_cast<const V&>(data[i]) == literal;
+      }
+      break;
+    case Operator::NOT_EQUAL:
+      for (std::size_t i = 0; i < size; ++i) {
+        mask[i] = static_cast<const V&>(data[i]) != literal;
+      }
+      break;
+  }
+}
+
+template <typename V, typename T>
+void rangeValues(const std::vector<T>& values, const V& min, const V& max, std::uint8_t* mask) {
+  const T* data = values.data();
+  std::size_t size = values.size();
+  for (std::size_t i = 0; i < size; ++i) {
+    mask[i] = (static_cast<const V&>(data[i]) >= min) & (static_cast<const V&>(data[i]) <= max);
+  }
+}
+
+// Selects the rows of a dictionary encoded column by the result of the
+// comparison of the dictionary values (one per code)
+void selectCodes(const std::vector<int32_t>& codes, const Filter::mask_type& matches, std::uint8_t* mask) {
+  const int32_t* data = codes.data();
+  std::size_t size = codes.size();
+  for (std::size_t i = 0; i < size; ++i) {
+    if (data[i] < 0 || static_cast<std::size_t>(data[i]) >= matches.size()) {
+      throw Elements::Exception() << "Dictionary code " << data[i] << " is out of range [0, "
+                                  << matches.size() << ")";
+    }
+    mask[i] = matches[data[i]];
+  }
+}
+
+// Integer columns are compared with integer literals as int64_t and all the
+// other numeric combinations as double
+template <typename T>
+bool useIntegers(const Filter::value_type& literal) {
+  return std::is_integral<T>::value && literal.which() == 0;
+}
+
+double asDouble(const Filter::value_type& literal) {
+  if (literal.which() == 0) {
+    return boost::get<int64_t>(literal);
+  }
+  return boost::get<double>(literal);
+}
+
+class CompareVisitor : public boost::static_visitor<void> {
+public:
+  CompareVisitor(const std::string& column, Operator op, const Filter::value_type& literal, std::uint8_t* mask)
+          : m_column(column), m_op(op), m_literal(literal), m_mask(mask) {
+  }
+  template <typename T>
+  void operator()(const std::vector<T>& values) const {
+    if (m_literal.which() == 2) {
+      throw Elements::Exception() << "Numeric column " << m_column << " cannot be compared with a string";
+    }
+    if (useIntegers<T>(m_literal)) {
+      compareValues(values, m_op, boost::get<int64_t>(m_literal), m_mask);
+    } else {
+      compareValues(values, m_op, asDouble(m_literal), m_mask);
+    }
+  }
+  void operator()(const std::vector<std::string>& values) const {
+    if (m_literal.which() != 2) {
+      throw Elements::Exception() << "String column " << m_column << " can only be compared with strings";
+    }
+    compareValues(values, m_op, boost::get<std::string>(m_literal), m_mask);
+  }
+  void operator()(const Filter::DictionaryCodes& values) const {
+    if (m_literal.which() != 2) {
+      throw Elements::Exception() << "String column " << m_column << " can only be compared with strings";
+    }
+    auto& literal = boost::get<std::string>(m_literal);
+    if (m_op == Operator::EQUAL || m_op == Operator::NOT_EQUAL) {
+      // A value missing from the dictionary gets a code no row has
+      auto code = values.dictionary->find(literal);
+      compareValues(values.codes, m_op, code ? *code : int32_t{-1}, m_mask);
+    } else {
+      Filter::mask_type matches (values.dictionary->size());
+      compareValues(values.dictionary->getValues(), m_op, literal, matches.data());
+      selectCodes(values.codes, matches, m_mask);
+    }
+  }
+private:
+  const std::string& m_column;
+  Operator m_op;
+  const Filter::value_type& m_literal;
+  std::uint8_t* m_mask;
+};
+
+class RangeVisitor : public boost::static_visitor<void> {
+public:
+  RangeVisitor(const std::string& column, const Filter::value_type& min, const Filter::value_type& max,
+               std::uint8_t* mask)
+          : m_column(column), m_min(min), m_max(max), m_mask(mask) {
+  }
+  template <typename T>
+  void operator()(const std::vector<T>& values) const {
+    if (m_min.which() == 2 || m_max.which() == 2) {
+      throw Elements::Exception() << "Numeric column " << m_column << " cannot be compared with a string";
+    }
+    if (useIntegers<T>(m_min) && useIntegers<T>(m_max)) {
+      rangeValues(values, boost::get<int64_t>(m_min), boost::get<int64_t>(m_max), m_mask);
+    } else {
+      rangeValues(values, asDouble(m_min), asDouble(m_max), m_mask);
+    }
+  }
+  void operator()(const std::vector<std::string>& values) const {
+    if (m_min.which() != 2 || m_max.which() != 2) {
+      throw Elements::Exception() << "String column " << m_column << " can only be compared with strings";
+    }
+    rangeValues(values, boost::get<std::string>(m_min), boost::get<std::string>(m_max), m_mask);
+  }
+  void operator()(const Filter::DictionaryCodes& values) const {
+    if (m_min.which() != 2 || m_max.which() != 2) {
+      throw Elements::Exception() << "String column " << m_column << " can only be compared with strings";
+    }
+    Filter::mask_type matches (values.dictionary->size());
+    rangeValues(values.dictionary->getValues(), boost::get<std::string>(m_min), boost::get<std::string>(m_max),
+                matches.data());
+    selectCodes(values.codes, matches, m_mask);
+  }
+private:
+  const std::string& m_column;
+  const Filter::value_type& m_min;
+  const Filter::value_type& m_max;
+  std::uint8_t* m_mask;
+};
+
+const ColumnStatistics* findStatistics(const std::map<std::string, ColumnStatistics>& statistics,
+                                       const std::string& column) {
+  auto found = statistics.find(column);
+  return found == statistics.end() ? nullptr : &found->second;
+}
+
+// The statistics are converted the same way as the column values when the
+// filter is evaluated. The conversion of int64_t to double keeps the order,
+// so the converted minimum and maximum are still bounds of the values.
+template <typename V>
+V statisticsValue(const ColumnStatistics::value_type& value) {
+  if (value.which() == 0) {
+    return static_cast<V>(boost::get<int64_t>(value));
+  }
+  return static_cast<V>(boost::get<double>(value));
+}
+
+template <typename V>
+bool mayCompare(const ColumnStatistics& statistics, Operator op, const V& literal) {
+  V min = statisticsValue<V>(statistics.min);
+  V max = statisticsValue<V>(statistics.max);
+  switch (op) {
+    case Operator::LESS:
+      return min < literal;
+    case Operator::LESS_EQUAL:
+      return min <= literal;
+    case Operator::GREATER:
+      return max > literal;
+    case Operator::GREATER_EQUAL:
+      return max >= literal;
+    case Operator::EQUAL:
+      return min <= literal && literal <= max;
+    case Operator::NOT_EQUAL:
+      return statistics.null_count > 0 || min != literal || max != literal;
+  }
+  return true;
+}
+
+class CompareNode : public Filter::Node {
+public:
+  CompareNode(std::string column, Operator op, Filter::value_type literal)
+          : m_column(std::move(column)), m_op(op), m_literal(std::move(literal)) {
+  }
+  void evaluate(const std::map<std::string, Filter::column_values>& columns,
+                const std::map<std::string, ValidityBitmap>& validity, std::size_t rows,
+                Filter::mask_type& mask) const override {
+    mask.resize(rows);
+    boost::apply_visitor(CompareVisitor{m_column, m_op, m_literal, mask.data()}, getColumn(columns, m_column, rows));
+    applyValidity(validity, m_column, mask);
+  }
+  void addColumns(std::set<std::string>& columns) const override {
+    columns.insert(m_column);
+  }
+  bool mayMatch(const std::map<std::string, ColumnStatistics>& statistics) const override {
+    auto column = findStatistics(statistics, m_column);
+    if (column == nullptr || m_literal.which() == 2) {
+      return true;
+    }
+    // All the comparisons with NaN are false, except of the NOT_EQUAL
+    if (!column->hasValues()) {
+      return m_op == Operator::NOT_EQUAL;
+    }
+    if (column->min.which() == 0 && m_literal.which() == 0) {
+      return mayCompare(*column, m_op, boost::get<int64_t>(m_literal));
+    }
+    return mayCompare(*column, m_op, asDouble(m_literal));
+  }
+private:
+  std::string m_column;
+  Operator m_op;
+  Filter::value_type m_literal;
+};
+
+class RangeNode : public Filter::Node {
+public:
+  RangeNode(std::string column, Filter::value_type min, Filter::value_type max)
+          : m_column(std::move(column)), m_min(std::move(min)), m_max(std::move(max)) {
+  }
+  void evaluate(const std::map<std::string, Filter::column_values>& columns,
+                const std::map<std::string, ValidityBitmap>& validity, std::size_t rows,
+                Filter::mask_type& mask) const override {
+    mask.resize(rows);
+    boost::apply_visitor(RangeVisitor{m_column, m_min, m_max, mask.data()}, getColumn(columns, m_column, rows));
+    applyValidity(validity, m_column, mask);
+  }
+  void addColumns(std::set<std::string>& columns) const override {
+    columns.insert(m_column);
+  }
+  bool mayMatch(const std::map<std::string, ColumnStatistics>& statistics) const override {
+    auto column = findStatistics(statistics, m_column);
+    if (column == nullptr || m_min.which() == 2 || m_max.which() == 2) {
+      return true;
+    }
+    if (!column->hasValues()) {
+      return false;
+    }
+    if (column->min.which() == 0 && m_min.which() == 0 && m_max.which() == 0) {
+      return statisticsValue<int64_t>(column->min) <= boost::get<int64_t>(m_max)
+             && statisticsValue<int64_t>(column->max) >= boost::get<int64_t>(m_min);
+    }
+    return statisticsValue<double>(column->min) <= asDouble(m_max)
+           && statisticsValue<double>(column->max) >= asDouble(m_min);
+  }
+private:
+  std::string m_column;
+  Filter::value_type m_min;
+  Filter::value_type m_max;
+};
+
+class LogicalNode : public Filter::Node {
+public:
+  LogicalNode(std::shared_ptr<const Filter::Node> left, std::shared_ptr<const Filter::Node> right, bool is_and)
+          : m_left(std::move(left)), m_right(std::move(right)), m_is_and(is_and) {
+  }
+  void evaluate(const std::map<std::string, Filter::column_values>& columns,
+                const std::map<std::string, ValidityBitmap>& validity, std::size_t rows,
+                Filter::mask_type& mask) const override {
+    Filter::mask_type right;
+    m_left->evaluate(columns, validity, rows, mask);
+    m_right->evaluate(columns, validity, rows, right);
+    if (m_is_and) {
+      for (std::size_t i = 0; i < rows; ++i) {
+        mask[i] &= right[i];
+      }
+    } else {
+      for (std::size_t i = 0; i < rows; ++i) {
+        mask[i] |= right[i];
+      }
+    }
+  }
+  void addColumns(std::set<std::string>& columns) const override {
+    m_left->addColumns(columns);
+    m_right->addColumns(columns);
+  }
+  bool mayMatch(const std::map<std::string, ColumnStatistics>& statistics) const override {
+    if (m_is_and) {
+      return m_left->mayMatch(statistics) && m_right->mayMatch(statistics);
+    }
+    return m_left->mayMatch(statistics) || m_right->mayMatch(statistics);
+  }
+private:
+  std::shared_ptr<const Filter::Node> m_left;
+  std::shared_ptr<const Filter::Node> m_right;
+  bool m_is_and;
+};
+
+class NotNode : public Filter::Node {
+public:
+  NotNode(std::shared_ptr<const Filter::Node> child) : m_child(std::move(child)) {
+  }
+  void evaluate(const std::map<std::string, Filter::column_values>& columns,
+                const std::map<std::string, ValidityBitmap>& validity, std::size_t rows,
+                Filter::mask_type& mask) const override {
+    m_child->evaluate(columns, validity, rows, mask);
+    for (std::size_t i = 0; i < rows; ++i) {
+      mask[i] ^= 1;
+    }
+  }
+  void addColumns(std::set<std::string>& columns) const override {
+    m_child->addColumns(columns);
+  }
+  bool mayMatch(const std::map<std::string, ColumnStatistics>&) const override {
+    // The statistics cannot prove that all the rows pass the child filter
+    return true;
+  }
+private:
+  std::shared_ptr<const Filter::Node> m_child;
+};
+
+template <typename T, typename S, typename GetCell>
+std::vector<T> typedValues(std::size_t size, GetCell get_cell) {
+  std::vector<T> values;
+  values.reserve(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    values.push_back(boost::get<S>(get_cell(i)));
+  }
+  return values;
+}
+
+template <typename GetCell>
+Filter::column_values columnValues(std::type_index type, std::size_t size, GetCell get_cell) {
+  if (type == typeid(bool)) {
+    return typedValues<int32_t, bool>(size, get_cell);
+  } if (type == typeid(int32_t)) {
+    return typedValues<int32_t, int32_t>(size, get_cell);
+  } if (type == typeid(int64_t)) {
+    return typedValues<int64_t, int64_t>(size, get_cell);
+  } if (type == typeid(float)) {
+    return typedValues<float, float>(size, get_cell);
+  } if (type == typeid(double)) {
+    return typedValues<double, double>(size, get_cell);
+  } if (type == typeid(std::string)) {
+    return typedValues<std::string, std::string>(size, get_cell);
+  }
+  throw Elements::Exception() << "Filtering on columns of type " << type.name() << " is not supported";
+}
+
+} // end of anonymous namespace
+
+Filter::Filter(std::shared_ptr<const Node> root) : m_root(std::move(root)) {
+}
+
+Filter Filter::makeCompare(const std::string& column, Operator op, value_type value) {
+  return Filter{std::make_shared<CompareNode>(column, op, std::move(value))};
+}
+
+Filter Filter::makeRange(const std::string& column, value_type min, value_type max) {
+  return Filter{std::make_shared<RangeNode>(column, std::move(min), std::move(max))};
+}
+
+Filter Filter::operator&&(const Filter& other) const {
+  return Filter{std::make_shared<LogicalNode>(m_root, other.m_root, true)};
+}
+
+Filter Filter::operator||(const Filter& other) const {
+  return Filter{std::make_shared<LogicalNode>(m_root, other.m_root, false)};
+}
+
+Filter Filter::operator!() const {
+  return Filter{std::make_shared<NotNode>(m_root)};
+}
+
+std::vector<std::string> Filter::getColumns() const {
+  std::set<std::string> columns {};
+  m_root->addColumns(columns);
+  return std::vector<std::string>(columns.begin(), columns.end());
+}
+
+Filter::mask_type Filter::evaluate(const std::map<std::string, column_values>& columns, std::size_t rows,
+                                   const std::map<std::string, ValidityBitmap>& validity) const {
+  mask_type mask;
+  m_root->evaluate(columns, validity, rows, mask);
+  return mask;
+}
+
+Filter::mask_type Filter::evaluate(const Table& table) const {
+  std::map<std::string, column_values> columns {};
+  std::map<std::string, ValidityBitmap> validity {};
+  auto& info = *table.getColumnInfo();
+  auto& bitmaps = table.getValidityBitmaps();
+  for (auto& name : getColumns()) {
+    auto index = info.findIndex(name);
+    if (!index) {
+      throw Elements::Exception() << "Table does not contain the filter column " << name;
+    }
+    auto i = *index;
+    auto bitmap = bitmaps.find(i);
+    if (bitmap != bitmaps.end()) {
+      validity.emplace(name, bitmap->second);
+    }
+    auto& dictionary = info.getDescription(i).dictionary;
+    if (dictionary != nullptr) {
+      columns.emplace(name, DictionaryCodes{table.column<int32_t>(name), dictionary});
+      continue;
+    }
+    columns.emplace(name, columnValues(info.getDescription(i).type, table.size(),
+                                       [&table, i](std::size_t row) -> const Row::cell_type& {
+                                         return table[row][i];
+                                       }));
+  }
+  return evaluate(columns, table.size(), validity);
+}
+
+bool Filter::mayMatch(const std::map<std::string, ColumnStatistics>& statistics) const {
+  return m_root->mayMatch(statistics);
+}
+
+Filter::column_values Filter::toColumnValues(std::type_index type, const std::vector<Row::cell_type>& cells) {
+  return columnValues(type, cells.size(), [&cells](std::size_t i) -> const Row::cell_type& { return cells[i]; });
+}
+
+} // Table namespace
+} // Euclid namespace
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/FitsColumnIO.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <CCfits/CCfits>
+#include "ElementsKernel/Exception.h"
+#include "Table/FitsColumnIO.h"
+
+namespace Euclid {
+namespace Table {
+
+namespace {
+
+template <typename T>
+struct FitsDataType;
+
+// cfitsio represents the FITS logical values as char
+template <>
+struct FitsDataType<char> {
+  static const int code = TLOGICAL;
+};
+
+template <>
+struct FitsDataType<int32_t> {
+  static const int code = TINT;
+};
+
+template <>
+struct FitsDataType<int64_t> {
+  static const int code = TLONGLONG;
+};
+
+template <>
+struct FitsDataType<float> {
+  static const int code = TFLOAT;
+};
+
+template <>
+struct FitsDataType<double> {
+  static const int code = TDOUBLE;
+};
+
+void checkStatus(int status, const CCfits::Column& column, const char* action) {
+  if (status != 0) {
+    char message[FLEN_STATUS];
+    fits_get_errstatus(status, message);
+    throw Elements::Exception() << "Failed to " << action << " FITS column "
+            << column.name() << ": " << message;
+  }
+}
+
+fitsfile* currentFile(CCfits::Column& column) {
+  // cfitsio reads from the current HDU, which might have been changed by
+  // other operations on the same file
+  column.parent()->makeThisCurrent();
+  return column.parent()->fitsPointer();
+}
+
+template <typename T>
+void readData(fitsfile* file, const CCfits::Column& column, long first_row, long rows, T* buffer) {
+  int status = 0;
+  fits_read_col(file, FitsDataType<T>::code, column.index(), first_row, 1,
+                static_cast<LONGLONG>(rows) * column.repeat(), nullptr, buffer, nullptr, &status);
+  checkStatus(status, column, "read");
+}
+
+template <typename T>
+void readData(CCfits::Column& column, long first_row, long rows, T* buffer) {
+  readData(currentFile(column), column, first_row, rows, buffer);
+}
+
+template <typename T>
+void writeData(CCfits::Column& column, long first_row, long rows, const T* buffer) {
+  int status = 0;
+  // cfitsio does not modify the buffer, it just does not declare it as const
+  fits_write_col(currentFile(column), FitsDataType<T>::code, column.index(), first_row, 1,
+                 static_cast<LONGLONG>(rows) * column.repeat(), const_cast<T*>(buffer), &status);
+  checkStatus(status, column, "write");
+}
+
+// The booleans are transferred via a temporary buffer, because cfitsio uses
+// char for the logical values. For ASCII tables, where the booleans are stored
+// as integers, they are transferred as int32_t.
+
+void readData(fitsfile* file, const CCfits::Column& column, long first_row, long rows, bool* buffer) {
+  std::vector<char> values (rows * column.repeat());
+  readData(file, column, first_row, rows, values.data());
+  std::copy(values.begin(), values.end(), buffer);
+}
+
+void readData(CCfits::Column& column, long first_row, long rows, bool* buffer) {
+  readData(currentFile(column), column, first_row, rows, buffer);
+}
+
+// The strings are read in a temporary buffer with space for the longest
+// string. For binary tables the width of the strings is the repeat count of
+// the column and for ASCII tables it is the width of the field, which cfitsio
+// also reports as repeat count.
+void readData(fitsfile* file, const CCfits::Column& column, long first_row, long rows, std::string* buffer) {
+  int status = 0;
+  int type_code = 0;
+  long width = 0;
+  fits_get_coltype(file, column.index(), &type_code, &width, nullptr, &status);
+  checkStatus(status, column, "read");
+  std::vector<char> data (rows * (width + 1));
+  std::vector<char*> strings (rows);
+  for (long i = 0; i < rows; ++i) {
+    strings[i] = data.data() + i * (width + 1);
+  }
+  char null_value[] = "";
+  int any_null = 0;
+  fits_read_col_str(file, column.index(), first_row, 1, rows, null_value, strings.data(), &any_null, &status);
+  checkStatus(status, column, "read");
+  std::copy(strings.begin(), strings.end(), buffer);
+}
+
+void writeData(CCfits::Column& column, long first_row, long rows, const bool* buffer) {
+  auto size = rows * column.repeat();
+  int status = 0;
+  int type_code = 0;
+  fits_get_coltype(currentFile(column), column.index(), &type_code, nullptr, nullptr, &status);
+  checkStatus(status, column, "write");
+  if (type_code == TLOGICAL) {
+    std::vector<char> values (buffer, buffer + size);
+    writeData(column, first_row, rows, values.data());
+  } else {
+    std::vector<int32_t> values (buffer, buffer + size);
+    writeData(column, first_row, rows, values.data());
+  }
+}
+
+} // end of anonymous namespace
+
+template <typename T>
+void readColumnData(CCfits::Column& column, long first_row, long rows, T* buffer) {
+  readData(column, first_row, rows, buffer);
+}
+
+template <typename T>
+void readColumnData(fitsfile* file, const CCfits::Column& column, long first_row, long rows, T* buffer) {
+  readData(file, column, first_row, rows, buffer);
+}
+
+template <typename T>
+void writeColumnData(CCfits::Column& column, long first_row, long rows, const T* buffer) {
+  writeData(column, first_row, rows, buffer);
+}
+
+#define TABLE_FITS_COLUMN_IO_INSTANTIATION(type) \
+  template void readColumnData<type>(CCfits::Column&, long, long, type*); \
+  template void writeColumnData<type>(CCfits::Column&, long, long, const type*); \
+  template void readColumnData<type>(fitsfile*, const CCfits::Column&, long, long, type*);
+
+TABLE_FITS_COLUMN_IO_INSTANTIATION(bool)
+TABLE_FITS_COLUMN_IO_INSTANTIATION(int32_t)
+TABLE_FITS_COLUMN_IO_INSTANTIATION(int64_t)
+TABLE_FITS_COLUMN_IO_INSTANTIATION(float)
+TABLE_FITS_COLUMN_IO_INSTANTIATION(double)
+template void readColumnData<std::string>(fitsfile*, const CCfits::Column&, long, long, std::string*);
+
+#undef TABLE_FITS_COLUMN_IO_INSTANTIATION
+
+} // Table namespace
+} // Euclid namespace
@@ -22,6 +22,9 @@
  * @author nikoapos
  */
 
+#include <algorithm>
+#include <map>
+#include <mutex>
 #include <set>
 // The std regex library is not fully implemented in GCC 4.8. The following lines
 // make use of the BOOST library and can be modified if GCC 4.9 will be used in
@@ -34,10 +37,13 @@ using boost::regex_match;
 #include "ElementsKernel/Exception.h"
 #include "ElementsKernel/Unused.h"
 #include "AlexandriaKernel/memory_tools.h"
+#include "Table/FitsColumnIO.h"
 #include "Table/FitsReader.h"
 
 #include "ReaderHelper.h"
 #include "FitsReaderHelper.h"
+#include "ThreadPoolHelper.h"
+#include "ZoneMapHelper.h"
 
 namespace Euclid {
 namespace Table {
@@ -84,7 +90,40 @@ FitsReader& FitsReader::fixColumnNames(std::vector<std::string> column_names) {
   return *this;
 }
 
+FitsReader& FitsReader::setThreadPool(std::shared_ptr<ThreadPool> thread_pool) {
+  m_thread_pool = std::move(thread_pool);
+  return *this;
+}
+
+FitsReader& FitsReader::setFilter(Filter filter) {
+  if (m_reading_started) {
+    throw Elements::Exception() << "Setting the filter after reading "
+            << "has started is not allowed";
+  }
+  m_filter = make_unique<Filter>(std::move(filter));
+  return *this;
+}
+
+const ZoneMap& FitsReader::getZoneMap() {
+  readColumnInfo();
+  if (m_zone_map == nullptr) {
+    m_zone_map = make_unique<ZoneMap>();
+    auto& keys = m_hdu.get().keyWord();
+    auto key = keys.find("ZONEMAP");
+    if (key != keys.end()) {
+      std::string hdu_name;
+      key->second->value(hdu_name);
+      // The zone map of a compressed table is in the original file
+      auto fits = (m_source_fits != nullptr) ? m_source_fits : m_hdu.get().parent();
+      FitsReader zone_map_reader {fits->extension(hdu_name)};
+      *m_zone_map = zoneMapFromTable(zone_map_reader.read(), *m_column_info);
+    }
+  }
+  return *m_zone_map;
+}
+
 void FitsReader::readColumnInfo() {
+  std::lock_guard<std::mutex> lock {*m_column_info_mutex};
   if (m_column_info != nullptr) {
     return;
   }
@@ -95,6 +134,14 @@ void FitsReader::readColumnInfo() {
   } catch (std::bad_cast&) {
     throw Elements::Exception() << "Given HDU is not a table";
   }
+
+  // The tile compressed tables are uncompressed in memory once, and all the
+  // reading is done from the uncompressed copy
+  if (isCompressedTable(m_hdu.get())) {
+    m_source_fits = m_hdu.get().parent();
+    m_uncompressed_fits = uncompressTable(m_hdu.get());
+    m_hdu = std::cref(_readKeys(m_uncompressed_fits->extension(1)));
+  }
   const CCfits::Table& table_hdu = dynamic_cast<const CCfits::Table&>(m_hdu.get());
   
   m_total_rows = table_hdu.rows();
@@ -111,6 +158,7 @@ void FitsReader::readColumnInfo() {
   }
   m_column_info = createColumnInfo(names, autoDetectColumnTypes(table_hdu),
           autoDetectColumnUnits(table_hdu), autoDetectColumnDescriptions(table_hdu));
+  m_null_values = autoDetectColumnNullValues(table_hdu);
 }
 
 const ColumnInfo& FitsReader::getInfo() {
@@ -123,8 +171,41 @@ std::string FitsReader::getComment() {
   return table_hdu.comment();
 }
 
+// The decoded cells are moved in the rows, so the vector and NdArray data are
+// not copied. The integer cells equal to the TNULLn value of their column and
+// the NaN cells are marked as missing in the validity bitmaps.
+static Table _createTable(std::vector<std::vector<Row::cell_type>>& data, std::size_t rows,
+                          const std::shared_ptr<ColumnInfo>& column_info,
+                          const std::vector<boost::optional<int64_t>>& null_values) {
+  std::vector<std::vector<std::size_t>> null_rows (data.size());
+  for (std::size_t column = 0; column < data.size(); ++column) {
+    if (!isNullableType(column_info->getDescription(column).type)) {
+      continue;
+    }
+    for (std::size_t i=0; i<rows; ++i) {
+      if (isNullCell(data[column][i], null_values[column])) {
+        null_rows[column].push_back(i);
+      }
+    }
+  }
+  std::vector<Row> row_list;
+  row_list.reserve(rows);
+  for (std::size_t i=0; i<rows; ++i) {
+    std::vector<Row::cell_type> cells {};
+    cells.reserve(data.size());
+    for (auto& column_data : data) {
+      cells.push_back(std::move(column_data[i]));
+    }
+    row_list.emplace_back(std::move(cells), column_info);
+  }
+  return Table{std::move(row_list), createValidityBitmaps(null_rows, rows)};
+}
+
 Table FitsReader::readImpl(long rows) {
   readColumnInfo();
+  if (m_filter != nullptr) {
+    return readFiltered(rows);
+  }
   
   // Compute how many rows we are going to read
   if (m_current_row > m_total_rows) {
@@ -138,40 +219,380 @@ Table FitsReader::readImpl(long rows) {
   const CCfits::Table& table_hdu = dynamic_cast<const CCfits::Table&>(m_hdu.get());
 
   // CCfits reads per column, so we first read all the columns and then we
-  // create all the rows
-  std::vector<std::vector<Row::cell_type>> data;
+  // create all the rows. The reading from the file is done here, and the
+  // conversion of the data to cells is done in parallel (if we have a pool)
+  std::vector<ColumnConverter> converters;
+  std::unique_lock<std::mutex> lock {hduMutex()};
   for (int i=1; i<=table_hdu.numCols(); ++i) {
     // The i-1 is because CCfits starts from 1 and ColumnInfo from 0
-    data.push_back(translateColumn(table_hdu.column(i), m_column_info->getDescription(i-1).type, m_current_row, m_current_row + rows - 1));
+    converters.push_back(readColumn(table_hdu.column(i), m_column_info->getDescription(i-1).type, m_current_row, m_current_row + rows - 1));
   }
+  lock.unlock();
+  std::vector<std::vector<Row::cell_type>> data (converters.size());
+  std::vector<std::function<void()>> tasks;
+  for (std::size_t i=0; i<converters.size(); ++i) {
+    tasks.emplace_back([&data, &converters, i]() { data[i] = converters[i](); });
+  }
+  runTasks(m_thread_pool.get(), tasks);
   
   m_current_row += rows;
 
-  std::vector<Row> row_list;
-  for (int i=0; i<rows; ++i) {
-    std::vector<Row::cell_type> cells {};
-    for (const auto& column_data : data) {
-      cells.push_back(column_data[i]);
+  return _createTable(data, rows, m_column_info, m_null_values);
+}
+
+// Serializes all the reading when cfitsio is not reentrant
+static std::mutex cfitsio_mutex {};
+
+std::mutex& FitsReader::hduMutex() {
+  return fits_is_reentrant() ? *m_hdu_mutex : cfitsio_mutex;
+}
+
+static void _closeFile(fitsfile* file) {
+  int status = 0;
+  fits_close_file(file, &status);
+}
+
+// Opens a private cfitsio handle of the file of the HDU, positioned at the HDU.
+// In contrast with fits_reopen_file(), the handle does not share the buffers
+// and the current HDU with the handle of the CCfits objects.
+static std::unique_ptr<fitsfile, void(*)(fitsfile*)> _openFile(const CCfits::HDU& hdu) {
+  char filename[FLEN_FILENAME];
+  fitsfile* file = nullptr;
+  int status = 0;
+  fits_file_name(hdu.fitsPointer(), filename, &status);
+  if (status == 0) {
+    fits_open_file(&file, filename, READONLY, &status);
+  }
+  std::unique_ptr<fitsfile, void(*)(fitsfile*)> result {file, _closeFile};
+  if (status == 0) {
+    // CCfits counts the HDUs starting from 0 and cfitsio from 1
+    fits_movabs_hdu(file, hdu.index() + 1, nullptr, &status);
+  }
+  if (status != 0) {
+    char message[FLEN_STATUS];
+    fits_get_errstatus(status, message);
+    throw Elements::Exception() << "Failed to open a new handle of the FITS file: " << message;
+  }
+  return result;
+}
+
+Table FitsReader::readRange(long first, long count) {
+  readColumnInfo();
+  if (first < 0 || first >= m_total_rows) {
+    throw Elements::Exception() << "First row " << first << " is out of the table range [0, "
+                                << m_total_rows << ")";
+  }
+  if (count == -1) {
+    count = m_total_rows - first;
+  }
+  if (count <= 0) {
+    throw Elements::Exception() << "Invalid number of rows to read " << count;
+  }
+  count = std::min(count, m_total_rows - first);
+
+  const CCfits::Table& table_hdu = dynamic_cast<const CCfits::Table&>(m_hdu.get());
+
+  // Each call reads the data with its own handle of the file, so the calls
+  // do not share any cfitsio state. The in-memory copies of compressed tables
+  // cannot be opened again, so they are read with the handle of the reader.
+  std::vector<ColumnConverter> converters;
+  if (m_uncompressed_fits != nullptr) {
+    std::lock_guard<std::mutex> lock {hduMutex()};
+    for (int i=1; i<=table_hdu.numCols(); ++i) {
+      converters.push_back(readColumn(table_hdu.column(i), m_column_info->getDescription(i-1).type,
+                                      first + 1, first + count));
     }
-    row_list.push_back(Row{cells, m_column_info});
+  } else {
+    std::unique_lock<std::mutex> lock {cfitsio_mutex, std::defer_lock};
+    if (!fits_is_reentrant()) {
+      lock.lock();
+    }
+    auto file = _openFile(table_hdu);
+    for (int i=1; i<=table_hdu.numCols(); ++i) {
+      converters.push_back(readColumn(table_hdu.column(i), m_column_info->getDescription(i-1).type,
+                                      first + 1, first + count, nullptr, file.get()));
+    }
+  }
+  std::vector<std::vector<Row::cell_type>> data (converters.size());
+  std::vector<std::function<void()>> tasks;
+  for (std::size_t i=0; i<converters.size(); ++i) {
+    tasks.emplace_back([&data, &converters, i]() { data[i] = converters[i](); });
   }
+  runTasks(m_thread_pool.get(), tasks);
+
+  return _createTable(data, count, m_column_info, m_null_values);
+}
+
+// The number of rows scanned at once when reading all the rows passing a filter
+static const long filter_chunk_rows = 65536;
+
+// Selected rows closer than this are read with a single call, together with
+// the rejected rows between them
+static const long max_row_gap = 16;
 
-  return Table{row_list};
+Table FitsReader::readFiltered(long rows) {
+  std::vector<Table> parts {};
+  long read_rows = 0;
+  if (m_filtered_ahead != nullptr) {
+    if (rows >= 0 && static_cast<long>(m_filtered_ahead->size()) > rows) {
+      auto result = m_filtered_ahead->slice(0, rows);
+      *m_filtered_ahead = m_filtered_ahead->slice(rows, m_filtered_ahead->size());
+      return result;
+    }
+    read_rows = m_filtered_ahead->size();
+    parts.push_back(std::move(*m_filtered_ahead));
+    m_filtered_ahead.reset();
+  }
+  if (rows < 0 || read_rows < rows) {
+    auto rest = scanFiltered(rows < 0 ? -1 : rows - read_rows, false);
+    if (rest != nullptr) {
+      parts.push_back(std::move(*rest));
+    }
+  }
+  if (parts.empty()) {
+    throw Elements::Exception() << "No more table rows left";
+  }
+  if (parts.size() == 1) {
+    return std::move(parts.front());
+  }
+  return Table{parts};
+}
+
+std::unique_ptr<Table> FitsReader::scanFiltered(long rows, bool first_match) {
+  const CCfits::Table& table_hdu = dynamic_cast<const CCfits::Table&>(m_hdu.get());
+
+  std::vector<std::size_t> filter_columns {};
+  for (auto& name : m_filter->getColumns()) {
+    auto index = m_column_info->findIndex(name);
+    if (!index) {
+      throw Elements::Exception() << "Filter column " << name << " does not exist";
+    }
+    filter_columns.push_back(*index);
+  }
+
+  if (m_skipped_rows == nullptr) {
+    m_skipped_rows = make_unique<std::vector<std::pair<long, long>>>();
+    for (auto& block : getZoneMap()) {
+      if (block.rows == 0 || m_filter->mayMatch(block.columns)) {
+        continue;
+      }
+      long block_first = block.offset + 1;
+      long block_last = block.offset + block.rows;
+      if (!m_skipped_rows->empty() && m_skipped_rows->back().second + 1 == block_first) {
+        m_skipped_rows->back().second = block_last;
+      } else {
+        m_skipped_rows->emplace_back(block_first, block_last);
+      }
+    }
+  }
+
+  std::size_t columns = m_column_info->size();
+  std::vector<std::vector<Row::cell_type>> data (columns);
+  long selected_rows = 0;
+  while (m_current_row <= m_total_rows && (rows < 0 || selected_rows < rows)
+         && !(first_match && selected_rows > 0)) {
+    // The rows of the blocks rejected by the zone map are skipped, and the
+    // chunks stop before the next rejected block
+    auto skipped = std::lower_bound(m_skipped_rows->begin(), m_skipped_rows->end(), m_current_row,
+                                    [](const std::pair<long, long>& range, long row) { return range.second < row; });
+    if (skipped != m_skipped_rows->end() && skipped->first <= m_current_row) {
+      m_current_row = skipped->second + 1;
+      continue;
+    }
+
+    // The rows are always scanned in chunks of the same size. When enough rows
+    // are selected, the scan continues after the last selected row next time.
+    long first = m_current_row;
+    long last = std::min(m_total_rows, first + filter_chunk_rows - 1);
+    if (skipped != m_skipped_rows->end()) {
+      last = std::min(last, skipped->first - 1);
+    }
+    m_current_row = last + 1;
+
+    // Only the filter columns are read for all the rows of the chunk. The
+    // values equal to the TNULLn of their column and the NaN values are marked
+    // as missing, so they do not pass the filter.
+    std::unique_lock<std::mutex> lock {hduMutex()};
+    std::map<std::string, Filter::column_values> values {};
+    std::map<std::string, ValidityBitmap> validity {};
+    for (auto index : filter_columns) {
+      auto& description = m_column_info->getDescription(index);
+      auto column_values = readFilterColumn(table_hdu.column(index + 1), description.type, first, last);
+      if (isNullableType(description.type)) {
+        addFilterValidity(validity, description.name, column_values, m_null_values[index]);
+      }
+      values.emplace(description.name, std::move(column_values));
+    }
+    auto mask = m_filter->evaluate(values, last - first + 1, validity);
+
+    // The selected rows are grouped in runs, with their indices relative to
+    // the first row of the run
+    std::vector<std::pair<long, std::shared_ptr<RowSelection>>> runs {};
+    for (long row = first; row <= last; ++row) {
+      if (!mask[row - first]) {
+        continue;
+      }
+      if (runs.empty() || row - runs.back().first - static_cast<long>(runs.back().second->back()) > max_row_gap) {
+        runs.emplace_back(row, std::make_shared<RowSelection>());
+      }
+      runs.back().second->push_back(row - runs.back().first);
+      if (++selected_rows == rows) {
+        m_current_row = row + 1;
+        break;
+      }
+    }
+
+    std::vector<std::vector<ColumnConverter>> converters (columns);
+    for (auto& run : runs) {
+      long run_last = run.first + run.second->back();
+      for (std::size_t i=0; i<columns; ++i) {
+        converters[i].push_back(readColumn(table_hdu.column(i + 1), m_column_info->getDescription(i).type,
+                                           run.first, run_last, run.second));
+      }
+    }
+    lock.unlock();
+    std::vector<std::function<void()>> tasks;
+    for (std::size_t i=0; i<columns; ++i) {
+      tasks.emplace_back([&data, &converters, i]() {
+        for (auto& converter : converters[i]) {
+          auto cells = converter();
+          data[i].insert(data[i].end(), std::make_move_iterator(cells.begin()), std::make_move_iterator(cells.end()));
+        }
+      });
+    }
+    runTasks(m_thread_pool.get(), tasks);
+  }
+
+  if (selected_rows == 0) {
+    return nullptr;
+  }
+  return make_unique<Table>(_createTable(data, selected_rows, m_column_info, m_null_values));
 }
 
 void FitsReader::skip(long rows) {
   readColumnInfo();
+  if (m_filter != nullptr) {
+    while (rows > 0 && hasMoreRows()) {
+      rows -= readFiltered(rows).size();
+    }
+    return;
+  }
   m_current_row += rows;
 }
 
 bool FitsReader::hasMoreRows() {
   readColumnInfo();
-  return m_current_row < m_total_rows;
+  if (m_filter != nullptr) {
+    if (m_filtered_ahead == nullptr && m_current_row <= m_total_rows) {
+      m_filtered_ahead = scanFiltered(-1, true);
+    }
+    return m_filtered_ahead != nullptr;
+  }
+  return m_current_row <= m_total_rows;
 }
 
 std::size_t FitsReader::rowsLeft() {
   readColumnInfo();
-  return m_total_rows - m_current_row + 1;
+  std::size_t ahead = (m_filtered_ahead != nullptr) ? m_filtered_ahead->size() : 0;
+  return ahead + std::max(m_total_rows - m_current_row + 1, 0L);
+}
+
+std::size_t FitsReader::readColumns(long rows) {
+  readColumnInfo();
+  if (m_filter != nullptr) {
+    throw Elements::Exception() << "Reading columns is not supported when a filter is set";
+  }
+  long rows_left = std::max(m_total_rows - m_current_row + 1, 0L);
+  m_columns_first = m_current_row;
+  m_columns_rows = (rows < 0) ? rows_left : std::min(rows, rows_left);
+  m_current_row += m_columns_rows;
+  return m_columns_rows;
+}
+
+// Reads the column as type C and converts the values to type T
+template <typename T, typename C>
+static void _readConverted(CCfits::Column& column, long first, long rows, std::vector<T>& values) {
+  std::unique_ptr<C[]> buffer {new C[rows]};
+  readColumnData(column, first, rows, buffer.get());
+  values.assign(buffer.get(), buffer.get() + rows);
+}
+
+// Reads the column directly in the vector
+template <typename T>
+static void _readDirect(CCfits::Column& column, long first, long rows, std::vector<T>& values) {
+  values.resize(rows);
+  readColumnData(column, first, rows, values.data());
+}
+
+// The std::vector<bool> does not have contiguous storage, so the non logical
+// columns requested as booleans are read as doubles
+static void _readDirect(CCfits::Column& column, long first, long rows, std::vector<bool>& values) {
+  _readConverted<bool, double>(column, first, rows, values);
+}
+
+template <typename T>
+void FitsReader::readNumericColumn(std::size_t index, std::vector<T>& values) {
+  readColumnInfo();
+  auto& description = m_column_info->getDescription(index);
+  if (description.type != typeid(bool) && description.type != typeid(int32_t)
+      && description.type != typeid(int64_t) && description.type != typeid(float)
+      && description.type != typeid(double)) {
+    throw Elements::Exception() << "Column " << description.name << " of type "
+                                << description.type.name() << " cannot be read as "
+                                << typeid(T).name();
+  }
+  values.clear();
+  if (m_columns_rows == 0) {
+    return;
+  }
+  const CCfits::Table& table_hdu = dynamic_cast<const CCfits::Table&>(m_hdu.get());
+  auto& column = table_hdu.column(index + 1);
+  std::lock_guard<std::mutex> lock {hduMutex()};
+  // cfitsio does not convert between logical and numeric values, so the
+  // booleans are converted after reading
+  if (description.type == typeid(bool)) {
+    _readConverted<T, bool>(column, m_columns_first, m_columns_rows, values);
+  } else {
+    _readDirect(column, m_columns_first, m_columns_rows, values);
+  }
+}
+
+void FitsReader::getColumn(std::size_t index, std::vector<bool>& values) {
+  readNumericColumn(index, values);
+}
+
+void FitsReader::getColumn(std::size_t index, std::vector<int32_t>& values) {
+  readNumericColumn(index, values);
+}
+
+void FitsReader::getColumn(std::size_t index, std::vector<int64_t>& values) {
+  readNumericColumn(index, values);
+}
+
+void FitsReader::getColumn(std::size_t index, std::vector<float>& values) {
+  readNumericColumn(index, values);
+}
+
+void FitsReader::getColumn(std::size_t index, std::vector<double>& values) {
+  readNumericColumn(index, values);
+}
+
+void FitsReader::getColumn(std::size_t index, std::vector<std::string>& values) {
+  readColumnInfo();
+  auto& description = m_column_info->getDescription(index);
+  if (description.type != typeid(std::string)) {
+    throw Elements::Exception() << "Column " << description.name << " of type "
+                                << description.type.name() << " cannot be read as string";
+  }
+  values.resize(m_columns_rows);
+  if (m_columns_rows == 0) {
+    return;
+  }
+  const CCfits::Table& table_hdu = dynamic_cast<const CCfits::Table&>(m_hdu.get());
+  std::lock_guard<std::mutex> lock {hduMutex()};
+  table_hdu.makeThisCurrent();
+  readColumnData(table_hdu.fitsPointer(), table_hdu.column(index + 1), m_columns_first,
+                 m_columns_rows, values.data());
 }
 
 
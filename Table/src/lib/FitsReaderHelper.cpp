@@ -22,10 +22,12 @@
  * @author Nikolaos Apostolakos
  */
 
+#include <memory>
 #include <CCfits/CCfits>
 #include <boost/lexical_cast.hpp>
 #include <boost/tokenizer.hpp>
 #include "ElementsKernel/Exception.h"
+#include "Table/FitsColumnIO.h"
 #include "FitsReaderHelper.h"
 
 namespace Euclid {
@@ -183,39 +185,153 @@ std::vector<std::string> autoDetectColumnDescriptions(const CCfits::Table& table
   return descriptions;
 }
 
-template<typename T>
-std::vector<Row::cell_type> convertScalarColumn(CCfits::Column& column, long first, long last) {
-  std::vector<T> data;
-  column.read(data, first, last);
-  std::vector<Row::cell_type> result;
-  for (auto value : data) {
-    result.push_back(value);
+std::vector<boost::optional<int64_t>> autoDetectColumnNullValues(const CCfits::Table& table_hdu) {
+  std::vector<boost::optional<int64_t>> null_values {};
+  bool binary = dynamic_cast<const CCfits::BinTable*>(&table_hdu) != nullptr;
+  for (int i=1; i<=table_hdu.numCols(); ++i) {
+    boost::optional<int64_t> null_value {};
+    auto key = table_hdu.keyWord().find("TNULL" + std::to_string(i));
+    if (binary && key != table_hdu.keyWord().end()) {
+      long value = 0;
+      key->second->value(value);
+      null_value = value;
+    }
+    null_values.push_back(null_value);
   }
+  return null_values;
+}
+
+bool isCompressedTable(const CCfits::HDU& hdu) {
+  // The keyword is read with cfitsio, because CCfits might not have read all
+  // the keywords of the HDU
+  int status = 0;
+  int value = 0;
+  hdu.makeThisCurrent();
+  fits_read_key(hdu.fitsPointer(), TLOGICAL, "ZTABLE", &value, nullptr, &status);
+  return status == 0 && value != 0;
+}
+
+static const std::string uncompressed_hdu_name = "UNCOMPRESSED";
+
+std::unique_ptr<CCfits::FITS> uncompressTable(const CCfits::HDU& hdu) {
+  auto result = std::unique_ptr<CCfits::FITS>(new CCfits::FITS("mem://", CCfits::RWmode::Write));
+  int status = 0;
+  hdu.makeThisCurrent();
+  fits_uncompress_table(hdu.fitsPointer(), result->fitsPointer(), &status);
+  // The table is added by cfitsio, so CCfits must read its header. It gets a
+  // fixed name, because CCfits can read extensions only by name.
+  fits_update_key_str(result->fitsPointer(), "EXTNAME", uncompressed_hdu_name.c_str(), nullptr, &status);
+  if (status != 0) {
+    char message[FLEN_STATUS];
+    fits_get_errstatus(status, message);
+    throw Elements::Exception() << "Failed to uncompress the FITS table: " << message;
+  }
+  result->read(uncompressed_hdu_name);
   return result;
 }
 
+// Calls the given function with the indices of the rows to convert
+template<typename F>
+void forEachRow(long rows, const std::shared_ptr<const RowSelection>& selection, F function) {
+  if (selection == nullptr) {
+    for (long i = 0; i < rows; ++i) {
+      function(i);
+    }
+  } else {
+    for (auto i : *selection) {
+      function(i);
+    }
+  }
+}
+
+std::size_t resultSize(long rows, const std::shared_ptr<const RowSelection>& selection) {
+  return selection == nullptr ? rows : selection->size();
+}
+
+// Reads with the given cfitsio handle, if there is one
 template<typename T>
-std::vector<Row::cell_type> convertVectorColumn(CCfits::Column& column, long first, long last) {
-  std::vector<std::valarray<T>> data;
-  column.readArrays(data, first, last);
-  std::vector<Row::cell_type> result;
-  for (auto& valar : data) {
-    result.push_back(std::vector<T>(std::begin(valar),std::end(valar)));
+void readData(fitsfile* file, CCfits::Column& column, long first, long rows, T* buffer) {
+  if (file == nullptr) {
+    readColumnData(column, first, rows, buffer);
+  } else {
+    readColumnData(file, column, first, rows, buffer);
   }
-  return result;
 }
 
 template<typename T>
-std::vector<Row::cell_type> convertNdArrayColumn(CCfits::Column& column, long first, long last) {
-  std::vector<std::valarray<T>> data;
-  column.readArrays(data, first, last);
-  std::vector<size_t> shape = parseTDIM(column.dimen());
+ColumnConverter readScalarColumn(CCfits::Column& column, long first, long last,
+                                 std::shared_ptr<const RowSelection> selection, fitsfile* file) {
+  long rows = last - first + 1;
+  // We do not use a std::vector, because std::vector<bool> is not contiguous
+  std::shared_ptr<T> data {new T[rows], std::default_delete<T[]>()};
+  readData(file, column, first, rows, data.get());
+  return [data, rows, selection]() {
+    std::vector<Row::cell_type> result;
+    result.reserve(resultSize(rows, selection));
+    forEachRow(rows, selection, [&](std::size_t i) {
+      result.push_back(data.get()[i]);
+    });
+    return result;
+  };
+}
 
-  std::vector<Row::cell_type> result;
-  for (auto& valar : data) {
-    result.push_back(NdArray<T>(shape, std::move(std::vector<T>(std::begin(valar), std::end(valar)))));
+template<>
+ColumnConverter readScalarColumn<std::string>(CCfits::Column& column, long first, long last,
+                                              std::shared_ptr<const RowSelection> selection, fitsfile* file) {
+  // cfitsio cannot read strings in a contiguous buffer, so we use CCfits,
+  // unless we have to read with our own handle
+  auto data = std::make_shared<std::vector<std::string>>();
+  if (file == nullptr) {
+    column.read(*data, first, last);
+  } else {
+    data->resize(last - first + 1);
+    readColumnData(file, column, first, data->size(), data->data());
   }
-  return result;
+  return [data, selection]() {
+    std::vector<Row::cell_type> result;
+    result.reserve(resultSize(data->size(), selection));
+    forEachRow(data->size(), selection, [&](std::size_t i) {
+      result.push_back(std::move((*data)[i]));
+    });
+    return result;
+  };
+}
+
+template<typename T>
+ColumnConverter readVectorColumn(CCfits::Column& column, long first, long last,
+                                 std::shared_ptr<const RowSelection> selection, fitsfile* file) {
+  long rows = last - first + 1;
+  std::size_t repeat = column.repeat();
+  auto data = std::make_shared<std::vector<T>>(rows * repeat);
+  readData(file, column, first, rows, data->data());
+  return [data, rows, repeat, selection]() {
+    std::vector<Row::cell_type> result;
+    result.reserve(resultSize(rows, selection));
+    forEachRow(rows, selection, [&](std::size_t i) {
+      auto it = data->begin() + i * repeat;
+      result.push_back(std::vector<T>(it, it + repeat));
+    });
+    return result;
+  };
+}
+
+template<typename T>
+ColumnConverter readNdArrayColumn(CCfits::Column& column, long first, long last,
+                                  std::shared_ptr<const RowSelection> selection, fitsfile* file) {
+  long rows = last - first + 1;
+  std::size_t repeat = column.repeat();
+  auto data = std::make_shared<std::vector<T>>(rows * repeat);
+  readData(file, column, first, rows, data->data());
+  std::vector<size_t> shape = parseTDIM(column.dimen());
+  return [data, rows, repeat, shape, selection]() {
+    std::vector<Row::cell_type> result;
+    result.reserve(resultSize(rows, selection));
+    forEachRow(rows, selection, [&](std::size_t i) {
+      auto it = data->begin() + i * repeat;
+      result.push_back(NdArray<T>(shape, std::vector<T>(it, it + repeat)));
+    });
+    return result;
+  };
 }
 
 std::vector<Row::cell_type> translateColumn(CCfits::Column& column, std::type_index type) {
@@ -223,37 +339,72 @@ std::vector<Row::cell_type> translateColumn(CCfits::Column& column, std::type_in
 }
 
 std::vector<Row::cell_type> translateColumn(CCfits::Column& column, std::type_index type, long first, long last) {
+  return readColumn(column, type, first, last)();
+}
+
+ColumnConverter readColumn(CCfits::Column& column, std::type_index type, long first, long last,
+                           std::shared_ptr<const RowSelection> selection, fitsfile* file) {
   if (type == typeid(bool)) {
-    return convertScalarColumn<bool>(column, first, last);
+    return readScalarColumn<bool>(column, first, last, selection, file);
   } if (type == typeid(int32_t)) {
-    return convertScalarColumn<int32_t>(column, first, last);
+    return readScalarColumn<int32_t>(column, first, last, selection, file);
   } if (type == typeid(int64_t)) {
-    return convertScalarColumn<int64_t>(column, first, last);
+    return readScalarColumn<int64_t>(column, first, last, selection, file);
   } if (type == typeid(float)) {
-    return convertScalarColumn<float>(column, first, last);
+    return readScalarColumn<float>(column, first, last, selection, file);
   } if (type == typeid(double)) {
-    return convertScalarColumn<double>(column, first, last);
+    return readScalarColumn<double>(column, first, last, selection, file);
   } if (type == typeid(std::string)) {
-    return convertScalarColumn<std::string>(column, first, last);
+    return readScalarColumn<std::string>(column, first, last, selection, file);
   } if (type == typeid(std::vector<int32_t>)) {
-    return convertVectorColumn<int32_t>(column, first, last);
+    return readVectorColumn<int32_t>(column, first, last, selection, file);
   } if (type == typeid(std::vector<int64_t>)) {
-    return convertVectorColumn<int64_t>(column, first, last);
+    return readVectorColumn<int64_t>(column, first, last, selection, file);
   } if (type == typeid(std::vector<float>)) {
-    return convertVectorColumn<float>(column, first, last);
+    return readVectorColumn<float>(column, first, last, selection, file);
   } if (type == typeid(std::vector<double>)) {
-    return convertVectorColumn<double>(column, first, last);
+    return readVectorColumn<double>(column, first, last, selection, file);
   } if (type == typeid(NdArray<int32_t>)) {
-    return convertNdArrayColumn<int32_t>(column, first, last);
+    return readNdArrayColumn<int32_t>(column, first, last, selection, file);
   } if (type == typeid(NdArray<int64_t>)) {
-    return convertNdArrayColumn<int64_t>(column, first, last);
+    return readNdArrayColumn<int64_t>(column, first, last, selection, file);
   } if (type == typeid(NdArray<float>)) {
-    return convertNdArrayColumn<float>(column, first, last);
+    return readNdArrayColumn<float>(column, first, last, selection, file);
   } if (type == typeid(NdArray<double>)) {
-    return convertNdArrayColumn<double>(column, first, last);
+    return readNdArrayColumn<double>(column, first, last, selection, file);
   }
   throw Elements::Exception() << "Unsupported column type " << type.name();
 }
 
+template<typename T>
+Filter::column_values readFilterValues(CCfits::Column& column, long first, long last) {
+  std::vector<T> values (last - first + 1);
+  readColumnData(column, first, values.size(), values.data());
+  return values;
+}
+
+Filter::column_values readFilterColumn(CCfits::Column& column, std::type_index type, long first, long last) {
+  if (type == typeid(bool)) {
+    long rows = last - first + 1;
+    std::unique_ptr<bool[]> data {new bool[rows]};
+    readColumnData(column, first, rows, data.get());
+    return std::vector<int32_t>(data.get(), data.get() + rows);
+  } if (type == typeid(int32_t)) {
+    return readFilterValues<int32_t>(column, first, last);
+  } if (type == typeid(int64_t)) {
+    return readFilterValues<int64_t>(column, first, last);
+  } if (type == typeid(float)) {
+    return readFilterValues<float>(column, first, last);
+  } if (type == typeid(double)) {
+    return readFilterValues<double>(column, first, last);
+  } if (type == typeid(std::string)) {
+    std::vector<std::string> values;
+    column.read(values, first, last);
+    return values;
+  }
+  throw Elements::Exception() << "Filtering on column " << column.name() << " of type "
+                              << type.name() << " is not supported";
+}
+
 }
 } // end of namespace Euclid
@@ -25,14 +25,18 @@
 #ifndef FITSREADERHELPER_H
 #define FITSREADERHELPER_H
 
+#include <functional>
+#include <memory>
 #include <vector>
 #include <string>
 #include <typeindex>
 #include <CCfits/CCfits>
+#include <boost/optional.hpp>
 
 #include "ElementsKernel/Export.h"
 
 #include "Table/Row.h"
+#include "Table/Filter.h"
 
 namespace Euclid {
 namespace Table {
@@ -68,6 +72,34 @@ ELEMENTS_API std::vector<std::string> autoDetectColumnUnits(const CCfits::Table&
 /// Reads the column descriptions based on the TDESCn keyword
 ELEMENTS_API std::vector<std::string> autoDetectColumnDescriptions(const CCfits::Table& table_hdu);
 
+/**
+ * @brief
+ * Reads the values marking the missing integers based on the TNULLn keyword
+ * @details
+ * The TNULLn keywords of ASCII tables, which are strings, are ignored.
+ *
+ * @param table_hdu The HDU to read the null values from
+ * @return the null value of each column, or none if the column does not have one
+ */
+ELEMENTS_API std::vector<boost::optional<int64_t>> autoDetectColumnNullValues(const CCfits::Table& table_hdu);
+
+/// Returns true if the HDU is a tile compressed table (its ZTABLE keyword is true)
+ELEMENTS_API bool isCompressedTable(const CCfits::HDU& hdu);
+
+/**
+ * @brief
+ * Uncompresses a tile compressed table in a new in-memory FITS file
+ * @details
+ * The whole table is uncompressed by cfitsio, in the first extension of the
+ * returned file.
+ *
+ * @param hdu The HDU of the compressed table
+ * @return The in-memory FITS file containing the uncompressed table
+ * @throws Elements::Exception
+ *    if cfitsio fails to uncompress the table
+ */
+ELEMENTS_API std::unique_ptr<CCfits::FITS> uncompressTable(const CCfits::HDU& hdu);
+
 /**
  * @brief
  * Returns a vector representing the given FITS table column data, converted to
@@ -84,6 +116,48 @@ ELEMENTS_API std::vector<Row::cell_type> translateColumn(CCfits::Column& column,
 
 ELEMENTS_API std::vector<Row::cell_type> translateColumn(CCfits::Column& column, std::type_index type, long first, long last);
 
+/// A function converting the already read data of a column to cells
+typedef std::function<std::vector<Row::cell_type>()> ColumnConverter;
+
+/// The indices of the rows to convert, relative to the first row read
+typedef std::vector<std::size_t> RowSelection;
+
+/**
+ * @brief
+ * Reads the data of the given rows of a FITS table column and returns a
+ * function converting them to the requested type
+ * @details
+ * The data are read from the file immediately, but they are converted only
+ * when the returned function is called. This allows the (thread safe)
+ * conversion of many columns to be done in parallel, while the (not thread
+ * safe) reading from the file is done by a single thread. The returned
+ * function must be called only once.
+ *
+ * @param column The column to read
+ * @param type The type of the column
+ * @param first The first row to read (starting from 1)
+ * @param last The last row to read
+ * @param selection The rows to convert, or null for converting all of them
+ * @param file The cfitsio handle to read with, or null for using the handle of
+ *    the CCfits file (see the readColumnData() functions)
+ * @return The function converting the data to Row::cell_type format
+ */
+ELEMENTS_API ColumnConverter readColumn(CCfits::Column& column, std::type_index type, long first, long last,
+                                        std::shared_ptr<const RowSelection> selection=nullptr,
+                                        fitsfile* file=nullptr);
+
+/**
+ * @brief
+ * Reads the data of the given rows of a FITS table column as typed values,
+ * for evaluating a Filter
+ * @details
+ * The bool columns are returned as int32_t values.
+ * @throws Elements::Exception
+ *    if the column is not a scalar or string column
+ */
+ELEMENTS_API Filter::column_values readFilterColumn(CCfits::Column& column, std::type_index type,
+                                                    long first, long last);
+
 }
 } // end of namespace Euclid
 
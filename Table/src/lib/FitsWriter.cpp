@@ -23,13 +23,19 @@
  */
 
 #include <CCfits/CCfits>
+#include <fitsio.h>
 #include "ElementsKernel/Exception.h"
+#include "ElementsKernel/Logging.h"
 #include "Table/FitsWriter.h"
 #include "FitsWriterHelper.h"
+#include "ReaderHelper.h"
+#include "ThreadPoolHelper.h"
+#include "ZoneMapHelper.h"
 
 namespace Euclid {
 namespace Table {
 
+static Elements::Logging logger = Elements::Logging::getLogger("FitsWriter");
 
 FitsWriter::FitsWriter(const std::string& filename, bool override_flag)
         : m_filename(filename), m_override_file(override_flag) {
@@ -38,6 +44,118 @@ FitsWriter::FitsWriter(const std::string& filename, bool override_flag)
 FitsWriter::FitsWriter(std::shared_ptr<CCfits::FITS> fits) : m_fits(fits) {
 }
 
+FitsWriter::~FitsWriter() {
+  try {
+    close();
+  } catch (const std::exception& e) {
+    logger.error() << "Failed to write the last rows of " << m_filename << ": " << e.what();
+  } catch (const CCfits::FitsException& e) {
+    logger.error() << "Failed to write the last rows of " << m_filename << ": " << e.message();
+  } catch (...) {
+    logger.error() << "Failed to write the last rows of " << m_filename;
+  }
+}
+
+FitsWriter& FitsWriter::setChunkSize(std::size_t rows) {
+  m_chunk_size = rows;
+  return *this;
+}
+
+FitsWriter& FitsWriter::setThreadPool(std::shared_ptr<ThreadPool> thread_pool) {
+  m_thread_pool = std::move(thread_pool);
+  return *this;
+}
+
+FitsWriter& FitsWriter::setZoneMapBlockSize(std::size_t rows) {
+  if (m_initialized) {
+    throw Elements::Exception() << "Changing the zone map block size after writing "
+            << "has started is not allowed";
+  }
+  m_zone_map_block_size = rows;
+  return *this;
+}
+
+void FitsWriter::flush() {
+  if (!m_chunk_rows.empty()) {
+    std::vector<Row> rows {};
+    std::map<std::size_t, ValidityBitmap> validity {};
+    rows.swap(m_chunk_rows);
+    validity.swap(m_chunk_validity);
+    writeRows(Table{std::move(rows), std::move(validity)});
+  }
+  writeZoneMap(false);
+  if (m_fits != nullptr) {
+    m_fits->flush();
+  }
+}
+
+void FitsWriter::close() {
+  flush();
+  writeZoneMap(true);
+  writeCompressed();
+  // We close only the files we have opened ourselves
+  if (!m_filename.empty()) {
+    m_fits.reset();
+  }
+}
+
+CCfits::FITS& FitsWriter::openFits() {
+  if (m_fits == nullptr) {
+    // CCfits overrides the file if the name starts with !, otherwise it opens
+    // it. The file must be overridden only the first time we open it.
+    std::string filename = (m_override_file && !m_initialized ? "!" : "") + m_filename;
+    m_fits = std::make_shared<CCfits::FITS>(filename, CCfits::RWmode::Write);
+  }
+  return *m_fits;
+}
+
+CCfits::FITS& FitsWriter::tableFits() {
+  if (m_format != Format::COMPRESSED_BINARY) {
+    return openFits();
+  }
+  if (m_staging_fits == nullptr) {
+    throw Elements::Exception() << "Compressed tables cannot be extended after they are closed";
+  }
+  return *m_staging_fits;
+}
+
+// The names of the algorithms in the FZALGn keywords
+static std::string _algorithmName(FitsWriter::Compression algorithm) {
+  switch (algorithm) {
+  case FitsWriter::Compression::RICE:
+    return "RICE_1";
+  case FitsWriter::Compression::GZIP:
+    return "GZIP_1";
+  case FitsWriter::Compression::SHUFFLED_GZIP:
+    return "GZIP_2";
+  }
+  return "";
+}
+
+void FitsWriter::writeCompressed() {
+  if (m_staging_fits == nullptr) {
+    return;
+  }
+  auto staging_fits = std::move(m_staging_fits);
+  staging_fits->extension(m_hdu_index).makeThisCurrent();
+  int status = 0;
+  fits_compress_table(staging_fits->fitsPointer(), openFits().fitsPointer(), &status);
+  if (status != 0) {
+    char message[FLEN_STATUS];
+    fits_get_errstatus(status, message);
+    throw Elements::Exception() << "Failed to compress the FITS table: " << message;
+  }
+}
+
+FitsWriter& FitsWriter::setCompression(const std::string& column, Compression algorithm) {
+  if (m_initialized) {
+    throw Elements::Exception() << "Changing the compression after writing "
+            << "has started is not allowed";
+  }
+  m_compression[column] = algorithm;
+  return *this;
+}
+
 FitsWriter& FitsWriter::setFormat(Format format) {
   if (m_initialized) {
     throw Elements::Exception() << "Changing the format after writing "
@@ -66,35 +184,56 @@ void FitsWriter::addComment(const std::string& message) {
 
 void FitsWriter::init(const Table& table) {
 
-  std::shared_ptr<CCfits::FITS> fits;
-  if (m_fits != nullptr) {
-    fits = m_fits;
-  } else {
-    // CCfits overrides the file if the name starts with !, otherwise it opens it
-    std::string filename = (m_override_file ? "!" : "") + m_filename;
-    fits = std::make_shared<CCfits::FITS>(filename, CCfits::RWmode::Write);
+  m_column_info = table.getColumnInfo();
+  auto& info = *m_column_info;
+
+  // The rows of compressed tables are written in an in-memory binary table,
+  // which is compressed in the file when the writer is closed
+  if (m_format == Format::COMPRESSED_BINARY) {
+    for (auto& pair : m_compression) {
+      auto index = info.find(pair.first);
+      if (index == nullptr) {
+        throw Elements::Exception() << "Compression set for column " << pair.first
+                                    << " which does not exist";
+      }
+      auto& type = info.getDescription(*index).type;
+      if (pair.second == Compression::RICE && type != typeid(int32_t) && type != typeid(int64_t)) {
+        throw Elements::Exception() << "Rice compression is only supported for integer columns, but "
+                                    << pair.first << " is of type " << type.name();
+      }
+    }
+    // The table is moved to the file when the writer is closed, after the
+    // zone map HDU, so its index in the file is not known for naming the latter
+    if (m_zone_map_block_size > 0 && m_hdu_name.empty()) {
+      throw Elements::Exception() << "Compressed tables with a zone map must have an HDU name";
+    }
+    if (openFits().extension().count(m_hdu_name) > 0) {
+      throw Elements::Exception() << "Appending to compressed tables is not supported, but the file "
+                                  << "already contains the HDU " << m_hdu_name;
+    }
+    m_staging_fits = std::make_shared<CCfits::FITS>("mem://", CCfits::RWmode::Write);
   }
+  auto& fits = tableFits();
   
   // Create the column info arrays to feed the CCfits based on the ColumnInfo object
-  auto& info = *table.getColumnInfo();
   std::vector<std::string> column_name_list {};
   std::vector<std::string> column_unit_list {};
   for (size_t column_index=0; column_index<info.size(); ++column_index) {
     column_name_list.push_back(info.getDescription(column_index).name);
     column_unit_list.push_back(info.getDescription(column_index).unit);
   }
-  std::vector<std::string> column_format_list = (m_format == Format::BINARY)
+  std::vector<std::string> column_format_list = (m_format != Format::ASCII)
                                               ? getBinaryFormatList(table)
                                               : getAsciiFormatList(table);
   
-  CCfits::HduType hdu_type = (m_format == Format::BINARY)
+  CCfits::HduType hdu_type = (m_format != Format::ASCII)
                            ? CCfits::HduType::BinaryTbl 
                            : CCfits::HduType::AsciiTbl;
   
-  auto number_of_hdus_before = fits->extension().size();
-  CCfits::Table* table_hdu = fits->addTable(m_hdu_name, 0, column_name_list,
+  auto number_of_hdus_before = fits.extension().size();
+  CCfits::Table* table_hdu = fits.addTable(m_hdu_name, 0, column_name_list,
                                            column_format_list, column_unit_list, hdu_type);
-  bool new_hdu = number_of_hdus_before != fits->extension().size();
+  bool new_hdu = number_of_hdus_before != fits.extension().size();
   m_hdu_index = table_hdu->index();
   m_current_line = table_hdu->rows() + 1;
   
@@ -109,6 +248,16 @@ void FitsWriter::init(const Table& table) {
         table_hdu->addKey(CCfits::Column::TDIM() + std::to_string(column_index+1), shape_str, "");
       }
     }
+
+    // The per column algorithms are read by CFITSIO when the table is compressed
+    for (auto& pair : m_compression) {
+      if (m_format != Format::COMPRESSED_BINARY) {
+        break;
+      }
+      auto index = *info.find(pair.first);
+      table_hdu->addKey("FZALG" + std::to_string(index + 1), _algorithmName(pair.second),
+                        "Compression algorithm of the column");
+    }
     
     for (auto& c : m_comments) {
       table_hdu->writeComment(c);
@@ -119,21 +268,112 @@ void FitsWriter::init(const Table& table) {
 }
 
 void FitsWriter::append(const Table& table) {
-  std::shared_ptr<CCfits::FITS> fits;
-  if (m_fits != nullptr) {
-    fits = m_fits;
-  } else {
-    fits = std::make_shared<CCfits::FITS>(m_filename, CCfits::RWmode::Write);
+  if (m_chunk_rows.empty() && table.size() >= m_chunk_size) {
+    writeRows(table);
+    return;
+  }
+  appendValidity(m_chunk_validity, m_chunk_rows.size(), table, 0, table.size());
+  m_chunk_rows.insert(m_chunk_rows.end(), table.begin(), table.end());
+  if (m_chunk_rows.size() >= m_chunk_size) {
+    std::vector<Row> rows {};
+    std::map<std::size_t, ValidityBitmap> validity {};
+    rows.swap(m_chunk_rows);
+    validity.swap(m_chunk_validity);
+    writeRows(Table{std::move(rows), std::move(validity)});
   }
-  auto& table_hdu = fits->extension(m_hdu_index);
+}
+
+void FitsWriter::writeRows(const Table& table) {
+  auto& table_hdu = tableFits().extension(m_hdu_index);
   
+  // When the zone map is enabled, the rows are split in the parts belonging
+  // to different blocks, for computing their statistics separately
+  std::vector<std::pair<std::size_t, std::size_t>> parts {};
+  if (m_zone_map_block_size > 0) {
+    std::size_t first = 0;
+    std::size_t block_rows = m_zone_block.rows;
+    while (first < table.size()) {
+      std::size_t last = std::min(table.size(), first + m_zone_map_block_size - block_rows);
+      parts.emplace_back(first, last);
+      first = last;
+      block_rows = 0;
+    }
+  }
+
+  // The columns are packed in parallel (if we have a pool) and they are
+  // written to the file by this thread, as cfitsio is not thread safe. The
+  // statistics are computed by the same task, while the column is in cache.
   auto& info = *table.getColumnInfo();
+  std::vector<ColumnWriter> writers (info.size());
+  std::vector<std::vector<boost::optional<ColumnStatistics>>> statistics (parts.size(),
+          std::vector<boost::optional<ColumnStatistics>>(info.size()));
+  std::vector<std::function<void()>> tasks;
   for (size_t column_index=0; column_index<info.size(); ++column_index) {
-    populateColumn(table, column_index, table_hdu, m_current_line);
+    tasks.emplace_back([&writers, &statistics, &parts, &table, column_index]() {
+      writers[column_index] = packColumn(table, column_index);
+      for (std::size_t i = 0; i < parts.size(); ++i) {
+        statistics[i][column_index] = computeStatistics(table, column_index, parts[i].first, parts[i].second);
+      }
+    });
+  }
+  runTasks(m_thread_pool.get(), tasks);
+  for (auto& writer : writers) {
+    writer(table_hdu, m_current_line);
+  }
+  for (std::size_t i = 0; i < parts.size(); ++i) {
+    addStatistics(m_current_line - 1 + parts[i].first, parts[i].second - parts[i].first, statistics[i]);
   }
   m_current_line += table.size();
 }
 
+void FitsWriter::addStatistics(std::size_t offset, std::size_t rows,
+                               const std::vector<boost::optional<ColumnStatistics>>& statistics) {
+  bool new_block = m_zone_block.rows == 0;
+  if (new_block) {
+    m_zone_block.offset = offset;
+  }
+  m_zone_block.rows += rows;
+  for (std::size_t column_index = 0; column_index < statistics.size(); ++column_index) {
+    if (!statistics[column_index]) {
+      continue;
+    }
+    auto& name = m_column_info->getDescription(column_index).name;
+    if (new_block) {
+      m_zone_block.columns[name] = *statistics[column_index];
+    } else {
+      mergeStatistics(m_zone_block.columns.at(name), *statistics[column_index]);
+    }
+  }
+  if (m_zone_block.rows == m_zone_map_block_size) {
+    m_zone_map.push_back(std::move(m_zone_block));
+    m_zone_block = ZoneMapBlock{};
+  }
+}
+
+void FitsWriter::writeZoneMap(bool include_incomplete) {
+  if (include_incomplete && m_zone_block.rows > 0) {
+    m_zone_map.push_back(std::move(m_zone_block));
+    m_zone_block = ZoneMapBlock{};
+  }
+  if (m_zone_map.empty()) {
+    return;
+  }
+
+  // The statistics are appended to the zone map HDU, which is created with
+  // the first blocks. The table HDU refers to it with the ZONEMAP keyword.
+  std::string hdu_name = (m_hdu_name.empty() ? "HDU" + std::to_string(m_hdu_index) : m_hdu_name) + "_ZONEMAP";
+  auto zone_map_table = zoneMapToTable(m_zone_map, *m_column_info);
+  m_zone_map.clear();
+  FitsWriter zone_map_writer {m_fits};
+  zone_map_writer.setHduName(hdu_name);
+  zone_map_writer.addData(zone_map_table);
+  zone_map_writer.close();
+  auto& table_hdu = tableFits().extension(m_hdu_index);
+  if (table_hdu.keyWord().find("ZONEMAP") == table_hdu.keyWord().end()) {
+    table_hdu.addKey("ZONEMAP", hdu_name, "The HDU with the statistics of the row blocks");
+  }
+}
+
 } // Table namespace
 } // Euclid namespace
 
@@ -25,9 +25,11 @@
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
-#include <valarray>
+#include <memory>
+#include <numeric>
 #include <boost/lexical_cast.hpp>
 #include <CCfits/CCfits>
+#include "Table/FitsColumnIO.h"
 #include "FitsWriterHelper.h"
 #include "Table/Table.h"
 #include "ElementsKernel/Exception.h"
@@ -44,8 +46,21 @@ std::string scientificFormat(T value) {
   return stream.str();
 }
 
+// The number of elements of the declared shape of a column, or 0 if the shape
+// is not declared
+size_t declaredSize(const ColumnDescription& description) {
+  if (description.shape.empty()) {
+    return 0;
+  }
+  return std::accumulate(description.shape.begin(), description.shape.end(), size_t{1},
+                         std::multiplies<size_t>());
+}
+
 size_t maxWidth(const Table& table, size_t column_index) {
-  size_t width = 0;
+  size_t width = table.getColumnInfo()->getDescription(column_index).width;
+  if (width > 0) {
+    return width;
+  }
   for (const auto& row : table) {
     width = std::max(width, boost::lexical_cast<std::string>(row[column_index]).size());
   }
@@ -53,7 +68,10 @@ size_t maxWidth(const Table& table, size_t column_index) {
 }
 
 size_t maxWidthScientific(const Table& table, size_t column_index) {
-  size_t width = 0;
+  size_t width = table.getColumnInfo()->getDescription(column_index).width;
+  if (width > 0) {
+    return width;
+  }
   for (const auto& row : table) {
     width = std::max(width, scientificFormat(row[column_index]).size());
   }
@@ -85,6 +103,10 @@ std::vector<std::string> getAsciiFormatList(const Table& table) {
 
 template <typename T>
 size_t vectorSize(const Table& table, size_t column_index) {
+  size_t declared_size = declaredSize(table.getColumnInfo()->getDescription(column_index));
+  if (declared_size > 0) {
+    return declared_size;
+  }
   size_t size = boost::get<std::vector<T>>(table[0][column_index]).size();
   for (const auto& row : table) {
     if (boost::get<std::vector<T>>(row[column_index]).size() != size) {
@@ -96,6 +118,10 @@ size_t vectorSize(const Table& table, size_t column_index) {
 
 template <typename T>
 size_t ndArraySize(const Table& table, size_t column_index) {
+  size_t declared_size = declaredSize(table.getColumnInfo()->getDescription(column_index));
+  if (declared_size > 0) {
+    return declared_size;
+  }
   const auto &ndarray = boost::get<NdArray<T>>(table[0][column_index]);
   size_t size = ndarray.size();
   auto shape = ndarray.shape();
@@ -163,98 +189,132 @@ std::vector<std::string> getBinaryFormatList(const Table& table) {
 }
 
 template<typename T>
-std::vector<T> createColumnData(const Euclid::Table::Table& table, size_t column_index) {
-  std::vector<T> data {};
+ColumnWriter packScalarColumn(const Table& table, size_t column_index) {
+  // We do not use a std::vector, because std::vector<bool> is not contiguous
+  std::shared_ptr<T> data {new T[table.size()], std::default_delete<T[]>()};
+  auto value = data.get();
   for (const auto& row : table) {
-    data.push_back(boost::get<T>(row[column_index]));
-  }
-  return data;
-}
-
-template <typename T>
-std::vector<std::valarray<T>> createVectorColumnData(const Euclid::Table::Table& table, size_t column_index) {
-  std::vector<std::valarray<T>> result {};
-  for (auto& row : table) {
-    const auto& vec = boost::get<std::vector<T>>(row[column_index]);
-    result.emplace_back(vec.data(), vec.size());
-  }
-  return result;
-}
-
-template <typename T>
-std::vector<T> createSingleValueVectorColumnData(const Euclid::Table::Table& table, size_t column_index) {
-  std::vector<T> result {};
-  for (auto& row : table) {
-    const auto& vec = boost::get<std::vector<T>>(row[column_index]);
-    result.push_back(vec.front());
+    *(value++) = boost::get<T>(row[column_index]);
   }
-  return result;
+  long rows = table.size();
+  return [data, rows, column_index](CCfits::ExtHDU& table_hdu, long first_row) {
+    writeColumnData(table_hdu.column(column_index+1), first_row, rows, data.get());
+  };
 }
 
-template <typename T>
-std::vector<std::valarray<T>> createNdArrayColumnData(const Euclid::Table::Table& table, size_t column_index) {
-  std::vector<std::valarray<T>> result{};
-  for (auto& row : table) {
-    const auto& ndarray = boost::get<NdArray<T>>(row[column_index]);
-    result.emplace_back(ndarray.data().data(), ndarray.size());
+template<>
+ColumnWriter packScalarColumn<std::string>(const Table& table, size_t column_index) {
+  // cfitsio cannot write strings from a contiguous buffer, so we use CCfits
+  auto& description = table.getColumnInfo()->getDescription(column_index);
+  auto data = std::make_shared<std::vector<std::string>>();
+  data->reserve(table.size());
+  for (const auto& row : table) {
+    data->push_back(boost::get<std::string>(row[column_index]));
+    if (description.width > 0 && data->back().size() > description.width) {
+      throw Elements::Exception() << "Value of length " << data->back().size() << " exceeds the declared "
+                                  << "width " << description.width << " of column " << description.name;
+    }
   }
-  return result;
+  return [data, column_index](CCfits::ExtHDU& table_hdu, long first_row) {
+    table_hdu.column(column_index+1).write(*data, first_row);
+  };
 }
 
-template <typename T>
-std::vector<T> createSingleNdArrayVectorColumnData(const Euclid::Table::Table& table, size_t column_index) {
-  std::vector<T> result {};
-  for (auto& row : table) {
-    const auto& nd = boost::get<NdArray<T>>(row[column_index]);
-    if (nd.size() > 0)
-      result.push_back(*nd.begin());
-    else
-      result.push_back(0);
+// Checks the values of a row fit exactly the repeat count of the FITS column,
+// which was fixed by the first Table written to it
+void checkRepeat(const CCfits::Column& column, size_t row_size, const std::string& name) {
+  if (static_cast<size_t>(column.repeat()) != row_size) {
+    throw Elements::Exception() << "Values of size " << row_size << " do not match the size "
+                                << column.repeat() << " of the FITS column " << name;
   }
-  return result;
 }
 
 template <typename T>
-void populateVectorColumn(const Table& table, size_t column_index, CCfits::ExtHDU& table_hdu, long first_row) {
-  const auto& vec = boost::get<std::vector<T>>(table[0][column_index]);
-  if (vec.size() > 1) {
-    table_hdu.column(column_index+1).writeArrays(createVectorColumnData<T>(table, column_index), first_row);
-  } else {
-    table_hdu.column(column_index+1).write(createSingleValueVectorColumnData<T>(table, column_index), first_row);
+ColumnWriter packVectorColumn(const Table& table, size_t column_index) {
+  // The vectors are stored one after the other in a single buffer, so they
+  // must all have the same size, which is checked against the column repeat
+  // count when the buffer is written
+  auto& description = table.getColumnInfo()->getDescription(column_index);
+  size_t declared_size = declaredSize(description);
+  size_t row_size = boost::get<std::vector<T>>(table[0][column_index]).size();
+  auto data = std::make_shared<std::vector<T>>();
+  data->reserve(table.size() * row_size);
+  for (const auto& row : table) {
+    const auto& vec = boost::get<std::vector<T>>(row[column_index]);
+    if (declared_size > 0 && vec.size() != declared_size) {
+      throw Elements::Exception() << "Vector of size " << vec.size() << " does not match the declared "
+                                  << "size " << declared_size << " of column " << description.name;
+    }
+    if (vec.size() != row_size) {
+      throw Elements::Exception() << "Binary FITS table variable length vector columns are not supported";
+    }
+    data->insert(data->end(), vec.begin(), vec.end());
   }
+  long rows = table.size();
+  std::string name = description.name;
+  return [data, rows, row_size, name, column_index](CCfits::ExtHDU& table_hdu, long first_row) {
+    auto& column = table_hdu.column(column_index+1);
+    checkRepeat(column, row_size, name);
+    writeColumnData(column, first_row, rows, data->data());
+  };
 }
 
 template <typename T>
-void populateNdArrayColumn(const Table& table, size_t column_index, CCfits::ExtHDU& table_hdu, long first_row) {
-  const auto& nd = boost::get<NdArray<T>>(table[0][column_index]);
-  if (nd.size() > 1) {
-    table_hdu.column(column_index + 1).writeArrays(createNdArrayColumnData<T>(table, column_index), first_row);
-  }
-  else {
-    table_hdu.column(column_index+1).write(createSingleNdArrayVectorColumnData<T>(table, column_index), first_row);
+ColumnWriter packNdArrayColumn(const Table& table, size_t column_index) {
+  auto& description = table.getColumnInfo()->getDescription(column_index);
+  auto shape = boost::get<NdArray<T>>(table[0][column_index]).shape();
+  size_t row_size = boost::get<NdArray<T>>(table[0][column_index]).size();
+  auto data = std::make_shared<std::vector<T>>();
+  data->reserve(table.size() * row_size);
+  for (const auto& row : table) {
+    const auto& ndarray = boost::get<NdArray<T>>(row[column_index]);
+    if (!description.shape.empty() && ndarray.shape() != description.shape) {
+      throw Elements::Exception() << "Array shape does not match the declared shape of column "
+                                  << description.name;
+    }
+    if (ndarray.shape() != shape) {
+      throw Elements::Exception() << "Binary FITS table variable shape array columns are not supported";
+    }
+    data->insert(data->end(), ndarray.begin(), ndarray.end());
   }
+  long rows = table.size();
+  std::string name = description.name;
+  return [data, rows, row_size, name, column_index](CCfits::ExtHDU& table_hdu, long first_row) {
+    auto& column = table_hdu.column(column_index+1);
+    checkRepeat(column, row_size, name);
+    writeColumnData(column, first_row, rows, data->data());
+  };
 }
 
 std::string getTDIM(const Table& table, size_t column_index) {
-  auto& first_row = table[0];
-  auto& cell = first_row[column_index];
-  auto type = table.getColumnInfo()->getDescription(column_index).type;
+  auto& description = table.getColumnInfo()->getDescription(column_index);
+  auto type = description.type;
   std::vector<size_t> shape;
 
-  if (type == typeid(NdArray<bool>)) {
-    shape = boost::get<NdArray<bool>>(cell).shape();
-  } else if (type == typeid(NdArray<int32_t>)) {
-    shape = boost::get<NdArray<int32_t>>(cell).shape();
-  } else if (type == typeid(NdArray<int64_t>)) {
-    shape = boost::get<NdArray<int64_t>>(cell).shape();
-  } else if (type == typeid(NdArray<float>)) {
-    shape = boost::get<NdArray<float>>(cell).shape();
-  } else if (type == typeid(NdArray<double>)) {
-    shape = boost::get<NdArray<double>>(cell).shape();
-  } else {
+  bool is_ndarray = type == typeid(NdArray<bool>) || type == typeid(NdArray<int32_t>)
+                    || type == typeid(NdArray<int64_t>) || type == typeid(NdArray<float>)
+                    || type == typeid(NdArray<double>);
+  if (!is_ndarray) {
     return "";
   }
 
+  if (!description.shape.empty()) {
+    shape = description.shape;
+  } else {
+    auto& cell = table[0][column_index];
+    if (type == typeid(NdArray<bool>)) {
+      shape = boost::get<NdArray<bool>>(cell).shape();
+    } else if (type == typeid(NdArray<int32_t>)) {
+      shape = boost::get<NdArray<int32_t>>(cell).shape();
+    } else if (type == typeid(NdArray<int64_t>)) {
+      shape = boost::get<NdArray<int64_t>>(cell).shape();
+    } else if (type == typeid(NdArray<float>)) {
+      shape = boost::get<NdArray<float>>(cell).shape();
+    } else {
+      shape = boost::get<NdArray<double>>(cell).shape();
+    }
+  }
+
   int64_t ncells = 1;
   for (auto &axis : shape) {
     ncells *= axis;
@@ -276,39 +336,41 @@ std::string getTDIM(const Table& table, size_t column_index) {
 }
 
 void populateColumn(const Table& table, size_t column_index, CCfits::ExtHDU& table_hdu, long first_row) {
+  packColumn(table, column_index)(table_hdu, first_row);
+}
+
+ColumnWriter packColumn(const Table& table, size_t column_index) {
   auto type = table.getColumnInfo()->getDescription(column_index).type;
-  // CCfits indices start from 1
   if (type == typeid(bool)) {
-    table_hdu.column(column_index+1).write(createColumnData<bool>(table, column_index), first_row);
+    return packScalarColumn<bool>(table, column_index);
   } else if (type == typeid(int32_t)) {
-    table_hdu.column(column_index+1).write(createColumnData<int32_t>(table, column_index), first_row);
+    return packScalarColumn<int32_t>(table, column_index);
   } else if (type == typeid(int64_t)) {
-    table_hdu.column(column_index+1).write(createColumnData<int64_t>(table, column_index), first_row);
+    return packScalarColumn<int64_t>(table, column_index);
   } else if (type == typeid(float)) {
-    table_hdu.column(column_index+1).write(createColumnData<float>(table, column_index), first_row);
+    return packScalarColumn<float>(table, column_index);
   } else if (type == typeid(double)) {
-    table_hdu.column(column_index+1).write(createColumnData<double>(table, column_index), first_row);
+    return packScalarColumn<double>(table, column_index);
   } else if (type == typeid(std::string)) {
-    table_hdu.column(column_index+1).write(createColumnData<std::string>(table, column_index), first_row);
+    return packScalarColumn<std::string>(table, column_index);
   } else if (type == typeid(std::vector<int32_t>)) {
-    populateVectorColumn<int32_t>(table, column_index, table_hdu, first_row);
+    return packVectorColumn<int32_t>(table, column_index);
   } else if (type == typeid(std::vector<int64_t>)) {
-    populateVectorColumn<int64_t>(table, column_index, table_hdu, first_row);
+    return packVectorColumn<int64_t>(table, column_index);
   } else if (type == typeid(std::vector<float>)) {
-    populateVectorColumn<float>(table, column_index, table_hdu, first_row);
+    return packVectorColumn<float>(table, column_index);
   } else if (type == typeid(std::vector<double>)) {
-    populateVectorColumn<double>(table, column_index, table_hdu, first_row);
+    return packVectorColumn<double>(table, column_index);
   } else if (type == typeid(NdArray<int32_t>)) {
-    populateNdArrayColumn<int32_t>(table, column_index, table_hdu, first_row);
+    return packNdArrayColumn<int32_t>(table, column_index);
   } else if (type == typeid(NdArray<int64_t>)) {
-    populateNdArrayColumn<int64_t>(table, column_index, table_hdu, first_row);
+    return packNdArrayColumn<int64_t>(table, column_index);
   } else if (type == typeid(NdArray<float>)) {
-    populateNdArrayColumn<float>(table, column_index, table_hdu, first_row);
+    return packNdArrayColumn<float>(table, column_index);
   } else if (type == typeid(NdArray<double>)) {
-    populateNdArrayColumn<double>(table, column_index, table_hdu, first_row);
-  } else {
-    throw Elements::Exception() << "Cannot populate FITS column with data of type " << type.name();
+    return packNdArrayColumn<double>(table, column_index);
   }
+  throw Elements::Exception() << "Cannot populate FITS column with data of type " << type.name();
 }
 
 }
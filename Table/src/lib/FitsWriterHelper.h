@@ -25,6 +25,7 @@
 #ifndef TABLE_FITSWRITERHELPER_H
 #define TABLE_FITSWRITERHELPER_H
 
+#include <functional>
 #include <string>
 #include <vector>
 #include <typeindex>
@@ -74,6 +75,25 @@ ELEMENTS_API std::string getTDIM(const Table& table, size_t column_index);
 
 void populateColumn(const Table& table, size_t column_index, CCfits::ExtHDU& table_hdu, long first_row=1);
 
+/// A function writing already packed column data to a table HDU, starting
+/// from the given row (starting from 1)
+typedef std::function<void(CCfits::ExtHDU&, long)> ColumnWriter;
+
+/**
+ * @brief
+ * Packs the data of a column of the table in a contiguous buffer and returns a
+ * function writing it to a FITS table HDU
+ * @details
+ * The packing is done immediately and it is thread safe, so many columns can
+ * be packed in parallel. The writing to the file is done only when the
+ * returned function is called, which should be done by a single thread.
+ *
+ * @param table The table
+ * @param column_index The index of the column to pack (starting from 0)
+ * @return The function writing the column data
+ */
+ELEMENTS_API ColumnWriter packColumn(const Table& table, size_t column_index);
+
 }
 } // end of namespace Euclid
 
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/FlatBuffersHelper.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include "ElementsKernel/Exception.h"
+#include "FlatBuffersHelper.h"
+
+namespace Euclid {
+namespace Table {
+
+namespace {
+
+void align(std::string& buffer, std::size_t alignment) {
+  buffer.append((alignment - buffer.size() % alignment) % alignment, '\0');
+}
+
+template <typename T>
+void put(std::string& buffer, T value) {
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void patch(std::string& buffer, std::size_t position, T value) {
+  std::memcpy(&buffer[position], &value, sizeof(T));
+}
+
+// Writes the object and sets the offset at the given position to point to it
+void writeReferenced(std::string& buffer, std::size_t offset_position, const FlatBufferObject& object) {
+  auto position = object.write(buffer);
+  patch<std::uint32_t>(buffer, offset_position, position - offset_position);
+}
+
+}
+
+FlatBufferTable& FlatBufferTable::addObject(std::size_t slot, std::shared_ptr<const FlatBufferObject> object) {
+  m_fields[slot] = Field {std::string(4, '\0'), 4, std::move(object)};
+  return *this;
+}
+
+std::size_t FlatBufferTable::write(std::string& buffer) const {
+  // Compute the positions of the fields in the table, after the vtable offset
+  std::size_t slots = m_fields.empty() ? 0 : m_fields.rbegin()->first + 1;
+  std::vector<std::uint16_t> offsets (slots, 0);
+  std::size_t table_size = 4;
+  for (auto& pair : m_fields) {
+    table_size += (pair.second.alignment - table_size % pair.second.alignment) % pair.second.alignment;
+    offsets[pair.first] = table_size;
+    table_size += pair.second.bytes.size();
+  }
+
+  align(buffer, 2);
+  std::size_t vtable = buffer.size();
+  put<std::uint16_t>(buffer, 4 + 2 * slots);
+  put<std::uint16_t>(buffer, table_size);
+  for (auto offset : offsets) {
+    put(buffer, offset);
+  }
+
+  // The table start is aligned to 8 bytes, so all its fields are aligned
+  align(buffer, 8);
+  std::size_t table = buffer.size();
+  put<std::int32_t>(buffer, table - vtable);
+  buffer.append(table_size - 4, '\0');
+  for (auto& pair : m_fields) {
+    buffer.replace(table + offsets[pair.first], pair.second.bytes.size(), pair.second.bytes);
+  }
+  for (auto& pair : m_fields) {
+    if (pair.second.object) {
+      writeReferenced(buffer, table + offsets[pair.first], *pair.second.object);
+    }
+  }
+  return table;
+}
+
+std::size_t FlatBufferString::write(std::string& buffer) const {
+  align(buffer, 4);
+  std::size_t position = buffer.size();
+  put<std::uint32_t>(buffer, m_value.size());
+  buffer.append(m_value);
+  buffer.push_back('\0');
+  return position;
+}
+
+std::size_t FlatBufferObjectVector::write(std::string& buffer) const {
+  align(buffer, 4);
+  std::size_t position = buffer.size();
+  put<std::uint32_t>(buffer, m_objects.size());
+  buffer.append(4 * m_objects.size(), '\0');
+  for (std::size_t i = 0; i < m_objects.size(); ++i) {
+    writeReferenced(buffer, position + 4 + 4 * i, *m_objects[i]);
+  }
+  return position;
+}
+
+std::size_t FlatBufferStructVector::write(std::string& buffer) const {
+  // The elements, which follow the size, must be aligned
+  align(buffer, 4);
+  while ((buffer.size() + 4) % m_alignment != 0) {
+    buffer.append(4, '\0');
+  }
+  std::size_t position = buffer.size();
+  put<std::uint32_t>(buffer, m_count);
+  buffer.append(m_bytes);
+  return position;
+}
+
+std::string finishFlatBuffer(const FlatBufferTable& root) {
+  std::string buffer (4, '\0');
+  writeReferenced(buffer, 0, root);
+  align(buffer, 8);
+  return buffer;
+}
+
+FlatBufferTableView::FlatBufferTableView(const char* buffer, std::size_t size, std::size_t position)
+        : m_buffer(buffer), m_size(size), m_position(position) {
+  std::int32_t vtable_offset;
+  std::memcpy(&vtable_offset, checked(position, 4), 4);
+  m_vtable = position - vtable_offset;
+  std::uint16_t vtable_size;
+  std::memcpy(&vtable_size, checked(m_vtable, 2), 2);
+  checked(m_vtable, vtable_size);
+  m_vtable_size = vtable_size;
+}
+
+FlatBufferTableView FlatBufferTableView::root(const char* buffer, std::size_t size) {
+  if (size < 4) {
+    throw Elements::Exception() << "Corrupted flatbuffer";
+  }
+  std::uint32_t offset;
+  std::memcpy(&offset, buffer, 4);
+  return FlatBufferTableView {buffer, size, offset};
+}
+
+const char* FlatBufferTableView::checked(std::size_t position, std::size_t size) const {
+  if (position > m_size || size > m_size - position) {
+    throw Elements::Exception() << "Corrupted flatbuffer";
+  }
+  return m_buffer + position;
+}
+
+std::uint16_t FlatBufferTableView::fieldOffset(std::size_t slot) const {
+  std::size_t entry = 4 + 2 * slot;
+  if (entry + 2 > m_vtable_size) {
+    return 0;
+  }
+  std::uint16_t offset;
+  std::memcpy(&offset, m_buffer + m_vtable + entry, 2);
+  return offset;
+}
+
+std::size_t FlatBufferTableView::follow(std::size_t position) const {
+  std::uint32_t offset;
+  std::memcpy(&offset, checked(position, 4), 4);
+  return position + offset;
+}
+
+bool FlatBufferTableView::has(std::size_t slot) const {
+  return fieldOffset(slot) != 0;
+}
+
+FlatBufferTableView FlatBufferTableView::table(std::size_t slot) const {
+  auto offset = fieldOffset(slot);
+  if (offset == 0) {
+    throw Elements::Exception() << "Missing flatbuffer table field";
+  }
+  return FlatBufferTableView {m_buffer, m_size, follow(m_position + offset)};
+}
+
+std::string FlatBufferTableView::readString(std::size_t position) const {
+  std::uint32_t length;
+  std::memcpy(&length, checked(position, 4), 4);
+  return std::string(checked(position + 4, length), length);
+}
+
+std::string FlatBufferTableView::string(std::size_t slot) const {
+  auto offset = fieldOffset(slot);
+  if (offset == 0) {
+    return "";
+  }
+  return readString(follow(m_position + offset));
+}
+
+std::size_t FlatBufferTableView::vectorStart(std::size_t slot) const {
+  auto offset = fieldOffset(slot);
+  if (offset == 0) {
+    throw Elements::Exception() << "Missing flatbuffer vector field";
+  }
+  return follow(m_position + offset);
+}
+
+std::size_t FlatBufferTableView::vectorSize(std::size_t slot) const {
+  if (!has(slot)) {
+    return 0;
+  }
+  std::uint32_t size;
+  std::memcpy(&size, checked(vectorStart(slot), 4), 4);
+  return size;
+}
+
+FlatBufferTableView FlatBufferTableView::vectorTable(std::size_t slot, std::size_t index) const {
+  if (index >= vectorSize(slot)) {
+    throw Elements::Exception() << "Flatbuffer vector index out of bounds";
+  }
+  return FlatBufferTableView {m_buffer, m_size, follow(vectorStart(slot) + 4 + 4 * index)};
+}
+
+std::string FlatBufferTableView::vectorString(std::size_t slot, std::size_t index) const {
+  if (index >= vectorSize(slot)) {
+    throw Elements::Exception() << "Flatbuffer vector index out of bounds";
+  }
+  return readString(follow(vectorStart(slot) + 4 + 4 * index));
+}
+
+const char* FlatBufferTableView::vectorStruct(std::size_t slot, std::size_t index, std::size_t struct_size) const {
+  if (index >= vectorSize(slot)) {
+    throw Elements::Exception() << "Flatbuffer vector index out of bounds";
+  }
+  return checked(vectorStart(slot) + 4 + struct_size * index, struct_size);
+}
+
+}
+} // end of namespace Euclid
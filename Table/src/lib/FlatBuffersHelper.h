@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/FlatBuffersHelper.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef TABLE_FLATBUFFERSHELPER_H
+#define TABLE_FLATBUFFERSHELPER_H
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ElementsKernel/Export.h"
+
+namespace Euclid {
+namespace Table {
+
+/*
+ * Minimal support of the FlatBuffers binary format, enough for reading and
+ * writing the metadata of the Arrow IPC files. The objects are written with
+ * the parents before their children, so all the unsigned offsets point
+ * forward, as the format requires.
+ */
+
+/// An object which can be serialized in a flatbuffer
+class ELEMENTS_API FlatBufferObject {
+public:
+  virtual ~FlatBufferObject() = default;
+  /// Appends the object to the buffer and returns the position to refer to it
+  virtual std::size_t write(std::string& buffer) const = 0;
+};
+
+/// A flatbuffer table, with fields identified by their slot number
+class ELEMENTS_API FlatBufferTable : public FlatBufferObject {
+public:
+  template <typename T>
+  FlatBufferTable& addScalar(std::size_t slot, T value) {
+    Field field {std::string(sizeof(T), '\0'), sizeof(T), nullptr};
+    std::memcpy(&field.bytes[0], &value, sizeof(T));
+    m_fields[slot] = std::move(field);
+    return *this;
+  }
+  FlatBufferTable& addObject(std::size_t slot, std::shared_ptr<const FlatBufferObject> object);
+  std::size_t write(std::string& buffer) const override;
+private:
+  struct Field {
+    std::string bytes;
+    std::size_t alignment;
+    std::shared_ptr<const FlatBufferObject> object;
+  };
+  std::map<std::size_t, Field> m_fields {};
+};
+
+/// A flatbuffer string
+class ELEMENTS_API FlatBufferString : public FlatBufferObject {
+public:
+  FlatBufferString(std::string value) : m_value(std::move(value)) {
+  }
+  std::size_t write(std::string& buffer) const override;
+private:
+  std::string m_value;
+};
+
+/// A flatbuffer vector of tables (or other objects)
+class ELEMENTS_API FlatBufferObjectVector : public FlatBufferObject {
+public:
+  FlatBufferObjectVector(std::vector<std::shared_ptr<const FlatBufferObject>> objects)
+          : m_objects(std::move(objects)) {
+  }
+  std::size_t write(std::string& buffer) const override;
+private:
+  std::vector<std::shared_ptr<const FlatBufferObject>> m_objects;
+};
+
+/// A flatbuffer vector of structs, given as their serialized bytes
+class ELEMENTS_API FlatBufferStructVector : public FlatBufferObject {
+public:
+  FlatBufferStructVector(std::string bytes, std::size_t count, std::size_t alignment)
+          : m_bytes(std::move(bytes)), m_count(count), m_alignment(alignment) {
+  }
+  std::size_t write(std::string& buffer) const override;
+private:
+  std::string m_bytes;
+  std::size_t m_count;
+  std::size_t m_alignment;
+};
+
+/// Returns the flatbuffer with the given root table, padded to 8 bytes
+ELEMENTS_API std::string finishFlatBuffer(const FlatBufferTable& root);
+
+/**
+ * @brief Read access to a table of a flatbuffer
+ * @details
+ * All the accesses are checked to be within the buffer, and an
+ * Elements::Exception is thrown for corrupted buffers.
+ */
+class ELEMENTS_API FlatBufferTableView {
+public:
+
+  /// Returns the root table of the given flatbuffer
+  static FlatBufferTableView root(const char* buffer, std::size_t size);
+
+  /// Returns true if the field of the given slot is present
+  bool has(std::size_t slot) const;
+
+  /// Returns the scalar of the given slot, or the default value if it is absent
+  template <typename T>
+  T scalar(std::size_t slot, T default_value) const {
+    auto offset = fieldOffset(slot);
+    if (offset == 0) {
+      return default_value;
+    }
+    T value;
+    std::memcpy(&value, checked(m_position + offset, sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  /// Returns the table of the given slot
+  FlatBufferTableView table(std::size_t slot) const;
+
+  /// Returns the string of the given slot, or the empty string if it is absent
+  std::string string(std::size_t slot) const;
+
+  /// Returns the size of the vector of the given slot, or 0 if it is absent
+  std::size_t vectorSize(std::size_t slot) const;
+
+  /// Returns the table of the given index in the vector of the given slot
+  FlatBufferTableView vectorTable(std::size_t slot, std::size_t index) const;
+
+  /// Returns the string of the given index in the vector of the given slot
+  std::string vectorString(std::size_t slot, std::size_t index) const;
+
+  /// Returns a pointer to the struct of the given index in the vector of the
+  /// given slot, which is checked to be within the buffer
+  const char* vectorStruct(std::size_t slot, std::size_t index, std::size_t struct_size) const;
+
+private:
+
+  FlatBufferTableView(const char* buffer, std::size_t size, std::size_t position);
+  std::uint16_t fieldOffset(std::size_t slot) const;
+  std::size_t follow(std::size_t position) const;
+  std::size_t vectorStart(std::size_t slot) const;
+  std::string readString(std::size_t position) const;
+  const char* checked(std::size_t position, std::size_t size) const;
+
+  const char* m_buffer;
+  std::size_t m_size;
+  std::size_t m_position;
+  std::size_t m_vtable;
+  std::size_t m_vtable_size;
+};
+
+}
+} // end of namespace Euclid
+
+#endif /* TABLE_FLATBUFFERSHELPER_H */
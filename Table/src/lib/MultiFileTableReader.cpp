@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/MultiFileTableReader.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <algorithm>
+#include <glob.h>
+#include <fitsio.h>
+#include <CCfits/CCfits>
+#include "ElementsKernel/Exception.h"
+#include "AlexandriaKernel/memory_tools.h"
+#include "Table/FitsReader.h"
+#include "Table/MultiFileTableReader.h"
+
+namespace Euclid {
+namespace Table {
+
+MultiFileTableReader::MultiFileTableReader(std::vector<std::string> filenames, int hdu_index)
+        : m_hdu_index(hdu_index) {
+  if (filenames.empty()) {
+    throw Elements::Exception() << "MultiFileTableReader needs at least one file";
+  }
+  // Only the headers are read here, for checking the columns and getting the
+  // number of rows
+  for (auto& filename : filenames) {
+    std::size_t rows = 0;
+    try {
+      FitsReader reader {filename, hdu_index};
+      auto& info = reader.getInfo();
+      if (m_column_info == nullptr) {
+        m_column_info = std::make_shared<ColumnInfo>(info);
+        m_comment = reader.getComment();
+      } else if (info != *m_column_info) {
+        throw Elements::Exception() << "The columns of " << filename << " differ from the ones of "
+                                    << m_shards.front().filename;
+      }
+      rows = reader.rowsLeft();
+    } catch (const CCfits::FitsException& e) {
+      throw Elements::Exception() << "Cannot read the table of " << filename << ": " << e.message();
+    }
+    m_shards.push_back(Shard{std::move(filename), rows});
+    m_rows_left += rows;
+  }
+}
+
+MultiFileTableReader::~MultiFileTableReader() {
+  std::unique_lock<std::mutex> lock {m_mutex};
+  m_condition.wait(lock, [this]() { return m_running == 0; });
+}
+
+std::vector<std::string> MultiFileTableReader::findFiles(const std::string& pattern) {
+  glob_t glob_result;
+  int status = glob(pattern.c_str(), 0, nullptr, &glob_result);
+  if (status != 0) {
+    globfree(&glob_result);
+    throw Elements::Exception() << "No files match the pattern " << pattern;
+  }
+  std::vector<std::string> files (glob_result.gl_pathv, glob_result.gl_pathv + glob_result.gl_pathc);
+  globfree(&glob_result);
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+MultiFileTableReader& MultiFileTableReader::setThreadPool(std::shared_ptr<ThreadPool> thread_pool) {
+  if (m_reading_started) {
+    throw Elements::Exception() << "Setting the thread pool after reading has started is not allowed";
+  }
+  m_thread_pool = std::move(thread_pool);
+  return *this;
+}
+
+MultiFileTableReader& MultiFileTableReader::setMaxShardsInMemory(std::size_t shards) {
+  if (m_reading_started) {
+    throw Elements::Exception() << "Setting the shards in memory after reading has started is not allowed";
+  }
+  if (shards == 0) {
+    throw Elements::Exception() << "At least one shard must be allowed in memory";
+  }
+  m_max_shards = shards;
+  return *this;
+}
+
+MultiFileTableReader& MultiFileTableReader::setCompletionOrder(bool completion_order) {
+  if (m_reading_started) {
+    throw Elements::Exception() << "Setting the order after reading has started is not allowed";
+  }
+  m_completion_order = completion_order;
+  return *this;
+}
+
+std::string MultiFileTableReader::getComment() {
+  return m_comment;
+}
+
+const ColumnInfo& MultiFileTableReader::getInfo() {
+  return *m_column_info;
+}
+
+std::unique_ptr<Table> MultiFileTableReader::readShard(std::size_t index) const {
+  // If cfitsio is not reentrant only one shard is read at a time
+  static std::mutex cfitsio_mutex {};
+  std::unique_lock<std::mutex> lock {cfitsio_mutex, std::defer_lock};
+  if (!fits_is_reentrant()) {
+    lock.lock();
+  }
+  if (m_shards[index].rows == 0) {
+    return nullptr;
+  }
+  try {
+    FitsReader reader {m_shards[index].filename, m_hdu_index};
+    return make_unique<Table>(reader.read());
+  } catch (const CCfits::FitsException& e) {
+    throw Elements::Exception() << "Cannot read the table of " << m_shards[index].filename << ": " << e.message();
+  }
+}
+
+// Must be called with m_mutex locked
+void MultiFileTableReader::startReads() {
+  while (m_next_to_start < m_shards.size() && m_in_memory < m_max_shards) {
+    auto index = m_next_to_start++;
+    ++m_in_memory;
+    ++m_running;
+    m_thread_pool->submit([this, index]() {
+      ShardData data {};
+      try {
+        data.table = readShard(index);
+      } catch (...) {
+        data.error = std::current_exception();
+      }
+      {
+        std::lock_guard<std::mutex> lock {m_mutex};
+        m_finished[index] = std::move(data);
+        m_finished_order.push_back(index);
+        --m_running;
+      }
+      m_condition.notify_all();
+    });
+  }
+}
+
+void MultiFileTableReader::releaseCurrent() {
+  m_current.reset();
+  if (m_current_counted) {
+    m_current_counted = false;
+    --m_in_memory;
+  }
+}
+
+bool MultiFileTableReader::loadNextShard() {
+  m_reading_started = true;
+  releaseCurrent();
+  if (m_next_shard >= m_shards.size()) {
+    return false;
+  }
+  if (m_thread_pool == nullptr) {
+    m_current = readShard(m_next_shard);
+    m_current_row = 0;
+    m_next_to_start = ++m_next_shard;
+    return true;
+  }
+
+  std::unique_lock<std::mutex> lock {m_mutex};
+  startReads();
+  m_condition.wait(lock, [this]() {
+    return m_completion_order ? !m_finished_order.empty() : m_finished.count(m_next_shard) > 0;
+  });
+  std::size_t index = m_next_shard;
+  if (m_completion_order) {
+    index = m_finished_order.front();
+  }
+  m_finished_order.erase(std::find(m_finished_order.begin(), m_finished_order.end(), index));
+  auto data = std::move(m_finished.at(index));
+  m_finished.erase(index);
+  ++m_next_shard;
+  if (data.error) {
+    // The shard is not returned again, so its rows are not left any more
+    --m_in_memory;
+    m_rows_left -= std::min(m_shards[index].rows, m_rows_left);
+    startReads();
+    lock.unlock();
+    std::rethrow_exception(data.error);
+  }
+  lock.unlock();
+
+  // The shard stays counted in memory until all its rows are consumed
+  m_current = std::move(data.table);
+  m_current_row = 0;
+  m_current_counted = true;
+  return true;
+}
+
+Table MultiFileTableReader::readImpl(long rows) {
+  // The rows of the shards are not copied, the result refers to them
+  std::vector<Table> parts {};
+  std::size_t read_rows = 0;
+  while (rows < 0 || read_rows < static_cast<std::size_t>(rows)) {
+    if (m_current == nullptr || m_current_row >= m_current->size()) {
+      if (!loadNextShard()) {
+        break;
+      }
+      continue;
+    }
+    std::size_t available = m_current->size() - m_current_row;
+    std::size_t count = rows < 0 ? available : std::min(available, rows - read_rows);
+    m_rows_left -= std::min(count, m_rows_left);
+    if (m_current_row == 0 && count == m_current->size()) {
+      parts.push_back(std::move(*m_current));
+      releaseCurrent();
+    } else {
+      parts.push_back(m_current->slice(m_current_row, m_current_row + count));
+      m_current_row += count;
+    }
+    read_rows += count;
+  }
+  if (parts.empty()) {
+    throw Elements::Exception() << "No more table rows left";
+  }
+  if (parts.size() == 1) {
+    return std::move(parts.front());
+  }
+  return Table{parts};
+}
+
+void MultiFileTableReader::skip(long rows) {
+  m_reading_started = true;
+  std::size_t to_skip = rows < 0 ? 0 : rows;
+  while (to_skip > 0) {
+    if (m_current != nullptr && m_current_row < m_current->size()) {
+      std::size_t count = std::min(to_skip, m_current->size() - m_current_row);
+      m_current_row += count;
+      to_skip -= count;
+      m_rows_left -= std::min(count, m_rows_left);
+      continue;
+    }
+    releaseCurrent();
+    // The next shard is skipped without reading it, if no shard that could
+    // be returned before it has started
+    if (m_in_memory == 0 && m_next_shard < m_shards.size() && m_shards[m_next_shard].rows <= to_skip) {
+      to_skip -= m_shards[m_next_shard].rows;
+      m_rows_left -= std::min(m_shards[m_next_shard].rows, m_rows_left);
+      m_next_to_start = ++m_next_shard;
+      continue;
+    }
+    if (!loadNextShard()) {
+      break;
+    }
+  }
+}
+
+bool MultiFileTableReader::hasMoreRows() {
+  return m_rows_left > 0;
+}
+
+std::size_t MultiFileTableReader::rowsLeft() {
+  return m_rows_left;
+}
+
+} // Table namespace
+} // Euclid namespace
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/PrefetchingTableReader.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include "ElementsKernel/Exception.h"
+#include "Table/PrefetchingTableReader.h"
+
+namespace Euclid {
+namespace Table {
+
+PrefetchingTableReader::PrefetchingTableReader(std::unique_ptr<TableReader> reader, std::size_t chunk_rows,
+                                               std::size_t chunks)
+        : m_reader(std::move(reader)), m_chunk_rows(chunk_rows), m_max_chunks(chunks) {
+  if (m_reader == nullptr) {
+    throw Elements::Exception() << "PrefetchingTableReader needs a reader to wrap";
+  }
+  if (m_chunk_rows == 0 || m_max_chunks == 0) {
+    throw Elements::Exception() << "PrefetchingTableReader needs a positive chunk size and number of chunks";
+  }
+  m_thread = std::thread(&PrefetchingTableReader::prefetch, this);
+}
+
+PrefetchingTableReader::~PrefetchingTableReader() {
+  {
+    std::lock_guard<std::mutex> queue_lock {m_queue_mutex};
+    m_stop = true;
+  }
+  m_queue_condition.notify_all();
+  m_thread.join();
+}
+
+void PrefetchingTableReader::prefetch() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> queue_lock {m_queue_mutex};
+      m_queue_condition.wait(queue_lock, [this]() {
+        return m_stop || (!m_finished && !m_error && m_chunks.size() < m_max_chunks);
+      });
+      if (m_stop) {
+        return;
+      }
+    }
+
+    // The caller might have skipped all the rows while we were waiting for
+    // the reader, so we check again if there are rows to read
+    std::lock_guard<std::mutex> reader_lock {m_reader_mutex};
+    std::unique_ptr<Table> chunk {};
+    std::exception_ptr error {};
+    bool finished = false;
+    try {
+      if (m_reader->hasMoreRows()) {
+        chunk.reset(new Table{m_reader->read(m_chunk_rows)});
+      } else {
+        finished = true;
+      }
+    } catch (...) {
+      error = std::current_exception();
+    }
+    {
+      std::lock_guard<std::mutex> queue_lock {m_queue_mutex};
+      if (chunk != nullptr) {
+        m_chunks.push_back(std::move(*chunk));
+      }
+      m_finished = m_finished || finished;
+      m_error = error;
+    }
+    m_queue_condition.notify_all();
+  }
+}
+
+std::string PrefetchingTableReader::getComment() {
+  std::lock_guard<std::mutex> reader_lock {m_reader_mutex};
+  return m_reader->getComment();
+}
+
+const ColumnInfo& PrefetchingTableReader::getInfo() {
+  std::lock_guard<std::mutex> reader_lock {m_reader_mutex};
+  return m_reader->getInfo();
+}
+
+Table PrefetchingTableReader::readImpl(long rows) {
+  std::vector<Table> parts {};
+  std::size_t read_rows = 0;
+  std::unique_lock<std::mutex> queue_lock {m_queue_mutex};
+  while (rows < 0 || read_rows < static_cast<std::size_t>(rows)) {
+    m_queue_condition.wait(queue_lock, [this]() {
+      return !m_chunks.empty() || m_finished || m_error;
+    });
+    if (m_chunks.empty()) {
+      // The rows already collected are returned and the error is thrown by
+      // the next call
+      if (m_error && parts.empty()) {
+        std::rethrow_exception(m_error);
+      }
+      break;
+    }
+    std::size_t missing = rows < 0 ? m_chunks.front().size() : rows - read_rows;
+    if (m_chunks.front().size() <= missing) {
+      parts.push_back(std::move(m_chunks.front()));
+      m_chunks.pop_front();
+    } else {
+      // Only the first rows of the chunk are needed, so it is split
+      auto& chunk = m_chunks.front();
+      parts.push_back(chunk.slice(0, missing));
+      chunk = chunk.slice(missing, chunk.size());
+    }
+    read_rows += parts.back().size();
+    m_queue_condition.notify_all();
+  }
+  queue_lock.unlock();
+
+  if (parts.empty()) {
+    throw Elements::Exception() << "No more table rows left";
+  }
+  if (parts.size() == 1) {
+    return std::move(parts.front());
+  }
+  return Table{parts};
+}
+
+void PrefetchingTableReader::skip(long rows) {
+  std::lock_guard<std::mutex> reader_lock {m_reader_mutex};
+  {
+    std::lock_guard<std::mutex> queue_lock {m_queue_mutex};
+    while (rows > 0 && !m_chunks.empty()) {
+      auto& chunk = m_chunks.front();
+      if (chunk.size() <= static_cast<std::size_t>(rows)) {
+        rows -= chunk.size();
+        m_chunks.pop_front();
+      } else {
+        chunk = chunk.slice(rows, chunk.size());
+        rows = 0;
+      }
+    }
+  }
+  if (rows > 0) {
+    m_reader->skip(rows);
+  }
+  m_queue_condition.notify_all();
+}
+
+bool PrefetchingTableReader::hasMoreRows() {
+  {
+    std::lock_guard<std::mutex> queue_lock {m_queue_mutex};
+    if (!m_chunks.empty() || m_error) {
+      return true;
+    }
+  }
+  std::lock_guard<std::mutex> reader_lock {m_reader_mutex};
+  std::lock_guard<std::mutex> queue_lock {m_queue_mutex};
+  // An error makes read() throw it, so it is reported as rows left
+  return !m_chunks.empty() || m_error || (!m_finished && m_reader->hasMoreRows());
+}
+
+std::size_t PrefetchingTableReader::rowsLeft() {
+  std::lock_guard<std::mutex> reader_lock {m_reader_mutex};
+  std::lock_guard<std::mutex> queue_lock {m_queue_mutex};
+  std::size_t rows = m_finished ? 0 : m_reader->rowsLeft();
+  for (auto& chunk : m_chunks) {
+    rows += chunk.size();
+  }
+  return rows;
+}
+
+} // Table namespace
+} // Euclid namespace
@@ -22,6 +22,7 @@
  * @author Nikolaos Apostolakos
  */
 
+#include <cmath>
 #include "ReaderHelper.h"
 
 namespace Euclid {
@@ -38,5 +39,128 @@ std::shared_ptr<ColumnInfo> createColumnInfo(const std::vector<std::string>& nam
   return std::shared_ptr<ColumnInfo>(new ColumnInfo{std::move(info_list)});
 }
 
+bool isNullableType(std::type_index type) {
+  return type == typeid(int32_t) || type == typeid(int64_t) || type == typeid(float)
+         || type == typeid(double);
+}
+
+bool isNullCell(const Row::cell_type& cell, const boost::optional<int64_t>& null_value) {
+  if (auto value = boost::get<double>(&cell)) {
+    return std::isnan(*value);
+  }
+  if (auto value = boost::get<float>(&cell)) {
+    return std::isnan(*value);
+  }
+  if (!null_value) {
+    return false;
+  }
+  if (auto value = boost::get<int32_t>(&cell)) {
+    return *value == *null_value;
+  }
+  if (auto value = boost::get<int64_t>(&cell)) {
+    return *value == *null_value;
+  }
+  return false;
+}
+
+std::map<std::size_t, ValidityBitmap> createValidityBitmaps(const std::vector<std::vector<std::size_t>>& null_rows,
+                                                            std::size_t rows) {
+  std::map<std::size_t, ValidityBitmap> result {};
+  for (std::size_t column = 0; column < null_rows.size(); ++column) {
+    if (null_rows[column].empty()) {
+      continue;
+    }
+    ValidityBitmap bitmap {rows};
+    for (auto row : null_rows[column]) {
+      bitmap.setValid(row, false);
+    }
+    result.emplace(column, std::move(bitmap));
+  }
+  return result;
+}
+
+std::map<std::size_t, ValidityBitmap> sliceValidity(const Table& table, std::size_t first, std::size_t count) {
+  std::map<std::size_t, ValidityBitmap> result {};
+  appendValidity(result, 0, table, first, count);
+  return result;
+}
+
+void appendValidity(std::map<std::size_t, ValidityBitmap>& validity, std::size_t rows,
+                    const Table& table, std::size_t first, std::size_t count) {
+  auto& table_validity = table.getValidityBitmaps();
+  for (auto& pair : table_validity) {
+    auto part = pair.second.slice(first, count);
+    auto existing = validity.find(pair.first);
+    if (existing != validity.end()) {
+      existing->second.append(part);
+    } else if (!part.allValid()) {
+      ValidityBitmap bitmap {rows};
+      bitmap.append(part);
+      validity.emplace(pair.first, std::move(bitmap));
+    }
+  }
+  // The columns without missing values in the table are extended as valid
+  for (auto& pair : validity) {
+    if (table_validity.count(pair.first) == 0) {
+      pair.second.append(ValidityBitmap(count));
+    }
+  }
+}
+
+namespace {
+
+// Collects the indices of the missing values and returns the number of values
+class NullValuesVisitor : public boost::static_visitor<std::size_t> {
+public:
+  NullValuesVisitor(const boost::optional<int64_t>& null_value, std::vector<std::size_t>& null_rows)
+          : m_null_value(null_value), m_null_rows(null_rows) {
+  }
+  template <typename T>
+  std::size_t operator()(const std::vector<T>& values) const {
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      if (isNull(values[i])) {
+        m_null_rows.push_back(i);
+      }
+    }
+    return values.size();
+  }
+  std::size_t operator()(const std::vector<std::string>& values) const {
+    return values.size();
+  }
+  std::size_t operator()(const Filter::DictionaryCodes& values) const {
+    return values.codes.size();
+  }
+private:
+  bool isNull(int32_t value) const {
+    return m_null_value && value == *m_null_value;
+  }
+  bool isNull(int64_t value) const {
+    return m_null_value && value == *m_null_value;
+  }
+  bool isNull(float value) const {
+    return std::isnan(value);
+  }
+  bool isNull(double value) const {
+    return std::isnan(value);
+  }
+  const boost::optional<int64_t>& m_null_value;
+  std::vector<std::size_t>& m_null_rows;
+};
+}
+
+void addFilterValidity(std::map<std::string, ValidityBitmap>& validity, const std::string& name,
+                       const Filter::column_values& values, const boost::optional<int64_t>& null_value) {
+  std::vector<std::size_t> null_rows {};
+  std::size_t rows = boost::apply_visitor(NullValuesVisitor{null_value, null_rows}, values);
+  if (null_rows.empty()) {
+    return;
+  }
+  ValidityBitmap bitmap {rows};
+  for (auto row : null_rows) {
+    bitmap.setValid(row, false);
+  }
+  validity.emplace(name, std::move(bitmap));
+}
+
 }
 } // end of namespace Euclid
\ No newline at end of file
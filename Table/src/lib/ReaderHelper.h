@@ -25,11 +25,18 @@
 #ifndef TABLE_READERHELPER_H
 #define TABLE_READERHELPER_H
 
+#include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 #include <typeindex>
+#include <boost/optional.hpp>
 #include "Table/ColumnInfo.h"
+#include "Table/Filter.h"
+#include "Table/Row.h"
+#include "Table/Table.h"
+#include "Table/ValidityBitmap.h"
 
 namespace Euclid {
 namespace Table {
@@ -40,6 +47,39 @@ std::shared_ptr<ColumnInfo> createColumnInfo(const std::vector<std::string>& nam
                                              const std::vector<std::string>& units,
                                              const std::vector<std::string>& descriptions);
 
+/// Returns true if the type is one of the scalar types which can have missing values
+bool isNullableType(std::type_index type);
+
+/// Returns true if the cell is a floating point NaN, or an integer equal to the null_value
+bool isNullCell(const Row::cell_type& cell, const boost::optional<int64_t>& null_value);
+
+/**
+ * Creates the validity bitmaps of a table, given for each column the indices
+ * of its rows with missing values. Only the columns with missing values get a
+ * bitmap.
+ */
+std::map<std::size_t, ValidityBitmap> createValidityBitmaps(const std::vector<std::vector<std::size_t>>& null_rows,
+                                                            std::size_t rows);
+
+/// Returns the validity bitmaps of count rows of the table, starting from the row first
+std::map<std::size_t, ValidityBitmap> sliceValidity(const Table& table, std::size_t first, std::size_t count);
+
+/**
+ * Appends to the validity bitmaps, which cover the given number of rows, the
+ * validity of count rows of the table, starting from the row first. Bitmaps
+ * are created only when there are missing values.
+ */
+void appendValidity(std::map<std::size_t, ValidityBitmap>& validity, std::size_t rows,
+                    const Table& table, std::size_t first, std::size_t count);
+
+/**
+ * Adds to the validity bitmaps of the filter columns the bitmap of the given
+ * column values, marking as missing the NaN values and the integers equal to
+ * the null_value. The bitmap is added only when there are missing values.
+ */
+void addFilterValidity(std::map<std::string, ValidityBitmap>& validity, const std::string& name,
+                       const Filter::column_values& values, const boost::optional<int64_t>& null_value);
+
 }
 } // end of namespace Euclid
 
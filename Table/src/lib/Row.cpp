@@ -74,9 +74,9 @@ Row::Row(std::vector<cell_type> values, std::shared_ptr<ColumnInfo> column_info)
     }
   }
   regex whitespace {".*\\s.*"}; // Checks if input contains any whitespace characters
-  for (auto cell : m_values) {
+  for (const auto& cell : m_values) {
     if (cell.type() == typeid(std::string)) {
-      std::string value = boost::get<std::string>(cell);
+      const std::string& value = boost::get<std::string>(cell);
       if (value.empty()) {
         throw Elements::Exception() << "Empty string cell values are not allowed";
       }
@@ -104,13 +104,21 @@ const Row::cell_type& Row::operator [](const size_t index) const {
 }
 
 const Row::cell_type& Row::operator [](const std::string& column) const {
-  auto index = m_column_info->find(column);
+  auto index = m_column_info->findIndex(column);
   if (!index) {
     throw Elements::Exception() << "Row does not contain column with name " << column;
   }
   return m_values[*index];
 }
 
+const Row::cell_type& Row::operator [](const ColumnInfo::Handle& column) const {
+  auto index = m_column_info->findIndex(column);
+  if (!index) {
+    throw Elements::Exception() << "Row does not contain column with name " << column.name();
+  }
+  return m_values[*index];
+}
+
 Row::const_iterator Row::begin() const {
   return m_values.cbegin();
 }
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file src/lib/StringDictionary.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include "ElementsKernel/Exception.h"
+#include "Table/StringDictionary.h"
+
+namespace Euclid {
+namespace Table {
+
+StringDictionary::StringDictionary(std::vector<std::string> values) : m_values(std::move(values)) {
+  m_codes.reserve(m_values.size());
+  for (std::size_t i = 0; i < m_values.size(); ++i) {
+    if (!m_codes.emplace(m_values[i], static_cast<int32_t>(i)).second) {
+      throw Elements::Exception() << "Duplicate dictionary value " << m_values[i];
+    }
+  }
+}
+
+const std::string& StringDictionary::decode(int32_t code) const {
+  if (code < 0 || static_cast<std::size_t>(code) >= m_values.size()) {
+    throw Elements::Exception() << "Dictionary code " << code << " is out of range [0, "
+                                << m_values.size() << ")";
+  }
+  return m_values[code];
+}
+
+boost::optional<int32_t> StringDictionary::find(const std::string& value) const {
+  auto found = m_codes.find(value);
+  if (found == m_codes.end()) {
+    return boost::none;
+  }
+  return found->second;
+}
+
+} // Table namespace
+} // Euclid namespace
@@ -22,28 +22,93 @@
  * @author Nikolaos Apostolakos
  */
 
+#include <algorithm>
 #include "ElementsKernel/Exception.h"
 #include "Table/Table.h"
+#include "ReaderHelper.h"
 
 namespace Euclid {
 namespace Table {
 
-Table::Table(std::vector<Row> row_list) : m_row_list {std::move(row_list)} ,
-                                          m_column_info {} {
+Table::Table(std::vector<Row> row_list) {
   // Check we have some rows
-  if (m_row_list.empty()) {
+  if (row_list.empty()) {
     throw Elements::Exception() << "Construction of empty tables is not allowed";
   }
   // We cannot initialize the m_column_info before this point because we must
   // be sure the row list is not empty
-  m_column_info = m_row_list[0].getColumnInfo();
+  m_column_info = row_list[0].getColumnInfo();
   // Check that all the rows have the same column info
-  for (auto row : m_row_list) {
-    if (*row.getColumnInfo() != *m_column_info) {
+  for (const auto& row : row_list) {
+    if (row.getColumnInfo() != m_column_info && *row.getColumnInfo() != *m_column_info) {
       throw Elements::Exception() << "Construction of table from rows with different "
                                 << "columns is not allowed";
     }
   }
+  auto owner = std::make_shared<const std::vector<Row>>(std::move(row_list));
+  m_blocks->blocks.push_back(RowBlock{owner, owner->data(), owner->data() + owner->size()});
+  m_blocks->offsets.push_back(0);
+  m_blocks->size = owner->size();
+}
+
+Table::Table(std::vector<Row> row_list, std::map<std::size_t, ValidityBitmap> validity)
+        : Table(std::move(row_list)) {
+  for (auto& pair : validity) {
+    if (pair.first >= m_column_info->size()) {
+      throw Elements::Exception() << "Validity bitmap for column " << pair.first
+                                  << " but the table has " << m_column_info->size() << " columns";
+    }
+    if (pair.second.size() != m_blocks->size) {
+      throw Elements::Exception() << "Validity bitmap of column " << pair.first << " has "
+                                  << pair.second.size() << " rows instead of " << m_blocks->size;
+    }
+  }
+  m_validity = std::move(validity);
+}
+
+Table::Table(const std::vector<Table>& tables) {
+  if (tables.empty()) {
+    throw Elements::Exception() << "Construction of empty tables is not allowed";
+  }
+  m_column_info = tables[0].m_column_info;
+  for (auto& table : tables) {
+    if (table.m_column_info != m_column_info && *table.m_column_info != *m_column_info) {
+      throw Elements::Exception() << "Concatenation of tables with different "
+                                << "columns is not allowed";
+    }
+    appendValidity(m_validity, m_blocks->size, table, 0, table.size());
+    for (auto& block : table.m_blocks->blocks) {
+      m_blocks->blocks.push_back(block);
+      m_blocks->offsets.push_back(m_blocks->size);
+      m_blocks->size += block.end - block.begin;
+    }
+  }
+}
+
+Table Table::slice(std::size_t begin, std::size_t end) const {
+  if (begin >= end || end > m_blocks->size) {
+    throw Elements::Exception() << "Invalid slice [" << begin << ", " << end << ") of a table with "
+                                << m_blocks->size << " rows";
+  }
+  Table result {};
+  result.m_column_info = m_column_info;
+  result.m_validity = sliceValidity(*this, begin, end - begin);
+  auto& blocks = m_blocks->blocks;
+  auto& result_blocks = *result.m_blocks;
+  for (std::size_t i = 0; i < blocks.size(); ++i) {
+    auto& block = blocks[i];
+    std::size_t block_begin = m_blocks->offsets[i];
+    std::size_t block_end = block_begin + (block.end - block.begin);
+    if (block_end <= begin || block_begin >= end) {
+      continue;
+    }
+    auto first = std::max(begin, block_begin) - block_begin;
+    auto last = std::min(end, block_end) - block_begin;
+    result_blocks.blocks.push_back(RowBlock{block.owner, block.begin + first, block.begin + last});
+    result_blocks.offsets.push_back(result_blocks.size);
+    result_blocks.size += last - first;
+  }
+  return result;
 }
 
 std::shared_ptr<ColumnInfo> Table::getColumnInfo() const {
@@ -51,22 +116,90 @@ std::shared_ptr<ColumnInfo> Table::getColumnInfo() const {
 }
 
 std::size_t Table::size() const {
-  return m_row_list.size();
+  return m_blocks->size;
 }
 
 const Row& Table::operator [](std::size_t index) const {
-  if (index >= m_row_list.size()) {
+  if (index >= m_blocks->size) {
     throw Elements::Exception("Index out of bounds");
   }
-  return m_row_list[index];
+  if (m_blocks->blocks.size() == 1) {
+    return m_blocks->blocks.front().begin[index];
+  }
+  return *iteratorAt(index);
 }
 
 Table::const_iterator Table::begin() const {
-  return m_row_list.cbegin();
+  return iteratorAt(0);
 }
 
 Table::const_iterator Table::end() const {
-  return m_row_list.cend();
+  return iteratorAt(m_blocks->size);
+}
+
+Table::const_iterator Table::iteratorAt(std::size_t index) const {
+  return m_blocks->iteratorAt(index);
+}
+
+Table::const_iterator Table::BlockList::iteratorAt(std::size_t index) const {
+  if (index >= size) {
+    return const_iterator{this, size, nullptr, nullptr, nullptr};
+  }
+  // The block containing the row is the last one starting before it
+  std::size_t block_index = std::upper_bound(offsets.begin(), offsets.end(), index) - offsets.begin() - 1;
+  auto& block = blocks[block_index];
+  return const_iterator{this, index, block.begin + (index - offsets[block_index]), block.begin, block.end};
+}
+
+Table::const_iterator& Table::const_iterator::operator+=(difference_type n) {
+  // Moving inside the current block does not need to search for the block
+  difference_type position = (m_row - m_block_begin) + n;
+  if (m_row != nullptr && position >= 0 && position < m_block_end - m_block_begin) {
+    m_row = m_block_begin + position;
+    m_index += n;
+  } else {
+    *this = m_blocks->iteratorAt(m_index + n);
+  }
+  return *this;
+}
+
+std::size_t Table::columnIndex(const std::string& name) const {
+  auto index = m_column_info->findIndex(name);
+  if (!index) {
+    throw Elements::Exception() << "Table does not contain column " << name;
+  }
+  return *index;
+}
+
+ValidityBitmap Table::getValidity(const std::string& name) const {
+  auto bitmap = m_validity.find(columnIndex(name));
+  if (bitmap == m_validity.end()) {
+    return ValidityBitmap(m_blocks->size);
+  }
+  return bitmap->second;
+}
+
+const std::map<std::size_t, ValidityBitmap>& Table::getValidityBitmaps() const {
+  return m_validity;
+}
+
+template <>
+std::vector<std::string> Table::column<std::string>(const std::string& name) const {
+  auto index = columnIndex(name);
+  auto& description = m_column_info->getDescription(index);
+  if (description.dictionary == nullptr) {
+    if (description.type != typeid(std::string)) {
+      throw Elements::Exception() << "Column " << name << " is of type " << description.type.name()
+                                  << " and not " << typeid(std::string).name();
+    }
+    return copyColumn<std::string>(index);
+  }
+  std::vector<std::string> result {};
+  result.reserve(m_blocks->size);
+  for (auto& row : *this) {
+    result.push_back(description.dictionary->decode(*boost::get<int32_t>(&row[index])));
+  }
+  return result;
 }
 
 }
@@ -0,0 +1,580 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/TableOperations.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <typeindex>
+#include <unordered_map>
+#include "ElementsKernel/Exception.h"
+#include "Table/TableOperations.h"
+#include "ThreadPoolHelper.h"
+
+namespace Euclid {
+namespace Table {
+
+namespace {
+
+// The minimum number of rows processed by each task
+const std::size_t min_part_rows = 4096;
+
+// Splits the rows in consecutive parts, one for each task
+std::vector<std::pair<std::size_t, std::size_t>> splitRows(std::size_t rows,
+                                                           const std::shared_ptr<ThreadPool>& thread_pool) {
+  std::size_t parts = 1;
+  if (thread_pool != nullptr) {
+    parts = std::max<std::size_t>(1, std::min<std::size_t>(thread_pool->threadCount(), rows / min_part_rows));
+  }
+  std::vector<std::pair<std::size_t, std::size_t>> result {};
+  for (std::size_t i = 0; i < parts; ++i) {
+    result.emplace_back(i * rows / parts, (i + 1) * rows / parts);
+  }
+  return result;
+}
+
+std::size_t columnIndex(const Table& table, const std::string& name) {
+  auto index = table.getColumnInfo()->findIndex(name);
+  if (!index) {
+    throw Elements::Exception() << "Table does not contain column " << name;
+  }
+  return *index;
+}
+
+void combineHash(std::size_t& seed, std::size_t value) {
+  seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+// The values of a column in a typed array
+class KeyColumn {
+public:
+
+  enum class Kind {
+    INTEGER, REAL, STRING
+  };
+
+  KeyColumn() = default;
+
+  KeyColumn(const Table& table, const std::string& name, bool descending=false) : m_descending(descending) {
+    auto& description = table.getColumnInfo()->getDescription(columnIndex(table, name));
+    auto type = description.type;
+    if (description.dictionary != nullptr) {
+      m_kind = Kind::STRING;
+      setDictionaryRanks(description.dictionary, table.column<int32_t>(name));
+    } else if (type == typeid(bool) || type == typeid(int32_t) || type == typeid(int64_t)) {
+      m_integers = table.columnCast<int64_t>(name);
+    } else if (type == typeid(float) || type == typeid(double)) {
+      m_kind = Kind::REAL;
+      m_reals = table.columnCast<double>(name);
+    } else if (type == typeid(std::string)) {
+      m_kind = Kind::STRING;
+      m_strings = table.column<std::string>(name);
+    } else {
+      throw Elements::Exception() << "Column " << name << " has unsupported type " << type.name();
+    }
+  }
+
+  Kind kind() const {
+    return m_kind;
+  }
+
+  const std::vector<int64_t>& integers() const {
+    return m_integers;
+  }
+
+  const std::vector<double>& reals() const {
+    return m_reals;
+  }
+
+  // Returns a negative number, zero or a positive number if the value of row
+  // a comes before, together with or after the one of row b
+  int compare(std::size_t a, std::size_t b) const {
+    int result = 0;
+    switch (m_kind) {
+      case Kind::INTEGER:
+        result = (m_integers[a] > m_integers[b]) - (m_integers[a] < m_integers[b]);
+        break;
+      case Kind::REAL: {
+        bool a_nan = std::isnan(m_reals[a]);
+        bool b_nan = std::isnan(m_reals[b]);
+        if (a_nan || b_nan) {
+          // NaN values go last regardless of the sort direction
+          return a_nan - b_nan;
+        }
+        result = (m_reals[a] > m_reals[b]) - (m_reals[a] < m_reals[b]);
+        break;
+      }
+      case Kind::STRING:
+        if (m_dictionary != nullptr) {
+          result = (m_integers[a] > m_integers[b]) - (m_integers[a] < m_integers[b]);
+        } else {
+          result = m_strings[a].compare(m_strings[b]);
+        }
+        break;
+    }
+    return m_descending ? -result : result;
+  }
+
+  bool equal(std::size_t row, const KeyColumn& other, std::size_t other_row) const {
+    switch (m_kind) {
+      case Kind::INTEGER:
+        return m_integers[row] == other.m_integers[other_row];
+      case Kind::REAL:
+        return m_reals[row] == other.m_reals[other_row]
+               || (std::isnan(m_reals[row]) && std::isnan(other.m_reals[other_row]));
+      case Kind::STRING:
+        if (m_dictionary != nullptr && m_dictionary == other.m_dictionary) {
+          return m_integers[row] == other.m_integers[other_row];
+        }
+        return string(row) == other.string(other_row);
+    }
+    return false;
+  }
+
+  std::size_t hash(std::size_t row) const {
+    switch (m_kind) {
+      case Kind::INTEGER:
+        return std::hash<int64_t>()(m_integers[row]);
+      case Kind::REAL:
+        // All NaN values are equal and -0. is equal to 0.
+        if (std::isnan(m_reals[row])) {
+          return 0;
+        }
+        return std::hash<double>()(m_reals[row] == 0 ? 0. : m_reals[row]);
+      case Kind::STRING:
+        if (m_dictionary != nullptr) {
+          return m_value_hashes[m_integers[row]];
+        }
+        return std::hash<std::string>()(m_strings[row]);
+    }
+    return 0;
+  }
+
+private:
+
+  const std::string& string(std::size_t row) const {
+    return m_dictionary != nullptr ? m_sorted_values[m_integers[row]] : m_strings[row];
+  }
+
+  // The rows of dictionary encoded columns are represented by the rank of
+  // their value in the sorted dictionary values, so they are compared and
+  // hashed as integers, but in the order of the strings. The hashes are the
+  // ones of the strings, so they can be matched with plain string columns.
+  void setDictionaryRanks(std::shared_ptr<const StringDictionary> dictionary, const std::vector<int32_t>& codes) {
+    m_dictionary = std::move(dictionary);
+    auto& values = m_dictionary->getValues();
+    std::vector<std::size_t> order (values.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&values](std::size_t a, std::size_t b) {
+      return values[a] < values[b];
+    });
+    std::vector<int64_t> ranks (values.size());
+    m_sorted_values.reserve(values.size());
+    m_value_hashes.reserve(values.size());
+    for (std::size_t rank = 0; rank < order.size(); ++rank) {
+      ranks[order[rank]] = rank;
+      m_sorted_values.push_back(values[order[rank]]);
+      m_value_hashes.push_back(std::hash<std::string>()(m_sorted_values.back()));
+    }
+    m_integers.reserve(codes.size());
+    for (auto code : codes) {
+      m_integers.push_back(ranks[code]);
+    }
+  }
+
+  Kind m_kind = Kind::INTEGER;
+  bool m_descending = false;
+  std::vector<int64_t> m_integers {};
+  std::vector<double> m_reals {};
+  std::vector<std::string> m_strings {};
+  std::shared_ptr<const StringDictionary> m_dictionary {};
+  std::vector<std::string> m_sorted_values {};
+  std::vector<std::size_t> m_value_hashes {};
+
+};
+
+// The key columns of a table, copied in parallel
+class KeyColumns {
+public:
+
+  KeyColumns(const Table& table, const std::vector<SortKey>& keys, const std::shared_ptr<ThreadPool>& thread_pool)
+          : m_columns(keys.size()), m_rows(table.size()) {
+    if (keys.empty()) {
+      throw Elements::Exception() << "No key columns given";
+    }
+    std::vector<std::function<void()>> tasks {};
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      tasks.emplace_back([this, &table, &keys, i]() {
+        m_columns[i] = KeyColumn(table, keys[i].column, keys[i].descending);
+      });
+    }
+    runTasks(thread_pool.get(), tasks);
+  }
+
+  const std::vector<KeyColumn>& columns() const {
+    return m_columns;
+  }
+
+  int compare(std::size_t a, std::size_t b) const {
+    for (auto& column : m_columns) {
+      int result = column.compare(a, b);
+      if (result != 0) {
+        return result;
+      }
+    }
+    return 0;
+  }
+
+  bool equal(std::size_t row, const KeyColumns& other, std::size_t other_row) const {
+    for (std::size_t i = 0; i < m_columns.size(); ++i) {
+      if (!m_columns[i].equal(row, other.m_columns[i], other_row)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::vector<std::size_t> hashes(const std::shared_ptr<ThreadPool>& thread_pool) const {
+    std::vector<std::size_t> result (m_rows);
+    std::vector<std::function<void()>> tasks {};
+    for (auto& part : splitRows(m_rows, thread_pool)) {
+      tasks.emplace_back([this, &result, part]() {
+        for (std::size_t row = part.first; row < part.second; ++row) {
+          std::size_t seed = 0;
+          for (auto& column : m_columns) {
+            combineHash(seed, column.hash(row));
+          }
+          result[row] = seed;
+        }
+      });
+    }
+    runTasks(thread_pool.get(), tasks);
+    return result;
+  }
+
+private:
+
+  std::vector<KeyColumn> m_columns;
+  std::size_t m_rows;
+
+};
+
+std::vector<SortKey> toSortKeys(const std::vector<std::string>& names) {
+  return std::vector<SortKey>(names.begin(), names.end());
+}
+
+// Computes the values of an aggregation for all the groups
+std::vector<Row::cell_type> aggregate(const Table& table, const Aggregation& aggregation,
+                                      const std::vector<std::size_t>& group_of, std::size_t groups,
+                                      std::type_index& type) {
+  std::vector<Row::cell_type> result {};
+  result.reserve(groups);
+  std::vector<int64_t> counts (groups, 0);
+  for (auto group : group_of) {
+    ++counts[group];
+  }
+  if (aggregation.function == Aggregation::Function::COUNT) {
+    type = typeid(int64_t);
+    result.assign(counts.begin(), counts.end());
+    return result;
+  }
+
+  KeyColumn column {table, aggregation.column};
+  if (column.kind() == KeyColumn::Kind::STRING) {
+    throw Elements::Exception() << "String column " << aggregation.column << " cannot be aggregated";
+  }
+  bool is_integer = column.kind() == KeyColumn::Kind::INTEGER;
+  bool integer_result = is_integer && aggregation.function != Aggregation::Function::MEAN;
+  type = integer_result ? std::type_index(typeid(int64_t)) : std::type_index(typeid(double));
+
+  std::vector<int64_t> integers (groups, 0);
+  std::vector<double> reals (groups, 0.);
+  std::vector<bool> initialized (groups, false);
+  for (std::size_t row = 0; row < group_of.size(); ++row) {
+    auto group = group_of[row];
+    if (is_integer) {
+      auto value = column.integers()[row];
+      switch (aggregation.function) {
+        case Aggregation::Function::MIN:
+          integers[group] = initialized[group] ? std::min(integers[group], value) : value;
+          break;
+        case Aggregation::Function::MAX:
+          integers[group] = initialized[group] ? std::max(integers[group], value) : value;
+          break;
+        default:
+          integers[group] += value;
+      }
+    } else {
+      auto value = column.reals()[row];
+      switch (aggregation.function) {
+        case Aggregation::Function::MIN:
+          reals[group] = initialized[group] ? std::fmin(reals[group], value) : value;
+          break;
+        case Aggregation::Function::MAX:
+          reals[group] = initialized[group] ? std::fmax(reals[group], value) : value;
+          break;
+        default:
+          reals[group] += value;
+      }
+    }
+    initialized[group] = true;
+  }
+
+  for (std::size_t group = 0; group < groups; ++group) {
+    if (aggregation.function == Aggregation::Function::MEAN) {
+      double sum = is_integer ? static_cast<double>(integers[group]) : reals[group];
+      result.push_back(sum / counts[group]);
+    } else if (integer_result) {
+      result.push_back(integers[group]);
+    } else {
+      result.push_back(reals[group]);
+    }
+  }
+  return result;
+}
+
+} // end of anonymous namespace
+
+std::vector<std::size_t> sortIndices(const Table& table, const std::vector<SortKey>& keys,
+                                     std::shared_ptr<ThreadPool> thread_pool) {
+  KeyColumns key_columns {table, keys, thread_pool};
+  std::vector<std::size_t> indices (table.size());
+  std::iota(indices.begin(), indices.end(), 0);
+  auto less = [&key_columns](std::size_t a, std::size_t b) {
+    return key_columns.compare(a, b) < 0;
+  };
+
+  // Each part is sorted by a different task and then the sorted parts are
+  // merged in pairs, until there is only one left
+  auto parts = splitRows(indices.size(), thread_pool);
+  std::vector<std::function<void()>> tasks {};
+  for (auto& part : parts) {
+    tasks.emplace_back([&indices, &less, part]() {
+      std::stable_sort(indices.begin() + part.first, indices.begin() + part.second, less);
+    });
+  }
+  runTasks(thread_pool.get(), tasks);
+  while (parts.size() > 1) {
+    std::vector<std::pair<std::size_t, std::size_t>> merged {};
+    tasks.clear();
+    for (std::size_t i = 0; i + 1 < parts.size(); i += 2) {
+      auto first = parts[i].first;
+      auto middle = parts[i].second;
+      auto last = parts[i + 1].second;
+      tasks.emplace_back([&indices, &less, first, middle, last]() {
+        std::inplace_merge(indices.begin() + first, indices.begin() + middle, indices.begin() + last, less);
+      });
+      merged.emplace_back(first, last);
+    }
+    if (parts.size() % 2 == 1) {
+      merged.push_back(parts.back());
+    }
+    runTasks(thread_pool.get(), tasks);
+    parts = std::move(merged);
+  }
+  return indices;
+}
+
+Table sort(const Table& table, const std::vector<SortKey>& keys, std::shared_ptr<ThreadPool> thread_pool) {
+  std::vector<Row> rows {};
+  rows.reserve(table.size());
+  for (auto index : sortIndices(table, keys, thread_pool)) {
+    rows.push_back(table[index]);
+  }
+  return Table{std::move(rows)};
+}
+
+Table groupBy(const Table& table, const std::vector<std::string>& keys,
+              const std::vector<Aggregation>& aggregations, std::shared_ptr<ThreadPool> thread_pool) {
+  KeyColumns key_columns {table, toSortKeys(keys), thread_pool};
+  auto hashes = key_columns.hashes(thread_pool);
+
+  // Assign each row to a group. The candidate groups of a row are the ones
+  // with the same hash.
+  std::vector<std::size_t> group_of (table.size());
+  std::vector<std::size_t> first_rows {};
+  std::unordered_map<std::size_t, std::vector<std::size_t>> groups_by_hash {};
+  for (std::size_t row = 0; row < table.size(); ++row) {
+    auto& candidates = groups_by_hash[hashes[row]];
+    auto group = std::find_if(candidates.begin(), candidates.end(), [&](std::size_t candidate) {
+      return key_columns.equal(row, key_columns, first_rows[candidate]);
+    });
+    if (group == candidates.end()) {
+      candidates.push_back(first_rows.size());
+      group_of[row] = first_rows.size();
+      first_rows.push_back(row);
+    } else {
+      group_of[row] = *group;
+    }
+  }
+
+  // Each aggregation is computed by a different task
+  std::vector<std::vector<Row::cell_type>> values (aggregations.size());
+  std::vector<std::type_index> types (aggregations.size(), typeid(int64_t));
+  std::vector<std::function<void()>> tasks {};
+  for (std::size_t i = 0; i < aggregations.size(); ++i) {
+    tasks.emplace_back([&, i]() {
+      values[i] = aggregate(table, aggregations[i], group_of, first_rows.size(), types[i]);
+    });
+  }
+  runTasks(thread_pool.get(), tasks);
+
+  auto& info = *table.getColumnInfo();
+  std::vector<std::size_t> key_indices {};
+  std::vector<ColumnDescription> descriptions {};
+  for (auto& key : keys) {
+    key_indices.push_back(columnIndex(table, key));
+    descriptions.push_back(info.getDescription(key_indices.back()));
+  }
+  for (std::size_t i = 0; i < aggregations.size(); ++i) {
+    std::string unit {};
+    if (aggregations[i].function != Aggregation::Function::COUNT) {
+      unit = info.getDescription(columnIndex(table, aggregations[i].column)).unit;
+    }
+    descriptions.emplace_back(aggregations[i].result_column, types[i], unit);
+  }
+  auto column_info = std::make_shared<ColumnInfo>(std::move(descriptions));
+
+  std::vector<Row> rows {};
+  rows.reserve(first_rows.size());
+  for (std::size_t group = 0; group < first_rows.size(); ++group) {
+    std::vector<Row::cell_type> cells {};
+    cells.reserve(column_info->size());
+    for (auto index : key_indices) {
+      cells.push_back(table[first_rows[group]][index]);
+    }
+    for (auto& aggregation_values : values) {
+      cells.push_back(std::move(aggregation_values[group]));
+    }
+    rows.emplace_back(std::move(cells), column_info);
+  }
+  return Table{std::move(rows)};
+}
+
+std::vector<std::pair<std::size_t, std::size_t>> joinIndices(
+        const Table& left, const Table& right, const std::vector<std::string>& keys,
+        std::shared_ptr<ThreadPool> thread_pool) {
+  KeyColumns left_keys {left, toSortKeys(keys), thread_pool};
+  KeyColumns right_keys {right, toSortKeys(keys), thread_pool};
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    if (left_keys.columns()[i].kind() != right_keys.columns()[i].kind()) {
+      throw Elements::Exception() << "Key column " << keys[i] << " has incompatible types in the joined tables";
+    }
+  }
+
+  // The hash table is built for the right table and it is probed in parallel
+  // by the parts of the left table
+  auto right_hashes = right_keys.hashes(thread_pool);
+  auto left_hashes = left_keys.hashes(thread_pool);
+  std::unordered_map<std::size_t, std::vector<std::size_t>> right_rows {};
+  for (std::size_t row = 0; row < right.size(); ++row) {
+    right_rows[right_hashes[row]].push_back(row);
+  }
+
+  auto parts = splitRows(left.size(), thread_pool);
+  std::vector<std::vector<std::pair<std::size_t, std::size_t>>> matches (parts.size());
+  std::vector<std::function<void()>> tasks {};
+  for (std::size_t i = 0; i < parts.size(); ++i) {
+    tasks.emplace_back([&, i]() {
+      for (std::size_t row = parts[i].first; row < parts[i].second; ++row) {
+        auto candidates = right_rows.find(left_hashes[row]);
+        if (candidates == right_rows.end()) {
+          continue;
+        }
+        for (auto right_row : candidates->second) {
+          if (left_keys.equal(row, right_keys, right_row)) {
+            matches[i].emplace_back(row, right_row);
+          }
+        }
+      }
+    });
+  }
+  runTasks(thread_pool.get(), tasks);
+
+  std::vector<std::pair<std::size_t, std::size_t>> result {};
+  for (auto& part_matches : matches) {
+    result.insert(result.end(), part_matches.begin(), part_matches.end());
+  }
+  return result;
+}
+
+Table join(const Table& left, const Table& right, const std::vector<std::string>& keys,
+           std::shared_ptr<ThreadPool> thread_pool) {
+  auto indices = joinIndices(left, right, keys, thread_pool);
+  if (indices.empty()) {
+    throw Elements::Exception() << "The joined tables do not have any matching rows";
+  }
+
+  auto& left_info = *left.getColumnInfo();
+  auto& right_info = *right.getColumnInfo();
+  std::vector<ColumnDescription> descriptions {};
+  for (std::size_t i = 0; i < left_info.size(); ++i) {
+    descriptions.push_back(left_info.getDescription(i));
+  }
+  std::vector<std::size_t> right_columns {};
+  for (std::size_t i = 0; i < right_info.size(); ++i) {
+    auto& description = right_info.getDescription(i);
+    if (std::find(keys.begin(), keys.end(), description.name) == keys.end()) {
+      right_columns.push_back(i);
+      descriptions.push_back(description);
+    }
+  }
+  auto column_info = std::make_shared<ColumnInfo>(std::move(descriptions));
+
+  // The rows are created in parallel, each task creating the rows of a part
+  auto parts = splitRows(indices.size(), thread_pool);
+  std::vector<std::vector<Row>> part_rows (parts.size());
+  std::vector<std::function<void()>> tasks {};
+  for (std::size_t i = 0; i < parts.size(); ++i) {
+    tasks.emplace_back([&, i]() {
+      part_rows[i].reserve(parts[i].second - parts[i].first);
+      for (std::size_t match = parts[i].first; match < parts[i].second; ++match) {
+        std::vector<Row::cell_type> cells {};
+        cells.reserve(column_info->size());
+        auto& left_row = left[indices[match].first];
+        auto& right_row = right[indices[match].second];
+        for (std::size_t column = 0; column < left_row.size(); ++column) {
+          cells.push_back(left_row[column]);
+        }
+        for (auto column : right_columns) {
+          cells.push_back(right_row[column]);
+        }
+        part_rows[i].emplace_back(std::move(cells), column_info);
+      }
+    });
+  }
+  runTasks(thread_pool.get(), tasks);
+
+  std::vector<Row> rows {};
+  rows.reserve(indices.size());
+  for (auto& part : part_rows) {
+    std::move(part.begin(), part.end(), std::back_inserter(rows));
+  }
+  return Table{std::move(rows)};
+}
+
+} // Table namespace
+} // Euclid namespace
@@ -23,12 +23,18 @@
  */
 
 #include "Table/TableWriter.h"
+#include "Table/DictionaryEncoding.h"
 #include "ElementsKernel/Exception.h"
 
 namespace Euclid {
 namespace Table {
 
 void TableWriter::addData(const Table& table) {
+  // The implementations write only the decoded string columns
+  if (hasDictionaryColumns(*table.getColumnInfo())) {
+    addData(decodeDictionaryColumns(table));
+    return;
+  }
   auto& info = *table.getColumnInfo();
   if (m_column_info == nullptr) {
     m_column_info.reset(new ColumnInfo(info));
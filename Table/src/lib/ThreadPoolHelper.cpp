@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/ThreadPoolHelper.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include "ThreadPoolHelper.h"
+
+namespace Euclid {
+namespace Table {
+
+namespace {
+
+struct TasksState {
+  std::mutex mutex {};
+  std::condition_variable done {};
+  std::size_t remaining = 0;
+  std::exception_ptr exception {};
+};
+
+}
+
+void runTasks(ThreadPool* pool, const std::vector<std::function<void()>>& tasks) {
+  if (pool == nullptr || tasks.size() < 2) {
+    for (auto& task : tasks) {
+      task();
+    }
+    return;
+  }
+  
+  // The state is shared with the submitted tasks, so it is not destroyed
+  // before the last task has released its mutex
+  auto state = std::make_shared<TasksState>();
+  state->remaining = tasks.size();
+  for (auto& task : tasks) {
+    pool->submit([state, task]() {
+      std::exception_ptr exception {};
+      try {
+        task();
+      } catch (...) {
+        exception = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock {state->mutex};
+      if (exception && !state->exception) {
+        state->exception = exception;
+      }
+      if (--state->remaining == 0) {
+        state->done.notify_all();
+      }
+    });
+  }
+  
+  std::unique_lock<std::mutex> lock {state->mutex};
+  state->done.wait(lock, [&state]() { return state->remaining == 0; });
+  if (state->exception) {
+    std::rethrow_exception(state->exception);
+  }
+}
+
+}
+} // end of namespace Euclid
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/ThreadPoolHelper.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef TABLE_THREADPOOLHELPER_H
+#define TABLE_THREADPOOLHELPER_H
+
+#include <functional>
+#include <vector>
+#include "ElementsKernel/Export.h"
+#include "AlexandriaKernel/ThreadPool.h"
+
+namespace Euclid {
+namespace Table {
+
+/**
+ * @brief
+ * Executes the given tasks in the thread pool and waits until they finish
+ * @details
+ * Only the given tasks are waited for, so the pool can be shared with other
+ * users. If the pool is null, or there is only one task, the tasks are executed
+ * in the calling thread. Note that the method must not be called from a task
+ * executed by the same pool, as it might block all its threads.
+ *
+ * @param pool The pool to execute the tasks, or null
+ * @param tasks The tasks to execute
+ * @throws
+ *    the first exception thrown by any of the tasks, after all the tasks have
+ *    finished
+ */
+ELEMENTS_API void runTasks(ThreadPool* pool, const std::vector<std::function<void()>>& tasks);
+
+}
+} // end of namespace Euclid
+
+#endif /* TABLE_THREADPOOLHELPER_H */
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file src/lib/TypedTableReader.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <cstdint>
+#include <string>
+#include "Table/TypedTableReader.h"
+
+namespace Euclid {
+namespace Table {
+
+bool isLosslessConversion(std::type_index from, std::type_index to) {
+  if (from == to) {
+    return true;
+  }
+  if (from == typeid(bool)) {
+    return to == typeid(int32_t) || to == typeid(int64_t) || to == typeid(float) || to == typeid(double);
+  }
+  if (from == typeid(int32_t)) {
+    return to == typeid(int64_t) || to == typeid(double);
+  }
+  if (from == typeid(float)) {
+    return to == typeid(double);
+  }
+  return false;
+}
+
+} // Table namespace
+} // Euclid namespace
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file src/lib/ValidityBitmap.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include "ElementsKernel/Exception.h"
+#include "Table/ValidityBitmap.h"
+
+namespace Euclid {
+namespace Table {
+
+const std::size_t ValidityBitmap::word_bits;
+
+ValidityBitmap::ValidityBitmap(std::size_t size)
+        : m_size(size), m_words((size + word_bits - 1) / word_bits, ~word_type{0}) {
+  // The unused bits of the last word are kept zero
+  if (size % word_bits != 0) {
+    m_words.back() = (word_type{1} << (size % word_bits)) - 1;
+  }
+}
+
+std::size_t ValidityBitmap::size() const {
+  return m_size;
+}
+
+void ValidityBitmap::setValid(std::size_t index, bool valid) {
+  if (index >= m_size) {
+    throw Elements::Exception() << "Index " << index << " is out of the bitmap range ("
+                                << m_size << " rows)";
+  }
+  auto mask = word_type{1} << (index % word_bits);
+  if (valid) {
+    m_words[index / word_bits] |= mask;
+  } else {
+    m_words[index / word_bits] &= ~mask;
+  }
+}
+
+std::size_t ValidityBitmap::countValid() const {
+  std::size_t count = 0;
+  for (auto word : m_words) {
+    // Clears the lowest set bit at each step
+    for (; word != 0; word &= word - 1) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+bool ValidityBitmap::allValid() const {
+  return countValid() == m_size;
+}
+
+const std::vector<ValidityBitmap::word_type>& ValidityBitmap::getWords() const {
+  return m_words;
+}
+
+ValidityBitmap ValidityBitmap::slice(std::size_t first, std::size_t count) const {
+  if (first + count > m_size) {
+    throw Elements::Exception() << "Rows [" << first << ", " << first + count
+                                << ") are out of the bitmap range (" << m_size << " rows)";
+  }
+  ValidityBitmap result {count};
+  std::size_t shift = first % word_bits;
+  for (std::size_t w = 0; w < result.m_words.size(); ++w) {
+    std::size_t source = first / word_bits + w;
+    auto word = m_words[source] >> shift;
+    if (shift != 0 && source + 1 < m_words.size()) {
+      word |= m_words[source + 1] << (word_bits - shift);
+    }
+    // The mask of the result keeps the unused bits of the last word zero
+    result.m_words[w] &= word;
+  }
+  return result;
+}
+
+void ValidityBitmap::append(const ValidityBitmap& other) {
+  std::size_t shift = m_size % word_bits;
+  std::size_t base = m_size / word_bits;
+  m_size += other.m_size;
+  m_words.resize((m_size + word_bits - 1) / word_bits, 0);
+  for (std::size_t w = 0; w < other.m_words.size(); ++w) {
+    m_words[base + w] |= other.m_words[w] << shift;
+    if (shift != 0 && base + w + 1 < m_words.size()) {
+      m_words[base + w + 1] |= other.m_words[w] >> (word_bits - shift);
+    }
+  }
+}
+
+ValidityBitmap& ValidityBitmap::operator&=(const ValidityBitmap& other) {
+  if (m_size != other.m_size) {
+    throw Elements::Exception() << "Cannot combine validity bitmaps of sizes " << m_size
+                                << " and " << other.m_size;
+  }
+  for (std::size_t i = 0; i < m_words.size(); ++i) {
+    m_words[i] &= other.m_words[i];
+  }
+  return *this;
+}
+
+bool ValidityBitmap::operator==(const ValidityBitmap& other) const {
+  return m_size == other.m_size && m_words == other.m_words;
+}
+
+bool ValidityBitmap::operator!=(const ValidityBitmap& other) const {
+  return !(*this == other);
+}
+
+ValidityBitmap operator&(ValidityBitmap left, const ValidityBitmap& right) {
+  left &= right;
+  return left;
+}
+
+} // Table namespace
+} // Euclid namespace
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/ZoneMapHelper.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <algorithm>
+#include <limits>
+#include "ElementsKernel/Exception.h"
+#include "ZoneMapHelper.h"
+
+namespace Euclid {
+namespace Table {
+
+namespace {
+
+// Returns the validity bitmap of the column, or null if it has no missing values
+const ValidityBitmap* findValidity(const Table& table, std::size_t column_index) {
+  auto& bitmaps = table.getValidityBitmaps();
+  auto bitmap = bitmaps.find(column_index);
+  return bitmap == bitmaps.end() ? nullptr : &bitmap->second;
+}
+
+// The missing values are counted as nulls. If all the values are missing the
+// minimum is greater than the maximum.
+template <typename T>
+ColumnStatistics integerStatistics(const Table& table, std::size_t column_index, std::size_t first, std::size_t last) {
+  auto validity = findValidity(table, column_index);
+  int64_t min = std::numeric_limits<int64_t>::max();
+  int64_t max = std::numeric_limits<int64_t>::min();
+  std::size_t null_count = 0;
+  for (std::size_t row = first; row < last; ++row) {
+    if (validity != nullptr && !validity->isValid(row)) {
+      ++null_count;
+      continue;
+    }
+    int64_t value = *boost::get<T>(&table[row][column_index]);
+    min = std::min(min, value);
+    max = std::max(max, value);
+  }
+  ColumnStatistics statistics {};
+  statistics.min = min;
+  statistics.max = max;
+  statistics.null_count = null_count;
+  return statistics;
+}
+
+template <typename T>
+ColumnStatistics realStatistics(const Table& table, std::size_t column_index, std::size_t first, std::size_t last) {
+  auto validity = findValidity(table, column_index);
+  double min = std::numeric_limits<double>::infinity();
+  double max = -std::numeric_limits<double>::infinity();
+  std::size_t null_count = 0;
+  for (std::size_t row = first; row < last; ++row) {
+    double value = *boost::get<T>(&table[row][column_index]);
+    if (std::isnan(value) || (validity != nullptr && !validity->isValid(row))) {
+      ++null_count;
+      continue;
+    }
+    min = std::min(min, value);
+    max = std::max(max, value);
+  }
+  ColumnStatistics statistics {};
+  if (null_count == last - first) {
+    min = max = std::numeric_limits<double>::quiet_NaN();
+  }
+  statistics.min = min;
+  statistics.max = max;
+  statistics.null_count = null_count;
+  return statistics;
+}
+
+const std::string offset_column = "OFFSET";
+const std::string rows_column = "ROWS";
+
+// The statistics are stored in the columns MINn, MAXn and NULLSn
+const std::vector<std::string> statistics_prefixes {"MIN", "MAX", "NULLS"};
+
+} // end of anonymous namespace
+
+boost::optional<ColumnStatistics> computeStatistics(const Table& table, std::size_t column_index,
+                                                    std::size_t first, std::size_t last) {
+  auto& type = table.getColumnInfo()->getDescription(column_index).type;
+  if (type == typeid(bool)) {
+    return integerStatistics<bool>(table, column_index, first, last);
+  }
+  if (type == typeid(int32_t)) {
+    return integerStatistics<int32_t>(table, column_index, first, last);
+  }
+  if (type == typeid(int64_t)) {
+    return integerStatistics<int64_t>(table, column_index, first, last);
+  }
+  if (type == typeid(float)) {
+    return realStatistics<float>(table, column_index, first, last);
+  }
+  if (type == typeid(double)) {
+    return realStatistics<double>(table, column_index, first, last);
+  }
+  return boost::none;
+}
+
+void mergeStatistics(ColumnStatistics& statistics, const ColumnStatistics& other) {
+  statistics.null_count += other.null_count;
+  if (!other.hasValues()) {
+    return;
+  }
+  if (!statistics.hasValues()) {
+    statistics.min = other.min;
+    statistics.max = other.max;
+    return;
+  }
+  if (statistics.min.which() == 0) {
+    statistics.min = std::min(boost::get<int64_t>(statistics.min), boost::get<int64_t>(other.min));
+    statistics.max = std::max(boost::get<int64_t>(statistics.max), boost::get<int64_t>(other.max));
+  } else {
+    statistics.min = std::min(boost::get<double>(statistics.min), boost::get<double>(other.min));
+    statistics.max = std::max(boost::get<double>(statistics.max), boost::get<double>(other.max));
+  }
+}
+
+Table zoneMapToTable(const ZoneMap& zone_map, const ColumnInfo& column_info) {
+  // The columns with statistics, in the order of the described table
+  std::vector<std::pair<std::size_t, std::string>> columns {};
+  for (auto& column : zone_map.front().columns) {
+    auto index = column_info.findIndex(column.first);
+    if (!index) {
+      throw Elements::Exception() << "Zone map column " << column.first << " is not a table column";
+    }
+    columns.emplace_back(*index, column.first);
+  }
+  std::sort(columns.begin(), columns.end());
+
+  std::vector<ColumnDescription> descriptions {
+    {offset_column, typeid(int64_t), "", "Number of table rows before the block"},
+    {rows_column, typeid(int64_t), "", "Number of rows of the block"}
+  };
+  for (auto& column : columns) {
+    auto number = std::to_string(column.first + 1);
+    auto& statistics = zone_map.front().columns.at(column.second);
+    std::type_index type = statistics.min.which() == 0 ? typeid(int64_t) : typeid(double);
+    descriptions.emplace_back("MIN" + number, type, "", "Minimum of " + column.second);
+    descriptions.emplace_back("MAX" + number, type, "", "Maximum of " + column.second);
+    descriptions.emplace_back("NULLS" + number, typeid(int64_t), "", "Number of NaN or missing values of " + column.second);
+  }
+  auto info = std::make_shared<ColumnInfo>(std::move(descriptions));
+
+  std::vector<Row> rows {};
+  rows.reserve(zone_map.size());
+  for (auto& block : zone_map) {
+    std::vector<Row::cell_type> cells {int64_t(block.offset), int64_t(block.rows)};
+    for (auto& column : columns) {
+      auto& statistics = block.columns.at(column.second);
+      if (statistics.min.which() == 0) {
+        cells.push_back(boost::get<int64_t>(statistics.min));
+        cells.push_back(boost::get<int64_t>(statistics.max));
+      } else {
+        cells.push_back(boost::get<double>(statistics.min));
+        cells.push_back(boost::get<double>(statistics.max));
+      }
+      cells.push_back(int64_t(statistics.null_count));
+    }
+    rows.emplace_back(std::move(cells), info);
+  }
+  return Table{std::move(rows)};
+}
+
+ZoneMap zoneMapFromTable(const Table& table, const ColumnInfo& column_info) {
+  auto& info = *table.getColumnInfo();
+  auto offset_index = info.findIndex(offset_column);
+  auto rows_index = info.findIndex(rows_column);
+  if (!offset_index || !rows_index) {
+    throw Elements::Exception() << "Zone map table without " << offset_column << " or " << rows_column << " column";
+  }
+
+  // The indices of the MINn, MAXn and NULLSn columns of each described column
+  std::map<std::string, std::vector<std::size_t>> statistics_columns {};
+  for (std::size_t i = 0; i < column_info.size(); ++i) {
+    std::vector<std::size_t> indices {};
+    for (auto& prefix : statistics_prefixes) {
+      auto index = info.findIndex(prefix + std::to_string(i + 1));
+      if (index) {
+        indices.push_back(*index);
+      }
+    }
+    if (indices.size() == statistics_prefixes.size()) {
+      statistics_columns.emplace(column_info.getDescription(i).name, std::move(indices));
+    }
+  }
+
+  auto toValue = [](const Row::cell_type& cell) -> ColumnStatistics::value_type {
+    if (cell.type() == typeid(int64_t)) {
+      return boost::get<int64_t>(cell);
+    }
+    return boost::get<double>(cell);
+  };
+  ZoneMap zone_map {};
+  for (auto& row : table) {
+    ZoneMapBlock block {};
+    block.offset = boost::get<int64_t>(row[*offset_index]);
+    block.rows = boost::get<int64_t>(row[*rows_index]);
+    for (auto& column : statistics_columns) {
+      ColumnStatistics statistics {};
+      statistics.min = toValue(row[column.second[0]]);
+      statistics.max = toValue(row[column.second[1]]);
+      statistics.null_count = boost::get<int64_t>(row[column.second[2]]);
+      block.columns.emplace(column.first, statistics);
+    }
+    zone_map.push_back(std::move(block));
+  }
+  return zone_map;
+}
+
+}
+} // end of namespace Euclid
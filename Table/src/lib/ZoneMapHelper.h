@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file src/lib/ZoneMapHelper.h
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#ifndef TABLE_ZONEMAPHELPER_H
+#define TABLE_ZONEMAPHELPER_H
+
+#include <boost/optional.hpp>
+#include "ElementsKernel/Export.h"
+#include "Table/Table.h"
+#include "Table/ZoneMap.h"
+
+namespace Euclid {
+namespace Table {
+
+/**
+ * @brief
+ * Computes the statistics of the rows [first, last) of a table column
+ * @details
+ * The range must not be empty.
+ * @return
+ *    The statistics, or none if the column is not of type bool, int32_t,
+ *    int64_t, float or double
+ */
+ELEMENTS_API boost::optional<ColumnStatistics> computeStatistics(const Table& table, std::size_t column_index,
+                                                                 std::size_t first, std::size_t last);
+
+/// Updates the statistics of a block with the ones of more rows of the same column
+ELEMENTS_API void mergeStatistics(ColumnStatistics& statistics, const ColumnStatistics& other);
+
+/**
+ * @brief
+ * Converts a zone map to the table stored in the index HDU of a FITS table
+ * @details
+ * The table has the columns OFFSET and ROWS, followed by the columns MINn,
+ * MAXn and NULLSn for the n-th column (starting from 1) of the described
+ * table, for each column with statistics. The statistics columns are named
+ * after the column numbers, so they stay valid when a reader renames the
+ * columns. All the blocks must have statistics for the same columns.
+ * @param zone_map
+ *    The zone map, which cannot be empty
+ * @param column_info
+ *    The columns of the table the zone map describes
+ * @throws Elements::Exception
+ *    if a column of the zone map is not in the column_info
+ */
+ELEMENTS_API Table zoneMapToTable(const ZoneMap& zone_map, const ColumnInfo& column_info);
+
+/**
+ * @brief
+ * Converts the table of an index HDU back to a zone map
+ * @details
+ * The statistics of the n-th column are stored in the zone map with the name
+ * of the n-th column of the given column_info.
+ * @throws Elements::Exception
+ *    if the table does not have the OFFSET and ROWS columns
+ */
+ELEMENTS_API ZoneMap zoneMapFromTable(const Table& table, const ColumnInfo& column_info);
+
+}
+} // end of namespace Euclid
+
+#endif /* TABLE_ZONEMAPHELPER_H */
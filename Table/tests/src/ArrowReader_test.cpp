@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file tests/src/ArrowReader_test.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <fstream>
+#include <boost/test/unit_test.hpp>
+#include "ElementsKernel/Exception.h"
+#include "ElementsKernel/Temporary.h"
+#include "Table/ArrowReader.h"
+#include "Table/ArrowWriter.h"
+
+using namespace Euclid::Table;
+using Euclid::NdArray::NdArray;
+
+struct ArrowReader_Fixture {
+  Elements::TempDir temp_dir;
+  std::string filename = (temp_dir.path() / "table.arrow").native();
+  std::shared_ptr<ColumnInfo> column_info {new ColumnInfo {{
+    ColumnInfo::info_type("Bool", typeid(bool), "", "A flag"),
+    ColumnInfo::info_type("Int", typeid(int32_t), "count"),
+    ColumnInfo::info_type("Long", typeid(int64_t)),
+    ColumnInfo::info_type("Float", typeid(float)),
+    ColumnInfo::info_type("Double", typeid(double), "mag"),
+    ColumnInfo::info_type("String", typeid(std::string)),
+    ColumnInfo::info_type("BoolVector", typeid(std::vector<bool>)),
+    ColumnInfo::info_type("DoubleVector", typeid(std::vector<double>)),
+    ColumnInfo::info_type("IntNdArray", typeid(NdArray<int32_t>))
+  }}};
+  std::vector<Row> rows {};
+  ArrowReader_Fixture() {
+    for (int32_t i = 0; i < 10; ++i) {
+      NdArray<int32_t> ndarray {{2, 3}};
+      std::fill(ndarray.begin(), ndarray.end(), i);
+      rows.emplace_back(std::vector<Row::cell_type>{
+        i % 2 == 0, i, int64_t{i} * 10000000000, 0.5f * i, 0.25 * i, "row" + std::to_string(i),
+        std::vector<bool>(i % 4, true), std::vector<double>(i, 1.5 * i), ndarray
+      }, column_info);
+    }
+    // Write the rows in two record batches
+    ArrowWriter writer {filename, true};
+    writer.addComment("A comment");
+    writer.addData(Table{std::vector<Row>(rows.begin(), rows.begin() + 4)});
+    writer.addData(Table{std::vector<Row>(rows.begin() + 4, rows.end())});
+  }
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (ArrowReader_test)
+
+//-----------------------------------------------------------------------------
+// Test reading all the rows of the table
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ReadAll, ArrowReader_Fixture) {
+
+  // Given
+  ArrowReader reader {filename};
+
+  // When
+  auto table = reader.read();
+
+  // Then
+  BOOST_CHECK(reader.getInfo() == *column_info);
+  BOOST_CHECK_EQUAL(reader.getComment(), "A comment");
+  BOOST_CHECK_EQUAL(table.size(), rows.size());
+  for (std::size_t r = 0; r < rows.size(); ++r) {
+    for (std::size_t c = 0; c < column_info->size(); ++c) {
+      BOOST_CHECK(table[r][c] == rows[r][c]);
+    }
+  }
+  BOOST_CHECK(!reader.hasMoreRows());
+  BOOST_CHECK_THROW(reader.read(), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test reading parts of the table crossing the record batches
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ReadParts, ArrowReader_Fixture) {
+
+  // Given
+  ArrowReader reader {filename};
+
+  // When
+  reader.skip(2);
+  auto first = reader.read(3);
+  auto left = reader.rowsLeft();
+  auto second = reader.read(100);
+
+  // Then
+  BOOST_CHECK_EQUAL(first.size(), 3);
+  BOOST_CHECK_EQUAL(left, 5);
+  BOOST_CHECK_EQUAL(second.size(), 5);
+  BOOST_CHECK(first[0][5] == rows[2][5]);
+  BOOST_CHECK(first[2][8] == rows[4][8]);
+  BOOST_CHECK(second[0][7] == rows[5][7]);
+  BOOST_CHECK(second[4][6] == rows[9][6]);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test reading only some of the columns
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(SelectColumns, ArrowReader_Fixture) {
+
+  // Given
+  ArrowReader reader {filename};
+
+  // When
+  reader.selectColumns({"String", "Long"});
+  auto table = reader.read();
+
+  // Then
+  BOOST_CHECK_EQUAL(reader.getInfo().size(), 2);
+  BOOST_CHECK_EQUAL(reader.getInfo().getDescription(0).name, "String");
+  BOOST_CHECK_EQUAL(table[7].size(), 2);
+  BOOST_CHECK(table[7][0] == rows[7][5]);
+  BOOST_CHECK(table[7][1] == rows[7][2]);
+  BOOST_CHECK_THROW(reader.selectColumns({"Long"}), Elements::Exception);
+  BOOST_CHECK_THROW(ArrowReader{filename}.selectColumns({"Missing"}), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test accessing the mapped column data directly
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(MapColumn, ArrowReader_Fixture) {
+
+  // Given
+  ArrowReader reader {filename};
+
+  // When
+  auto chunks = reader.mapColumn<double>("Double");
+
+  // Then
+  BOOST_CHECK_EQUAL(chunks.size(), 2);
+  BOOST_CHECK_EQUAL(chunks[0].size, 4);
+  BOOST_CHECK_EQUAL(chunks[1].size, 6);
+  BOOST_CHECK_EQUAL(chunks[0].data[3], 0.75);
+  BOOST_CHECK_EQUAL(chunks[1].data[5], 2.25);
+  BOOST_CHECK_THROW(reader.mapColumn<float>("Double"), Elements::Exception);
+
+  // When
+  auto ndarray_chunks = reader.mapColumn<int32_t>("IntNdArray");
+
+  // Then
+  BOOST_CHECK_EQUAL(ndarray_chunks.size(), 2);
+  BOOST_CHECK_EQUAL(ndarray_chunks[1].size, 36);
+  BOOST_CHECK_EQUAL(ndarray_chunks[1].data[6], 5);
+  BOOST_CHECK_THROW(reader.mapColumn<double>("DoubleVector"), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test files which are not Arrow files are rejected
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(InvalidFile, ArrowReader_Fixture) {
+
+  // Given
+  auto text_file = (temp_dir.path() / "table.txt").native();
+  {
+    std::ofstream out {text_file};
+    out << "# Column: Id long\n1\n2\n3\n4\n5\n6\n7\n8\n9\n";
+  }
+  auto truncated_file = (temp_dir.path() / "truncated.arrow").native();
+  {
+    std::ifstream in {filename, std::ios::binary};
+    std::string content {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    std::ofstream out {truncated_file, std::ios::binary};
+    out << content.substr(0, content.size() - 5);
+  }
+
+  // Then
+  BOOST_CHECK_THROW(ArrowReader{text_file}, Elements::Exception);
+  BOOST_CHECK_THROW(ArrowReader{truncated_file}, Elements::Exception);
+  BOOST_CHECK_THROW(ArrowReader{(temp_dir.path() / "missing").native()}, Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file tests/src/ArrowWriter_test.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "ElementsKernel/Exception.h"
+#include "ElementsKernel/Temporary.h"
+#include "Table/ArrowReader.h"
+#include "Table/ArrowWriter.h"
+
+using namespace Euclid::Table;
+using Euclid::NdArray::NdArray;
+
+struct ArrowWriter_Fixture {
+  Elements::TempDir temp_dir;
+  std::string filename = (temp_dir.path() / "table.arrow").native();
+  std::shared_ptr<ColumnInfo> column_info {new ColumnInfo {{
+    ColumnInfo::info_type("Id", typeid(int64_t)),
+    ColumnInfo::info_type("Name", typeid(std::string))
+  }}};
+  Table table {{
+    Row{{int64_t{1}, std::string{"First"}}, column_info},
+    Row{{int64_t{2}, std::string{"Second"}}, column_info}
+  }};
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (ArrowWriter_test)
+
+//-----------------------------------------------------------------------------
+// Test the data are readable after each addData() call
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(AddData, ArrowWriter_Fixture) {
+
+  // Given
+  ArrowWriter writer {filename, true};
+
+  // When
+  writer.addData(table);
+
+  // Then
+  BOOST_CHECK_EQUAL(ArrowReader{filename}.rowsLeft(), 2);
+
+  // When
+  writer.addData(table);
+  writer.addComment("Added later");
+
+  // Then
+  ArrowReader reader {filename};
+  BOOST_CHECK_EQUAL(reader.rowsLeft(), 4);
+  BOOST_CHECK_EQUAL(reader.getComment(), "Added later");
+
+}
+
+//-----------------------------------------------------------------------------
+// Test appending to and overriding an existing file
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ExistingFile, ArrowWriter_Fixture) {
+
+  // Given
+  {
+    ArrowWriter writer {filename, true};
+    writer.addComment("First");
+    writer.addData(table);
+  }
+
+  // When
+  {
+    ArrowWriter writer {filename};
+    writer.addComment("Second");
+    writer.addData(table);
+  }
+  ArrowReader appended {filename};
+
+  // Then
+  BOOST_CHECK_EQUAL(appended.rowsLeft(), 4);
+  BOOST_CHECK_EQUAL(appended.getComment(), "First\nSecond");
+  auto result = appended.read();
+  BOOST_CHECK(result[3][1] == table[1][1]);
+
+  // When
+  {
+    ArrowWriter writer {filename, true};
+    writer.addData(table);
+  }
+
+  // Then
+  BOOST_CHECK_EQUAL(ArrowReader{filename}.rowsLeft(), 2);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test appending a table with different columns to an existing file fails
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ExistingFileDifferentColumns, ArrowWriter_Fixture) {
+
+  // Given
+  {
+    ArrowWriter writer {filename, true};
+    writer.addData(table);
+  }
+  std::shared_ptr<ColumnInfo> other_info {new ColumnInfo {{
+    ColumnInfo::info_type("Id", typeid(int32_t))
+  }}};
+  Table other {{Row{{int32_t{1}}, other_info}}};
+
+  // When
+  ArrowWriter writer {filename};
+
+  // Then
+  BOOST_CHECK_THROW(writer.addData(other), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test NdArray columns must have the same shape in all the rows
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(NdArrayShapes, ArrowWriter_Fixture) {
+
+  // Given
+  std::shared_ptr<ColumnInfo> ndarray_info {new ColumnInfo {{
+    ColumnInfo::info_type("Image", typeid(NdArray<float>))
+  }}};
+  Table same_shape {{
+    Row{{NdArray<float>{{2, 2}}}, ndarray_info},
+    Row{{NdArray<float>{{2, 2}}}, ndarray_info}
+  }};
+  Table different_shape {{
+    Row{{NdArray<float>{{2, 2}}}, ndarray_info},
+    Row{{NdArray<float>{{4}}}, ndarray_info}
+  }};
+  ArrowWriter writer {filename, true};
+
+  // When
+  writer.addData(same_shape);
+
+  // Then
+  BOOST_CHECK_THROW(writer.addData(different_shape), Elements::Exception);
+  auto result = ArrowReader{filename}.read();
+  BOOST_CHECK_EQUAL(result.size(), 2);
+  BOOST_CHECK(boost::get<NdArray<float>>(result[1][0]).shape() == std::vector<std::size_t>({2, 2}));
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -428,6 +428,73 @@ BOOST_FIXTURE_TEST_CASE(autoDetectColumnNamesDuplicate, AsciiReaderHelper_Fixtur
   
 }
 
+//-----------------------------------------------------------------------------
+// Test the autoDetectColumnTypes selects the narrowest type of each column
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(autoDetectColumnTypes) {
+  
+  // Given
+  std::stringstream stream {
+    "# Comment\n"
+    "t 1 3000000000 1.5 0.123456789 abc 1,2 1.5,2 <2>1,2 \n"
+    "\n"
+    "n -7 1 -2e3 1e300 1 3 nan 5 # comment\n"
+    "y 0 2 inf 2 2 4 1 6 \n"
+    "1 1 1 1 1 1 1 1 1"};
+  
+  // When
+  auto types = Euclid::Table::autoDetectColumnTypes(stream, "#", 10, 3);
+  
+  // Then
+  std::vector<std::type_index> expected {
+    typeid(bool), typeid(int32_t), typeid(int64_t), typeid(float), typeid(double),
+    typeid(std::string), typeid(std::vector<int32_t>), typeid(std::vector<float>),
+    typeid(std::string), typeid(std::string)
+  };
+  BOOST_CHECK(types == expected);
+  BOOST_CHECK_EQUAL(stream.tellg(), 0);
+  
+}
+
+//-----------------------------------------------------------------------------
+// Test the buildRowIndex keeps the positions of the sampled data rows
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(buildRowIndex) {
+  
+  // Given
+  std::string data {
+    "# Comment\n"   // 0
+    "1\n"           // 10
+    "\n"            // 12
+    "2 # data\n"    // 13
+    "# Comment\n"   // 22
+    "3\n"           // 32
+    "4"             // 34
+  };
+  std::stringstream in {data};
+  
+  // When
+  auto index = Euclid::Table::buildRowIndex(in, "#", 2);
+  std::stringstream stored {};
+  Euclid::Table::writeRowIndex(stored, index);
+  auto loaded = Euclid::Table::readRowIndex(stored);
+  
+  // Then
+  std::vector<std::streamoff> expected {10, 32};
+  BOOST_CHECK_EQUAL(index.rows, 4);
+  BOOST_CHECK_EQUAL(index.end, 35);
+  BOOST_CHECK_EQUAL_COLLECTIONS(index.offsets.begin(), index.offsets.end(), expected.begin(), expected.end());
+  BOOST_CHECK_EQUAL(in.tellg(), 0);
+  BOOST_CHECK_EQUAL(loaded.rows, index.rows);
+  BOOST_CHECK_EQUAL(loaded.end, index.end);
+  BOOST_CHECK_EQUAL(loaded.comment, "#");
+  BOOST_CHECK_EQUAL_COLLECTIONS(loaded.offsets.begin(), loaded.offsets.end(), expected.begin(), expected.end());
+  BOOST_CHECK_THROW(Euclid::Table::buildRowIndex(in, "#", 0), Elements::Exception);
+  
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END ()
@@ -25,6 +25,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include "ElementsKernel/Exception.h"
+#include "ElementsKernel/Temporary.h"
 #include "Table/AsciiReader.h"
 #include "Table/TableWriter.h"
 
@@ -104,6 +105,21 @@ struct AsciiReader_Fixture {
     "# Column: Double double\n"
     "  Something"
   };
+  
+  std::string seven_rows {
+    "# Column: Id int\n"
+    "\n"
+    "# Id\n"
+    "0\n"
+    "1 # A comment after data\n"
+    "# A comment between the rows\n"
+    "2\n"
+    "\n"
+    "3\n"
+    "4\n"
+    "5\n"
+    "6"
+  };
 };
 
 //-----------------------------------------------------------------------------
@@ -467,6 +483,311 @@ BOOST_FIXTURE_TEST_CASE(ReadComment, AsciiReader_Fixture) {
   BOOST_CHECK_EQUAL(slash_reader.getComment(), "This string contains no data\nonly double slash comments");
 }
 
+//-----------------------------------------------------------------------------
+// Test the type inference of the columns without description
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(InferColumnTypes, AsciiReader_Fixture) {
+  
+  // Given
+  std::stringstream in {
+    "# Column: Label string\n"
+    "# Label Id Flux Flags\n"
+    "1 1 0.5 t\n"
+    "2 2 1.25 f\n"};
+  
+  // When
+  AsciiReader reader {in};
+  reader.inferColumnTypes(2);
+  auto table = reader.read();
+  
+  // Then
+  auto& info = *table.getColumnInfo();
+  BOOST_CHECK(info.getDescription(0).type == typeid(std::string));
+  BOOST_CHECK(info.getDescription(1).type == typeid(int32_t));
+  BOOST_CHECK(info.getDescription(2).type == typeid(float));
+  BOOST_CHECK(info.getDescription(3).type == typeid(bool));
+  BOOST_CHECK_EQUAL(boost::get<std::string>(table[1][0]), "2");
+  BOOST_CHECK_EQUAL(boost::get<int32_t>(table[1][1]), 2);
+  BOOST_CHECK_EQUAL(boost::get<float>(table[1][2]), 1.25f);
+  BOOST_CHECK_EQUAL(boost::get<bool>(table[1][3]), false);
+  BOOST_CHECK_THROW(reader.inferColumnTypes(), Elements::Exception);
+  BOOST_CHECK_THROW(AsciiReader{in}.inferColumnTypes(0), Elements::Exception);
+  
+}
+
+//-----------------------------------------------------------------------------
+// Test that a zero row index sampling throws an exception
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(RowIndexZeroSampling, AsciiReader_Fixture) {
+  
+  // Given
+  std::stringstream in {seven_rows};
+  
+  // When
+  AsciiReader reader {in};
+  
+  // Then
+  BOOST_CHECK_THROW(reader.useRowIndex(0), Elements::Exception);
+  
+}
+
+//-----------------------------------------------------------------------------
+// Test the rowsLeft, hasMoreRows and skip when the row index is used
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(RowIndexSkip, AsciiReader_Fixture) {
+  
+  // Given
+  std::stringstream in {seven_rows};
+  
+  // When
+  AsciiReader reader {in};
+  reader.useRowIndex(2);
+  
+  // Then
+  BOOST_CHECK_EQUAL(reader.rowsLeft(), 7);
+  reader.skip(3);
+  BOOST_CHECK_EQUAL(reader.rowsLeft(), 4);
+  BOOST_CHECK(reader.hasMoreRows());
+  auto table = reader.read(2);
+  BOOST_CHECK_EQUAL(table.size(), 2);
+  BOOST_CHECK_EQUAL(boost::get<int32_t>(table[0][0]), 3);
+  BOOST_CHECK_EQUAL(boost::get<int32_t>(table[1][0]), 4);
+  BOOST_CHECK_EQUAL(reader.rowsLeft(), 2);
+  reader.skip(1);
+  BOOST_CHECK_EQUAL(boost::get<int32_t>(reader.read(1)[0][0]), 6);
+  BOOST_CHECK(!reader.hasMoreRows());
+  BOOST_CHECK_EQUAL(reader.rowsLeft(), 0);
+  BOOST_CHECK_THROW(reader.read(), Elements::Exception);
+  
+}
+
+//-----------------------------------------------------------------------------
+// Test the random access of the rows
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(RowIndexReadRows, AsciiReader_Fixture) {
+  
+  // Given
+  std::stringstream in {seven_rows};
+  
+  // When
+  AsciiReader reader {in};
+  reader.useRowIndex(3);
+  auto last = reader.readRows(5);
+  auto middle = reader.readRows(1, 2);
+  auto next = reader.read(1);
+  
+  // Then
+  BOOST_CHECK_EQUAL(last.size(), 2);
+  BOOST_CHECK_EQUAL(boost::get<int32_t>(last[0][0]), 5);
+  BOOST_CHECK_EQUAL(boost::get<int32_t>(last[1][0]), 6);
+  BOOST_CHECK_EQUAL(middle.size(), 2);
+  BOOST_CHECK_EQUAL(boost::get<int32_t>(middle[0][0]), 1);
+  BOOST_CHECK_EQUAL(boost::get<int32_t>(middle[1][0]), 2);
+  BOOST_CHECK_EQUAL(boost::get<int32_t>(next[0][0]), 3);
+  BOOST_CHECK_THROW(reader.readRows(7), Elements::Exception);
+  
+}
+
+//-----------------------------------------------------------------------------
+// Test storing and loading the row index
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(RowIndexSaveLoad, AsciiReader_Fixture) {
+  
+  // Given
+  Elements::TempFile index_file;
+  std::stringstream in {seven_rows};
+  std::stringstream in_again {seven_rows};
+  std::stringstream other {all_types};
+  
+  // When
+  AsciiReader reader {in};
+  reader.useRowIndex(2);
+  reader.saveRowIndex(index_file.path().native());
+  AsciiReader reader_again {in_again};
+  reader_again.loadRowIndex(index_file.path().native());
+  AsciiReader other_reader {other};
+  
+  // Then
+  BOOST_CHECK_EQUAL(reader_again.rowsLeft(), 7);
+  BOOST_CHECK_EQUAL(boost::get<int32_t>(reader_again.readRows(4, 1)[0][0]), 4);
+  BOOST_CHECK_THROW(other_reader.loadRowIndex(index_file.path().native()), Elements::Exception);
+  
+}
+
+//-----------------------------------------------------------------------------
+// Test reading only the rows passing a filter
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ReadWithFilter, AsciiReader_Fixture) {
+
+  // Given
+  std::stringstream in {all_types};
+  std::stringstream all_in {all_types};
+  std::stringstream wrong_in {all_types};
+  auto filter = Filter::range("Int1", 8, 22) && Filter::compare("Bool1", Filter::Operator::EQUAL, true);
+
+  // When
+  AsciiReader reader {in};
+  reader.setFilter(filter);
+  auto first = reader.read(1);
+  auto second = reader.read(1);
+  auto all = AsciiReader{all_in}.setFilter(!filter).read();
+
+  // Then
+  BOOST_CHECK_EQUAL(first.size(), 1);
+  BOOST_CHECK_EQUAL(boost::get<int32_t>(first[0][2]), 8);
+  BOOST_CHECK_EQUAL(boost::get<std::string>(first[0][8]), "14");
+  BOOST_CHECK_EQUAL(second.size(), 1);
+  BOOST_CHECK_EQUAL(boost::get<int32_t>(second[0][2]), 15);
+  BOOST_CHECK_THROW(reader.read(), Elements::Exception);
+  BOOST_CHECK_THROW(reader.setFilter(filter), Elements::Exception);
+  BOOST_CHECK_EQUAL(all.size(), 3);
+  BOOST_CHECK_EQUAL(boost::get<int32_t>(all[2][2]), 29);
+  BOOST_CHECK_THROW(AsciiReader{wrong_in}.setFilter(Filter::compare("NdArray", Filter::Operator::LESS, 1)).read(),
+                    Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test hasMoreRows() and skip() refer to the rows passing the filter
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(HasMoreRowsWithFilter, AsciiReader_Fixture) {
+
+  // Given
+  std::stringstream in {all_types};
+  std::stringstream skip_in {all_types};
+  auto filter = Filter::range("Int1", 8, 22) && Filter::compare("Bool1", Filter::Operator::EQUAL, true);
+
+  // When
+  AsciiReader reader {in};
+  reader.setFilter(filter);
+  std::vector<int32_t> values {};
+  while (reader.hasMoreRows()) {
+    values.push_back(boost::get<int32_t>(reader.read(1)[0][2]));
+  }
+  AsciiReader skip_reader {skip_in};
+  skip_reader.setFilter(filter);
+  skip_reader.skip(1);
+  auto after_skip = skip_reader.read();
+
+  // Then
+  std::vector<int32_t> expected {8, 15};
+  BOOST_CHECK_EQUAL_COLLECTIONS(values.begin(), values.end(), expected.begin(), expected.end());
+  BOOST_CHECK_EQUAL(reader.rowsLeft(), 0);
+  BOOST_CHECK_EQUAL(after_skip.size(), 1);
+  BOOST_CHECK_EQUAL(boost::get<int32_t>(after_skip[0][2]), 15);
+  BOOST_CHECK(!skip_reader.hasMoreRows());
+
+}
+
+//-----------------------------------------------------------------------------
+// Test reading typed columns
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ReadColumns, AsciiReader_Fixture) {
+
+  // Given
+  std::stringstream in {all_types};
+  AsciiReader reader {in};
+  std::vector<bool> bools {};
+  std::vector<double> ints {};
+  std::vector<int32_t> bools_as_ints {};
+  std::vector<std::string> strings {};
+  std::vector<double> remaining {};
+
+  // When
+  auto first_rows = reader.readColumns(3);
+  reader.getColumn(0, bools);
+  reader.getColumn(2, ints);
+  reader.getColumn(1, bools_as_ints);
+  reader.getColumn(8, strings);
+  auto last_rows = reader.readColumns(-1);
+  reader.getColumn(7, remaining);
+
+  // Then
+  BOOST_CHECK_EQUAL(first_rows, 3);
+  BOOST_CHECK((bools == std::vector<bool>{true, true, true}));
+  BOOST_CHECK((ints == std::vector<double>{1, 8, 15}));
+  BOOST_CHECK((bools_as_ints == std::vector<int32_t>{1, 1, 0}));
+  BOOST_CHECK((strings == std::vector<std::string>{"7", "14", "21"}));
+  BOOST_CHECK_EQUAL(last_rows, 2);
+  BOOST_CHECK((remaining == std::vector<double>{2.7, 3.4}));
+  BOOST_CHECK_EQUAL(reader.readColumns(-1), 0);
+  BOOST_CHECK(!reader.hasMoreRows());
+  BOOST_CHECK_THROW(reader.getColumn(9, remaining), Elements::Exception);
+  BOOST_CHECK_THROW(reader.getColumn(8, remaining), Elements::Exception);
+  BOOST_CHECK_THROW(reader.getColumn(2, strings), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the null tokens and NaN values are marked as missing
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(NullTokens, AsciiReader_Fixture) {
+
+  // Given
+  std::string nulls {
+    "# Id  Flux  Name\n"
+    "  1   1.5   first\n"
+    "  NA  nan   second\n"
+    "  3   -     NA\n"
+  };
+  std::stringstream in {nulls};
+  std::stringstream wrong_in {nulls};
+  AsciiReader reader {in};
+
+  // When
+  reader.setNullTokens({"NA", "-"}).inferColumnTypes(10);
+  auto table = reader.read();
+
+  // Then
+  BOOST_CHECK(reader.getInfo().getDescription(0).type == typeid(int32_t));
+  BOOST_CHECK(reader.getInfo().getDescription(1).type == typeid(float));
+  BOOST_CHECK(table.getValidity("Id").isValid(0));
+  BOOST_CHECK(!table.getValidity("Id").isValid(1));
+  BOOST_CHECK_EQUAL(boost::get<int32_t>(table[1][0]), 0);
+  BOOST_CHECK_EQUAL(table.getValidity("Flux").countValid(), 1);
+  BOOST_CHECK(!table.getValidity("Name").isValid(2));
+  BOOST_CHECK_EQUAL(boost::get<std::string>(table[2][2]), "NA");
+  BOOST_CHECK_THROW(AsciiReader{wrong_in}.setNullTokens({"N A"}), Elements::Exception);
+  BOOST_CHECK_THROW(reader.setNullTokens({"NA"}), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the missing values do not pass the filter pushed in the reader
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(FilterMissingValues, AsciiReader_Fixture) {
+
+  // Given
+  std::string nulls {
+    "# Column: Id long\n"
+    "# Column: Flux long\n"
+    "  1     -99\n"
+    "  2     -5\n"
+    "  3     7\n"
+  };
+  std::stringstream in {nulls};
+  AsciiReader reader {in};
+
+  // When
+  reader.setNullTokens({"-99"}).setFilter(Filter::compare("Flux", Filter::Operator::LESS_EQUAL, 0));
+  auto table = reader.read();
+
+  // Then
+  BOOST_CHECK_EQUAL(table.size(), 1);
+  BOOST_CHECK_EQUAL(boost::get<int64_t>(table[0][0]), 2);
+
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END ()
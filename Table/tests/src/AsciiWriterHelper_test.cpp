@@ -22,6 +22,8 @@
  * @author Nikolaos Apostolakos
  */
 
+#include <limits>
+#include <boost/lexical_cast.hpp>
 #include <boost/test/unit_test.hpp>
 #include "ElementsKernel/Exception.h"
 #include "Table/ColumnInfo.h"
@@ -106,6 +108,65 @@ BOOST_FIXTURE_TEST_CASE(calculateColumnLengths, AsciiWriterHelper_Fixture) {
   
 }
 
+//-----------------------------------------------------------------------------
+// Test the calculateColumnLengths uses the declared widths of the columns
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(calculateColumnLengthsDeclared, AsciiWriterHelper_Fixture) {
+
+  // Given
+  info_list[1].width = 30;
+  info_list[2].width = 3;
+  info_list[3].width = 12;
+  auto declared_info = std::make_shared<Euclid::Table::ColumnInfo>(info_list);
+  std::vector<Euclid::Table::Row> declared_rows {};
+  for (auto& row : row_list) {
+    std::vector<Euclid::Table::Row::cell_type> values {row.begin(), row.end()};
+    declared_rows.emplace_back(values, declared_info);
+  }
+  Euclid::Table::Table declared_table {declared_rows};
+
+  // When
+  auto sizes = Euclid::Table::calculateColumnLengths(declared_table);
+
+  // Then
+  BOOST_CHECK_EQUAL(sizes[0], 8);
+  BOOST_CHECK_EQUAL(sizes[1], 31);
+  BOOST_CHECK_EQUAL(sizes[2], 8);
+  BOOST_CHECK_EQUAL(sizes[3], 13);
+  BOOST_CHECK_EQUAL(sizes[4], 2);
+  BOOST_CHECK_EQUAL(sizes[5], 16);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the formatCell gives the same representation as boost::lexical_cast
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(formatCell) {
+  
+  // Given
+  std::vector<Euclid::Table::Row::cell_type> cells {
+    true, false, 0, -17, std::numeric_limits<int32_t>::min(),
+    std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(),
+    0.f, -1.5f, 3.14159265f, 1e-30f, 0., 0.1, 123456789.123, -42e-16, 1e300,
+    std::numeric_limits<double>::infinity(), std::string{"Text"},
+    std::vector<bool>{true, false}, std::vector<int64_t>{-1, 2},
+    std::vector<float>{0.25f, 1e10f}
+  };
+  
+  for (auto& cell : cells) {
+    
+    // When
+    std::string buffer {"prefix"};
+    Euclid::Table::formatCell(cell, buffer);
+    
+    // Then
+    BOOST_CHECK_EQUAL(buffer, "prefix" + boost::lexical_cast<std::string>(cell));
+  }
+  
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END ()
\ No newline at end of file
@@ -231,6 +231,62 @@ BOOST_FIXTURE_TEST_CASE(addDataComments, AsciiWriter_Fixture) {
   
 }
 
+//-----------------------------------------------------------------------------
+// Test the addData method with fixed column widths
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(addDataColumnWidths, AsciiWriter_Fixture) {
+  
+  // Given
+  std::stringstream stream {};
+  AsciiWriter writer {stream};
+  
+  // When
+  writer.showColumnInfo(false);
+  writer.setColumnWidths({3, 6, 11, 8, 2, 8, 13});
+  writer.addData(table);
+  
+  // Then
+  BOOST_CHECK_EQUAL(stream.str(),
+    "# Boolean ThisIsAVeryLongColumnName    Integer       D F DoubleVector      NdArray\n"
+    "\n"
+    "   1 Two-1          1     4.1 0 1.1,1.2 <2,2>1,2,3,4\n"
+    "   0 Two-2 1234567890 4.2e-15 0 2.1,2.2 <2,2>9,8,7,6\n"
+    "   1 Two-3        234     4.3 0 3.1,3.2,3.3,3.4 <2,2>1,3,5,7\n"
+  );
+  BOOST_CHECK_THROW(writer.setColumnWidths({}), Elements::Exception);
+  BOOST_CHECK_THROW(AsciiWriter{stream}.setColumnWidths({1, 0}), Elements::Exception);
+  BOOST_CHECK_THROW(AsciiWriter{stream}.setColumnWidths({1, 2}).addData(table), Elements::Exception);
+  
+}
+
+//-----------------------------------------------------------------------------
+// Test the addData method with a column separator
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(addDataColumnSeparator, AsciiWriter_Fixture) {
+  
+  // Given
+  std::stringstream stream {};
+  AsciiWriter writer {stream};
+  
+  // When
+  writer.showColumnInfo(false);
+  writer.setColumnSeparator("\t");
+  writer.addData(table);
+  
+  // Then
+  BOOST_CHECK_EQUAL(stream.str(),
+    "# Boolean\tThisIsAVeryLongColumnName\tInteger\tD\tF\tDoubleVector\tNdArray\n"
+    "\n"
+    "1\tTwo-1\t1\t4.1\t0\t1.1,1.2\t<2,2>1,2,3,4\n"
+    "0\tTwo-2\t1234567890\t4.2e-15\t0\t2.1,2.2\t<2,2>9,8,7,6\n"
+    "1\tTwo-3\t234\t4.3\t0\t3.1,3.2,3.3,3.4\t<2,2>1,3,5,7\n"
+  );
+  BOOST_CHECK_THROW(writer.setColumnSeparator(" "), Elements::Exception);
+  
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file tests/src/BinaryColumnarWriter_test.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "ElementsKernel/Exception.h"
+#include "ElementsKernel/Temporary.h"
+#include "Table/BinaryColumnarReader.h"
+#include "Table/BinaryColumnarWriter.h"
+
+using namespace Euclid::Table;
+
+struct BinaryColumnarWriter_Fixture {
+  Elements::TempDir temp_dir;
+  std::string filename = (temp_dir.path() / "table.bin").native();
+  std::shared_ptr<ColumnInfo> column_info {new ColumnInfo {{
+    ColumnInfo::info_type("Id", typeid(int64_t)),
+    ColumnInfo::info_type("Name", typeid(std::string))
+  }}};
+  Table table {{
+    Row{{int64_t{1}, std::string{"First"}}, column_info},
+    Row{{int64_t{2}, std::string{"Second"}}, column_info}
+  }};
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (BinaryColumnarWriter_test)
+
+//-----------------------------------------------------------------------------
+// Test the data are readable after each addData() call
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(AddData, BinaryColumnarWriter_Fixture) {
+
+  // Given
+  BinaryColumnarWriter writer {filename, true};
+
+  // When
+  writer.addData(table);
+  writer.close();
+
+  // Then
+  BOOST_CHECK_EQUAL(BinaryColumnarReader{filename}.rowsLeft(), 2);
+
+  // When
+  writer.addData(table);
+  writer.addComment("Added later");
+  writer.close();
+
+  // Then
+  BinaryColumnarReader reader {filename};
+  BOOST_CHECK_EQUAL(reader.rowsLeft(), 4);
+  BOOST_CHECK_EQUAL(reader.getComment(), "Added later");
+
+}
+
+//-----------------------------------------------------------------------------
+// Test appending to and overriding an existing file
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ExistingFile, BinaryColumnarWriter_Fixture) {
+
+  // Given
+  {
+    BinaryColumnarWriter writer {filename, true};
+    writer.addComment("First");
+    writer.addData(table);
+  }
+
+  // When
+  {
+    BinaryColumnarWriter writer {filename};
+    writer.addComment("Second");
+    writer.addData(table);
+  }
+  BinaryColumnarReader appended {filename};
+
+  // Then
+  BOOST_CHECK_EQUAL(appended.rowsLeft(), 4);
+  BOOST_CHECK_EQUAL(appended.getComment(), "First\nSecond");
+  auto result = appended.read();
+  BOOST_CHECK(result[3][1] == table[1][1]);
+
+  // When
+  {
+    BinaryColumnarWriter writer {filename, true};
+    writer.addData(table);
+  }
+
+  // Then
+  BOOST_CHECK_EQUAL(BinaryColumnarReader{filename}.rowsLeft(), 2);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test appending a table with different columns to an existing file fails
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ExistingFileDifferentColumns, BinaryColumnarWriter_Fixture) {
+
+  // Given
+  {
+    BinaryColumnarWriter writer {filename, true};
+    writer.addData(table);
+  }
+  std::shared_ptr<ColumnInfo> other_info {new ColumnInfo {{
+    ColumnInfo::info_type("Id", typeid(int32_t))
+  }}};
+  Table other {{Row{{int32_t{1}}, other_info}}};
+
+  // When
+  BinaryColumnarWriter writer {filename};
+
+  // Then
+  BOOST_CHECK_THROW(writer.addData(other), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test an existing file keeps its table while rows are appended
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ExistingFileBeforeClose, BinaryColumnarWriter_Fixture) {
+
+  // Given
+  {
+    BinaryColumnarWriter writer {filename, true};
+    writer.addData(table);
+  }
+  BinaryColumnarWriter writer {filename};
+
+  // When
+  writer.addData(table);
+
+  // Then
+  BinaryColumnarReader before_close {filename};
+  BOOST_CHECK_EQUAL(before_close.rowsLeft(), 2);
+  BOOST_CHECK(before_close.read()[1][1] == table[1][1]);
+
+  // When
+  writer.close();
+  writer.addData(table);
+
+  // Then
+  BOOST_CHECK_EQUAL(BinaryColumnarReader{filename}.rowsLeft(), 4);
+
+  // When
+  writer.close();
+
+  // Then
+  BinaryColumnarReader after_close {filename};
+  BOOST_CHECK_EQUAL(after_close.rowsLeft(), 6);
+  auto result = after_close.read();
+  BOOST_CHECK(result[5][1] == table[1][1]);
+  BOOST_CHECK(result[2][0] == table[0][0]);
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -69,6 +69,8 @@ BOOST_AUTO_TEST_CASE(DefaultValues) {
   BOOST_CHECK_EQUAL(result.type.name(), typeid(std::string).name());
   BOOST_CHECK_EQUAL(result.unit, "");
   BOOST_CHECK_EQUAL(result.description, "");
+  BOOST_CHECK_EQUAL(result.width, 0);
+  BOOST_CHECK(result.shape.empty());
 
 }
 
@@ -104,6 +106,45 @@ BOOST_AUTO_TEST_CASE(NameWithWhitespaces) {
   
 }
 
+//-----------------------------------------------------------------------------
+// Test the dictionary encoded columns must have int32_t codes and they are
+// compared by their dictionary values
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(Dictionary) {
+
+  // Given
+  auto dictionary = std::make_shared<StringDictionary>(std::vector<std::string>{"VIS", "Y"});
+  auto same = std::make_shared<StringDictionary>(std::vector<std::string>{"VIS", "Y"});
+  auto other = std::make_shared<StringDictionary>(std::vector<std::string>{"Y", "VIS"});
+
+  // Then
+  BOOST_CHECK_THROW(ColumnDescription("Band", typeid(std::string), "", "", dictionary), Elements::Exception);
+  BOOST_CHECK(ColumnDescription("Band", typeid(int32_t), "", "", dictionary)
+              == ColumnDescription("Band", typeid(int32_t), "", "", same));
+  BOOST_CHECK(ColumnDescription("Band", typeid(int32_t), "", "", dictionary)
+              != ColumnDescription("Band", typeid(int32_t), "", "", other));
+  BOOST_CHECK(ColumnDescription("Band", typeid(int32_t), "", "", dictionary)
+              != ColumnDescription("Band", typeid(int32_t)));
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the declared schema is ignored by the comparison
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(DeclaredSchema) {
+
+  // Given
+  ColumnDescription declared {"Flux", typeid(std::vector<double>)};
+  declared.width = 10;
+  declared.shape = {3};
+
+  // Then
+  BOOST_CHECK(declared == ColumnDescription("Flux", typeid(std::vector<double>)));
+
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END ()
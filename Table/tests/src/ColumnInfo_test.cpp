@@ -252,6 +252,42 @@ BOOST_AUTO_TEST_CASE(find) {
   
 }
 
+//-----------------------------------------------------------------------------
+// Test the findIndex and getHandle methods
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(findIndexAndHandle) {
+  
+  // Given
+  std::vector<Euclid::Table::ColumnInfo::info_type> info_list {};
+  info_list.push_back(Euclid::Table::ColumnInfo::info_type("First", typeid(std::string)));
+  info_list.push_back(Euclid::Table::ColumnInfo::info_type("Second", typeid(double)));
+  info_list.push_back(Euclid::Table::ColumnInfo::info_type("Third", typeid(int)));
+  Euclid::Table::ColumnInfo columnInfo {info_list};
+  Euclid::Table::ColumnInfo reordered {{info_list[2], info_list[0], info_list[1]}};
+  Euclid::Table::ColumnInfo same {info_list};
+  auto copy = columnInfo;
+  
+  // When
+  auto index = columnInfo.findIndex("Third");
+  auto missing = columnInfo.findIndex("NotThere");
+  auto handle = columnInfo.getHandle("Third");
+  
+  // Then
+  BOOST_CHECK(index);
+  BOOST_CHECK_EQUAL(*index, 2u);
+  BOOST_CHECK(!missing);
+  BOOST_CHECK_EQUAL(handle.index(), 2u);
+  BOOST_CHECK_EQUAL(handle.name(), "Third");
+  BOOST_CHECK_EQUAL(*columnInfo.findIndex(handle), 2u);
+  BOOST_CHECK_EQUAL(*reordered.findIndex(handle), 0u);
+  BOOST_CHECK_EQUAL(*same.findIndex(handle), 2u);
+  BOOST_CHECK_EQUAL(*copy.findIndex(handle), 2u);
+  BOOST_CHECK_EQUAL(*columnInfo.findIndex(reordered.getHandle("Second")), 1u);
+  BOOST_CHECK_THROW(columnInfo.getHandle("NotThere"), Elements::Exception);
+  
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END ()
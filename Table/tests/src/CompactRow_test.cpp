@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file tests/src/CompactRow_test.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "ElementsKernel/Exception.h"
+#include "Table/CompactRow.h"
+
+using namespace Euclid::Table;
+
+struct CompactRow_Fixture {
+  std::shared_ptr<ColumnInfo> column_info {new ColumnInfo {{
+    ColumnInfo::info_type("Bool", typeid(bool)),
+    ColumnInfo::info_type("Int", typeid(int32_t)),
+    ColumnInfo::info_type("String", typeid(std::string)),
+    ColumnInfo::info_type("Long", typeid(int64_t)),
+    ColumnInfo::info_type("Float", typeid(float)),
+    ColumnInfo::info_type("Vector", typeid(std::vector<double>)),
+    ColumnInfo::info_type("Double", typeid(double))
+  }}};
+  std::vector<Row::cell_type> values {true, int32_t{-3}, std::string{"text"}, int64_t{1234567890123},
+                                      1.5f, std::vector<double>{1.1, 2.2}, 2.5};
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (CompactRow_test)
+
+//-----------------------------------------------------------------------------
+// Test the layout of the cells computed by the ColumnInfo
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(CellLayout, CompactRow_Fixture) {
+
+  // Then
+  BOOST_CHECK_EQUAL(column_info->getInlineSize(), 8 + 8 + 4 + 4 + 1);
+  BOOST_CHECK_EQUAL(column_info->getOutOfLineSize(), 2);
+  BOOST_CHECK(column_info->getCellLayout(3).is_inline);
+  BOOST_CHECK_EQUAL(column_info->getCellLayout(3).position, 0);
+  BOOST_CHECK_EQUAL(column_info->getCellLayout(6).position, 8);
+  BOOST_CHECK_EQUAL(column_info->getCellLayout(1).position, 16);
+  BOOST_CHECK_EQUAL(column_info->getCellLayout(4).position, 20);
+  BOOST_CHECK_EQUAL(column_info->getCellLayout(0).position, 24);
+  BOOST_CHECK(!column_info->getCellLayout(2).is_inline);
+  BOOST_CHECK_EQUAL(column_info->getCellLayout(2).position, 0);
+  BOOST_CHECK_EQUAL(column_info->getCellLayout(5).position, 1);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the access to the cells
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(Access, CompactRow_Fixture) {
+
+  // Given
+  Row row {values, column_info};
+
+  // When
+  CompactRow compact {row};
+
+  // Then
+  BOOST_CHECK_EQUAL(compact.size(), values.size());
+  BOOST_CHECK_EQUAL(compact.get<bool>(0), true);
+  BOOST_CHECK_EQUAL(compact.get<int32_t>(1), -3);
+  BOOST_CHECK_EQUAL(compact.get<std::string>(2), "text");
+  BOOST_CHECK_EQUAL(compact.get<int64_t>(3), 1234567890123);
+  BOOST_CHECK_EQUAL(compact.get<float>(4), 1.5f);
+  BOOST_CHECK_EQUAL(compact.get<std::vector<double>>(5).size(), 2);
+  BOOST_CHECK_EQUAL(compact.get<double>(6), 2.5);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    BOOST_CHECK(compact[i] == values[i]);
+  }
+  BOOST_CHECK_THROW(compact.get<double>(0), Elements::Exception);
+  BOOST_CHECK_THROW(compact.get<double>(7), Elements::Exception);
+  BOOST_CHECK_THROW(compact[7], Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test copying and converting back to a Row
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(CopyAndConvert, CompactRow_Fixture) {
+
+  // Given
+  CompactRow compact {values, *column_info};
+  std::shared_ptr<ColumnInfo> other_info {new ColumnInfo {*column_info}};
+
+  // When
+  CompactRow copy {compact};
+  compact = CompactRow {std::vector<Row::cell_type>{false, int32_t{1}, std::string{"other"}, int64_t{2},
+                                                    3.f, std::vector<double>{}, 4.}, *column_info};
+  auto row = copy.toRow(other_info);
+
+  // Then
+  BOOST_CHECK_EQUAL(compact.get<int64_t>(3), 2);
+  BOOST_CHECK_EQUAL(copy.get<int64_t>(3), 1234567890123);
+  BOOST_CHECK(row.getColumnInfo() == other_info);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    BOOST_CHECK(row[i] == values[i]);
+  }
+  BOOST_CHECK_THROW(CompactRow(std::vector<Row::cell_type>{true}, *column_info), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test a moved from row can be copied and assigned
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(CopyMovedFrom, CompactRow_Fixture) {
+
+  // Given
+  CompactRow row {values, *column_info};
+  CompactRow moved {std::move(row)};
+
+  // When
+  CompactRow copy {row};
+  copy = moved;
+
+  // Then
+  BOOST_CHECK_EQUAL(copy.get<int64_t>(3), 1234567890123);
+  BOOST_CHECK_EQUAL(boost::get<std::string>(copy[2]), "text");
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
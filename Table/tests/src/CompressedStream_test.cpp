@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file tests/src/CompressedStream_test.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <fstream>
+#include <sstream>
+#include <boost/test/unit_test.hpp>
+#include "ElementsKernel/Exception.h"
+#include "ElementsKernel/Temporary.h"
+#include "Table/CompressedStream.h"
+#include "Table/AsciiReader.h"
+#include "Table/AsciiWriter.h"
+
+using namespace Euclid::Table;
+
+struct CompressedStream_Fixture {
+  Elements::TempDir temp_dir;
+  std::string content;
+  CompressedStream_Fixture() {
+    // Big enough to need more than one decompressed chunk
+    std::stringstream stream;
+    for (int i = 0; i < 300000; ++i) {
+      stream << "line " << i << '\n';
+    }
+    content = stream.str();
+  }
+  std::string write(const std::string& name, Compression compression) {
+    auto filename = (temp_dir.path() / name).native();
+    CompressedOStream out {filename, compression};
+    out << content;
+    return filename;
+  }
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (CompressedStream_test)
+
+//-----------------------------------------------------------------------------
+// Test the compression detection from the magic bytes and the extension
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(DetectCompression, CompressedStream_Fixture) {
+
+  // When
+  auto none = write("plain", Compression::NONE);
+  auto gzip = write("data.gz", Compression::GZIP);
+  auto bzip2 = write("data.bz2", Compression::BZIP2);
+  auto zstd = write("data.zst", Compression::ZSTD);
+
+  // Then
+  BOOST_CHECK(detectCompression(none) == Compression::NONE);
+  BOOST_CHECK(detectCompression(gzip) == Compression::GZIP);
+  BOOST_CHECK(detectCompression(bzip2) == Compression::BZIP2);
+  BOOST_CHECK(detectCompression(zstd) == Compression::ZSTD);
+  BOOST_CHECK(compressionFromExtension("table.txt") == Compression::NONE);
+  BOOST_CHECK(compressionFromExtension("table.txt.gz") == Compression::GZIP);
+  BOOST_CHECK(compressionFromExtension("table.txt.bz2") == Compression::BZIP2);
+  BOOST_CHECK(compressionFromExtension("table.txt.zst") == Compression::ZSTD);
+  BOOST_CHECK_THROW(detectCompression((temp_dir.path() / "missing").native()), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test reading back the compressed data, with and without helper thread
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(RoundTrip, CompressedStream_Fixture) {
+
+  for (auto compression : {Compression::NONE, Compression::GZIP, Compression::BZIP2, Compression::ZSTD}) {
+    for (bool threaded : {false, true}) {
+
+      // Given
+      auto filename = write("data", compression);
+
+      // When
+      CompressedIStream in {filename, threaded};
+      std::stringstream result;
+      result << in.rdbuf();
+
+      // Then
+      BOOST_CHECK(result.str() == content);
+    }
+  }
+
+}
+
+//-----------------------------------------------------------------------------
+// Test seeking in the decompressed data
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(Seek, CompressedStream_Fixture) {
+
+  for (bool threaded : {false, true}) {
+
+    // Given
+    auto filename = write("data.gz", Compression::GZIP);
+    CompressedIStream in {filename, threaded};
+    std::string line;
+    auto far_position = content.find("line 250000\n");
+    auto near_position = content.find("line 249999\n");
+
+    // When
+    in.seekg(far_position);
+    std::getline(in, line);
+
+    // Then
+    BOOST_CHECK_EQUAL(line, "line 250000");
+    BOOST_CHECK_EQUAL(in.tellg(), far_position + line.size() + 1);
+
+    // When
+    in.seekg(near_position);
+    std::getline(in, line);
+
+    // Then
+    BOOST_CHECK_EQUAL(line, "line 249999");
+
+    // When
+    in.seekg(5);
+    std::getline(in, line);
+
+    // Then
+    BOOST_CHECK_EQUAL(line, "0");
+
+    // When
+    in.seekg(0, std::ios::end);
+
+    // Then
+    BOOST_CHECK_EQUAL(in.tellg(), content.size());
+    BOOST_CHECK(!std::getline(in, line));
+  }
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the AsciiWriter and AsciiReader handle compressed files transparently
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(AsciiTableRoundTrip, CompressedStream_Fixture) {
+
+  // Given
+  auto filename = (temp_dir.path() / "table.txt.gz").native();
+  std::shared_ptr<ColumnInfo> column_info {new ColumnInfo {{
+    ColumnInfo::info_type("Id", typeid(int64_t)),
+    ColumnInfo::info_type("Value", typeid(double))
+  }}};
+  std::vector<Row> rows {};
+  for (int64_t i = 0; i < 1000; ++i) {
+    rows.emplace_back(std::vector<Row::cell_type>{i, 0.5 * i}, column_info);
+  }
+
+  // When
+  {
+    AsciiWriter writer {filename};
+    writer.addData(Table{rows});
+  }
+  AsciiReader reader {filename};
+  auto table = reader.read();
+
+  // Then
+  BOOST_CHECK(detectCompression(filename) == Compression::GZIP);
+  BOOST_CHECK(*table.getColumnInfo() == *column_info);
+  BOOST_CHECK_EQUAL(table.size(), 1000);
+  BOOST_CHECK_EQUAL(boost::get<int64_t>(table[999][0]), 999);
+  BOOST_CHECK_EQUAL(boost::get<double>(table[999][1]), 499.5);
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
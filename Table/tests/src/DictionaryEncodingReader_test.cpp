@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file tests/src/DictionaryEncodingReader_test.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "ElementsKernel/Exception.h"
+#include "AlexandriaKernel/memory_tools.h"
+#include "Table/DictionaryEncodingReader.h"
+
+using namespace Euclid::Table;
+using Euclid::make_unique;
+
+// A reader returning the rows of a vector
+class VectorReader : public TableReader {
+public:
+  VectorReader(std::vector<Row> rows) : m_rows(std::move(rows)) {
+  }
+  std::string getComment() override {
+    return "Vector";
+  }
+  const ColumnInfo& getInfo() override {
+    return *m_rows.front().getColumnInfo();
+  }
+  void skip(long rows) override {
+    m_current = std::min(m_rows.size(), m_current + rows);
+  }
+  bool hasMoreRows() override {
+    return m_current < m_rows.size();
+  }
+  std::size_t rowsLeft() override {
+    return m_rows.size() - m_current;
+  }
+protected:
+  Table readImpl(long rows) override {
+    if (m_current >= m_rows.size()) {
+      throw Elements::Exception() << "No more table rows left";
+    }
+    std::size_t last = rows < 0 ? m_rows.size() : std::min(m_rows.size(), m_current + rows);
+    std::vector<Row> result (m_rows.begin() + m_current, m_rows.begin() + last);
+    m_current = last;
+    return Table{std::move(result)};
+  }
+private:
+  std::vector<Row> m_rows;
+  std::size_t m_current = 0;
+};
+
+struct DictionaryEncodingReader_Fixture {
+
+  std::shared_ptr<ColumnInfo> column_info {new ColumnInfo {{
+    ColumnDescription {"Band", typeid(std::string)},
+    ColumnDescription {"Name", typeid(std::string)}
+  }}};
+
+  std::vector<std::string> bands {"Y", "Y", "Y", "VIS", "VIS", "J", "J", "H"};
+
+  std::unique_ptr<TableReader> vectorReader() {
+    std::vector<Row> rows {};
+    for (std::size_t i = 0; i < bands.size(); ++i) {
+      rows.emplace_back(std::vector<Row::cell_type>{bands[i], "Source" + std::to_string(i)}, column_info);
+    }
+    return make_unique<VectorReader>(std::move(rows));
+  }
+
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (DictionaryEncodingReader_test)
+
+//-----------------------------------------------------------------------------
+// Test the constructor throws without a reader
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(ConstructorInvalid) {
+
+  // Then
+  BOOST_CHECK_THROW(DictionaryEncodingReader(nullptr, 10), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the columns selected by the first read keep their codes in the
+// following reads
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ReadInChunks, DictionaryEncodingReader_Fixture) {
+
+  // Given
+  DictionaryEncodingReader reader {vectorReader(), 1};
+
+  // When
+  auto first = reader.read(2);
+  auto second = reader.read(3);
+  auto third = reader.read();
+
+  // Then
+  BOOST_CHECK(reader.getInfo() == *column_info);
+  BOOST_CHECK(!reader.hasMoreRows());
+  auto& first_info = *first.getColumnInfo();
+  BOOST_REQUIRE(first_info.getDescription(0).dictionary != nullptr);
+  BOOST_CHECK(first_info.getDescription(1).dictionary == nullptr);
+  BOOST_CHECK(first_info.getDescription(1).type == typeid(std::string));
+  BOOST_CHECK((first.column<int32_t>("Band") == std::vector<int32_t>{0, 0}));
+  BOOST_CHECK((second.column<int32_t>("Band") == std::vector<int32_t>{0, 1, 1}));
+  BOOST_CHECK((third.column<int32_t>("Band") == std::vector<int32_t>{2, 2, 3}));
+  BOOST_CHECK((third.getColumnInfo()->getDescription(0).dictionary->getValues()
+               == std::vector<std::string>{"Y", "VIS", "J", "H"}));
+  BOOST_CHECK((third.column<std::string>("Band") == std::vector<std::string>{"J", "J", "H"}));
+
+}
+
+//-----------------------------------------------------------------------------
+// Test consecutive reads without new values share their column info
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(SharedColumnInfo, DictionaryEncodingReader_Fixture) {
+
+  // Given
+  DictionaryEncodingReader reader {vectorReader(), 1};
+
+  // When
+  auto first = reader.read(2);
+  auto second = reader.read(1);
+  auto third = reader.read(1);
+
+  // Then
+  BOOST_CHECK(first.getColumnInfo() == second.getColumnInfo());
+  BOOST_CHECK(second.getColumnInfo() != third.getColumnInfo());
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
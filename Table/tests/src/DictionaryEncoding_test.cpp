@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file tests/src/DictionaryEncoding_test.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "ElementsKernel/Exception.h"
+#include "Table/DictionaryEncoding.h"
+
+using namespace Euclid::Table;
+
+struct DictionaryEncoding_Fixture {
+
+  std::shared_ptr<ColumnInfo> column_info {new ColumnInfo {{
+    ColumnDescription {"Id", typeid(int32_t)},
+    ColumnDescription {"Band", typeid(std::string), "", "The filter"},
+    ColumnDescription {"Name", typeid(std::string)}
+  }}};
+
+  Table table {{
+    Row {{0, std::string{"Y"}, std::string{"a"}}, column_info},
+    Row {{1, std::string{"VIS"}, std::string{"b"}}, column_info},
+    Row {{2, std::string{"Y"}, std::string{"c"}}, column_info},
+    Row {{3, std::string{"J"}, std::string{"d"}}, column_info}
+  }};
+
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (DictionaryEncoding_test)
+
+//-----------------------------------------------------------------------------
+// Test only the string columns with low cardinality are encoded
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(Encode, DictionaryEncoding_Fixture) {
+
+  // When
+  auto encoded = encodeDictionaryColumns(table, 3);
+
+  // Then
+  auto& info = *encoded.getColumnInfo();
+  BOOST_CHECK(hasDictionaryColumns(info));
+  BOOST_CHECK(info.getDescription(0) == column_info->getDescription(0));
+  BOOST_CHECK(info.getDescription(1).type == typeid(int32_t));
+  BOOST_CHECK_EQUAL(info.getDescription(1).description, "The filter");
+  BOOST_REQUIRE(info.getDescription(1).dictionary != nullptr);
+  BOOST_CHECK((info.getDescription(1).dictionary->getValues() == std::vector<std::string>{"Y", "VIS", "J"}));
+  BOOST_CHECK((encoded.column<int32_t>("Band") == std::vector<int32_t>{0, 1, 0, 2}));
+  BOOST_CHECK(info.getDescription(2) == column_info->getDescription(2));
+  BOOST_CHECK((encoded.column<std::string>("Name") == std::vector<std::string>{"a", "b", "c", "d"}));
+
+}
+
+//-----------------------------------------------------------------------------
+// Test decoding restores the original table
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(Decode, DictionaryEncoding_Fixture) {
+
+  // Given
+  auto encoded = encodeDictionaryColumns(table, 10);
+
+  // When
+  auto decoded = decodeDictionaryColumns(encoded);
+
+  // Then
+  BOOST_CHECK(!hasDictionaryColumns(*decoded.getColumnInfo()));
+  BOOST_CHECK(*decoded.getColumnInfo() == *column_info);
+  for (std::size_t i = 0; i < table.size(); ++i) {
+    for (std::size_t j = 0; j < column_info->size(); ++j) {
+      BOOST_CHECK(decoded[i][j] == table[i][j]);
+    }
+  }
+
+}
+
+//-----------------------------------------------------------------------------
+// Test decoding fails for codes missing from the dictionary
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(DecodeInvalidCode) {
+
+  // Given
+  auto dictionary = std::make_shared<StringDictionary>(std::vector<std::string>{"VIS"});
+  std::shared_ptr<ColumnInfo> column_info {new ColumnInfo {{
+    ColumnDescription {"Band", typeid(int32_t), "", "", dictionary}
+  }}};
+  Table table {{Row {{int32_t{1}}, column_info}}};
+
+  // Then
+  BOOST_CHECK_THROW(decodeDictionaryColumns(table), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
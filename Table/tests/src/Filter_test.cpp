@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file tests/src/Filter_test.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <limits>
+#include <boost/test/unit_test.hpp>
+#include "ElementsKernel/Exception.h"
+#include "Table/Filter.h"
+
+using namespace Euclid::Table;
+
+typedef Filter::Operator Op;
+
+struct Filter_Fixture {
+  std::map<std::string, Filter::column_values> columns {
+    {"Int", std::vector<int32_t>{1, 5, 3, -2, 8}},
+    {"Long", std::vector<int64_t>{9007199254740993, 1, 2, 3, 9007199254740992}},
+    {"Float", std::vector<float>{0.5f, 1.5f, 2.5f, std::numeric_limits<float>::quiet_NaN(), 4.5f}},
+    {"Double", std::vector<double>{0.1, 0.2, 0.3, 0.4, 0.5}},
+    {"String", std::vector<std::string>{"a", "b", "c", "b", "e"}}
+  };
+  Filter::mask_type mask(std::initializer_list<int> values) {
+    return Filter::mask_type(values.begin(), values.end());
+  }
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (Filter_test)
+
+//-----------------------------------------------------------------------------
+// Test all the comparison operators
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(Comparisons, Filter_Fixture) {
+
+  // When
+  auto less = Filter::compare("Int", Op::LESS, 3).evaluate(columns, 5);
+  auto less_equal = Filter::compare("Int", Op::LESS_EQUAL, 3).evaluate(columns, 5);
+  auto greater = Filter::compare("Double", Op::GREATER, 0.3).evaluate(columns, 5);
+  auto greater_equal = Filter::compare("Float", Op::GREATER_EQUAL, 2.5).evaluate(columns, 5);
+  auto equal = Filter::compare("String", Op::EQUAL, "b").evaluate(columns, 5);
+  auto not_equal = Filter::compare("Float", Op::NOT_EQUAL, 1.5f).evaluate(columns, 5);
+
+  // Then
+  BOOST_CHECK(less == mask({1, 0, 0, 1, 0}));
+  BOOST_CHECK(less_equal == mask({1, 0, 1, 1, 0}));
+  BOOST_CHECK(greater == mask({0, 0, 0, 1, 1}));
+  BOOST_CHECK(greater_equal == mask({0, 0, 1, 0, 1}));
+  BOOST_CHECK(equal == mask({0, 1, 0, 1, 0}));
+  BOOST_CHECK(not_equal == mask({1, 0, 1, 1, 1}));
+
+}
+
+//-----------------------------------------------------------------------------
+// Test integer columns are compared exactly with integer values
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(IntegerPrecision, Filter_Fixture) {
+
+  // When
+  auto result = Filter::compare("Long", Op::EQUAL, int64_t{9007199254740993}).evaluate(columns, 5);
+
+  // Then
+  BOOST_CHECK(result == mask({1, 0, 0, 0, 0}));
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the ranges and the logical operators
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(RangesAndLogical, Filter_Fixture) {
+
+  // Given
+  auto range = Filter::range("Int", 1, 5);
+  auto small = Filter::compare("Double", Op::LESS, 0.25);
+
+  // When
+  auto range_result = range.evaluate(columns, 5);
+  auto and_result = (range && small).evaluate(columns, 5);
+  auto or_result = (range || small).evaluate(columns, 5);
+  auto not_result = (!range).evaluate(columns, 5);
+
+  // Then
+  BOOST_CHECK(range_result == mask({1, 1, 1, 0, 0}));
+  BOOST_CHECK(and_result == mask({1, 1, 0, 0, 0}));
+  BOOST_CHECK(or_result == mask({1, 1, 1, 0, 0}));
+  BOOST_CHECK(not_result == mask({0, 0, 0, 1, 1}));
+  BOOST_CHECK((range && small).getColumns() == std::vector<std::string>({"Double", "Int"}));
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the errors of the evaluation
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(EvaluationErrors, Filter_Fixture) {
+
+  // Then
+  BOOST_CHECK_THROW(Filter::compare("Missing", Op::LESS, 1).evaluate(columns, 5), Elements::Exception);
+  BOOST_CHECK_THROW(Filter::compare("Int", Op::LESS, 1).evaluate(columns, 4), Elements::Exception);
+  BOOST_CHECK_THROW(Filter::compare("Int", Op::LESS, "1").evaluate(columns, 5), Elements::Exception);
+  BOOST_CHECK_THROW(Filter::range("String", 1., 2.).evaluate(columns, 5), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test evaluating a filter on a table
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(EvaluateTable) {
+
+  // Given
+  std::shared_ptr<ColumnInfo> column_info {new ColumnInfo {{
+    ColumnInfo::info_type("Flag", typeid(bool)),
+    ColumnInfo::info_type("Z", typeid(double)),
+    ColumnInfo::info_type("Vector", typeid(std::vector<double>))
+  }}};
+  Table table {{
+    Row{{true, 0.5, std::vector<double>{1.}}, column_info},
+    Row{{false, 0.7, std::vector<double>{2.}}, column_info},
+    Row{{true, 1.5, std::vector<double>{3.}}, column_info}
+  }};
+  auto filter = Filter::compare("Flag", Op::EQUAL, true) && Filter::range("Z", 0., 1.);
+
+  // When
+  auto result = filter.evaluate(table);
+
+  // Then
+  BOOST_CHECK(result == Filter::mask_type({1, 0, 0}));
+  BOOST_CHECK_THROW(Filter::compare("Vector", Op::LESS, 1).evaluate(table), Elements::Exception);
+  BOOST_CHECK_THROW(Filter::compare("Missing", Op::LESS, 1).evaluate(table), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the blocks of rows are checked using their statistics
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(MayMatch, Filter_Fixture) {
+
+  // Given
+  ColumnStatistics ints {};
+  ints.min = int64_t{10};
+  ints.max = int64_t{20};
+  ColumnStatistics reals {};
+  reals.min = 0.5;
+  reals.max = 1.5;
+  reals.null_count = 2;
+  ColumnStatistics nans {};
+  nans.min = nans.max = std::numeric_limits<double>::quiet_NaN();
+  std::map<std::string, ColumnStatistics> statistics {{"Int", ints}, {"Double", reals}, {"Nan", nans}};
+
+  // Then
+  BOOST_CHECK(!Filter::compare("Int", Op::LESS, 10).mayMatch(statistics));
+  BOOST_CHECK(Filter::compare("Int", Op::LESS_EQUAL, 10).mayMatch(statistics));
+  BOOST_CHECK(!Filter::compare("Int", Op::GREATER, 20.).mayMatch(statistics));
+  BOOST_CHECK(Filter::compare("Int", Op::EQUAL, 15).mayMatch(statistics));
+  BOOST_CHECK(!Filter::compare("Double", Op::EQUAL, 2.).mayMatch(statistics));
+  BOOST_CHECK(Filter::compare("Double", Op::NOT_EQUAL, 1.).mayMatch(statistics));
+  BOOST_CHECK(!Filter::range("Int", 21, 30).mayMatch(statistics));
+  BOOST_CHECK(Filter::range("Double", 1., 2.).mayMatch(statistics));
+  BOOST_CHECK(!Filter::compare("Nan", Op::GREATER, 0.).mayMatch(statistics));
+  BOOST_CHECK(Filter::compare("Nan", Op::NOT_EQUAL, 0.).mayMatch(statistics));
+  BOOST_CHECK(Filter::compare("Missing", Op::EQUAL, 1).mayMatch(statistics));
+  BOOST_CHECK(!(Filter::compare("Int", Op::LESS, 10) && Filter::compare("Missing", Op::EQUAL, 1)).mayMatch(statistics));
+  BOOST_CHECK((Filter::compare("Int", Op::LESS, 10) || Filter::compare("Missing", Op::EQUAL, 1)).mayMatch(statistics));
+  BOOST_CHECK((!Filter::compare("Int", Op::LESS, 10)).mayMatch(statistics));
+
+}
+
+//-----------------------------------------------------------------------------
+// Test string comparisons on dictionary encoded columns
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(DictionaryColumns, Filter_Fixture) {
+
+  // Given
+  auto dictionary = std::make_shared<StringDictionary>(std::vector<std::string>{"c", "a", "b"});
+  columns.emplace("Dictionary", Filter::DictionaryCodes{{1, 2, 0, 2, 1}, dictionary});
+
+  // When
+  auto equal = Filter::compare("Dictionary", Op::EQUAL, "b").evaluate(columns, 5);
+  auto not_equal = Filter::compare("Dictionary", Op::NOT_EQUAL, "b").evaluate(columns, 5);
+  auto missing = Filter::compare("Dictionary", Op::EQUAL, "x").evaluate(columns, 5);
+  auto greater = Filter::compare("Dictionary", Op::GREATER, "a").evaluate(columns, 5);
+  auto range = Filter::range("Dictionary", std::string{"b"}, std::string{"c"}).evaluate(columns, 5);
+
+  // Then
+  BOOST_CHECK(equal == mask({0, 1, 0, 1, 0}));
+  BOOST_CHECK(not_equal == mask({1, 0, 1, 0, 1}));
+  BOOST_CHECK(missing == mask({0, 0, 0, 0, 0}));
+  BOOST_CHECK(greater == mask({0, 1, 1, 1, 0}));
+  BOOST_CHECK(range == mask({0, 1, 1, 1, 0}));
+  BOOST_CHECK_THROW(Filter::compare("Dictionary", Op::EQUAL, 1).evaluate(columns, 5), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test codes outside of the dictionary are rejected
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(InvalidDictionaryCodes, Filter_Fixture) {
+
+  // Given
+  auto dictionary = std::make_shared<StringDictionary>(std::vector<std::string>{"c", "a", "b"});
+  columns.emplace("Large", Filter::DictionaryCodes{{1, 3}, dictionary});
+  columns.emplace("Negative", Filter::DictionaryCodes{{-1, 0}, dictionary});
+
+  // Then
+  BOOST_CHECK_THROW(Filter::compare("Large", Op::GREATER, "a").evaluate(columns, 2), Elements::Exception);
+  BOOST_CHECK_THROW(Filter::range("Negative", std::string{"a"}, std::string{"c"}).evaluate(columns, 2),
+                    Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the missing values do not pass any comparison
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(MissingValues, Filter_Fixture) {
+
+  // Given
+  std::map<std::string, ValidityBitmap> validity {{"Int", ValidityBitmap{5}}};
+  validity.at("Int").setValid(1, false);
+  validity.at("Int").setValid(3, false);
+  auto column_info = std::make_shared<ColumnInfo>(std::vector<ColumnDescription>{
+    ColumnDescription {"Value", typeid(int64_t)}
+  });
+  ValidityBitmap table_validity {2};
+  table_validity.setValid(0, false);
+  Table table {{Row{{int64_t{0}}, column_info}, Row{{int64_t{1}}, column_info}}, {{0, table_validity}}};
+
+  // When
+  auto less = Filter::compare("Int", Op::LESS, 6).evaluate(columns, 5, validity);
+  auto not_equal = Filter::compare("Int", Op::NOT_EQUAL, 5).evaluate(columns, 5, validity);
+  auto range = Filter::range("Int", -5, 5).evaluate(columns, 5, validity);
+  auto negated = (!Filter::compare("Int", Op::LESS, 6)).evaluate(columns, 5, validity);
+  auto table_mask = Filter::compare("Value", Op::LESS_EQUAL, 0).evaluate(table);
+
+  // Then
+  BOOST_CHECK(less == mask({1, 0, 1, 0, 0}));
+  BOOST_CHECK(not_equal == mask({1, 0, 1, 0, 1}));
+  BOOST_CHECK(range == mask({1, 0, 1, 0, 0}));
+  BOOST_CHECK(negated == mask({0, 1, 0, 1, 1}));
+  BOOST_CHECK(table_mask == mask({0, 0}));
+  validity.at("Int") = ValidityBitmap{4};
+  BOOST_CHECK_THROW(Filter::compare("Int", Op::LESS, 6).evaluate(columns, 5, validity), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file tests/src/FitsColumnIO_test.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <CCfits/CCfits>
+#include "ElementsKernel/Exception.h"
+#include "ElementsKernel/Temporary.h"
+#include "Table/FitsColumnIO.h"
+
+using namespace Euclid::Table;
+
+struct FitsColumnIO_Fixture {
+  Elements::TempDir temp_dir;
+  std::unique_ptr<CCfits::FITS> fits {new CCfits::FITS(
+        (temp_dir.path()/"FitsColumnIO_test.fits").native(), CCfits::RWmode::Write)};
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (FitsColumnIO_test)
+
+//-----------------------------------------------------------------------------
+// Test writing and reading back scalar and vector binary columns
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(binaryColumns, FitsColumnIO_Fixture) {
+
+  // Given
+  std::vector<std::string> names {"Boolean", "Integer", "Vector"};
+  std::vector<std::string> types {"L", "J", "3D"};
+  CCfits::Table* table_hdu = fits->addTable("Binary", 0, names, types);
+  bool booleans[] = {true, false, true, true};
+  int32_t integers[] = {1, -2, 3, 4};
+  double vectors[] = {1.5, 2.5, 3.5, 4.5, 5.5, 6.5, 7.5, 8.5, 9.5, 10.5, 11.5, 12.5};
+
+  // When
+  writeColumnData(table_hdu->column(1), 1, 4, booleans);
+  writeColumnData(table_hdu->column(2), 1, 4, integers);
+  writeColumnData(table_hdu->column(3), 1, 4, vectors);
+  bool read_booleans[2];
+  int64_t read_integers[2];
+  float read_vectors[6];
+  readColumnData(table_hdu->column(1), 2, 2, read_booleans);
+  readColumnData(table_hdu->column(2), 2, 2, read_integers);
+  readColumnData(table_hdu->column(3), 2, 2, read_vectors);
+
+  // Then
+  BOOST_CHECK_EQUAL_COLLECTIONS(read_booleans, read_booleans + 2, booleans + 1, booleans + 3);
+  BOOST_CHECK_EQUAL_COLLECTIONS(read_integers, read_integers + 2, integers + 1, integers + 3);
+  BOOST_CHECK_EQUAL_COLLECTIONS(read_vectors, read_vectors + 6, vectors + 3, vectors + 9);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the booleans are written as integers in ASCII tables
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(asciiColumns, FitsColumnIO_Fixture) {
+
+  // Given
+  std::vector<std::string> names {"Boolean", "Double"};
+  std::vector<std::string> types {"I1", "E12"};
+  std::vector<std::string> units {"", ""};
+  CCfits::Table* table_hdu = fits->addTable("Ascii", 0, names, types, units, CCfits::HduType::AsciiTbl);
+  bool booleans[] = {true, false};
+  double doubles[] = {0.25, -4.};
+
+  // When
+  writeColumnData(table_hdu->column(1), 1, 2, booleans);
+  writeColumnData(table_hdu->column(2), 1, 2, doubles);
+  int32_t read_integers[2];
+  double read_doubles[2];
+  readColumnData(table_hdu->column(1), 1, 2, read_integers);
+  readColumnData(table_hdu->column(2), 1, 2, read_doubles);
+
+  // Then
+  BOOST_CHECK_EQUAL(read_integers[0], 1);
+  BOOST_CHECK_EQUAL(read_integers[1], 0);
+  BOOST_CHECK_EQUAL(read_doubles[0], 0.25);
+  BOOST_CHECK_EQUAL(read_doubles[1], -4.);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test reading after the end of the table throws
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(readOutOfRange, FitsColumnIO_Fixture) {
+
+  // Given
+  std::vector<std::string> names {"Integer"};
+  std::vector<std::string> types {"J"};
+  CCfits::Table* table_hdu = fits->addTable("Binary", 0, names, types);
+  int32_t integers[] = {1, 2};
+  writeColumnData(table_hdu->column(1), 1, 2, integers);
+
+  // Then
+  BOOST_CHECK_THROW(readColumnData(table_hdu->column(1), 2, 2, integers), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -22,6 +22,8 @@
  * @author nikoapos
  */
 
+#include <limits>
+#include <thread>
 #include <boost/test/unit_test.hpp>
 
 #include "ElementsKernel/Temporary.h"
@@ -255,6 +257,231 @@ BOOST_FIXTURE_TEST_CASE(ReadSuccess, FitsReader_Fixture) {
   BOOST_CHECK_EQUAL(reader.getComment(), "TEST COMMENT\nWITH LINES");
 }
 
+//-----------------------------------------------------------------------------
+// Test the columns converted by a thread pool give the same table
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ReadWithThreadPool, FitsReader_Fixture) {
+
+  // Given
+  FitsReader serial_reader {*table_hdu};
+  FitsReader parallel_reader {*table_hdu};
+  parallel_reader.setThreadPool(std::make_shared<Euclid::ThreadPool>(4));
+
+  // When
+  auto expected = serial_reader.read();
+  auto first = parallel_reader.read(1);
+  auto second = parallel_reader.read();
+
+  // Then
+  BOOST_CHECK_EQUAL(first.size(), 1);
+  BOOST_CHECK_EQUAL(second.size(), 1);
+  for (std::size_t i = 0; i < expected[0].size(); ++i) {
+    BOOST_CHECK(first[0][i] == expected[0][i]);
+    BOOST_CHECK(second[0][i] == expected[1][i]);
+  }
+
+}
+
+//-----------------------------------------------------------------------------
+// Test reading only the rows passing a filter
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ReadWithFilter, FitsReader_Fixture) {
+
+  // Given
+  FitsReader reader {*table_hdu};
+  FitsReader string_reader {*table_hdu};
+  FitsReader vector_reader {*table_hdu};
+  reader.setFilter(Filter::compare("Double", Filter::Operator::LESS, 1.) || Filter::compare("Bool", Filter::Operator::EQUAL, 0));
+  string_reader.setFilter(Filter::compare("String", Filter::Operator::EQUAL, "Small"));
+  vector_reader.setFilter(Filter::compare("IntVector", Filter::Operator::EQUAL, 1));
+
+  // When
+  auto table = reader.read();
+  auto string_table = string_reader.read();
+
+  // Then
+  BOOST_CHECK_EQUAL(table.size(), 1);
+  BOOST_CHECK_EQUAL(boost::get<int32_t>(table[0][1]), -2346);
+  BOOST_CHECK(boost::get<NdArray<double>>(table[0][8]).shape() == std::vector<size_t>({2, 3}));
+  BOOST_CHECK_THROW(reader.read(), Elements::Exception);
+  BOOST_CHECK_EQUAL(string_table.size(), 1);
+  BOOST_CHECK_EQUAL(boost::get<int64_t>(string_table[0][2]), 123456789);
+  BOOST_CHECK_THROW(vector_reader.read(), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test hasMoreRows() looks ahead for a row passing the filter
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(HasMoreRowsWithFilter, FitsReader_Fixture) {
+
+  // Given
+  FitsReader reader {*table_hdu};
+  reader.setFilter(Filter::compare("String", Filter::Operator::EQUAL, "Small"));
+
+  // When
+  std::vector<int64_t> values {};
+  while (reader.hasMoreRows()) {
+    values.push_back(boost::get<int64_t>(reader.read(1)[0][2]));
+  }
+
+  // Then
+  BOOST_REQUIRE_EQUAL(values.size(), 1);
+  BOOST_CHECK_EQUAL(values[0], 123456789);
+  BOOST_CHECK_EQUAL(reader.rowsLeft(), 0);
+  BOOST_CHECK_THROW(reader.read(), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test hasMoreRows() and rowsLeft() account for the last row
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(HasMoreRows, FitsReader_Fixture) {
+
+  // Given
+  FitsReader reader {*table_hdu};
+
+  // When
+  reader.read(1);
+
+  // Then
+  BOOST_CHECK(reader.hasMoreRows());
+  BOOST_CHECK_EQUAL(reader.rowsLeft(), 1);
+
+  // When
+  reader.read(1);
+
+  // Then
+  BOOST_CHECK(!reader.hasMoreRows());
+  BOOST_CHECK_EQUAL(reader.rowsLeft(), 0);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test readRange() reads the given rows without moving the reader position
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ReadRange, FitsReader_Fixture) {
+
+  // Given
+  FitsReader reader {*table_hdu};
+
+  // When
+  auto second = reader.readRange(1, 1);
+  auto all = reader.readRange(0, -1);
+  auto clipped = reader.readRange(1, 10);
+
+  // Then
+  BOOST_CHECK_EQUAL(second.size(), 1);
+  BOOST_CHECK_EQUAL(boost::get<int32_t>(second[0][1]), -2346);
+  BOOST_CHECK_EQUAL(boost::get<std::string>(second[0][3]), "1234567890");
+  BOOST_CHECK_EQUAL(boost::get<std::vector<int32_t>>(second[0][6])[0], 3);
+  BOOST_CHECK_EQUAL(all.size(), 2);
+  BOOST_CHECK_EQUAL(boost::get<std::string>(all[0][3]), "Small");
+  BOOST_CHECK_EQUAL(clipped.size(), 1);
+  BOOST_CHECK_EQUAL(reader.rowsLeft(), 2);
+  BOOST_CHECK_THROW(reader.readRange(-1, 1), Elements::Exception);
+  BOOST_CHECK_THROW(reader.readRange(2, 1), Elements::Exception);
+  BOOST_CHECK_THROW(reader.readRange(0, 0), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test readRange() can be called concurrently on the same reader
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ReadRangeConcurrently, FitsReader_Fixture) {
+
+  // Given
+  FitsReader reader {*table_hdu};
+  std::vector<std::string> results (8);
+
+  // When
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    threads.emplace_back([&reader, &results, i]() {
+      auto table = reader.readRange(i % 2, 1);
+      results[i] = boost::get<std::string>(table[0][3]);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Then
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    BOOST_CHECK_EQUAL(results[i], i % 2 == 0 ? "Small" : "1234567890");
+  }
+
+}
+
+//-----------------------------------------------------------------------------
+// Test reading typed columns
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ReadColumns, FitsReader_Fixture) {
+
+  // Given
+  FitsReader reader {*table_hdu};
+  std::vector<bool> bools {};
+  std::vector<int32_t> bools_as_ints {};
+  std::vector<int64_t> ints {};
+  std::vector<double> floats {};
+  std::vector<std::string> strings {};
+
+  // When
+  auto rows = reader.readColumns(-1);
+  reader.getColumn(0, bools);
+  reader.getColumn(0, bools_as_ints);
+  reader.getColumn(1, ints);
+  reader.getColumn(4, floats);
+  reader.getColumn(3, strings);
+
+  // Then
+  BOOST_CHECK_EQUAL(rows, 2);
+  BOOST_CHECK((bools == std::vector<bool>{true, false}));
+  BOOST_CHECK((bools_as_ints == std::vector<int32_t>{1, 0}));
+  BOOST_CHECK((ints == std::vector<int64_t>{3, -2346}));
+  BOOST_CHECK_CLOSE(floats[0], 3.4, 1E-4);
+  BOOST_CHECK((strings == std::vector<std::string>{"Small", "1234567890"}));
+  BOOST_CHECK_EQUAL(reader.readColumns(-1), 0);
+  BOOST_CHECK(!reader.hasMoreRows());
+  BOOST_CHECK_THROW(reader.getColumn(6, ints), Elements::Exception);
+  BOOST_CHECK_THROW(reader.getColumn(3, floats), Elements::Exception);
+  BOOST_CHECK_THROW(reader.getColumn(1, strings), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the TNULLn and NaN values are marked as missing
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(NullValues, FitsReader_Fixture) {
+
+  // Given
+  auto nulls_hdu = fits->addTable("Nulls", 3, {"Int", "Double"}, {"J", "D"}, {"", ""});
+  std::vector<int32_t> int_values {1, -99, 3};
+  nulls_hdu->column(1).write(int_values, 1);
+  std::vector<double> double_values {1.5, 2.5, std::numeric_limits<double>::quiet_NaN()};
+  nulls_hdu->column(2).write(double_values, 1);
+  nulls_hdu->addKey("TNULL1", -99, "");
+  FitsReader reader {*nulls_hdu};
+
+  // When
+  auto table = reader.read();
+
+  // Then
+  BOOST_CHECK(!table.getValidity("Int").isValid(1));
+  BOOST_CHECK_EQUAL(table.getValidity("Int").countValid(), 2);
+  BOOST_CHECK(!table.getValidity("Double").isValid(2));
+  BOOST_CHECK_EQUAL(table.getValidity("Double").countValid(), 2);
+
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END ()
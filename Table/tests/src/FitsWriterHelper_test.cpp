@@ -91,6 +91,49 @@ BOOST_FIXTURE_TEST_CASE(getBinaryFormatList, FitsWriterHelper_Fixture) {
 
 }
 
+//-----------------------------------------------------------------------------
+// Test the declared widths and shapes are used instead of the values
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(declaredSchema) {
+
+  // Given
+  using namespace Euclid::Table;
+  ColumnDescription integer {"Integer", typeid(int32_t)};
+  integer.width = 10;
+  ColumnDescription string {"String", typeid(std::string)};
+  string.width = 20;
+  ColumnDescription vector {"Vector", typeid(std::vector<double>)};
+  vector.shape = {3};
+  ColumnDescription ndarray {"NdArray", typeid(Euclid::NdArray::NdArray<float>)};
+  ndarray.shape = {2, 3};
+  auto ascii_info = std::make_shared<ColumnInfo>(std::vector<ColumnDescription>{integer, string});
+  auto binary_info = std::make_shared<ColumnInfo>(std::vector<ColumnDescription>{string, vector, ndarray});
+  Table ascii_table {{Row{{1, std::string{"a"}}, ascii_info}}};
+  Table binary_table {{Row{{std::string{"a"}, std::vector<double>{1., 2., 3.},
+                            Euclid::NdArray::NdArray<float>({2, 3}, {1, 2, 3, 4, 5, 6})}, binary_info}}};
+  Table long_string_table {{Row{{std::string(21, 'a'), std::vector<double>{1., 2., 3.},
+                                 Euclid::NdArray::NdArray<float>({2, 3}, {1, 2, 3, 4, 5, 6})}, binary_info}}};
+  Table wrong_size_table {{Row{{std::string{"a"}, std::vector<double>{1., 2.},
+                                Euclid::NdArray::NdArray<float>({2, 3}, {1, 2, 3, 4, 5, 6})}, binary_info}}};
+
+  // When
+  auto ascii_format_list = Euclid::Table::getAsciiFormatList(ascii_table);
+  auto binary_format_list = Euclid::Table::getBinaryFormatList(binary_table);
+  auto tdim = Euclid::Table::getTDIM(binary_table, 2);
+
+  // Then
+  BOOST_CHECK_EQUAL(ascii_format_list[0], "I10");
+  BOOST_CHECK_EQUAL(ascii_format_list[1], "A20");
+  BOOST_CHECK_EQUAL(binary_format_list[0], "20A");
+  BOOST_CHECK_EQUAL(binary_format_list[1], "3D");
+  BOOST_CHECK_EQUAL(binary_format_list[2], "6E");
+  BOOST_CHECK_EQUAL(tdim, "(3,2)");
+  BOOST_CHECK_THROW(Euclid::Table::packColumn(long_string_table, 0), Elements::Exception);
+  BOOST_CHECK_THROW(Euclid::Table::packColumn(wrong_size_table, 1), Elements::Exception);
+
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END ()
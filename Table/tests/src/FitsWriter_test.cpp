@@ -22,9 +22,11 @@
  * @author nikoapos
  */
 
+#include <limits>
 #include <boost/test/unit_test.hpp>
 #include <CCfits/CCfits>
 #include "ElementsKernel/Temporary.h"
+#include "Table/FitsReader.h"
 #include "Table/FitsWriter.h"
 
 using namespace Euclid::Table;
@@ -94,6 +96,7 @@ BOOST_FIXTURE_TEST_CASE(writeBinary, BinaryFitsWriter_Fixture) {
 
   // When
   writer.addData(table);
+  writer.flush();
   CCfits::FITS fits {fits_file_path, CCfits::RWmode::Read};
   auto& result = fits.extension("BinaryTable");
   result.readAllKeys();
@@ -220,6 +223,7 @@ BOOST_FIXTURE_TEST_CASE(writeAscii, AsciiFitsWriter_Fixture) {
 
   // When
   writer.addData(table);
+  writer.flush();
   CCfits::FITS fits {fits_file_path, CCfits::RWmode::Read};
   auto& result = fits.extension("AsciiTable");
   result.readAllKeys();
@@ -308,6 +312,223 @@ BOOST_FIXTURE_TEST_CASE(writeAscii, AsciiFitsWriter_Fixture) {
 
 }
 
+//-----------------------------------------------------------------------------
+// Test that small tables are collected and written when the chunk is full
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(writeChunks, BinaryFitsWriter_Fixture) {
+
+  // Given
+  FitsWriter writer {fits_file_path, true};
+  writer.setHduName("BinaryTable");
+  writer.setChunkSize(5);
+
+  // When
+  for (int i = 0; i < 3; ++i) {
+    writer.addData(table);
+  }
+  writer.flush();
+  std::vector<int32_t> int_data {};
+  {
+    CCfits::FITS fits {fits_file_path, CCfits::RWmode::Read};
+    auto& result = fits.extension("BinaryTable");
+    result.column(2).read(int_data, 1, result.rows());
+  }
+
+  // Then
+  std::vector<int32_t> expected {1, 12345, 1, 12345, 1, 12345};
+  BOOST_CHECK_EQUAL_COLLECTIONS(int_data.begin(), int_data.end(), expected.begin(), expected.end());
+
+  // When
+  writer.addData(table);
+  writer.close();
+  writer.addData(table);
+  writer.close();
+  CCfits::FITS fits {fits_file_path, CCfits::RWmode::Read};
+
+  // Then
+  BOOST_CHECK_EQUAL(fits.extension("BinaryTable").rows(), 10);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the columns packed by a thread pool are written correctly
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(writeWithThreadPool, BinaryFitsWriter_Fixture) {
+
+  // Given
+  FitsWriter writer {fits_file_path, true};
+  writer.setHduName("BinaryTable");
+  writer.setThreadPool(std::make_shared<Euclid::ThreadPool>(4));
+
+  // When
+  writer.addData(table);
+  writer.addData(table);
+  writer.close();
+  CCfits::FITS fits {fits_file_path, CCfits::RWmode::Read};
+  auto& result = fits.extension("BinaryTable");
+  std::vector<int32_t> int_data {};
+  result.column(2).read(int_data, 1, result.rows());
+
+  // Then
+  std::vector<int32_t> expected {1, 12345, 1, 12345};
+  BOOST_CHECK_EQUAL_COLLECTIONS(int_data.begin(), int_data.end(), expected.begin(), expected.end());
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the zone map is written and used by the reader for skipping blocks
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(writeZoneMap, BinaryFitsWriter_Fixture) {
+
+  // Given
+  auto info = std::make_shared<ColumnInfo>(std::vector<ColumnDescription>{
+    ColumnDescription {"Index", typeid(int32_t)},
+    ColumnDescription {"Value", typeid(double)},
+    ColumnDescription {"Name", typeid(std::string)}
+  });
+  std::vector<Row> rows {};
+  for (int32_t i = 0; i < 10; ++i) {
+    double value = (i == 9) ? std::numeric_limits<double>::quiet_NaN() : i * 0.5;
+    rows.emplace_back(std::vector<Row::cell_type>{i, value, std::string{"Name"} + std::to_string(i)}, info);
+  }
+  Table first_rows {std::vector<Row>(rows.begin(), rows.begin() + 3)};
+  Table last_rows {std::vector<Row>(rows.begin() + 3, rows.end())};
+  FitsWriter writer {fits_file_path, true};
+  writer.setHduName("Indexed").setZoneMapBlockSize(4);
+
+  // When
+  writer.addData(first_rows);
+  writer.addData(last_rows);
+  writer.close();
+  FitsReader reader {fits_file_path, "Indexed"};
+  auto zone_map = reader.getZoneMap();
+
+  // Then
+  BOOST_REQUIRE_EQUAL(zone_map.size(), 3);
+  BOOST_CHECK_EQUAL(zone_map[1].offset, 4);
+  BOOST_CHECK_EQUAL(zone_map[2].rows, 2);
+  BOOST_CHECK_EQUAL(zone_map[0].columns.count("Name"), 0);
+  BOOST_CHECK_EQUAL(boost::get<int64_t>(zone_map[1].columns.at("Index").min), 4);
+  BOOST_CHECK_EQUAL(boost::get<int64_t>(zone_map[1].columns.at("Index").max), 7);
+  BOOST_CHECK_EQUAL(boost::get<double>(zone_map[2].columns.at("Value").max), 4.);
+  BOOST_CHECK_EQUAL(zone_map[2].columns.at("Value").null_count, 1);
+
+  // When
+  FitsReader filtered_reader {fits_file_path, "Indexed"};
+  filtered_reader.setFilter(Filter::compare("Index", Filter::Operator::GREATER_EQUAL, 6));
+  auto result = filtered_reader.read();
+
+  // Then
+  BOOST_REQUIRE_EQUAL(result.size(), 4);
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    BOOST_CHECK_EQUAL(boost::get<int32_t>(result[i][0]), 6 + static_cast<int32_t>(i));
+  }
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the compressed tables are written with the per column algorithms and
+// are read back transparently
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(writeCompressed, BinaryFitsWriter_Fixture) {
+
+  // Given
+  FitsWriter writer {fits_file_path, true};
+  writer.setHduName("Compressed").setFormat(FitsWriter::Format::COMPRESSED_BINARY);
+  writer.setCompression("Integer", FitsWriter::Compression::RICE)
+        .setCompression("Double", FitsWriter::Compression::SHUFFLED_GZIP);
+
+  // When
+  writer.addData(table);
+  writer.addData(table);
+  writer.close();
+  std::string integer_algorithm {};
+  {
+    CCfits::FITS fits {fits_file_path, CCfits::RWmode::Read};
+    auto& hdu = fits.extension("Compressed");
+    hdu.keyWord("ZCTYP2").value(integer_algorithm);
+  }
+  FitsReader reader {fits_file_path, "Compressed"};
+  auto result = reader.read();
+
+  // Then
+  BOOST_CHECK_EQUAL(integer_algorithm, "RICE_1");
+  BOOST_REQUIRE_EQUAL(result.size(), 4);
+  BOOST_CHECK(*result.getColumnInfo() == *column_info);
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    BOOST_CHECK_EQUAL(boost::get<int32_t>(result[i][1]), boost::get<int32_t>(table[i % 2][1]));
+    BOOST_CHECK_EQUAL(boost::get<double>(result[i][4]), boost::get<double>(table[i % 2][4]));
+    BOOST_CHECK_EQUAL(boost::get<std::string>(result[i][5]), boost::get<std::string>(table[i % 2][5]));
+  }
+
+  // When
+  writer.addData(table);
+
+  // Then
+  BOOST_CHECK_THROW(writer.close(), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the compression algorithms are validated against the column types
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(writeCompressedInvalidAlgorithm, BinaryFitsWriter_Fixture) {
+
+  // Given
+  FitsWriter writer {fits_file_path, true};
+  writer.setFormat(FitsWriter::Format::COMPRESSED_BINARY);
+  writer.setCompression("String", FitsWriter::Compression::RICE);
+
+  // Then
+  BOOST_CHECK_THROW(writer.addData(table), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test vectors of a later chunk not matching the column size are rejected
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(writeVectorSizeMismatch, BinaryFitsWriter_Fixture) {
+
+  // Given
+  auto info = std::make_shared<ColumnInfo>(std::vector<ColumnDescription>{
+    ColumnDescription {"Vector", typeid(std::vector<double>)}
+  });
+  Table first_chunk {{Row{{std::vector<double>{1., 2., 3.}}, info}}};
+  Table second_chunk {{Row{{std::vector<double>{1.}}, info}}};
+  FitsWriter writer {fits_file_path, true};
+  writer.setHduName("Vectors");
+
+  // When
+  writer.addData(first_chunk);
+  writer.flush();
+  writer.addData(second_chunk);
+
+  // Then
+  BOOST_CHECK_THROW(writer.flush(), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test compressed tables with a zone map must have a name
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(writeCompressedZoneMapWithoutName, BinaryFitsWriter_Fixture) {
+
+  // Given
+  FitsWriter writer {fits_file_path, true};
+  writer.setFormat(FitsWriter::Format::COMPRESSED_BINARY).setZoneMapBlockSize(4);
+
+  // Then
+  BOOST_CHECK_THROW(writer.addData(table), Elements::Exception);
+
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file tests/src/MultiFileTableReader_test.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <boost/test/unit_test.hpp>
+#include "ElementsKernel/Exception.h"
+#include "ElementsKernel/Temporary.h"
+#include "Table/FitsWriter.h"
+#include "Table/MultiFileTableReader.h"
+
+using namespace Euclid::Table;
+
+struct MultiFileTableReader_Fixture {
+
+  Elements::TempDir temp_dir;
+  std::shared_ptr<ColumnInfo> column_info {new ColumnInfo {{
+    ColumnDescription {"Id", typeid(int64_t)},
+    ColumnDescription {"Value", typeid(double)}
+  }}};
+  std::vector<std::string> filenames {};
+
+  MultiFileTableReader_Fixture() {
+    // Three shards with 5, 3 and 4 rows and ids increasing over all of them
+    int64_t id = 0;
+    for (int rows : {5, 3, 4}) {
+      std::vector<Row> row_list {};
+      for (int i = 0; i < rows; ++i, ++id) {
+        row_list.emplace_back(std::vector<Row::cell_type>{id, id * 0.5}, column_info);
+      }
+      filenames.push_back((temp_dir.path() / ("shard" + std::to_string(filenames.size()) + ".fits")).native());
+      FitsWriter writer {filenames.back(), true};
+      writer.addData(Table{row_list});
+    }
+  }
+
+  std::vector<int64_t> ids(const Table& table) {
+    std::vector<int64_t> result {};
+    for (auto& row : table) {
+      result.push_back(boost::get<int64_t>(row[0]));
+    }
+    return result;
+  }
+
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (MultiFileTableReader_test)
+
+//-----------------------------------------------------------------------------
+// Test the columns and the number of rows come from the headers
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(InfoAndRows, MultiFileTableReader_Fixture) {
+
+  // Given
+  MultiFileTableReader reader {filenames};
+
+  // Then
+  BOOST_CHECK(reader.getInfo() == *column_info);
+  BOOST_CHECK_EQUAL(reader.rowsLeft(), 12);
+  BOOST_CHECK(reader.hasMoreRows());
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the shards must have the same columns
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(DifferentColumns, MultiFileTableReader_Fixture) {
+
+  // Given
+  auto other_info = std::make_shared<ColumnInfo>(std::vector<ColumnDescription>{
+    ColumnDescription {"Id", typeid(int64_t)}
+  });
+  auto other_file = (temp_dir.path() / "other.fits").native();
+  FitsWriter writer {other_file, true};
+  writer.addData(Table{{Row{{int64_t{1}}, other_info}}});
+  writer.close();
+  filenames.push_back(other_file);
+
+  // Then
+  BOOST_CHECK_THROW(MultiFileTableReader{filenames}, Elements::Exception);
+  BOOST_CHECK_THROW(MultiFileTableReader{std::vector<std::string>{}}, Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test reading across the shards, in the calling thread and in parallel
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ReadInOrder, MultiFileTableReader_Fixture) {
+
+  for (bool parallel : {false, true}) {
+
+    // Given
+    MultiFileTableReader reader {filenames};
+    if (parallel) {
+      reader.setThreadPool(std::make_shared<Euclid::ThreadPool>(3)).setMaxShardsInMemory(2);
+    }
+
+    // When
+    auto first = reader.read(4);
+    auto second = reader.read(3);
+    auto rest = reader.read();
+
+    // Then
+    BOOST_CHECK((ids(first) == std::vector<int64_t>{0, 1, 2, 3}));
+    BOOST_CHECK((ids(second) == std::vector<int64_t>{4, 5, 6}));
+    BOOST_CHECK((ids(rest) == std::vector<int64_t>{7, 8, 9, 10, 11}));
+    BOOST_CHECK(!reader.hasMoreRows());
+    BOOST_CHECK_THROW(reader.read(), Elements::Exception);
+
+  }
+
+}
+
+//-----------------------------------------------------------------------------
+// Test reading in completion order returns all the rows of every shard
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ReadCompletionOrder, MultiFileTableReader_Fixture) {
+
+  // Given
+  MultiFileTableReader reader {filenames};
+  reader.setThreadPool(std::make_shared<Euclid::ThreadPool>(3)).setCompletionOrder();
+  std::vector<int64_t> result {};
+
+  // When
+  while (reader.hasMoreRows()) {
+    auto table_ids = ids(reader.read(2));
+    result.insert(result.end(), table_ids.begin(), table_ids.end());
+  }
+
+  // Then
+  std::sort(result.begin(), result.end());
+  BOOST_REQUIRE_EQUAL(result.size(), 12);
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    BOOST_CHECK_EQUAL(result[i], static_cast<int64_t>(i));
+  }
+
+}
+
+//-----------------------------------------------------------------------------
+// Test skipping rows inside and across shards
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(Skip, MultiFileTableReader_Fixture) {
+
+  // Given
+  MultiFileTableReader reader {filenames};
+
+  // When
+  reader.skip(2);
+  auto first = reader.read(1);
+  reader.skip(6);
+
+  // Then
+  BOOST_CHECK((ids(first) == std::vector<int64_t>{2}));
+  BOOST_CHECK_EQUAL(reader.rowsLeft(), 3);
+  BOOST_CHECK((ids(reader.read()) == std::vector<int64_t>{9, 10, 11}));
+
+}
+
+//-----------------------------------------------------------------------------
+// Test finding the shards with a wildcard pattern
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(FindFiles, MultiFileTableReader_Fixture) {
+
+  // When
+  auto files = MultiFileTableReader::findFiles((temp_dir.path() / "shard*.fits").native());
+
+  // Then
+  BOOST_CHECK(files == filenames);
+  BOOST_CHECK_THROW(MultiFileTableReader::findFiles((temp_dir.path() / "none*").native()), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test a shard which cannot be read does not count in the rows left
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ShardReadError, MultiFileTableReader_Fixture) {
+
+  // Given
+  MultiFileTableReader reader {filenames};
+  reader.setThreadPool(std::make_shared<Euclid::ThreadPool>(2)).setMaxShardsInMemory(1);
+  std::ofstream {filenames[1], std::ios::trunc} << "Not a FITS file";
+
+  // When
+  auto first = reader.read(5);
+
+  // Then
+  BOOST_CHECK((ids(first) == std::vector<int64_t>{0, 1, 2, 3, 4}));
+  BOOST_CHECK_THROW(reader.read(), Elements::Exception);
+  BOOST_CHECK_EQUAL(reader.rowsLeft(), 4);
+  BOOST_CHECK((ids(reader.read()) == std::vector<int64_t>{8, 9, 10, 11}));
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file tests/src/PrefetchingTableReader_test.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include <boost/test/unit_test.hpp>
+#include "ElementsKernel/Exception.h"
+#include "AlexandriaKernel/memory_tools.h"
+#include "Table/AsciiReader.h"
+#include "Table/PrefetchingTableReader.h"
+
+using namespace Euclid::Table;
+using Euclid::make_unique;
+
+// A reader returning the rows of a vector, which can be made slow and fail
+// when reaching a given row
+class VectorReader : public TableReader {
+public:
+  VectorReader(std::vector<Row> rows, std::size_t failing_row=0)
+          : m_rows(std::move(rows)), m_failing_row(failing_row) {
+  }
+  std::string getComment() override {
+    return "Vector";
+  }
+  const ColumnInfo& getInfo() override {
+    return *m_rows.front().getColumnInfo();
+  }
+  void skip(long rows) override {
+    m_current = std::min(m_rows.size(), m_current + rows);
+  }
+  bool hasMoreRows() override {
+    return m_current < m_rows.size();
+  }
+  std::size_t rowsLeft() override {
+    return m_rows.size() - m_current;
+  }
+protected:
+  Table readImpl(long rows) override {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (m_current >= m_rows.size()) {
+      throw Elements::Exception() << "No more table rows left";
+    }
+    std::size_t last = rows < 0 ? m_rows.size() : std::min(m_rows.size(), m_current + rows);
+    if (m_failing_row > 0 && last > m_failing_row) {
+      throw std::runtime_error("Read failure");
+    }
+    std::vector<Row> result (m_rows.begin() + m_current, m_rows.begin() + last);
+    m_current = last;
+    return Table{std::move(result)};
+  }
+private:
+  std::vector<Row> m_rows;
+  std::size_t m_failing_row;
+  std::size_t m_current = 0;
+};
+
+struct PrefetchingTableReader_Fixture {
+
+  std::shared_ptr<ColumnInfo> column_info {new ColumnInfo {{ColumnDescription {"Id", typeid(int32_t)}}}};
+
+  std::unique_ptr<TableReader> vectorReader(std::size_t rows, std::size_t failing_row=0) {
+    std::vector<Row> row_list {};
+    for (std::size_t i = 0; i < rows; ++i) {
+      row_list.emplace_back(std::vector<Row::cell_type>{static_cast<int32_t>(i)}, column_info);
+    }
+    return make_unique<VectorReader>(std::move(row_list), failing_row);
+  }
+
+  std::vector<int32_t> ids(const Table& table) {
+    std::vector<int32_t> result {};
+    for (auto& row : table) {
+      result.push_back(boost::get<int32_t>(row[0]));
+    }
+    return result;
+  }
+
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (PrefetchingTableReader_test)
+
+//-----------------------------------------------------------------------------
+// Test the constructor throws for invalid arguments
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ConstructorInvalid, PrefetchingTableReader_Fixture) {
+
+  // Then
+  BOOST_CHECK_THROW(PrefetchingTableReader(nullptr, 10), Elements::Exception);
+  BOOST_CHECK_THROW(PrefetchingTableReader(vectorReader(5), 0), Elements::Exception);
+  BOOST_CHECK_THROW(PrefetchingTableReader(vectorReader(5), 10, 0), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test reading with sizes different than the chunk size
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ReadAcrossChunks, PrefetchingTableReader_Fixture) {
+
+  // Given
+  PrefetchingTableReader reader {vectorReader(10), 3};
+
+  // When
+  auto first = reader.read(4);
+  auto second = reader.read(3);
+  auto third = reader.read();
+
+  // Then
+  BOOST_CHECK((ids(first) == std::vector<int32_t>{0, 1, 2, 3}));
+  BOOST_CHECK((ids(second) == std::vector<int32_t>{4, 5, 6}));
+  BOOST_CHECK((ids(third) == std::vector<int32_t>{7, 8, 9}));
+  BOOST_CHECK(!reader.hasMoreRows());
+  BOOST_CHECK_EQUAL(reader.rowsLeft(), 0);
+  BOOST_CHECK_THROW(reader.read(), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test reading in chunks of the prefetching size
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ReadChunks, PrefetchingTableReader_Fixture) {
+
+  // Given
+  PrefetchingTableReader reader {vectorReader(100), 10, 3};
+  std::vector<int32_t> result {};
+
+  // When
+  while (reader.hasMoreRows()) {
+    auto table = reader.read(10);
+    auto table_ids = ids(table);
+    result.insert(result.end(), table_ids.begin(), table_ids.end());
+  }
+
+  // Then
+  BOOST_REQUIRE_EQUAL(result.size(), 100);
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    BOOST_CHECK_EQUAL(result[i], static_cast<int32_t>(i));
+  }
+
+}
+
+//-----------------------------------------------------------------------------
+// Test skipping prefetched and not prefetched rows
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(Skip, PrefetchingTableReader_Fixture) {
+
+  // Given
+  PrefetchingTableReader reader {vectorReader(20), 3};
+
+  // When
+  reader.skip(2);
+  auto first = reader.read(2);
+  reader.skip(10);
+
+  // Then
+  BOOST_CHECK((ids(first) == std::vector<int32_t>{2, 3}));
+  BOOST_CHECK_EQUAL(reader.rowsLeft(), 6);
+  BOOST_CHECK((ids(reader.read(1)) == std::vector<int32_t>{14}));
+
+  // When
+  reader.skip(100);
+
+  // Then
+  BOOST_CHECK(!reader.hasMoreRows());
+  BOOST_CHECK_THROW(reader.read(), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the comment and the column info are forwarded
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(Forwarding, PrefetchingTableReader_Fixture) {
+
+  // Given
+  PrefetchingTableReader reader {vectorReader(5), 2};
+
+  // Then
+  BOOST_CHECK_EQUAL(reader.getComment(), "Vector");
+  BOOST_CHECK(reader.getInfo() == *column_info);
+  BOOST_CHECK_EQUAL(reader.rowsLeft(), 5);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the errors of the background reads are thrown by read()
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ReadError, PrefetchingTableReader_Fixture) {
+
+  // Given
+  PrefetchingTableReader reader {vectorReader(10, 7), 3};
+
+  // When
+  auto table = reader.read();
+
+  // Then
+  BOOST_CHECK((ids(table) == std::vector<int32_t>{0, 1, 2, 3, 4, 5}));
+  BOOST_CHECK(reader.hasMoreRows());
+  BOOST_CHECK_THROW(reader.read(), std::runtime_error);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the validity bitmaps are kept when the chunks are split and joined
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ReadValidity, PrefetchingTableReader_Fixture) {
+
+  // Given
+  std::stringstream in {"# Column: Value double\n1\nNA\n3\n4\nNA\n6\n7\n"};
+  auto ascii_reader = make_unique<AsciiReader>(in);
+  ascii_reader->setNullTokens({"NA"});
+  PrefetchingTableReader reader {std::move(ascii_reader), 3};
+
+  // When
+  auto first = reader.read(2);
+  auto second = reader.read(4);
+
+  // Then
+  BOOST_CHECK_EQUAL(first.getValidity("Value").countValid(), 1);
+  BOOST_CHECK(!first.getValidity("Value").isValid(1));
+  BOOST_CHECK_EQUAL(second.getValidity("Value").countValid(), 3);
+  BOOST_CHECK(!second.getValidity("Value").isValid(2));
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
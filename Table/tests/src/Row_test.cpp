@@ -215,6 +215,29 @@ BOOST_FIXTURE_TEST_CASE(StringBracketOperator, Row_Fixture) {
   
 }
 
+//-----------------------------------------------------------------------------
+// Test the operator[handle]
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(HandleBracketOperator, Row_Fixture) {
+  
+  // Given
+  std::vector<Euclid::Table::Row::cell_type> values {std::string{"One"}, std::string{"Two"}, 3., 4., 5, std::vector<double>{6.1, 6.2}};
+  Euclid::Table::Row row {values, column_info};
+  std::shared_ptr<Euclid::Table::ColumnInfo> other_info {new Euclid::Table::ColumnInfo {{
+      Euclid::Table::ColumnInfo::info_type("Fourth", typeid(double))
+  }}};
+  
+  // When
+  auto handle = column_info->getHandle("Fourth");
+  auto other_handle = other_info->getHandle("Fourth");
+  
+  // Then
+  BOOST_CHECK_EQUAL(row[handle], values[3]);
+  BOOST_CHECK_EQUAL(row[other_handle], values[3]);
+  
+}
+
 //-----------------------------------------------------------------------------
 // Test the iterator
 //-----------------------------------------------------------------------------
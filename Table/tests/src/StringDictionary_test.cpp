@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file tests/src/StringDictionary_test.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "ElementsKernel/Exception.h"
+#include "Table/StringDictionary.h"
+
+using namespace Euclid::Table;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (StringDictionary_test)
+
+//-----------------------------------------------------------------------------
+// Test the constructor rejects duplicate values
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(DuplicateValues) {
+
+  // Then
+  BOOST_CHECK_THROW(StringDictionary({"VIS", "Y", "VIS"}), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the values are decoded and found by their codes
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(DecodeAndFind) {
+
+  // Given
+  StringDictionary dictionary {{"VIS", "Y", "J", "H"}};
+
+  // Then
+  BOOST_CHECK_EQUAL(dictionary.size(), 4);
+  BOOST_CHECK_EQUAL(dictionary.decode(0), "VIS");
+  BOOST_CHECK_EQUAL(dictionary.decode(3), "H");
+  BOOST_CHECK_THROW(dictionary.decode(4), Elements::Exception);
+  BOOST_CHECK_THROW(dictionary.decode(-1), Elements::Exception);
+  BOOST_CHECK_EQUAL(*dictionary.find("J"), 2);
+  BOOST_CHECK(!dictionary.find("K"));
+
+}
+
+//-----------------------------------------------------------------------------
+// Test dictionaries are equal only with the same values in the same order
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(Equality) {
+
+  // Given
+  StringDictionary dictionary {{"VIS", "Y"}};
+
+  // Then
+  BOOST_CHECK(dictionary == StringDictionary({"VIS", "Y"}));
+  BOOST_CHECK(dictionary != StringDictionary({"Y", "VIS"}));
+  BOOST_CHECK(dictionary != StringDictionary({"VIS", "Y", "J"}));
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,394 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file tests/src/TableOperations_test.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <cmath>
+#include <limits>
+#include <boost/test/unit_test.hpp>
+#include "ElementsKernel/Exception.h"
+#include "Table/DictionaryEncoding.h"
+#include "Table/TableOperations.h"
+
+using namespace Euclid::Table;
+
+struct TableOperations_Fixture {
+
+  double nan = std::numeric_limits<double>::quiet_NaN();
+
+  std::shared_ptr<ColumnInfo> column_info {new ColumnInfo {{
+    ColumnDescription {"Id", typeid(int32_t)},
+    ColumnDescription {"Name", typeid(std::string)},
+    ColumnDescription {"Value", typeid(double), "mag"},
+    ColumnDescription {"Flag", typeid(bool)}
+  }}};
+
+  Table table {{
+    Row {{0, std::string{"b"}, 2., true}, column_info},
+    Row {{1, std::string{"a"}, nan, false}, column_info},
+    Row {{2, std::string{"b"}, 1., false}, column_info},
+    Row {{3, std::string{"c"}, 4., true}, column_info},
+    Row {{4, std::string{"a"}, 2., true}, column_info},
+    Row {{5, std::string{"b"}, 3., true}, column_info}
+  }};
+
+  std::shared_ptr<ColumnInfo> other_info {new ColumnInfo {{
+    ColumnDescription {"Name", typeid(std::string)},
+    ColumnDescription {"Score", typeid(int64_t)}
+  }}};
+
+  Table other {{
+    Row {{std::string{"b"}, int64_t{10}}, other_info},
+    Row {{std::string{"d"}, int64_t{20}}, other_info},
+    Row {{std::string{"a"}, int64_t{30}}, other_info},
+    Row {{std::string{"b"}, int64_t{40}}, other_info}
+  }};
+
+  // Creates a table with a large number of rows, so the work is split in
+  // multiple tasks when a thread pool is used
+  Table largeTable(std::size_t rows) {
+    std::shared_ptr<ColumnInfo> info {new ColumnInfo {{
+      ColumnDescription {"Id", typeid(int64_t)},
+      ColumnDescription {"Key", typeid(int32_t)}
+    }}};
+    std::vector<Row> result {};
+    for (std::size_t i = 0; i < rows; ++i) {
+      result.emplace_back(std::vector<Row::cell_type>{int64_t(i), int32_t((i * 7919) % 101)}, info);
+    }
+    return Table{std::move(result)};
+  }
+
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (TableOperations_test)
+
+//-----------------------------------------------------------------------------
+// Test sorting by multiple keys in both directions
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(SortMultipleKeys, TableOperations_Fixture) {
+
+  // When
+  auto ascending = sortIndices(table, {SortKey{"Name"}, SortKey{"Value"}});
+  auto descending = sortIndices(table, {SortKey{"Name", true}, SortKey{"Value", true}});
+
+  // Then
+  BOOST_CHECK((ascending == std::vector<std::size_t>{4, 1, 2, 0, 5, 3}));
+  BOOST_CHECK((descending == std::vector<std::size_t>{3, 5, 0, 2, 4, 1}));
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the NaN values go last in both directions and the sort is stable
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(SortNanAndStability, TableOperations_Fixture) {
+
+  // When
+  auto ascending = sortIndices(table, {SortKey{"Value"}});
+  auto descending = sortIndices(table, {SortKey{"Value", true}});
+  auto by_flag = sortIndices(table, {SortKey{"Flag"}});
+
+  // Then
+  BOOST_CHECK((ascending == std::vector<std::size_t>{2, 0, 4, 5, 3, 1}));
+  BOOST_CHECK((descending == std::vector<std::size_t>{3, 5, 0, 4, 2, 1}));
+  BOOST_CHECK((by_flag == std::vector<std::size_t>{1, 2, 0, 3, 4, 5}));
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the sorted table
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(SortTable, TableOperations_Fixture) {
+
+  // When
+  auto result = sort(table, {SortKey{"Id", true}});
+
+  // Then
+  BOOST_CHECK_EQUAL(result.size(), table.size());
+  BOOST_CHECK(*result.getColumnInfo() == *column_info);
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    BOOST_CHECK_EQUAL(boost::get<int32_t>(result[i][0]), 5 - static_cast<int32_t>(i));
+  }
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the parallel sort gives the same result as the serial one
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(SortWithThreadPool, TableOperations_Fixture) {
+
+  // Given
+  auto large = largeTable(50000);
+  auto pool = std::make_shared<Euclid::ThreadPool>(4);
+
+  // When
+  auto serial = sortIndices(large, {SortKey{"Key"}});
+  auto parallel = sortIndices(large, {SortKey{"Key"}}, pool);
+
+  // Then
+  BOOST_CHECK(serial == parallel);
+  for (std::size_t i = 1; i < parallel.size(); ++i) {
+    auto previous = boost::get<int32_t>(large[parallel[i - 1]][1]);
+    auto current = boost::get<int32_t>(large[parallel[i]][1]);
+    BOOST_CHECK(previous < current || (previous == current && parallel[i - 1] < parallel[i]));
+  }
+
+}
+
+//-----------------------------------------------------------------------------
+// Test sorting by a missing or an unsupported column throws
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(SortInvalidKeys, TableOperations_Fixture) {
+
+  // Given
+  std::shared_ptr<ColumnInfo> info {new ColumnInfo {{ColumnDescription {"Vector", typeid(std::vector<double>)}}}};
+  Table vector_table {{Row {{std::vector<double>{1., 2.}}, info}}};
+
+  // Then
+  BOOST_CHECK_THROW(sortIndices(table, {SortKey{"Missing"}}), Elements::Exception);
+  BOOST_CHECK_THROW(sortIndices(table, {}), Elements::Exception);
+  BOOST_CHECK_THROW(sortIndices(vector_table, {SortKey{"Vector"}}), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test grouping with all the aggregation functions
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(GroupByAggregations, TableOperations_Fixture) {
+
+  // Given
+  typedef Aggregation::Function F;
+  std::vector<Aggregation> aggregations {
+    {F::COUNT, "", "Count"},
+    {F::SUM, "Id", "SumId"},
+    {F::MIN, "Value", "MinValue"},
+    {F::MAX, "Id", "MaxId"},
+    {F::MEAN, "Id", "MeanId"}
+  };
+
+  // When
+  auto result = groupBy(table, {"Name"}, aggregations);
+
+  // Then
+  auto& info = *result.getColumnInfo();
+  BOOST_CHECK_EQUAL(info.size(), 6);
+  BOOST_CHECK(info.getDescription(0) == column_info->getDescription(1));
+  BOOST_CHECK(info.getDescription(1).type == typeid(int64_t));
+  BOOST_CHECK(info.getDescription(2).type == typeid(int64_t));
+  BOOST_CHECK(info.getDescription(3).type == typeid(double));
+  BOOST_CHECK_EQUAL(info.getDescription(3).unit, "mag");
+  BOOST_CHECK(info.getDescription(4).type == typeid(int64_t));
+  BOOST_CHECK(info.getDescription(5).type == typeid(double));
+  BOOST_REQUIRE_EQUAL(result.size(), 3);
+  std::vector<std::string> names {"b", "a", "c"};
+  std::vector<int64_t> counts {3, 2, 1};
+  std::vector<int64_t> sums {7, 5, 3};
+  std::vector<double> minimums {1., 2., 4.};
+  std::vector<int64_t> maximums {5, 4, 3};
+  std::vector<double> means {7. / 3, 2.5, 3.};
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    BOOST_CHECK_EQUAL(boost::get<std::string>(result[i][0]), names[i]);
+    BOOST_CHECK_EQUAL(boost::get<int64_t>(result[i][1]), counts[i]);
+    BOOST_CHECK_EQUAL(boost::get<int64_t>(result[i][2]), sums[i]);
+    BOOST_CHECK_EQUAL(boost::get<double>(result[i][3]), minimums[i]);
+    BOOST_CHECK_EQUAL(boost::get<int64_t>(result[i][4]), maximums[i]);
+    BOOST_CHECK_CLOSE(boost::get<double>(result[i][5]), means[i], 1E-10);
+  }
+
+}
+
+//-----------------------------------------------------------------------------
+// Test grouping by multiple keys, with NaN keys in the same group
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(GroupByMultipleKeys, TableOperations_Fixture) {
+
+  // Given
+  auto nan_info = std::make_shared<ColumnInfo>(std::vector<ColumnDescription>{
+    ColumnDescription {"Flag", typeid(bool)},
+    ColumnDescription {"Value", typeid(float)}
+  });
+  float float_nan = std::numeric_limits<float>::quiet_NaN();
+  Table nan_table {{
+    Row {{true, float_nan}, nan_info},
+    Row {{true, 1.f}, nan_info},
+    Row {{false, float_nan}, nan_info},
+    Row {{true, float_nan}, nan_info},
+    Row {{true, -0.f}, nan_info},
+    Row {{true, 0.f}, nan_info}
+  }};
+  auto pool = std::make_shared<Euclid::ThreadPool>(2);
+
+  // When
+  auto result = groupBy(nan_table, {"Flag", "Value"},
+                        {Aggregation{Aggregation::Function::COUNT, "", "Count"}}, pool);
+
+  // Then
+  BOOST_REQUIRE_EQUAL(result.size(), 4);
+  std::vector<int64_t> counts {2, 1, 1, 2};
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    BOOST_CHECK_EQUAL(boost::get<int64_t>(result[i][2]), counts[i]);
+  }
+  BOOST_CHECK(std::isnan(boost::get<float>(result[0][1])));
+  BOOST_CHECK_EQUAL(boost::get<bool>(result[2][0]), false);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the invalid aggregations throw
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(GroupByInvalid, TableOperations_Fixture) {
+
+  // Given
+  typedef Aggregation::Function F;
+
+  // Then
+  BOOST_CHECK_THROW(groupBy(table, {"Flag"}, {Aggregation{F::SUM, "Name", "Sum"}}), Elements::Exception);
+  BOOST_CHECK_THROW(groupBy(table, {"Flag"}, {Aggregation{F::SUM, "Missing", "Sum"}}), Elements::Exception);
+  BOOST_CHECK_THROW(groupBy(table, {"Flag"}, {Aggregation{F::COUNT, "", "Flag"}}), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the indices of the joined rows
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(JoinIndices, TableOperations_Fixture) {
+
+  // When
+  auto result = joinIndices(table, other, {"Name"});
+
+  // Then
+  std::vector<std::pair<std::size_t, std::size_t>> expected {
+    {0, 0}, {0, 3}, {1, 2}, {2, 0}, {2, 3}, {4, 2}, {5, 0}, {5, 3}
+  };
+  BOOST_CHECK(result == expected);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the joined table
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(JoinTables, TableOperations_Fixture) {
+
+  // When
+  auto result = join(table, other, {"Name"});
+
+  // Then
+  auto& info = *result.getColumnInfo();
+  BOOST_CHECK_EQUAL(info.size(), 5);
+  BOOST_CHECK_EQUAL(info.getDescription(4).name, "Score");
+  BOOST_REQUIRE_EQUAL(result.size(), 8);
+  BOOST_CHECK_EQUAL(boost::get<int32_t>(result[1][0]), 0);
+  BOOST_CHECK_EQUAL(boost::get<int64_t>(result[1][4]), 40);
+  BOOST_CHECK_EQUAL(boost::get<int32_t>(result[5][0]), 4);
+  BOOST_CHECK_EQUAL(boost::get<int64_t>(result[5][4]), 30);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the parallel join gives the same result as the serial one
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(JoinWithThreadPool, TableOperations_Fixture) {
+
+  // Given
+  auto left = largeTable(30000);
+  auto right = largeTable(101);
+  auto pool = std::make_shared<Euclid::ThreadPool>(4);
+
+  // When
+  auto serial = joinIndices(left, right, {"Key"});
+  auto parallel = joinIndices(left, right, {"Key"}, pool);
+
+  // Then
+  BOOST_CHECK_EQUAL(parallel.size(), 30000);
+  BOOST_CHECK(serial == parallel);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the invalid joins throw
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(JoinInvalid, TableOperations_Fixture) {
+
+  // Given
+  auto no_match_info = std::make_shared<ColumnInfo>(std::vector<ColumnDescription>{
+    ColumnDescription {"Name", typeid(std::string)}
+  });
+  Table no_match {{Row {{std::string{"z"}}, no_match_info}}};
+  auto number_info = std::make_shared<ColumnInfo>(std::vector<ColumnDescription>{
+    ColumnDescription {"Name", typeid(int32_t)}
+  });
+  Table number {{Row {{1}, number_info}}};
+
+  // Then
+  BOOST_CHECK_THROW(join(table, no_match, {"Name"}), Elements::Exception);
+  BOOST_CHECK_THROW(joinIndices(table, number, {"Name"}), Elements::Exception);
+  BOOST_CHECK_THROW(join(table, table, {"Name"}), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test dictionary encoded keys are sorted, grouped and joined by their values
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(DictionaryKeys, TableOperations_Fixture) {
+
+  // Given
+  auto encoded = encodeDictionaryColumns(table, 10);
+  auto other_encoded = encodeDictionaryColumns(other, 10);
+  BOOST_REQUIRE(encoded.getColumnInfo()->getDescription(1).dictionary != nullptr);
+  BOOST_REQUIRE(other_encoded.getColumnInfo()->getDescription(0).dictionary != nullptr);
+
+  // When
+  auto sorted = sortIndices(encoded, {SortKey{"Name"}, SortKey{"Value"}});
+  auto grouped = groupBy(encoded, {"Name"}, {{Aggregation::Function::COUNT, "", "Count"}});
+  auto mixed_join = joinIndices(encoded, other, {"Name"});
+  auto encoded_join = joinIndices(encoded, other_encoded, {"Name"});
+
+  // Then
+  BOOST_CHECK((sorted == std::vector<std::size_t>{4, 1, 2, 0, 5, 3}));
+  BOOST_CHECK((grouped.column<std::string>("Name") == std::vector<std::string>{"b", "a", "c"}));
+  BOOST_CHECK((grouped.column<int64_t>("Count") == std::vector<int64_t>{3, 2, 1}));
+  std::vector<std::pair<std::size_t, std::size_t>> expected {
+    {0, 0}, {0, 3}, {1, 2}, {2, 0}, {2, 3}, {4, 2}, {5, 0}, {5, 3}
+  };
+  BOOST_CHECK(mixed_join == expected);
+  BOOST_CHECK(encoded_join == expected);
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -74,6 +74,11 @@ MATCHER_P(TableFirstValue, expected, "") {
   return boost::get<int>(arg[0][0]) == expected;
 }
 
+MATCHER_P(TableFirstString, expected, "") {
+  return arg.getColumnInfo()->getDescription(0).type == typeid(std::string)
+         && boost::get<std::string>(arg[0][0]) == expected;
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE (TableWriter_test)
@@ -119,6 +124,37 @@ BOOST_FIXTURE_TEST_CASE(addDataWrongColumn_test, TableWriter_Fixture) {
 
 }
 
+//-----------------------------------------------------------------------------
+// Test the dictionary encoded columns are given decoded to the implementation
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(addDataDictionary_test) {
+
+  // Given
+  MockTableWriter writer {};
+  auto first_dictionary = std::make_shared<StringDictionary>(std::vector<std::string>{"VIS"});
+  auto second_dictionary = std::make_shared<StringDictionary>(std::vector<std::string>{"VIS", "Y"});
+  std::shared_ptr<ColumnInfo> first_info {new ColumnInfo {{
+      ColumnInfo::info_type("Band", typeid(int32_t), "", "", first_dictionary)
+  }}};
+  std::shared_ptr<ColumnInfo> second_info {new ColumnInfo {{
+      ColumnInfo::info_type("Band", typeid(int32_t), "", "", second_dictionary)
+  }}};
+  Table first {{Row {{int32_t{0}}, first_info}}};
+  Table second {{Row {{int32_t{1}}, second_info}}};
+
+  // Expect
+  InSequence dummy;
+  EXPECT_CALL(writer, init(TableFirstString("VIS"))).Times(1);
+  EXPECT_CALL(writer, append(TableFirstString("VIS"))).Times(1);
+  EXPECT_CALL(writer, append(TableFirstString("Y"))).Times(1);
+
+  // When
+  writer.addData(first);
+  writer.addData(second);
+
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END ()
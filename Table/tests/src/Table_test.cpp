@@ -160,6 +160,232 @@ BOOST_FIXTURE_TEST_CASE(Iterator, Table_Fixture) {
   
 }
 
+//-----------------------------------------------------------------------------
+// Test the column method returns the values of a column
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(Column, Table_Fixture) {
+
+  // Given
+  Euclid::Table::Table table {row_list};
+
+  // When
+  auto first = table.column<std::string>("First");
+  auto third = table.column<double>("Third");
+
+  // Then
+  BOOST_CHECK((first == std::vector<std::string>{"One-1", "One-2", "One-3"}));
+  BOOST_CHECK((third == std::vector<double>{3.1, 3.2, 3.3}));
+  BOOST_CHECK_THROW(table.column<float>("Third"), Elements::Exception);
+  BOOST_CHECK_THROW(table.column<double>("Missing"), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the columnCast method converts the values of a numeric column
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ColumnCast, Table_Fixture) {
+
+  // Given
+  Euclid::Table::Table table {row_list};
+
+  // When
+  auto fifth = table.columnCast<double>("Fifth");
+  auto fourth = table.columnCast<int64_t>("Fourth");
+
+  // Then
+  BOOST_CHECK((fifth == std::vector<double>{51., 52., 53.}));
+  BOOST_CHECK((fourth == std::vector<int64_t>{4, 4, 4}));
+  BOOST_CHECK_THROW(table.columnCast<double>("First"), Elements::Exception);
+  BOOST_CHECK_THROW(table.columnCast<double>("Missing"), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the column method decodes the dictionary encoded columns
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(ColumnDictionary) {
+
+  // Given
+  auto dictionary = std::make_shared<Euclid::Table::StringDictionary>(std::vector<std::string>{"VIS", "Y"});
+  std::shared_ptr<Euclid::Table::ColumnInfo> column_info {new Euclid::Table::ColumnInfo {{
+      Euclid::Table::ColumnInfo::info_type("Band", typeid(int32_t), "", "", dictionary)
+  }}};
+  Euclid::Table::Table table {{
+      Euclid::Table::Row {{int32_t{1}}, column_info},
+      Euclid::Table::Row {{int32_t{0}}, column_info},
+      Euclid::Table::Row {{int32_t{1}}, column_info}
+  }};
+
+  // When
+  auto codes = table.column<int32_t>("Band");
+  auto values = table.column<std::string>("Band");
+
+  // Then
+  BOOST_CHECK((codes == std::vector<int32_t>{1, 0, 1}));
+  BOOST_CHECK((values == std::vector<std::string>{"Y", "VIS", "Y"}));
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the validity bitmaps of the columns
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(Validity, Table_Fixture) {
+
+  // Given
+  Euclid::Table::ValidityBitmap third_validity {3};
+  third_validity.setValid(1, false);
+  std::map<std::size_t, Euclid::Table::ValidityBitmap> validity {{2, third_validity}};
+
+  // When
+  Euclid::Table::Table table {row_list, validity};
+  Euclid::Table::Table no_nulls {row_list};
+
+  // Then
+  BOOST_CHECK(table.getValidity("Third") == third_validity);
+  BOOST_CHECK(table.getValidity("Fourth").allValid());
+  BOOST_CHECK_EQUAL(table.getValidityBitmaps().size(), 1);
+  BOOST_CHECK(no_nulls.getValidity("Third").allValid());
+  BOOST_CHECK(no_nulls.getValidityBitmaps().empty());
+  BOOST_CHECK_THROW(table.getValidity("Missing"), Elements::Exception);
+  BOOST_CHECK_THROW((Euclid::Table::Table{row_list, {{5, third_validity}}}), Elements::Exception);
+  BOOST_CHECK_THROW((Euclid::Table::Table{row_list, {{2, Euclid::Table::ValidityBitmap{2}}}}),
+                    Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the concatenation refers to the rows of the tables and merges their
+// validity bitmaps
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(Concatenate, Table_Fixture) {
+
+  // Given
+  Euclid::Table::ValidityBitmap third_validity {3};
+  third_validity.setValid(2, false);
+  Euclid::Table::Table first {row_list};
+  Euclid::Table::Table second {row_list, {{2, third_validity}}};
+
+  // When
+  Euclid::Table::Table result {std::vector<Euclid::Table::Table>{first, second, first}};
+
+  // Then
+  BOOST_REQUIRE_EQUAL(result.size(), 9);
+  BOOST_CHECK_EQUAL(&result[4], &second[1]);
+  BOOST_CHECK_EQUAL(boost::get<int>(result[8][4]), 53);
+  BOOST_CHECK_EQUAL(result.getValidity("Third").countValid(), 8);
+  BOOST_CHECK(!result.getValidity("Third").isValid(5));
+  BOOST_CHECK(result.getValidity("Fourth").allValid());
+  BOOST_CHECK_EQUAL(result.column<double>("Third").size(), 9);
+  BOOST_CHECK_THROW(Euclid::Table::Table{std::vector<Euclid::Table::Table>{}}, Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the concatenation of tables with different columns throws
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ConcatenateDifferentColumnInfo, Table_Fixture) {
+
+  // Given
+  auto other_info = std::make_shared<Euclid::Table::ColumnInfo>(
+      std::vector<Euclid::Table::ColumnDescription>{Euclid::Table::ColumnDescription{"First"}});
+  Euclid::Table::Table other {{Euclid::Table::Row{{std::string{"Test"}}, other_info}}};
+  std::vector<Euclid::Table::Table> tables {Euclid::Table::Table{row_list}, other};
+
+  // Then
+  BOOST_CHECK_THROW(Euclid::Table::Table{tables}, Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the slices refer to the rows of the table, also across the tables of a
+// concatenation
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(Slice, Table_Fixture) {
+
+  // Given
+  Euclid::Table::ValidityBitmap third_validity {3};
+  third_validity.setValid(0, false);
+  Euclid::Table::Table first {row_list};
+  Euclid::Table::Table second {row_list, {{2, third_validity}}};
+  Euclid::Table::Table concatenated {std::vector<Euclid::Table::Table>{first, second}};
+
+  // When
+  auto result = concatenated.slice(2, 5);
+  auto inner = result.slice(1, 2);
+
+  // Then
+  BOOST_REQUIRE_EQUAL(result.size(), 3);
+  BOOST_CHECK_EQUAL(&result[0], &first[2]);
+  BOOST_CHECK_EQUAL(&result[2], &second[1]);
+  BOOST_CHECK(result.getValidity("Third").isValid(0));
+  BOOST_CHECK(!result.getValidity("Third").isValid(1));
+  BOOST_CHECK_EQUAL(inner.size(), 1);
+  BOOST_CHECK_EQUAL(&inner[0], &second[0]);
+  BOOST_CHECK_THROW(concatenated.slice(3, 3), Elements::Exception);
+  BOOST_CHECK_THROW(concatenated.slice(4, 7), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the iterator moves over the rows of all the blocks
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(IteratorConcatenated, Table_Fixture) {
+
+  // Given
+  Euclid::Table::Table first {row_list};
+  Euclid::Table::Table concatenated {std::vector<Euclid::Table::Table>{first, first.slice(1, 2), first}};
+
+  // When
+  std::vector<int> values {};
+  for (auto& row : concatenated) {
+    values.push_back(boost::get<int>(row[4]));
+  }
+  auto iter = concatenated.begin() + 5;
+  std::vector<Euclid::Table::Row> copied {concatenated.begin() + 2, concatenated.end()};
+
+  // Then
+  std::vector<int> expected {51, 52, 53, 52, 51, 52, 53};
+  BOOST_CHECK_EQUAL_COLLECTIONS(values.begin(), values.end(), expected.begin(), expected.end());
+  BOOST_CHECK_EQUAL(concatenated.end() - concatenated.begin(), 7);
+  BOOST_CHECK_EQUAL(boost::get<int>((*iter)[4]), 52);
+  BOOST_CHECK_EQUAL(boost::get<int>((*--iter)[4]), 51);
+  BOOST_CHECK_EQUAL(boost::get<int>((*--iter)[4]), 52);
+  BOOST_CHECK_EQUAL(boost::get<int>(iter[-1][4]), 53);
+  BOOST_CHECK_EQUAL(copied.size(), 5);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the iterator stays valid across the blocks when the table is moved
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(IteratorMovedTable, Table_Fixture) {
+
+  // Given
+  Euclid::Table::Table first {row_list};
+  Euclid::Table::Table concatenated {std::vector<Euclid::Table::Table>{first, first}};
+  auto iter = concatenated.begin() + 2;
+
+  // When
+  Euclid::Table::Table moved {std::move(concatenated)};
+  concatenated = first;
+  ++iter;
+  iter += 2;
+
+  // Then
+  BOOST_CHECK_EQUAL(boost::get<int>((*iter)[4]), 53);
+  BOOST_CHECK(++iter == moved.end());
+
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END ()
\ No newline at end of file
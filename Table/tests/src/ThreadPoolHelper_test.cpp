@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file tests/src/ThreadPoolHelper_test.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <atomic>
+#include <stdexcept>
+#include <boost/test/unit_test.hpp>
+#include "src/lib/ThreadPoolHelper.h"
+
+using namespace Euclid;
+using namespace Euclid::Table;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (ThreadPoolHelper_test)
+
+//-----------------------------------------------------------------------------
+// Test the tasks are executed in order when there is no pool
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(runTasksSerial) {
+
+  // Given
+  std::vector<int> order {};
+  std::vector<std::function<void()>> tasks {};
+  for (int i = 0; i < 5; ++i) {
+    tasks.emplace_back([&order, i]() { order.push_back(i); });
+  }
+
+  // When
+  runTasks(nullptr, tasks);
+
+  // Then
+  std::vector<int> expected {0, 1, 2, 3, 4};
+  BOOST_CHECK_EQUAL_COLLECTIONS(order.begin(), order.end(), expected.begin(), expected.end());
+
+}
+
+//-----------------------------------------------------------------------------
+// Test all the tasks are executed by the pool before returning
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(runTasksParallel) {
+
+  // Given
+  ThreadPool pool {4};
+  std::vector<int> results (100, 0);
+  std::vector<std::function<void()>> tasks {};
+  for (int i = 0; i < 100; ++i) {
+    tasks.emplace_back([&results, i]() { results[i] = i * i; });
+  }
+
+  // When
+  runTasks(&pool, tasks);
+
+  // Then
+  for (int i = 0; i < 100; ++i) {
+    BOOST_CHECK_EQUAL(results[i], i * i);
+  }
+
+}
+
+//-----------------------------------------------------------------------------
+// Test an exception of a task is rethrown after all the tasks are finished
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(runTasksException) {
+
+  // Given
+  ThreadPool pool {4};
+  std::atomic<int> executed {0};
+  std::vector<std::function<void()>> tasks {};
+  for (int i = 0; i < 10; ++i) {
+    tasks.emplace_back([&executed, i]() {
+      ++executed;
+      if (i == 3) {
+        throw std::runtime_error("failure");
+      }
+    });
+  }
+
+  // Then
+  BOOST_CHECK_THROW(runTasks(&pool, tasks), std::runtime_error);
+  BOOST_CHECK_EQUAL(executed.load(), 10);
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file tests/src/TypedTableReader_test.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <sstream>
+#include <boost/test/unit_test.hpp>
+#include "ElementsKernel/Exception.h"
+#include "AlexandriaKernel/memory_tools.h"
+#include "Table/AsciiReader.h"
+#include "Table/TypedTableReader.h"
+
+using namespace Euclid::Table;
+using Euclid::make_unique;
+
+struct Source {
+  int64_t id;
+  double z;
+  bool flag;
+  std::string name;
+};
+
+struct TypedTableReader_Fixture {
+  std::string table {
+    "# Column: ID int\n"
+    "# Column: Z float\n"
+    "# Column: Flag bool\n"
+    "# Column: Name string\n"
+    "# Column: Mag double\n"
+    "1 0.5 true  first  20.1\n"
+    "2 1.5 false second 21.2\n"
+    "# A comment\n"
+    "3 2.5 t     third  22.3\n"
+  };
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (TypedTableReader_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(isLosslessConversion_test) {
+
+  // Then
+  BOOST_CHECK(isLosslessConversion(typeid(double), typeid(double)));
+  BOOST_CHECK(isLosslessConversion(typeid(bool), typeid(int32_t)));
+  BOOST_CHECK(isLosslessConversion(typeid(int32_t), typeid(int64_t)));
+  BOOST_CHECK(isLosslessConversion(typeid(int32_t), typeid(double)));
+  BOOST_CHECK(isLosslessConversion(typeid(float), typeid(double)));
+  BOOST_CHECK(!isLosslessConversion(typeid(double), typeid(float)));
+  BOOST_CHECK(!isLosslessConversion(typeid(int64_t), typeid(double)));
+  BOOST_CHECK(!isLosslessConversion(typeid(int32_t), typeid(float)));
+  BOOST_CHECK(!isLosslessConversion(typeid(int32_t), typeid(bool)));
+  BOOST_CHECK(!isLosslessConversion(typeid(std::string), typeid(double)));
+  BOOST_CHECK(!isLosslessConversion(typeid(std::vector<double>), typeid(double)));
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ReadAll, TypedTableReader_Fixture) {
+
+  // Given
+  std::stringstream in {table};
+  auto reader = makeTypedTableReader<Source>(make_unique<AsciiReader>(in),
+                                             field("Name", &Source::name), field("ID", &Source::id),
+                                             field("Z", &Source::z), field("Flag", &Source::flag));
+
+  // When
+  auto sources = reader.read();
+
+  // Then
+  BOOST_CHECK_EQUAL(sources.size(), 3);
+  BOOST_CHECK_EQUAL(sources[0].id, 1);
+  BOOST_CHECK_EQUAL(sources[1].z, 1.5);
+  BOOST_CHECK_EQUAL(sources[1].flag, false);
+  BOOST_CHECK_EQUAL(sources[2].flag, true);
+  BOOST_CHECK_EQUAL(sources[2].name, "third");
+  BOOST_CHECK(!reader.hasMoreRows());
+  BOOST_CHECK_THROW(reader.read(), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ReadChunks, TypedTableReader_Fixture) {
+
+  // Given
+  std::stringstream in {table};
+  auto reader = makeTypedTableReader<Source>(make_unique<AsciiReader>(in), field("ID", &Source::id));
+
+  // When
+  auto first = reader.read(2);
+  auto second = reader.read(2);
+
+  // Then
+  BOOST_CHECK_EQUAL(first.size(), 2);
+  BOOST_CHECK_EQUAL(first[1].id, 2);
+  BOOST_CHECK_EQUAL(second.size(), 1);
+  BOOST_CHECK_EQUAL(second[0].id, 3);
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(WrongBindings, TypedTableReader_Fixture) {
+
+  // Given
+  std::stringstream missing_in {table};
+  std::stringstream lossy_in {table};
+  std::stringstream string_in {table};
+
+  // Then
+  BOOST_CHECK_THROW(makeTypedTableReader<Source>(make_unique<AsciiReader>(missing_in),
+                                                 field("Missing", &Source::z)),
+                    Elements::Exception);
+  BOOST_CHECK_THROW(makeTypedTableReader<Source>(make_unique<AsciiReader>(lossy_in),
+                                                 field("ID", &Source::flag)),
+                    Elements::Exception);
+  BOOST_CHECK_THROW(makeTypedTableReader<Source>(make_unique<AsciiReader>(string_in),
+                                                 field("Name", &Source::z)),
+                    Elements::Exception);
+  BOOST_CHECK_THROW(makeTypedTableReader<Source>(nullptr, field("ID", &Source::id)),
+                    Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
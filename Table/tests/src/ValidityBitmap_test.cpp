@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file tests/src/ValidityBitmap_test.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "ElementsKernel/Exception.h"
+#include "Table/ValidityBitmap.h"
+
+using namespace Euclid::Table;
+
+struct ValidityBitmap_Fixture {
+  // 150 rows, spanning three words, with the multiples of 7 missing
+  ValidityBitmap bitmap {150};
+  ValidityBitmap_Fixture() {
+    for (std::size_t i = 0; i < bitmap.size(); i += 7) {
+      bitmap.setValid(i, false);
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (ValidityBitmap_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(AllValid) {
+
+  // Given
+  ValidityBitmap bitmap {70};
+
+  // Then
+  BOOST_CHECK_EQUAL(bitmap.size(), 70);
+  BOOST_CHECK_EQUAL(bitmap.countValid(), 70);
+  BOOST_CHECK(bitmap.allValid());
+  BOOST_CHECK_EQUAL(bitmap.getWords().size(), 2);
+  BOOST_CHECK_EQUAL(bitmap.getWords()[1], 0x3Fu);
+  BOOST_CHECK_THROW(bitmap.setValid(70, false), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(SetValid, ValidityBitmap_Fixture) {
+
+  // When
+  bitmap.setValid(7, true);
+
+  // Then
+  BOOST_CHECK(!bitmap.isValid(0));
+  BOOST_CHECK(bitmap.isValid(1));
+  BOOST_CHECK(bitmap.isValid(7));
+  BOOST_CHECK(!bitmap.isValid(147));
+  BOOST_CHECK_EQUAL(bitmap.countValid(), 150 - 21);
+  BOOST_CHECK(!bitmap.allValid());
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ForEachValid, ValidityBitmap_Fixture) {
+
+  // Given
+  std::vector<std::size_t> expected {};
+  for (std::size_t i = 0; i < bitmap.size(); ++i) {
+    if (i % 7 != 0) {
+      expected.push_back(i);
+    }
+  }
+  ValidityBitmap full {128};
+  std::size_t full_count = 0;
+
+  // When
+  std::vector<std::size_t> indices {};
+  bitmap.forEachValid([&indices](std::size_t i) { indices.push_back(i); });
+  full.forEachValid([&full_count](std::size_t) { ++full_count; });
+
+  // Then
+  BOOST_CHECK(indices == expected);
+  BOOST_CHECK_EQUAL(full_count, 128);
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(And, ValidityBitmap_Fixture) {
+
+  // Given
+  ValidityBitmap other {150};
+  other.setValid(1, false);
+  other.setValid(7, false);
+
+  // When
+  auto result = bitmap & other;
+
+  // Then
+  BOOST_CHECK(!result.isValid(0));
+  BOOST_CHECK(!result.isValid(1));
+  BOOST_CHECK(!result.isValid(7));
+  BOOST_CHECK_EQUAL(result.countValid(), 150 - 23);
+  BOOST_CHECK_THROW(bitmap &= ValidityBitmap{10}, Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(SliceAndAppend, ValidityBitmap_Fixture) {
+
+  // When
+  auto first = bitmap.slice(0, 65);
+  auto second = bitmap.slice(65, 85);
+  auto joined = first;
+  joined.append(second);
+
+  // Then
+  BOOST_CHECK_EQUAL(second.size(), 85);
+  BOOST_CHECK(second.isValid(0));
+  BOOST_CHECK(!second.isValid(5));
+  BOOST_CHECK(!second.isValid(82));
+  BOOST_CHECK_EQUAL(second.countValid(), 85 - 12);
+  BOOST_CHECK(joined == bitmap);
+  BOOST_CHECK(first != bitmap);
+  BOOST_CHECK_THROW(bitmap.slice(100, 51), Elements::Exception);
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
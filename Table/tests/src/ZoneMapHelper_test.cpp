@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+/**
+ * @file tests/src/ZoneMapHelper_test.cpp
+ * @date 10/19/26
+ * @author nikoapos
+ */
+
+#include <cmath>
+#include <limits>
+#include <boost/test/unit_test.hpp>
+#include "ElementsKernel/Exception.h"
+#include "src/lib/ZoneMapHelper.h"
+
+using namespace Euclid::Table;
+
+struct ZoneMapHelper_Fixture {
+
+  double nan = std::numeric_limits<double>::quiet_NaN();
+
+  std::shared_ptr<ColumnInfo> column_info {new ColumnInfo {{
+    ColumnDescription {"Flag", typeid(bool)},
+    ColumnDescription {"Int", typeid(int32_t)},
+    ColumnDescription {"Float", typeid(float)},
+    ColumnDescription {"Double", typeid(double)},
+    ColumnDescription {"Name", typeid(std::string)}
+  }}};
+
+  Table table {{
+    Row {{true, 5, 1.5f, nan, std::string{"a"}}, column_info},
+    Row {{false, -3, 0.5f, nan, std::string{"b"}}, column_info},
+    Row {{true, 8, -2.5f, 4., std::string{"c"}}, column_info},
+    Row {{true, 1, 3.5f, nan, std::string{"d"}}, column_info}
+  }};
+
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (ZoneMapHelper_test)
+
+//-----------------------------------------------------------------------------
+// Test the statistics of the numeric columns
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ComputeStatistics, ZoneMapHelper_Fixture) {
+
+  // When
+  auto flag = computeStatistics(table, 0, 0, 4);
+  auto integer = computeStatistics(table, 1, 1, 4);
+  auto real = computeStatistics(table, 2, 0, 2);
+  auto with_nan = computeStatistics(table, 3, 0, 4);
+  auto only_nan = computeStatistics(table, 3, 0, 2);
+  auto name = computeStatistics(table, 4, 0, 4);
+
+  // Then
+  BOOST_REQUIRE(flag && integer && real && with_nan && only_nan);
+  BOOST_CHECK_EQUAL(boost::get<int64_t>(flag->min), 0);
+  BOOST_CHECK_EQUAL(boost::get<int64_t>(flag->max), 1);
+  BOOST_CHECK_EQUAL(boost::get<int64_t>(integer->min), -3);
+  BOOST_CHECK_EQUAL(boost::get<int64_t>(integer->max), 8);
+  BOOST_CHECK_EQUAL(boost::get<double>(real->min), 0.5);
+  BOOST_CHECK_EQUAL(boost::get<double>(real->max), 1.5);
+  BOOST_CHECK_EQUAL(boost::get<double>(with_nan->min), 4.);
+  BOOST_CHECK_EQUAL(with_nan->null_count, 3);
+  BOOST_CHECK(!only_nan->hasValues());
+  BOOST_CHECK_EQUAL(only_nan->null_count, 2);
+  BOOST_CHECK(!name);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test merging the statistics of consecutive rows
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(MergeStatistics, ZoneMapHelper_Fixture) {
+
+  // Given
+  auto integer = *computeStatistics(table, 1, 0, 2);
+  auto real = *computeStatistics(table, 3, 0, 2);
+
+  // When
+  mergeStatistics(integer, *computeStatistics(table, 1, 2, 4));
+  mergeStatistics(real, *computeStatistics(table, 3, 2, 4));
+
+  // Then
+  BOOST_CHECK_EQUAL(boost::get<int64_t>(integer.min), -3);
+  BOOST_CHECK_EQUAL(boost::get<int64_t>(integer.max), 8);
+  BOOST_CHECK_EQUAL(boost::get<double>(real.min), 4.);
+  BOOST_CHECK_EQUAL(boost::get<double>(real.max), 4.);
+  BOOST_CHECK_EQUAL(real.null_count, 3);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the zone map is converted to a table and back, using column numbers
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ZoneMapTable, ZoneMapHelper_Fixture) {
+
+  // Given
+  ZoneMap zone_map {};
+  for (std::size_t first : {0, 2}) {
+    ZoneMapBlock block {};
+    block.offset = first;
+    block.rows = 2;
+    block.columns.emplace("Int", *computeStatistics(table, 1, first, first + 2));
+    block.columns.emplace("Double", *computeStatistics(table, 3, first, first + 2));
+    zone_map.push_back(block);
+  }
+  ColumnInfo renamed {{
+    ColumnDescription {"A", typeid(bool)},
+    ColumnDescription {"B", typeid(int32_t)},
+    ColumnDescription {"C", typeid(float)},
+    ColumnDescription {"D", typeid(double)},
+    ColumnDescription {"E", typeid(std::string)}
+  }};
+
+  // When
+  auto zone_map_table = zoneMapToTable(zone_map, *column_info);
+  auto result = zoneMapFromTable(zone_map_table, renamed);
+
+  // Then
+  auto& info = *zone_map_table.getColumnInfo();
+  BOOST_CHECK_EQUAL(info.size(), 8);
+  BOOST_CHECK_EQUAL(info.getDescription(2).name, "MIN2");
+  BOOST_CHECK(info.getDescription(5).type == typeid(double));
+  BOOST_REQUIRE_EQUAL(result.size(), 2);
+  BOOST_CHECK_EQUAL(result[1].offset, 2);
+  BOOST_CHECK_EQUAL(result[1].rows, 2);
+  BOOST_CHECK_EQUAL(result[0].columns.size(), 2);
+  BOOST_CHECK_EQUAL(boost::get<int64_t>(result[1].columns.at("B").max), 8);
+  BOOST_CHECK(!result[0].columns.at("D").hasValues());
+  BOOST_CHECK_EQUAL(result[0].columns.at("D").null_count, 2);
+
+}
+
+//-----------------------------------------------------------------------------
+// Test the missing values are excluded from the statistics
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(ComputeStatisticsMissingValues, ZoneMapHelper_Fixture) {
+
+  // Given
+  ValidityBitmap int_validity {4};
+  int_validity.setValid(2, false);
+  ValidityBitmap float_validity {4};
+  float_validity.setValid(1, false);
+  std::vector<Row> rows (table.begin(), table.end());
+  Table with_missing {std::move(rows), {{1, int_validity}, {2, float_validity}}};
+
+  // When
+  auto integer = computeStatistics(with_missing, 1, 0, 4);
+  auto only_missing = computeStatistics(with_missing, 1, 2, 3);
+  auto real = computeStatistics(with_missing, 2, 0, 2);
+
+  // Then
+  BOOST_REQUIRE(integer && only_missing && real);
+  BOOST_CHECK_EQUAL(boost::get<int64_t>(integer->min), -3);
+  BOOST_CHECK_EQUAL(boost::get<int64_t>(integer->max), 5);
+  BOOST_CHECK_EQUAL(integer->null_count, 1);
+  BOOST_CHECK(!only_missing->hasValues());
+  BOOST_CHECK_EQUAL(only_missing->null_count, 1);
+  BOOST_CHECK_EQUAL(boost::get<double>(real->min), 1.5);
+  BOOST_CHECK_EQUAL(boost::get<double>(real->max), 1.5);
+  BOOST_CHECK_EQUAL(real->null_count, 1);
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()